@@ -64,7 +64,12 @@
 // Headers provided by other cob-packages
 #include <cob_canopen_motor/CanDriveItf.h>
 #include <cob_canopen_motor/CanDriveHarmonica.h>
+#include <cob_canopen_motor/DriveConversion.h>
 #include <cob_generic_can/CanItf.h>
+#include <cob_generic_can/CanBusMonitor.h>
+
+// Headers provided by this package
+#include <cob_base_drive_chain/ElmoRecorderDownload.h>
 
 // Headers provided by cob-packages which should be avoided/removed
 #include <cob_utilities/IniFile.h>
@@ -130,6 +135,26 @@ public:
 	 */
 	bool resetPltf();
 
+	/**
+	 * Duration of the phases of the last initPltf() in sec, the motors are brought up at the same time.
+	 */
+	struct BringUpTimingType
+	{
+		double dNetStart;
+		double dWatchdogConfig;
+		double dInitStart;
+		double dHoming;
+		double dWatchdogStart;
+		double dTotal;
+		// init and start of each motor
+		std::vector<double> vdInitStartMotor;
+	};
+
+	/**
+	 * Returns the timing of the last initPltf(), it is also printed at the end of initPltf().
+	 */
+	const BringUpTimingType& getBringUpTiming() { return m_BringUpTiming; }
+
 	/**
 	 * Signs an error of the platform.
 	 * @return true if there is an error.
@@ -196,12 +221,28 @@ public:
 
 	/**
 	 * Gets the position and velocity.
+	 * With CanCtrl.ini [CanCtrl] VelEstimation = 1 the velocity is estimated from the positions sampled
+	 * at the SYNC msgs (see CanDriveHarmonica::getGearVelAccEstim()) instead of measured by the drive.
 	 * @param iCanIdent choose a can node
 	 * @param pdAngleGearRad joint-position in radian
 	 * @param pdVelGearRadS joint-velocity in radian per second
 	 */
 	int getGearPosVelRadS(int iCanIdent, double* pdAngleGearRad, double* pdVelGearRadS);
 
+	/**
+	 * Gets the positions and velocities of all motors, converted at once.
+	 * The velocities are estimated like in the single motor version if configured.
+	 * @param vdAngleGearRad joint-positions in radian, indexed by the CANNode enumeration
+	 * @param vdVelGearRadS joint-velocities in radian per second, indexed by the CANNode enumeration
+	 */
+	int getGearPosVelRadS(std::vector<double>& vdAngleGearRad, std::vector<double>& vdVelGearRadS);
+
+	/**
+	 * Returns the bus load accounting of the CAN interface.
+	 * @return NULL if disabled by CanCtrl.ini [CanCtrl] BusMonitor = 0
+	 */
+	CanBusMonitor* getBusMonitor() { return m_pBusMonitor; }
+
 	/**
 	 * Gets the delta joint-angle since the last call and the velocity.
 	 * @param iCanIdent choose a can node
@@ -234,13 +275,22 @@ public:
 	 * @param iFlag To keep the interface slight, use iParam to command the recorder:
 	 * 0: Configure the Recorder to record the sources Main Speed(1), Main position(2), Active current(10), Speed command(16). With iParam = iRecordingGap you specify every which time quantum (4*90usec) a new data point (of 1024 points in total) is recorded; 
 	 * 1: Query Upload of recorded source (1=Main Speed, 2=Main position, 10=Active Current, 16=Speed command) with iParam and log data to file sParam = file prefix. Filename is extended with _MotorNumber_RecordedSource.log
+	 * 2: Query Upload of all recorded sources, log data to files like with flag 1 (iParam is ignored)
 	 * 99: Abort and clear current SDO readout process
-	 * 100: Request status of readout. Gives back 0 if all transmissions have finished and no CAN polling is needed anymore.
+	 * 100: Request status of readout and continue the uploads. Has to be called cyclically after evalCanBuffer(). Gives back 0 if all transmissions have finished and no CAN polling is needed anymore.
+	 * All drives upload at the same time, limited to the share of the bus bandwidth set in CanCtrl.ini, section ElmoRecorder, key BandwidthShare.
+	 * The data is written as binary trace files (see ElmoTrace.h) and/or text logfiles, set with key LogFormat (1 = text, 2 = binary, 3 = both) of that section.
+	 * A source which isn't uploaded within key Timeout of that section (in seconds, default 30) is aborted.
 	 * @return -1: Unknown flag set; 0: Success; 1: Recorder hasn't been configured yet; 2: data collection still in progress
 	 *
 	*/
 	int ElmoRecordings(int iFlag, int iParam, std::string sString);
 
+	/**
+	 * Sets the function which is called by ElmoRecordings(100, ..) after every finished or failed upload.
+	 */
+	void setElmoRecordingsCallback(ElmoRecorderDownload::CallbackType callback);
+
 	//--------------------------------- Commands for other nodes
 
 
@@ -442,6 +492,10 @@ protected:
 	//--------------------------------- Components
 	// Can-Interface
 	CanItf* m_pCanCtrl;
+	// the same object as m_pCanCtrl if the bus is monitored, else NULL
+	CanBusMonitor* m_pBusMonitor;
+	// report the velocity estimated from the SYNC positions instead of the measured one
+	bool m_bVelEstimation;
 	IniFile m_IniFile;
 
 	int m_iNumMotors;
@@ -462,6 +516,33 @@ protected:
 	// this has to be adapted in c++ file to your hardware
 	std::vector<int> m_viMotorID;
 
+	// conversion factors of all motors and the unconverted values of the last PDOs
+	DriveConversionBatch m_DriveConversion;
+	std::vector<int> m_viPosMotIncr;
+	std::vector<int> m_viVelMotIncrPeriod;
+
+	BringUpTimingType m_BringUpTiming;
+
+	/**
+	 * Initializes (bInit = true) and starts all motors at the same time, see CanDriveHarmonica::beginBringUp().
+	 * @param vbRetMotor success of each motor
+	 * @return true if all motors are up
+	 */
+	bool bringUpMotors(bool bInit, std::vector<bool>& vbRetMotor);
+
+	/**
+	 * Evaluates the CAN messages until the SDO clients of all motors are idle, requests left after dTimeoutSec are cancelled.
+	 * @return false if a request failed
+	 */
+	bool waitForSDOClients(double dTimeoutSec);
+
+	// readout of the ElmoRecorders of all motors
+	ElmoRecorderDownload m_RecorderDownload;
+	int m_iRecorderLogFormat;
+
+	// passes m_iRecorderLogFormat to all motors
+	void setElmoRecorderLogFormat();
+
 	// other
 
 
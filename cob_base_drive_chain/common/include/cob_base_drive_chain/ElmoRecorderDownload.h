@@ -0,0 +1,169 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_base_drive_chain
+ * Description: Downloads the ElmoRecorder data of all drives at once, within a share of the CAN bandwidth.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef ELMORECORDERDOWNLOAD_INCLUDEDEF_H
+#define ELMORECORDERDOWNLOAD_INCLUDEDEF_H
+
+//-----------------------------------------------
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+
+#include <cob_canopen_motor/CanDriveItf.h>
+#include <cob_utilities/TimeStamp.h>
+
+//-----------------------------------------------
+
+/**
+ * Downloads the recorded sources of the ElmoRecorders of several drives.
+ * Every drive keeps one SDO block upload open (CANopen allows one transfer per node), the drives upload at the same time.
+ * Each drive holds back the confirmation of its blocks (CanDriveItf::setRecorder(3, ..)). update() releases
+ * the confirmations round robin as long as the transfers stay within the configured share of the bus bandwidth,
+ * so the PDOs of the control cycle still get through.
+ * A source which isn't uploaded within the timeout, or can't even be requested because the drive stays busy,
+ * is aborted and counted as failed, the drive goes on with its next source.
+ */
+class ElmoRecorderDownload
+{
+public:
+	/**
+	 * Called when the upload of a recorded source of a drive has ended.
+	 * @param iMotor index of the drive in the vector passed to start()
+	 * @param iObjSubIndex recorded source which has been uploaded
+	 * @param iResult ElmoRecorder::UploadResult, only UPLOAD_SUCCEEDED has written a log file
+	 * @param iNumFinished number of uploads finished so far, including the failed ones
+	 * @param iNumTotal number of uploads of the whole download
+	 */
+	typedef boost::function<void (int iMotor, int iObjSubIndex, int iResult, int iNumFinished, int iNumTotal)> CallbackType;
+
+	ElmoRecorderDownload();
+
+	/**
+	 * Sets the share of the bus bandwidth the uploads may use.
+	 * @param iBaudrateKBit bit rate of the CAN bus in kbit/s
+	 * @param dShare share of the bit rate (0..1), 0 or less uploads without pacing
+	 * @param iBlockSize number of segments a drive sends per released confirmation (1..127)
+	 */
+	void setBandwidth(int iBaudrateKBit, double dShare, int iBlockSize = 16);
+
+	/**
+	 * Sets the time after which the upload of a source is aborted, measured from its request,
+	 * or from the end of the previous source while the drive is too busy to accept the request.
+	 * @param dTimeoutSec timeout in seconds, 0 or less waits forever
+	 */
+	void setTimeout(double dTimeoutSec) { m_dTimeoutSec = dTimeoutSec; }
+
+	/**
+	 * Sets the function which is called after each finished upload.
+	 */
+	void setCallback(CallbackType callback) { m_Callback = callback; }
+
+	/**
+	 * Starts the download of the recorded sources viObjSubIndex of all drives.
+	 * The first source of every drive is requested immediately, the others are requested by update().
+	 * @param sFilePrefix prefix of the log files, see CanDriveItf::setRecorder()
+	 * @return 0: Success, 1: a Recorder hasn't been configured yet, 2: a download is still in progress
+	 */
+	int start(const std::vector<CanDriveItf*>& vpMotor, const std::vector<int>& viObjSubIndex, std::string sFilePrefix);
+
+	/**
+	 * Has to be called cyclically after the received CAN messages have been evaluated.
+	 * Requests the next sources and releases the block confirmations within the bandwidth.
+	 * @return true while the download is in progress
+	 */
+	bool update();
+
+	/**
+	 * Aborts the running uploads and clears the queued ones.
+	 */
+	void abort();
+
+	bool isRunning() const { return m_bRunning; }
+	int getNumFinished() const { return m_iNumFinished; }
+	int getNumFailed() const { return m_iNumFailed; }
+	int getNumTotal() const { return m_iNumTotal; }
+
+private:
+	// drops the pacing of the drives and ends the download
+	void finish();
+
+	// ends the upload of the active source of drive iMotor
+	void finishSource(unsigned int iMotor, int iResult);
+
+	std::vector<CanDriveItf*> m_vpMotor;
+	// sources of each drive which haven't been requested yet
+	std::vector< std::deque<int> > m_vQueue;
+	// source which each drive is uploading, -1 if idle
+	std::vector<int> m_viActive;
+	// time the active source of each drive has been requested, or the next one has started to wait
+	std::vector<TimeStamp> m_vStartTime;
+	double m_dTimeoutSec;
+	std::string m_sFilePrefix;
+	CallbackType m_Callback;
+
+	// segments per second the uploads may use, 0 for no pacing
+	double m_dSegmentsPerSec;
+	int m_iBlockSize;
+	// segments the uploads may still send, negative after a released block exceeded the budget
+	double m_dBudget;
+	TimeStamp m_LastUpdate;
+	// drive whose confirmation is released first in the next update
+	unsigned int m_iNextMotor;
+
+	int m_iNumFinished;
+	int m_iNumFailed;
+	int m_iNumTotal;
+	bool m_bRunning;
+};
+
+//-----------------------------------------------
+#endif
@@ -62,6 +62,10 @@
 #include <cob_generic_can/CanESD.h>
 #include <cob_generic_can/CanPeakSys.h>
 #include <cob_generic_can/CanPeakSysUSB.h>
+#include <cob_generic_can/CanSimBus.h>
+#include <cob_generic_can/CanBusMonitor.h>
+#include <cob_generic_can/CanSocket.h>
+#include <cob_canopen_motor/HarmonicaSim.h>
 #include <cob_base_drive_chain/CanCtrlPltfCOb3.h>
 
 #include <unistd.h>
@@ -85,6 +89,8 @@ CanCtrlPltfCOb3::CanCtrlPltfCOb3(std::string iniDirectory)
 
 	// ------------- first of all set used CanItf
 	m_pCanCtrl = NULL;
+	m_pBusMonitor = NULL;
+	m_bVelEstimation = false;
 
 	// ------------- init hardware-specific vectors and set default values
 	m_vpMotor.resize(m_iNumMotors);
@@ -248,6 +254,7 @@ void CanCtrlPltfCOb3::readConfiguration()
 
 	int iTypeCan = 0;
 	int iMaxMessages = 0;
+	CanSimBus* pSimBus = NULL;
 
 	DriveParam DriveParamW1DriveMotor;
 	DriveParam DriveParamW1SteerMotor;
@@ -307,6 +314,67 @@ void CanCtrlPltfCOb3::readConfiguration()
 		m_pCanCtrl = new CanESD(sComposed.c_str(), false);
 		std::cout << "Uses CAN-ESD-card" << std::endl;
 	}
+	else if (iTypeCan == 3)
+	{
+		// created below, as soon as the baudrate is known
+		std::cout << "Uses simulated drives" << std::endl;
+	}
+	else if (iTypeCan == 4)
+	{
+		sComposed = sIniDirectory;
+		sComposed += "CanCtrl.ini";
+		m_pCanCtrl = new CanSocket(sComposed.c_str());
+		std::cout << "Uses SocketCAN" << std::endl;
+	}
+
+	// bandwidth of the ElmoRecorder readout
+	int iBaudrateVal = 0;
+	int iBaudrateKBit;
+	double dRecorderShare = 0.3;
+	int iRecorderBlockSize = 16;
+	double dRecorderTimeout = 30.0;
+	m_IniFile.GetKeyInt("CanCtrl", "BaudrateVal", &iBaudrateVal, true);
+	switch(iBaudrateVal)
+	{
+	case 0: iBaudrateKBit = 1000; break;
+	case 2: iBaudrateKBit = 500; break;
+	case 4: iBaudrateKBit = 250; break;
+	case 6: iBaudrateKBit = 125; break;
+	case 9: iBaudrateKBit = 50; break;
+	case 11: iBaudrateKBit = 20; break;
+	case 13: iBaudrateKBit = 10; break;
+	default: iBaudrateKBit = 1000;
+	}
+	m_IniFile.GetKeyDouble("ElmoRecorder", "BandwidthShare", &dRecorderShare, false);
+	m_IniFile.GetKeyInt("ElmoRecorder", "BlockSize", &iRecorderBlockSize, false);
+	m_iRecorderLogFormat = ElmoRecorder::LOG_BINARY;
+	m_IniFile.GetKeyInt("ElmoRecorder", "LogFormat", &m_iRecorderLogFormat, false);
+	m_IniFile.GetKeyDouble("ElmoRecorder", "Timeout", &dRecorderTimeout, false);
+	m_RecorderDownload.setBandwidth(iBaudrateKBit, dRecorderShare, iRecorderBlockSize);
+	m_RecorderDownload.setTimeout(dRecorderTimeout);
+
+	if (iTypeCan == 3)
+	{
+		pSimBus = new CanSimBus(iBaudrateKBit);
+		m_pCanCtrl = pSimBus;
+	}
+
+	// accounting of the bus load and trace of the last frames, wraps the CAN interface
+	int iBusMonitor = 1;
+	int iTraceSize = 4096;
+	m_IniFile.GetKeyInt("CanCtrl", "BusMonitor", &iBusMonitor, false);
+	m_IniFile.GetKeyInt("CanCtrl", "TraceSize", &iTraceSize, false);
+	if ((iBusMonitor != 0) && (m_pCanCtrl != NULL))
+	{
+		m_pBusMonitor = new CanBusMonitor(m_pCanCtrl, iBaudrateKBit, iTraceSize);
+		m_pCanCtrl = m_pBusMonitor;
+	}
+
+	// velocity estimated from the positions sampled at the SYNC msgs, without the delay of the
+	// velocity measurement of the drives
+	int iVelEstimation = 0;
+	m_IniFile.GetKeyInt("CanCtrl", "VelEstimation", &iVelEstimation, false);
+	m_bVelEstimation = (iVelEstimation != 0);
 
 	// CanOpenId's ----- Default values (DESIRE)
 	// Wheel 1
@@ -892,6 +960,35 @@ void CanCtrlPltfCOb3::readConfiguration()
 
 	m_IniFile.GetKeyInt("Config", "GenericBufferLen", &iMaxMessages, true);
 
+	// one simulated Harmonica per configured motor, answering to its identifiers
+	if (pSimBus != NULL)
+	{
+		for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+		{
+			if(m_vpMotor[i] == NULL)
+				continue;
+
+			const CanDriveHarmonica::ParamCanOpenType& ids = ((CanDriveHarmonica*) m_vpMotor[i])->getCanOpenParam();
+			HarmonicaSim* pSim = new HarmonicaSim(ids.iTxPDO1 - 0x180);
+			pSim->setCanOpenParam(ids.iTxPDO1, ids.iTxPDO2, ids.iRxPDO2, ids.iTxSDO, ids.iRxSDO);
+			pSimBus->addNode(pSim);
+		}
+	}
+
+	// conversion factors in the order of m_vpMotor
+	DriveParam* pDriveParam[] = {
+		&DriveParamW1DriveMotor, &DriveParamW1SteerMotor,
+		&DriveParamW2DriveMotor, &DriveParamW2SteerMotor,
+		&DriveParamW3DriveMotor, &DriveParamW3SteerMotor,
+		&DriveParamW4DriveMotor, &DriveParamW4SteerMotor };
+
+	m_DriveConversion.clear();
+	for(unsigned int i = 0; (i < m_vpMotor.size()) && (i < 8); i++)
+	{
+		m_DriveConversion.add(*pDriveParam[i]);
+	}
+	m_viPosMotIncr.assign(m_DriveConversion.size(), 0);
+	m_viVelMotIncrPeriod.assign(m_DriveConversion.size(), 0);
 
 }
 
@@ -963,45 +1060,38 @@ bool CanCtrlPltfCOb3::initPltf()
 	double dhomeVeloRadS = -1.0;
 
 
+	TimeStamp StartTime, PhaseTime, Now;
+	StartTime.SetNow();
+	m_BringUpTiming.dNetStart = 0;
+	m_BringUpTiming.dWatchdogConfig = 0;
+	m_BringUpTiming.dInitStart = 0;
+	m_BringUpTiming.dHoming = 0;
+	m_BringUpTiming.dWatchdogStart = 0;
+	m_BringUpTiming.dTotal = 0;
+	m_BringUpTiming.vdInitStartMotor.assign(m_iNumMotors, 0);
+
 	// Start can open network
 	std::cout << "StartCanOpen" << std::endl;
+	PhaseTime.SetNow();
 	sendNetStartCanOpen();
-	
+	Now.SetNow();
+	m_BringUpTiming.dNetStart = Now - PhaseTime;
 
 	// initialize drives
 	
 	// 1st init watchdogs
+	// 2nd send watchdogs to bed while initializing drives
+	// the configuration is sent to all drives at once
 	std::cout << "Initialization of Watchdogs" << std::endl;
+	PhaseTime.SetNow();
 	for(int i=0; i<m_iNumMotors; i++)
-	{
-		m_vpMotor[i]->startWatchdog(true);
-	}
-/*	m_vpMotor[0]->startWatchdog(true);
-	m_vpMotor[1]->startWatchdog(true);
-	m_vpMotor[2]->startWatchdog(true);
-	m_vpMotor[3]->startWatchdog(true);
-	m_vpMotor[4]->startWatchdog(true);
-	m_vpMotor[5]->startWatchdog(true);
-	m_vpMotor[6]->startWatchdog(true);
-	m_vpMotor[7]->startWatchdog(true);
-*/
-	usleep(10000);
-	
-	// 2nd send watchdogs to bed while initializing drives
+		((CanDriveHarmonica*) m_vpMotor[i])->requestWatchdog(true);
 	for(int i=0; i<m_iNumMotors; i++)
-	{
-		m_vpMotor[i]->startWatchdog(false);
-	}
-/*	m_vpMotor[0]->startWatchdog(false);
-	m_vpMotor[1]->startWatchdog(false);
-	m_vpMotor[2]->startWatchdog(false);
-	m_vpMotor[3]->startWatchdog(false);
-	m_vpMotor[4]->startWatchdog(false);
-	m_vpMotor[5]->startWatchdog(false);
-	m_vpMotor[6]->startWatchdog(false);
-	m_vpMotor[7]->startWatchdog(false);
-*/
-	usleep(100000);
+		((CanDriveHarmonica*) m_vpMotor[i])->requestWatchdog(false);
+	if(!waitForSDOClients(2.0))
+		std::cout << "Initialization of Watchdogs: not all drives confirmed the configuration" << std::endl;
+	Now.SetNow();
+	m_BringUpTiming.dWatchdogConfig = Now - PhaseTime;
 
 	std::cout << "Initialization of Watchdogs done" << std::endl;
 
@@ -1011,16 +1101,17 @@ bool CanCtrlPltfCOb3::initPltf()
 	// o.k. to avoid crashing hardware -> lets check that we have at least the 8 motors, like we have on cob
 	if( (int)m_vpMotor.size() == m_iNumMotors )
 	{
-		// Initialize and start all motors
+		// Initialize and start all motors at the same time
+		std::vector<bool> vbRetMotor;
+		PhaseTime.SetNow();
+		bringUpMotors(true, vbRetMotor);
+		Now.SetNow();
+		m_BringUpTiming.dInitStart = Now - PhaseTime;
+
 		for (int i = 0; i<m_iNumDrives; i++)
 		{
-			// init + start
-			vbRetDriveMotor[i] = vpDriveMotor[i]->init();
-			vbRetSteerMotor[i] = vpSteerMotor[i]->init();
-			usleep(10000);
-			vbRetDriveMotor[i] = vbRetDriveMotor[i] && vpDriveMotor[i]->start();
-			vbRetSteerMotor[i] = vbRetSteerMotor[i] && vpSteerMotor[i]->start();
-			usleep(10000);
+			vbRetDriveMotor[i] = vbRetMotor[2*i];
+			vbRetSteerMotor[i] = vbRetMotor[2*i+1];
 			// output State / Errors
 			if (vbRetDriveMotor[i] && vbRetSteerMotor[i])
 				std::cout << "Initialization of Wheel "<< (i+1) << " OK" << std::endl;
@@ -1044,6 +1135,7 @@ bool CanCtrlPltfCOb3::initPltf()
 			if((vbRetDriveMotor[i] && vbRetSteerMotor[i]) == false)
 				bHomingOk = false;
 		}
+		PhaseTime.SetNow();
 		if(bHomingOk)
 		{
 			// Calc Compensation factor for Velocity:
@@ -1172,14 +1264,31 @@ bool CanCtrlPltfCOb3::initPltf()
 				}
 			}
 		}
+		Now.SetNow();
+		m_BringUpTiming.dHoming = Now - PhaseTime;
 	}
 	// ---------------------- end homing procedure
 
 	// homing done -> wake up watchdogs
+	PhaseTime.SetNow();
 	for(int i=0; i<m_iNumMotors; i++)
-	{
-		m_vpMotor[i]->startWatchdog(true);
-	}
+		((CanDriveHarmonica*) m_vpMotor[i])->requestWatchdog(true);
+	if(!waitForSDOClients(2.0))
+		std::cout << "Start of Watchdogs: not all drives confirmed the configuration" << std::endl;
+	Now.SetNow();
+	m_BringUpTiming.dWatchdogStart = Now - PhaseTime;
+	m_BringUpTiming.dTotal = Now - StartTime;
+
+	std::cout << "Timing of the platform initialization [ms]: CANopen start " << 1000 * m_BringUpTiming.dNetStart
+		<< ", watchdog configuration " << 1000 * m_BringUpTiming.dWatchdogConfig
+		<< ", init and start " << 1000 * m_BringUpTiming.dInitStart
+		<< ", homing " << 1000 * m_BringUpTiming.dHoming
+		<< ", watchdog start " << 1000 * m_BringUpTiming.dWatchdogStart
+		<< ", total " << 1000 * m_BringUpTiming.dTotal << std::endl;
+	std::cout << "Init and start of the motors [ms]:";
+	for(int i=0; i<m_iNumMotors; i++)
+		std::cout << " " << 1000 * m_BringUpTiming.vdInitStartMotor[i];
+	std::cout << std::endl;
 /*	m_vpMotor[0]->startWatchdog(true);
 	m_vpMotor[1]->startWatchdog(true);
 	m_vpMotor[2]->startWatchdog(true);
@@ -1206,13 +1315,15 @@ bool CanCtrlPltfCOb3::initPltf()
 //-----------------------------------------------
 bool CanCtrlPltfCOb3::resetPltf()
 {
-	bool bRetMotor = true;
 	bool bRet = true;
-	
+	std::vector<bool> vbRetMotor;
+
+	// start all motors at the same time
+	bringUpMotors(false, vbRetMotor);
+
 	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
 	{
-		bRetMotor = m_vpMotor[i]->start();
-		if (bRetMotor == true)
+		if (vbRetMotor[i] == true)
 		{
 			m_vpMotor[i]->setGearVelRadS(0);
 		}
@@ -1221,11 +1332,94 @@ bool CanCtrlPltfCOb3::resetPltf()
 			std::cout << "Resetting of Motor " << i << " failed" << std::endl;
 		}
 
-		bRet &= bRetMotor;
+		bRet &= vbRetMotor[i];
 	}
 	return(bRet);
 }
 
+//-----------------------------------------------
+bool CanCtrlPltfCOb3::bringUpMotors(bool bInit, std::vector<bool>& vbRetMotor)
+{
+	bool bRunning;
+	bool bRet = true;
+
+	vbRetMotor.assign(m_vpMotor.size(), false);
+
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+		((CanDriveHarmonica*) m_vpMotor[i])->beginBringUp(bInit);
+
+	// every drive advances on its own replies, the drives time out by themselves
+	do
+	{
+		evalCanBuffer();
+
+		bRunning = false;
+		for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+		{
+			if(((CanDriveHarmonica*) m_vpMotor[i])->updateBringUp() == CanDriveHarmonica::BRINGUP_RUNNING)
+				bRunning = true;
+		}
+
+		if(bRunning)
+			usleep(1000);
+	}
+	while(bRunning);
+
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+	{
+		CanDriveHarmonica* pMotor = (CanDriveHarmonica*) m_vpMotor[i];
+		vbRetMotor[i] = (pMotor->updateBringUp() == CanDriveHarmonica::BRINGUP_DONE);
+		if(i < m_BringUpTiming.vdInitStartMotor.size())
+			m_BringUpTiming.vdInitStartMotor[i] = pMotor->getBringUpDuration();
+		bRet &= vbRetMotor[i];
+	}
+
+	return bRet;
+}
+
+//-----------------------------------------------
+bool CanCtrlPltfCOb3::waitForSDOClients(double dTimeoutSec)
+{
+	TimeStamp StartTime, Now;
+	std::vector<unsigned int> viNumFailed(m_vpMotor.size());
+	bool bIdle;
+	bool bRet = true;
+
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+		viNumFailed[i] = ((CanDriveHarmonica*) m_vpMotor[i])->getSDOClient().getNumFailed();
+
+	StartTime.SetNow();
+	do
+	{
+		bIdle = true;
+		for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+		{
+			CanDriveHarmonica* pMotor = (CanDriveHarmonica*) m_vpMotor[i];
+			pMotor->updateSDOClient();
+			bIdle &= pMotor->getSDOClient().isIdle();
+		}
+		if(bIdle)
+			break;
+
+		usleep(1000);
+		evalCanBuffer();
+
+		Now.SetNow();
+	}
+	while( (Now - StartTime) < dTimeoutSec );
+
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+	{
+		SDOClient& client = ((CanDriveHarmonica*) m_vpMotor[i])->getSDOClient();
+		if(!client.isIdle())
+			client.cancel();
+		if(client.getNumFailed() != viNumFailed[i])
+			bRet = false;
+	}
+
+	return bRet;
+}
+
 //-----------------------------------------------
 bool CanCtrlPltfCOb3::shutdownPltf()
 {
@@ -1396,12 +1590,49 @@ int CanCtrlPltfCOb3::getGearPosVelRadS(int iCanIdent, double* pdAngleGearRad, do
 		if(iCanIdent == m_viMotorID[i])
 		{
 			m_vpMotor[i]->getGearPosVelRadS(pdAngleGearRad, pdVelGearRadS);
+			if(m_bVelEstimation)
+			{
+				double dAccGearRadS2;
+				((CanDriveHarmonica*) m_vpMotor[i])->getGearVelAccEstim(pdVelGearRadS, &dAccGearRadS2);
+			}
 		}
 	}
 	
 	return 0;
 }
 
+//-----------------------------------------------
+int CanCtrlPltfCOb3::getGearPosVelRadS(std::vector<double>& vdAngleGearRad, std::vector<double>& vdVelGearRadS)
+{
+	int iNum = m_DriveConversion.size();
+
+	vdAngleGearRad.resize(iNum);
+	vdVelGearRadS.resize(iNum);
+	if(iNum == 0)
+		return 0;
+
+	for(int i = 0; i < iNum; i++)
+	{
+		if(m_vpMotor[i] != NULL)
+			((CanDriveHarmonica*) m_vpMotor[i])->getPosVelMotIncr(&m_viPosMotIncr[i], &m_viVelMotIncrPeriod[i]);
+	}
+
+	m_DriveConversion.convertPosVel(&m_viPosMotIncr[0], &m_viVelMotIncrPeriod[0],
+		&vdAngleGearRad[0], &vdVelGearRadS[0]);
+
+	if(m_bVelEstimation)
+	{
+		double dAccGearRadS2;
+		for(int i = 0; i < iNum; i++)
+		{
+			if(m_vpMotor[i] != NULL)
+				((CanDriveHarmonica*) m_vpMotor[i])->getGearVelAccEstim(&vdVelGearRadS[i], &dAccGearRadS2);
+		}
+	}
+
+	return 0;
+}
+
 //-----------------------------------------------
 int CanCtrlPltfCOb3::getGearDeltaPosVelRadS(int iCanIdent, double* pdAngleGearRad,
 										   double* pdVelGearRadS)
@@ -1492,8 +1723,8 @@ void CanCtrlPltfCOb3::setMotorTorque(int iCanIdent, double dTorqueNm)
 
 //-----------------------------------------------
 int CanCtrlPltfCOb3::ElmoRecordings(int iFlag, int iParam, std::string sString) {
-	int tempRet = 0;
 	int bRet = 0;
+	std::vector<int> viObjSubIndex;
 	
 	switch(iFlag) {
 		case 0: //Flag = 0 means reset recorder and configure it
@@ -1503,26 +1734,62 @@ int CanCtrlPltfCOb3::ElmoRecordings(int iFlag, int iParam, std::string sString)
 			return 0;
 
 		case 1: //Flag = 1 means start readout process, mustn't be called too early (while Rec is in process..)
-			for(unsigned int i = 0; i < m_vpMotor.size(); i++) {
-				if((tempRet = m_vpMotor[i]->setRecorder(1, iParam, sString)) > bRet) { 
-					bRet = tempRet; //Query Readout of Index to Log Directory
-				}
-			}
+			viObjSubIndex.push_back(iParam);
+			m_Mutex.lock();
+			setElmoRecorderLogFormat();
+			bRet = m_RecorderDownload.start(m_vpMotor, viObjSubIndex, sString); //Query Readout of Index to Log Directory on all drives
+			m_Mutex.unlock();
+			return bRet;
+
+		case 2: //Flag = 2 means readout of all recorded sources
+			viObjSubIndex.push_back(1);
+			viObjSubIndex.push_back(2);
+			viObjSubIndex.push_back(10);
+			viObjSubIndex.push_back(16);
+			m_Mutex.lock();
+			setElmoRecorderLogFormat();
+			bRet = m_RecorderDownload.start(m_vpMotor, viObjSubIndex, sString);
+			m_Mutex.unlock();
 			return bRet;
 		
 		case 99:
+			m_Mutex.lock();
+			m_RecorderDownload.abort();
 			for(unsigned int i = 0; i < m_vpMotor.size(); i++) {
 				m_vpMotor[i]->setRecorder(99, 0); //Stop any ongoing SDO transfer and clear corresponding data.
 			}
+			m_Mutex.unlock();
 			return 0;
 			
 		case 100:
+			m_Mutex.lock();
+			if(m_RecorderDownload.update()) {
+				bRet = 2; //Request next sources and release blocks
+			}
 			for(unsigned int i = 0; i < m_vpMotor.size(); i++) {
 				bRet += m_vpMotor[i]->setRecorder(2, 0); //Request state of transmission
 			}
+			m_Mutex.unlock();
 			return bRet;
 		
 		default:
 			return -1;
 	}
 }
+
+//-----------------------------------------------
+void CanCtrlPltfCOb3::setElmoRecordingsCallback(ElmoRecorderDownload::CallbackType callback)
+{
+	m_RecorderDownload.setCallback(callback);
+}
+
+//-----------------------------------------------
+void CanCtrlPltfCOb3::setElmoRecorderLogFormat()
+{
+	if(m_RecorderDownload.isRunning())
+		return;
+
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++) {
+		m_vpMotor[i]->setRecorder(5, m_iRecorderLogFormat); //Select text logfile and/or binary trace file
+	}
+}
@@ -0,0 +1,258 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_base_drive_chain
+ * Description: Downloads the ElmoRecorder data of all drives at once, within a share of the CAN bandwidth.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+//-----------------------------------------------
+#include <cob_base_drive_chain/ElmoRecorderDownload.h>
+#include <cob_canopen_motor/ElmoRecorder.h>
+#include <algorithm>
+#include <iostream>
+
+//-----------------------------------------------
+
+// Bits of a CAN frame with 8 data bytes and 11 bit identifier, including stuff bits (worst case) and interframe space
+static const double c_dBitsPerFrame = 135.0;
+// Budget which may be saved up while the drives are busy, in blocks per drive
+static const double c_dMaxBudgetBlocks = 1.0;
+
+//-----------------------------------------------
+ElmoRecorderDownload::ElmoRecorderDownload()
+{
+	m_dSegmentsPerSec = 0;
+	m_iBlockSize = 127;
+	m_dBudget = 0;
+	m_dTimeoutSec = 30.0;
+	m_iNextMotor = 0;
+	m_iNumFinished = 0;
+	m_iNumFailed = 0;
+	m_iNumTotal = 0;
+	m_bRunning = false;
+}
+
+//-----------------------------------------------
+void ElmoRecorderDownload::setBandwidth(int iBaudrateKBit, double dShare, int iBlockSize)
+{
+	if(iBaudrateKBit <= 0 || dShare <= 0)
+	{
+		m_dSegmentsPerSec = 0;
+		m_iBlockSize = 127;
+		return;
+	}
+
+	// every segment costs the segment itself and a share of the block confirmation
+	m_iBlockSize = std::max(1, std::min(iBlockSize, 127));
+	double dFramesPerSec = std::min(dShare, 1.0) * iBaudrateKBit * 1000.0 / c_dBitsPerFrame;
+	m_dSegmentsPerSec = dFramesPerSec * m_iBlockSize / (m_iBlockSize + 1);
+}
+
+//-----------------------------------------------
+int ElmoRecorderDownload::start(const std::vector<CanDriveItf*>& vpMotor, const std::vector<int>& viObjSubIndex, std::string sFilePrefix)
+{
+	if(m_bRunning)
+		return 2;
+
+	m_vpMotor = vpMotor;
+	m_sFilePrefix = sFilePrefix;
+	m_vQueue.assign(m_vpMotor.size(), std::deque<int>(viObjSubIndex.begin(), viObjSubIndex.end()));
+	m_viActive.assign(m_vpMotor.size(), -1);
+	m_iNumFinished = 0;
+	m_iNumFailed = 0;
+	m_iNumTotal = m_vpMotor.size() * viObjSubIndex.size();
+	m_iNextMotor = 0;
+	m_dBudget = 0;
+	m_LastUpdate.SetNow();
+	// a busy drive waits for the request of its first source from now on
+	m_vStartTime.assign(m_vpMotor.size(), m_LastUpdate);
+
+	if(m_iNumTotal == 0)
+		return 0;
+
+	int iRet = 0;
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+	{
+		m_vpMotor[i]->setRecorder(3, (m_dSegmentsPerSec > 0) ? m_iBlockSize : 0);
+
+		int iObjSubIndex = m_vQueue[i].front();
+		int iTempRet = m_vpMotor[i]->setRecorder(1, iObjSubIndex, m_sFilePrefix);
+		if(iTempRet == 0)
+		{
+			m_vQueue[i].pop_front();
+			m_viActive[i] = iObjSubIndex;
+			m_vStartTime[i] = m_LastUpdate;
+			// the device sends the first block without waiting for a confirmation
+			m_dBudget -= m_iBlockSize;
+		}
+		iRet = std::max(iRet, iTempRet);
+	}
+
+	if(iRet == 1)
+	{
+		// a recorder hasn't been configured, keep the behaviour of a single readout
+		abort();
+		return 1;
+	}
+
+	m_bRunning = true;
+	return 0;
+}
+
+//-----------------------------------------------
+bool ElmoRecorderDownload::update()
+{
+	if(!m_bRunning)
+		return false;
+
+	TimeStamp Now;
+	Now.SetNow();
+	double dt = Now - m_LastUpdate;
+	m_LastUpdate = Now;
+
+	if(m_dSegmentsPerSec > 0)
+	{
+		m_dBudget += dt * m_dSegmentsPerSec;
+		m_dBudget = std::min(m_dBudget, c_dMaxBudgetBlocks * m_iBlockSize * m_vpMotor.size());
+	}
+
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+	{
+		if(m_viActive[i] >= 0)
+		{
+			if(m_vpMotor[i]->setRecorder(2) == 0)
+			{
+				// drive has ended the upload, aborted and corrupted transfers end as well
+				finishSource(i, m_vpMotor[i]->setRecorder(6));
+				m_vStartTime[i] = Now;
+			}
+			else if(m_dTimeoutSec > 0 && (Now - m_vStartTime[i]) > m_dTimeoutSec)
+			{
+				std::cout << "ElmoRecorderDownload: source " << m_viActive[i] << " of motor " << i << " not uploaded in time, aborted" << std::endl;
+				m_vpMotor[i]->setRecorder(99);
+				finishSource(i, ElmoRecorder::UPLOAD_ABORTED);
+				m_vStartTime[i] = Now;
+			}
+		}
+
+		// request the next source, the timeout also covers a drive which stays busy
+		if(m_viActive[i] < 0 && !m_vQueue[i].empty())
+		{
+			int iObjSubIndex = m_vQueue[i].front();
+			if(m_vpMotor[i]->setRecorder(1, iObjSubIndex, m_sFilePrefix) == 0)
+			{
+				m_vQueue[i].pop_front();
+				m_viActive[i] = iObjSubIndex;
+				m_vStartTime[i] = Now;
+				m_dBudget -= m_iBlockSize;
+			}
+			else if(m_dTimeoutSec > 0 && (Now - m_vStartTime[i]) > m_dTimeoutSec)
+			{
+				std::cout << "ElmoRecorderDownload: motor " << i << " stayed busy, source " << iObjSubIndex << " aborted" << std::endl;
+				// releases the transfer which blocks the drive, the next source is requested in the next cycle
+				m_vpMotor[i]->setRecorder(99);
+				m_vQueue[i].pop_front();
+				m_viActive[i] = iObjSubIndex;
+				finishSource(i, ElmoRecorder::UPLOAD_ABORTED);
+				m_vStartTime[i] = Now;
+			}
+		}
+	}
+
+	// release the waiting blocks round robin, the last one may exceed the budget,
+	// so every transfer makes progress even with a budget smaller than one block
+	if(m_dSegmentsPerSec > 0)
+	{
+		unsigned int iNumMotors = m_vpMotor.size();
+		for(unsigned int k = 0; k < iNumMotors && m_dBudget > 0; k++)
+		{
+			unsigned int i = (m_iNextMotor + k) % iNumMotors;
+			if(m_viActive[i] >= 0 && m_vpMotor[i]->setRecorder(4) == 0)
+				m_dBudget -= m_iBlockSize;
+		}
+		m_iNextMotor = (m_iNextMotor + 1) % iNumMotors;
+	}
+
+	if(m_iNumFinished >= m_iNumTotal)
+		finish();
+
+	return m_bRunning;
+}
+
+//-----------------------------------------------
+void ElmoRecorderDownload::abort()
+{
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+	{
+		if(m_viActive[i] >= 0)
+			m_vpMotor[i]->setRecorder(99);
+		m_vQueue[i].clear();
+		m_viActive[i] = -1;
+	}
+	finish();
+}
+
+//-----------------------------------------------
+void ElmoRecorderDownload::finishSource(unsigned int iMotor, int iResult)
+{
+	int iObjSubIndex = m_viActive[iMotor];
+	m_viActive[iMotor] = -1;
+	m_iNumFinished++;
+	if(iResult != ElmoRecorder::UPLOAD_SUCCEEDED)
+		m_iNumFailed++;
+
+	if(m_Callback)
+		m_Callback(iMotor, iObjSubIndex, iResult, m_iNumFinished, m_iNumTotal);
+}
+
+//-----------------------------------------------
+void ElmoRecorderDownload::finish()
+{
+	for(unsigned int i = 0; i < m_vpMotor.size(); i++)
+		m_vpMotor[i]->setRecorder(3, 0);
+	m_bRunning = false;
+}
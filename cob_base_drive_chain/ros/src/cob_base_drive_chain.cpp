@@ -55,7 +55,7 @@
 //#### includes ####
 
 // standard includes
-//--
+#include <stdio.h>
 
 // ROS includes
 #include <ros/ros.h>
@@ -153,6 +153,12 @@ class NodeClass
 		*/
 		ros::ServiceServer srvServer_ElmoRecorderReadout;
 
+		/**
+		* Service requests cob_srvs::Trigger and writes the trace of the last CAN frames in the log format of candump
+		* to the file given by the parameter "CanTraceFile".
+		*/
+		ros::ServiceServer srvServer_DumpCanTrace;
+
 		// global variables
 		// generate can-node handle
 #ifdef __SIM__
@@ -189,6 +195,8 @@ class NodeClass
 		std::string sIniDirectory;
 		bool m_bPubEffort;
 		bool m_bReadoutElmo;
+		std::string m_sCanTraceFile;
+		double m_dBusLoadWarn;
 
 		// Constructor
 		NodeClass()
@@ -208,6 +216,9 @@ class NodeClass
 
 			n.param<bool>("PublishEffort", m_bPubEffort, false);
 			if(m_bPubEffort) ROS_INFO("You have choosen to publish effort of motors, that charges capacity of CAN");
+
+			n.param<std::string>("CanTraceFile", m_sCanTraceFile, "/tmp/base_drive_chain_can.log");
+			n.param<double>("BusLoadWarn", m_dBusLoadWarn, 0.8);
 			
 			
 			IniFile iniFile;
@@ -237,6 +248,7 @@ class NodeClass
 			m_gazeboVel.resize(m_iNumMotors);
 #else
 			m_CanCtrlPltf = new CanCtrlPltfCOb3(sIniDirectory);
+			m_CanCtrlPltf->setElmoRecordingsCallback(boost::bind(&NodeClass::callback_ElmoRecorderUploaded, this, _1, _2, _3, _4, _5));
 #endif
 			
 			// implementation of topics
@@ -257,6 +269,7 @@ class NodeClass
 
 			srvServer_Recover = n.advertiseService("recover", &NodeClass::srvCallback_Recover, this);
 			srvServer_Shutdown = n.advertiseService("shutdown", &NodeClass::srvCallback_Shutdown, this);
+			srvServer_DumpCanTrace = n.advertiseService("dump_can_trace", &NodeClass::srvCallback_DumpCanTrace, this);
 			
 			// initialization of variables
 #ifdef __SIM__
@@ -479,7 +492,10 @@ class NodeClass
 				res.success = true;
 #else
 				m_CanCtrlPltf->evalCanBuffer();
-				res.success = m_CanCtrlPltf->ElmoRecordings(1, req.subindex, req.fileprefix);
+				if(req.subindex == 0)
+					res.success = m_CanCtrlPltf->ElmoRecordings(2, 0, req.fileprefix);
+				else
+					res.success = m_CanCtrlPltf->ElmoRecordings(1, req.subindex, req.fileprefix);
 #endif
 				if(res.success == 0) {
 					res.message = "Successfully requested reading out of Recorded data";
@@ -491,6 +507,29 @@ class NodeClass
 
 			return true;
 		}
+
+		// called by the platform after every finished or failed upload of a recorded source
+		void callback_ElmoRecorderUploaded(int iMotor, int iObjSubIndex, int iResult, int iNumFinished, int iNumTotal)
+		{
+			switch(iResult)
+			{
+			case ElmoRecorder::UPLOAD_SUCCEEDED:
+				ROS_INFO("ElmoRecorder readout: source %d of motor %d uploaded (%d of %d)", iObjSubIndex, iMotor, iNumFinished, iNumTotal);
+				break;
+			case ElmoRecorder::UPLOAD_NO_DATA:
+				ROS_WARN("ElmoRecorder readout: motor %d has no finished record of source %d (%d of %d)", iMotor, iObjSubIndex, iNumFinished, iNumTotal);
+				break;
+			case ElmoRecorder::UPLOAD_CRC_ERROR:
+				ROS_ERROR("ElmoRecorder readout: source %d of motor %d dropped, CRC error (%d of %d)", iObjSubIndex, iMotor, iNumFinished, iNumTotal);
+				break;
+			case ElmoRecorder::UPLOAD_WRITE_ERROR:
+				ROS_ERROR("ElmoRecorder readout: source %d of motor %d uploaded, but the log file couldn't be written (%d of %d)", iObjSubIndex, iMotor, iNumFinished, iNumTotal);
+				break;
+			default:
+				ROS_ERROR("ElmoRecorder readout: upload of source %d of motor %d aborted (%d of %d)", iObjSubIndex, iMotor, iNumFinished, iNumTotal);
+				break;
+			}
+		}
 		
 		
 		
@@ -541,6 +580,85 @@ class NodeClass
 			return true;
 		}
 
+		// write the trace of the CAN frames
+		bool srvCallback_DumpCanTrace(cob_srvs::Trigger::Request &req,
+									 cob_srvs::Trigger::Response &res )
+		{
+#ifdef __SIM__
+			res.success.data = true;
+#else
+			CanBusMonitor* pBusMonitor = m_CanCtrlPltf->getBusMonitor();
+			if(pBusMonitor == NULL)
+			{
+				res.success.data = false;
+				res.error_message.data = "CAN bus monitor disabled in CanCtrl.ini";
+				return true;
+			}
+
+			int iNumFrames = pBusMonitor->dumpTrace(m_sCanTraceFile);
+			res.success.data = (iNumFrames >= 0);
+			if(res.success.data)
+				ROS_INFO("%d CAN frames written to %s", iNumFrames, m_sCanTraceFile.c_str());
+			else
+				res.error_message.data = "can't open " + m_sCanTraceFile;
+#endif
+			return true;
+		}
+
+		// add the bus load and the COB-IDs using most of it to the diagnostics
+		void addBusDiagnostics(diagnostic_msgs::DiagnosticStatus& diagnostics)
+		{
+#ifndef __SIM__
+			CanBusMonitor* pBusMonitor = m_CanCtrlPltf->getBusMonitor();
+			if(pBusMonitor == NULL)
+				return;
+
+			double dBusLoad = pBusMonitor->getBusLoad();
+			unsigned int iNumTx, iNumRx, iNumTxFailed;
+			pBusMonitor->getNumFrames(&iNumTx, &iNumRx, &iNumTxFailed);
+			std::vector<CanBusMonitor::IDStatistics> vStatistics;
+			pBusMonitor->getStatistics(vStatistics);
+
+			unsigned long long iNumBitsTotal = 0;
+			for(unsigned int i = 0; i < vStatistics.size(); i++)
+				iNumBitsTotal += vStatistics[i].iNumBits;
+
+			char cBuf[64];
+			diagnostic_msgs::KeyValue kv;
+
+			kv.key = "CAN bus load";
+			sprintf(cBuf, "%.1f %%", 100 * dBusLoad);
+			kv.value = cBuf;
+			diagnostics.values.push_back(kv);
+
+			kv.key = "CAN frames per second";
+			sprintf(cBuf, "%.0f", pBusMonitor->getFrameRate());
+			kv.value = cBuf;
+			diagnostics.values.push_back(kv);
+
+			kv.key = "CAN frames sent / received / failed";
+			sprintf(cBuf, "%u / %u / %u", iNumTx, iNumRx, iNumTxFailed);
+			kv.value = cBuf;
+			diagnostics.values.push_back(kv);
+
+			for(unsigned int i = 0; (i < vStatistics.size()) && (i < 5); i++)
+			{
+				sprintf(cBuf, "CAN COB-ID 0x%03X", vStatistics[i].iID);
+				kv.key = cBuf;
+				sprintf(cBuf, "%.1f %% of bits, %u tx, %u rx", 100.0 * vStatistics[i].iNumBits / iNumBitsTotal,
+					vStatistics[i].iNumTx, vStatistics[i].iNumRx);
+				kv.value = cBuf;
+				diagnostics.values.push_back(kv);
+			}
+
+			if((dBusLoad > m_dBusLoadWarn) && (diagnostics.level == 0))
+			{
+				diagnostics.level = 1;
+				diagnostics.message = "CAN bus load high";
+			}
+#endif
+		}
+
 		//publish JointStates cyclical instead of service callback
 		bool publish_JointStates()
 		{
@@ -610,6 +728,8 @@ class NodeClass
 				ROS_DEBUG("Read CAN-Buffer");
 				m_CanCtrlPltf->evalCanBuffer();
 				ROS_DEBUG("Successfully read CAN-Buffer");
+				// convert the PDOs of all motors at once
+				m_CanCtrlPltf->getGearPosVelRadS(vdAngGearRad, vdVelGearRad);
 #endif
 				j = 0;
 				k = 0;
@@ -618,8 +738,6 @@ class NodeClass
 #ifdef __SIM__
 					vdAngGearRad[i] = m_gazeboPos[i];
 					vdVelGearRad[i] = m_gazeboVel[i];
-#else
-					m_CanCtrlPltf->getGearPosVelRadS(i,  &vdAngGearRad[i], &vdVelGearRad[i]);
 #endif
 					
 					//Get motor torque
@@ -708,6 +826,8 @@ class NodeClass
 				}
 			}
 
+			addBusDiagnostics(diagnostics);
+
 			// publish diagnostic message
 			topicPub_Diagnostic.publish(diagnostics);
 			ROS_DEBUG("published new drive-chain configuration (JointState message)");
@@ -70,6 +70,9 @@ using namespace std;
 #include <geometry_msgs/Twist.h>
 #include <ros/console.h>
 #include <std_msgs/String.h>
+
+#include <velocity_window.h>
+#include <jerk_limiter.h>
 /****************************************************************
  * the ros navigation doesn't run very smoothly because acceleration is too high
  * --> cob has strong base motors and therefore reacts with shaking behavior 
@@ -94,6 +97,13 @@ private:
   double loop_rate_;
   // delay between received commands that is allowed. After that, fill buffer with zeros.
   double max_delay_between_commands_;
+  // smoothing mode (to be loaded from parameter server, otherwise set to default value "mean")
+  // "mean": mean value of past messages plus acceleration limit, "jerk_limited": S-curve per axis
+  enum SmoothingMode { MEAN, JERK_LIMITED };
+  SmoothingMode smoothing_mode_;
+  // jerk-limited trajectory generators for x, y and theta and the time of their last step
+  JerkLimiter jerk_limiter_[3];
+  ros::Time last_jerk_step_;
   //geometry message filled with zero values
   geometry_msgs::Twist zero_values_;
   // subscribed geometry message
@@ -117,10 +127,10 @@ public:
   //create node handle
   ros::NodeHandle nh_, pnh_;
 
-  //circular buffers for velocity, output and time
-  boost::circular_buffer<geometry_msgs::Twist> cb_;
+  //time window of past velocity commands (replaces the circular buffers for velocity and time)
+  VelocityWindow window_;
+  //circular buffer for output
   boost::circular_buffer<geometry_msgs::Twist> cb_out_;
-  boost::circular_buffer<ros::Time> cb_time_;
 
   // declaration of ros subscribers
   ros::Subscriber geometry_msgs_sub_;
@@ -132,12 +142,16 @@ public:
   void geometryCallback(const geometry_msgs::Twist::ConstPtr &cmd_vel);
   //calculation function called periodically in main
   void calculationStep();
-  //function that updates the circular buffer after receiving a new geometry message
+  //function that updates the time window after receiving a new geometry message
   void reviseCircBuff(ros::Time now, geometry_msgs::Twist cmd_vel);
+  //function that advances the jerk-limited trajectory generators towards cmd_vel
+  geometry_msgs::Twist jerkLimitedOutput(ros::Time now, geometry_msgs::Twist cmd_vel);
+  //boolean function that returns true if the jerk-limited output has reached cmd_vel
+  bool jerkLimitedSettled(geometry_msgs::Twist cmd_vel);
   //function to limit the acceleration under the given threshhold thresh
   void limitAcceleration(ros::Time now, geometry_msgs::Twist& cmd_vel);
 
-  //boolean function that returns true if all messages stored in the circular buffer are older than store_delay, false otherwise
+  //boolean function that returns true if all messages stored in the time window are older than store_delay, false otherwise
   bool circBuffOutOfDate(ros::Time now);
   // function to compare two geometry messages
   bool IsEqual(geometry_msgs::Twist msg1, geometry_msgs::Twist msg2);
@@ -0,0 +1,95 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_base_velocity_smoother
+ * Description: Online jerk-limited velocity profile for one axis.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef JERK_LIMITER_H
+#define JERK_LIMITER_H
+
+/****************************************************************
+ * JerkLimiter is an online trajectory generator for the velocity of one
+ * axis. Each step moves the velocity towards the (possibly changing) target
+ * with |acceleration| <= max_acc and |jerk| <= max_jerk, i.e. along an
+ * S-curve, without averaging over past commands.
+ *
+ * Every step picks the largest acceleration (within the jerk limit) from
+ * which the acceleration can still be ramped down to zero exactly when the
+ * target is reached; ramping down from a changes the velocity by
+ * a^2 / (2 * max_jerk). This gives the time-optimal S-curve without
+ * overshoot. One step costs a constant number of operations.
+ ****************************************************************/
+class JerkLimiter
+{
+public:
+  JerkLimiter(double max_acc = 1.0, double max_jerk = 5.0);
+
+  // returns false and keeps the previous limits unless both limits are > 0
+  bool setLimits(double max_acc, double max_jerk);
+
+  // sets the state, e.g. when the smoother is (re)started
+  void reset(double velocity = 0.0, double acceleration = 0.0);
+
+  // advances the profile by dt seconds towards target and returns the new velocity
+  double step(double target, double dt);
+
+  // true if the velocity has reached target and the acceleration is zero
+  bool settled(double target) const;
+
+  double velocity() const { return vel_; }
+  double acceleration() const { return acc_; }
+  double maxAcceleration() const { return max_acc_; }
+  double maxJerk() const { return max_jerk_; }
+
+private:
+  double max_acc_;
+  double max_jerk_;
+  double vel_;
+  double acc_;
+};
+
+#endif
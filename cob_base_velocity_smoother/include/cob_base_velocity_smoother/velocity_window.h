@@ -0,0 +1,129 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_base_velocity_smoother
+ * Description: Time-windowed running mean of velocity commands.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef VELOCITY_WINDOW_H
+#define VELOCITY_WINDOW_H
+
+#include <deque>
+
+/****************************************************************
+ * VelocityWindow replaces the circular buffers of past commands.
+ * It stores the commands run-length encoded (a burst of equal commands
+ * received at the same time is one entry with a count) and keeps for each
+ * axis (x, y, theta) the running sum and monotonic min/max queues.
+ * Pushing a command, evicting out-dated commands and evaluating the
+ * trimmed mean are therefore O(1) (amortized) instead of O(capacity).
+ *
+ * The trimmed mean is the one the smoother always used: the mean of all
+ * stored commands without the single command farthest from the plain mean.
+ * The farthest command is always the minimum or the maximum of the window;
+ * on a tie the newer one is dropped, as the old linear scan did.
+ ****************************************************************/
+class VelocityWindow
+{
+public:
+  enum Axis { X = 0, Y = 1, THETA = 2, NUM_AXES = 3 };
+
+  // capacity: maximal number of stored commands (counting repetitions)
+  // store_delay: commands older than store_delay seconds are evicted
+  VelocityWindow(unsigned long capacity = 12, double store_delay = 4.0);
+
+  void configure(unsigned long capacity, double store_delay);
+
+  // drops everything and fills the window up to its capacity with zero commands stamped now
+  void fillWithZeros(double now);
+
+  // adds count copies of a command stamped now, the oldest commands are dropped when full
+  void push(double now, double x, double y, double theta, unsigned long count = 1);
+
+  // drops all commands which are at least store_delay old
+  void evictOutdated(double now);
+
+  // true if all commands are at least store_delay old (or the window is empty)
+  bool outOfDate(double now) const;
+
+  // trimmed mean of one axis, see above
+  double mean(Axis axis) const;
+
+  // time stamp of the index-th newest command (0 = newest), counting repetitions
+  double timeAt(unsigned long index) const;
+
+  unsigned long size() const { return size_; }
+  unsigned long capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ >= capacity_; }
+
+private:
+  struct Entry
+  {
+    unsigned long seq;
+    double time;
+    double value[NUM_AXES];
+    unsigned long count;
+  };
+
+  const Entry& entry(unsigned long seq) const { return entries_[seq - entries_.front().seq]; }
+
+  void popOldest();
+  void shrinkOldest(unsigned long count);
+  void clear();
+
+  std::deque<Entry> entries_; // back = newest
+  std::deque<unsigned long> min_[NUM_AXES]; // seqs, values increasing from front to back
+  std::deque<unsigned long> max_[NUM_AXES]; // seqs, values decreasing from front to back
+  double sum_[NUM_AXES];
+
+  unsigned long size_;
+  unsigned long next_seq_;
+  unsigned long capacity_;
+  double store_delay_;
+};
+
+#endif
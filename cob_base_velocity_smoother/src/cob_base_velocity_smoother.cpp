@@ -125,6 +125,39 @@ cob_base_velocity_smoother::cob_base_velocity_smoother()
   }
   pnh_.param("loop_rate", loop_rate_, 30.0);
 
+  std::string smoothing_mode;
+  if( !pnh_.hasParam("smoothing_mode") )
+  {
+    ROS_WARN("No parameter smoothing_mode on parameter server. Using default [mean]");
+  }
+  pnh_.param<std::string>("smoothing_mode", smoothing_mode, "mean");
+  if( smoothing_mode == "jerk_limited" )
+    smoothing_mode_ = JERK_LIMITED;
+  else
+  {
+    if( smoothing_mode != "mean" )
+      ROS_WARN("Unknown smoothing_mode %s. Using [mean]", smoothing_mode.c_str());
+    smoothing_mode_ = MEAN;
+  }
+
+  // limits for smoothing_mode jerk_limited
+  double max_acc_lin, max_acc_rot, max_jerk_lin, max_jerk_rot;
+  pnh_.param("max_acceleration_linear", max_acc_lin, 1.0);
+  pnh_.param("max_acceleration_angular", max_acc_rot, 1.5);
+  pnh_.param("max_jerk_linear", max_jerk_lin, 5.0);
+  pnh_.param("max_jerk_angular", max_jerk_rot, 7.5);
+  if( !jerk_limiter_[VelocityWindow::X].setLimits(max_acc_lin, max_jerk_lin) ||
+      !jerk_limiter_[VelocityWindow::Y].setLimits(max_acc_lin, max_jerk_lin) )
+  {
+    ROS_WARN("max_acceleration_linear %f and max_jerk_linear %f must be > 0. Using [%f and %f]", max_acc_lin, max_jerk_lin,
+             jerk_limiter_[VelocityWindow::X].maxAcceleration(), jerk_limiter_[VelocityWindow::X].maxJerk());
+  }
+  if( !jerk_limiter_[VelocityWindow::THETA].setLimits(max_acc_rot, max_jerk_rot) )
+  {
+    ROS_WARN("max_acceleration_angular %f and max_jerk_angular %f must be > 0. Using [%f and %f]", max_acc_rot, max_jerk_rot,
+             jerk_limiter_[VelocityWindow::THETA].maxAcceleration(), jerk_limiter_[VelocityWindow::THETA].maxJerk());
+  }
+
   double min_input_rate;
   if( !pnh_.hasParam("min_input_rate") )
   {
@@ -148,21 +181,13 @@ cob_base_velocity_smoother::cob_base_velocity_smoother()
   zero_values_.angular.y=0;
   zero_values_.angular.z=0;
 
-  // initialize circular buffers
-  cb_.set_capacity(buffer_capacity_);
+  // initialize time window and output buffer
+  window_.configure(buffer_capacity_, store_delay_);
   cb_out_.set_capacity(buffer_capacity_);
-  cb_time_.set_capacity(buffer_capacity_);
-
-  // set actual ros::Time
-  ros::Time now = ros::Time::now();
-
-  // fill circular buffer with zero values
-  while(cb_.full() == false){
 
-    cb_.push_front(zero_values_);
-    cb_time_.push_front(now);
-
-  }	
+  // fill time window with zero values
+  window_.fillWithZeros(ros::Time::now().toSec());
+  last_jerk_step_ = ros::Time::now();
 };
 
 // destructor
@@ -200,6 +225,12 @@ void cob_base_velocity_smoother::calculationStep(){
   // Do not publish! Otherwise, the output of other nodes will be overwritten!
   else if ( fabs((last - now).toSec()) > max_delay_between_commands_)
     result = this->setOutput(now, geometry_msgs::Twist());
+  // the jerk-limited output keeps moving towards the last command until it has reached it
+  else if (smoothing_mode_ == JERK_LIMITED && !jerkLimitedSettled(sub_msg_))
+  {
+    result = this->setOutput(now, sub_msg_);
+    pub_.publish(result);
+  }
   // if last message was a zero msg, fill the buffer with zeros and publish again
   else if (IsZeroMsg(sub_msg_))
   {
@@ -214,6 +245,9 @@ void cob_base_velocity_smoother::calculationStep(){
 // returns the resulting geomtry message to be published to the base_controller
 geometry_msgs::Twist cob_base_velocity_smoother::setOutput(ros::Time now, geometry_msgs::Twist cmd_vel)
 {
+  if (smoothing_mode_ == JERK_LIMITED)
+    return jerkLimitedOutput(now, cmd_vel);
+
   geometry_msgs::Twist result = zero_values_;
 
   // update the circular buffers
@@ -234,91 +268,73 @@ geometry_msgs::Twist cob_base_velocity_smoother::setOutput(ros::Time now, geomet
 
 }
 
-// function that updates the circular buffer after receiving a new geometry message
-void cob_base_velocity_smoother::reviseCircBuff(ros::Time now, geometry_msgs::Twist cmd_vel)
+// function that advances the jerk-limited trajectory generators towards cmd_vel
+// no averaging: the output follows the command as fast as acceleration and jerk limits allow
+geometry_msgs::Twist cob_base_velocity_smoother::jerkLimitedOutput(ros::Time now, geometry_msgs::Twist cmd_vel)
 {
-  if(this->circBuffOutOfDate(now) == true){
-    // the circular buffer is out of date, so clear and refill with zero messages before adding the new command
+  geometry_msgs::Twist result = zero_values_;
 
-    // clear buffers
-    cb_.clear();
-    cb_time_.clear();
+  // the generators are stepped every cycle while moving, longer gaps only occur when settled
+  double dt = (now - last_jerk_step_).toSec();
+  if (dt > 2.0 / loop_rate_)
+    dt = 2.0 / loop_rate_;
+  last_jerk_step_ = now;
 
-    // fill circular buffer with zero_values_ and time buffer with actual time-stamp
-    while(cb_.full() == false){
+  result.linear.x = jerk_limiter_[VelocityWindow::X].step(cmd_vel.linear.x, dt);
+  result.linear.y = jerk_limiter_[VelocityWindow::Y].step(cmd_vel.linear.y, dt);
+  result.angular.z = jerk_limiter_[VelocityWindow::THETA].step(cmd_vel.angular.z, dt);
 
-      cb_.push_front(zero_values_);
-      cb_time_.push_front(now);
+  cb_out_.push_front(result);
 
-    }
+  return result;
+}
 
-    // add new command velocity message to circular buffer
-    cb_.push_front(cmd_vel);
-    // add new timestamp for subscribed command velocity message
-    cb_time_.push_front(now);
+// returns true if the jerk-limited output has reached cmd_vel
+bool cob_base_velocity_smoother::jerkLimitedSettled(geometry_msgs::Twist cmd_vel)
+{
+  return jerk_limiter_[VelocityWindow::X].settled(cmd_vel.linear.x)
+    && jerk_limiter_[VelocityWindow::Y].settled(cmd_vel.linear.y)
+    && jerk_limiter_[VelocityWindow::THETA].settled(cmd_vel.angular.z);
+}
 
-  }
-  else{
-    // only some elements of the circular buffer are out of date, so only delete those
-    double delay=(now.toSec() - cb_time_.back().toSec());
+// function that updates the time window after receiving a new geometry message
+// all operations on the window are O(1), bursts of zero messages are stored as one entry
+void cob_base_velocity_smoother::reviseCircBuff(ros::Time now, geometry_msgs::Twist cmd_vel)
+{
+  double t = now.toSec();
 
-    while( delay >= store_delay_ ){
-      // remove out-dated messages
-      cb_.pop_back();
-      cb_time_.pop_back();
+  if(this->circBuffOutOfDate(now) == true){
+    // the time window is out of date, so clear and refill with zero messages before adding the new command
+    window_.fillWithZeros(t);
 
-      delay=(now.toSec() - cb_time_.back().toSec());
-    }
-    // if the circular buffer is empty now, refill with zero values
-    if(cb_.empty() == true){
-      while(cb_.full() == false){
+    // add new command velocity message
+    window_.push(t, cmd_vel.linear.x, cmd_vel.linear.y, cmd_vel.angular.z);
 
-        cb_.push_front(zero_values_);
-        cb_time_.push_front(now);
+  }
+  else{
+    // only some messages of the window are out of date, so only delete those
+    window_.evictOutdated(t);
 
-      }
+    // if the window is empty now, refill with zero values
+    if(window_.empty() == true){
+      window_.fillWithZeros(t);
     }
     if(this->IsZeroMsg(cmd_vel)){
       // here we subscribed  a zero message, so we want to stop the robot
-      long unsigned int size = floor( cb_.size() / 3 );
-
-      // to stop the robot faster, fill the circular buffer with more than one, in fact floor (cb_.size() / 3 ), zero messages
-      for(long unsigned int i=0; i< size; i++){
-
-        // add new command velocity message to circular buffer
-        cb_.push_front(cmd_vel);
-        // add new timestamp for subscribed command velocity message
-        cb_time_.push_front(now);
-      }
-
+      // to stop the robot faster, add more than one, in fact floor (size / 3 ), zero messages at once
+      window_.push(t, 0.0, 0.0, 0.0, window_.size() / 3);
     }
     else{
-      // add new command velocity message to circular buffer
-      cb_.push_front(cmd_vel);
-      // add new timestamp for subscribed command velocity message
-      cb_time_.push_front(now);
+      // add new command velocity message
+      window_.push(t, cmd_vel.linear.x, cmd_vel.linear.y, cmd_vel.angular.z);
     }
   }
 };
 
-// returns true if all messages in cb are out of date in consideration of store_delay
+// returns true if all messages in the time window are out of date in consideration of store_delay
 bool cob_base_velocity_smoother::circBuffOutOfDate(ros::Time now)
 {
-  bool result=true;
-
-  long unsigned int count=0;
-
-  while( (count < cb_.size()) && (result == true) ){
-		
-    double delay=(now.toSec() - cb_time_[count].toSec());
-    if(delay < store_delay_){
-      result = false;
-    }
-    count++;
-  }
-
-  return result;
-
+  return window_.outOfDate(now.toSec());
 };
 
 // returns true if the input msg cmd_vel equals zero_values_, false otherwise
@@ -342,130 +358,22 @@ int cob_base_velocity_smoother::signum(double var)
   }
 };
 
-// functions to calculate the mean values for linear/x
+// functions to calculate the mean values (without the value farthest from the mean) for linear/x
 double cob_base_velocity_smoother::meanValueX()
 {
-  double result = 0;
-  long unsigned int size = cb_.size();
-
-  // calculate sum
-  for(long unsigned int i=0; i<size; i++){
-
-    result += cb_[i].linear.x;
-
-  }
-  result /= size;
-	
-  if(size > 1){
-
-    double help_result = 0;
-    double max = cb_[0].linear.x;
-    long unsigned int max_ind = 0;
-    for(long unsigned int i=0; i<size; i++){
-
-      if(abs(result-cb_[i].linear.x) > abs(result-max)){
-        max = cb_[i].linear.x;
-        max_ind = i;
-      }
-
-    }
-
-    // calculate sum
-    for(long unsigned int i=0; i<size; i++){
-		
-      if(i != max_ind){
-        help_result += cb_[i].linear.x;
-      }
-    }
-    result = help_result / (size - 1);
-  }
-
-  return result;
-	
+  return window_.mean(VelocityWindow::X);
 };
 
-// functions to calculate the mean values for linear/y
+// functions to calculate the mean values (without the value farthest from the mean) for linear/y
 double cob_base_velocity_smoother::meanValueY()
 {
-  double result = 0;
-  long unsigned int size = cb_.size();
-
-  // calculate sum
-  for(long unsigned int i=0; i<size; i++){
-
-    result += cb_[i].linear.y;
-
-  }
-  result /= size;
-
-  if(size > 1){
-
-    double help_result = 0;
-    double max = cb_[0].linear.y;
-    long unsigned int max_ind = 0;
-    for(long unsigned int i=0; i<size; i++){
-
-      if(abs(result-cb_[i].linear.y) > abs(result-max)){
-        max = cb_[i].linear.y;
-        max_ind = i;
-      }
-
-    }
-
-    // calculate sum
-    for(long unsigned int i=0; i<size; i++){
-		
-      if(i != max_ind){
-        help_result += cb_[i].linear.y;
-      }
-    }
-    result = help_result / (size - 1);
-  }
-
-  return result;
-	
+  return window_.mean(VelocityWindow::Y);
 };
 
-// functions to calculate the mean values for angular/z
+// functions to calculate the mean values (without the value farthest from the mean) for angular/z
 double cob_base_velocity_smoother::meanValueZ()
 {
-  double result = 0;
-  long unsigned int size = cb_.size();
-
-  // calculate sum
-  for(long unsigned int i=0; i<size; i++){
-
-  result += cb_[i].angular.z;
-
-  }
-  result /= size;
-	
-  if(size > 1){
-		
-    double help_result = 0;
-    double max = cb_[0].angular.z;
-    long unsigned int max_ind = 0;
-    for(long unsigned int i=0; i<size; i++){
-
-      if(abs(result-cb_[i].angular.z) > abs(result-max)){
-        max = cb_[i].angular.z;
-        max_ind = i;
-      }
-
-    }
-
-    // calculate sum
-    for(long unsigned int i=0; i<size; i++){
-
-      if(i != max_ind){
-        help_result += cb_[i].angular.z;
-      }
-    }
-    result = help_result / (size - 1);
-  }
-
-  return result;
-	
+  return window_.mean(VelocityWindow::THETA);
 };
 
 // function to make the loop rate availabe outside the class
@@ -495,8 +403,8 @@ void cob_base_velocity_smoother::limitAcceleration(ros::Time now, geometry_msgs:
 	
   double deltaTime = 0;	
 
-  if(cb_time_.size() > 1){
-    deltaTime = now.toSec() - cb_time_[2].toSec();
+  if(window_.size() > 1){
+    deltaTime = now.toSec() - window_.timeAt(2);
   }
 
   if( cb_out_.size() > 0){
@@ -0,0 +1,133 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_base_velocity_smoother
+ * Description: Online jerk-limited velocity profile for one axis.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <jerk_limiter.h>
+
+#include <cmath>
+
+JerkLimiter::JerkLimiter(double max_acc, double max_jerk) :
+  max_acc_(1.0), max_jerk_(5.0)
+{
+  setLimits(max_acc, max_jerk);
+  reset();
+}
+
+bool JerkLimiter::setLimits(double max_acc, double max_jerk)
+{
+  // step() divides by max_jerk, the negation also rejects NaN
+  if (!(max_acc > 0.0) || !(max_jerk > 0.0))
+    return false;
+  max_acc_ = max_acc;
+  max_jerk_ = max_jerk;
+  return true;
+}
+
+void JerkLimiter::reset(double velocity, double acceleration)
+{
+  vel_ = velocity;
+  acc_ = acceleration;
+}
+
+double JerkLimiter::step(double target, double dt)
+{
+  if (dt <= 0.0)
+    return vel_;
+
+  double dv = target - vel_;
+  double max_dacc = max_jerk_ * dt;
+
+  // close enough to land within this cycle with an acceleration reachable under the jerk limit
+  if (std::fabs(dv) <= 0.5 * max_dacc * dt && std::fabs(acc_) <= max_dacc)
+  {
+    vel_ = target;
+    acc_ = 0.0;
+    return vel_;
+  }
+
+  // mirror the problem so that the target lies ahead, taking into account
+  // the velocity change needed to ramp the current acceleration down to zero
+  double sign = (dv - acc_ * std::fabs(acc_) / (2.0 * max_jerk_) >= 0.0) ? 1.0 : -1.0;
+  double w = sign * dv;
+  double b = sign * acc_;
+
+  double x;
+  if (b < 0.0)
+  {
+    // accelerating away from the target, turn around as fast as possible
+    x = b + max_dacc;
+  }
+  else
+  {
+    // largest acceleration x at the end of this step from which braking with max_jerk
+    // ends exactly at the target: w = (b + x) / 2 * dt + x^2 / (2 * max_jerk)
+    // (the discriminant is >= (b / max_jerk - dt / 2)^2 because w >= b^2 / (2 * max_jerk))
+    double disc = 0.25 * dt * dt + 2.0 * (w - 0.5 * b * dt) / max_jerk_;
+    x = max_jerk_ * (std::sqrt(disc) - 0.5 * dt);
+  }
+
+  if (x > b + max_dacc)
+    x = b + max_dacc;
+  else if (x < b - max_dacc)
+    x = b - max_dacc;
+  if (x > max_acc_)
+    x = max_acc_;
+  else if (x < -max_acc_)
+    x = -max_acc_;
+
+  double acc_next = sign * x;
+  vel_ += 0.5 * (acc_ + acc_next) * dt;
+  acc_ = acc_next;
+  return vel_;
+}
+
+bool JerkLimiter::settled(double target) const
+{
+  return vel_ == target && acc_ == 0.0;
+}
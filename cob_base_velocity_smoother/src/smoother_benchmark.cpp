@@ -0,0 +1,204 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_base_velocity_smoother
+ * Description: Step response benchmark of the smoothing modes.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+/****************************************************************
+ * Offline comparison of the two smoothing modes of cob_base_velocity_smoother
+ * for a step of the commanded velocity, without ROS.
+ * The "mean" mode is reproduced with the same VelocityWindow update and
+ * per-cycle acceleration limit as the node; commands arrive with input_rate
+ * and the smoother runs with loop_rate.
+ *
+ * usage: smoother_benchmark [loop_rate] [input_rate] [step] [circular_buffer_capacity]
+ *                           [thresh_max_acc] [max_acceleration] [max_jerk]
+ *
+ * Prints, for both modes, the time until the output first reaches 90% of
+ * the step, the time until it stays within 2% of the step, the largest
+ * acceleration and jerk of the output and the cost per cycle.
+ ****************************************************************/
+
+#include <velocity_window.h>
+#include <jerk_limiter.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+
+struct Response
+{
+  double t90;
+  double t_settle;
+  double max_acc;
+  double max_jerk;
+  double ns_per_cycle;
+};
+
+static double wallTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static void evaluate(const double* out, int cycles, double dt, double step, Response& r)
+{
+  r.t90 = -1.0;
+  r.t_settle = -1.0;
+  r.max_acc = 0.0;
+  r.max_jerk = 0.0;
+
+  // the output starts at zero, progress is measured in the direction of the step
+  double sign = (step < 0.0) ? -1.0 : 1.0;
+  double prev_acc = 0.0;
+  for (int i = 0; i < cycles; i++)
+  {
+    if (r.t90 < 0.0 && out[i] * sign >= 0.9 * std::fabs(step))
+      r.t90 = i * dt;
+    if (std::fabs(out[i] - step) > 0.02 * std::fabs(step))
+      r.t_settle = -1.0;
+    else if (r.t_settle < 0.0)
+      r.t_settle = i * dt;
+
+    double acc = (i > 0) ? (out[i] - out[i - 1]) / dt : 0.0;
+    if (std::fabs(acc) > r.max_acc)
+      r.max_acc = std::fabs(acc);
+    if (i > 1 && std::fabs(acc - prev_acc) / dt > r.max_jerk)
+      r.max_jerk = std::fabs(acc - prev_acc) / dt;
+    prev_acc = acc;
+  }
+}
+
+static void print(const char* mode, const Response& r)
+{
+  printf("%-13s %10.3f %12.3f %12.3f %12.2f %12.1f\n", mode, r.t90, r.t_settle, r.max_acc, r.max_jerk, r.ns_per_cycle);
+}
+
+int main(int argc, char** argv)
+{
+  double loop_rate = (argc > 1) ? atof(argv[1]) : 30.0;
+  double input_rate = (argc > 2) ? atof(argv[2]) : 10.0;
+  double step = (argc > 3) ? atof(argv[3]) : 0.5;
+  int capacity = (argc > 4) ? atoi(argv[4]) : 12;
+  double acc_limit = (argc > 5) ? atof(argv[5]) : 0.3;
+  double max_acc = (argc > 6) ? atof(argv[6]) : 1.0;
+  double max_jerk = (argc > 7) ? atof(argv[7]) : 5.0;
+
+  const double store_delay = 4.0;
+  const double duration = 10.0;
+  const int repetitions = 200;
+
+  double dt = 1.0 / loop_rate;
+  int cycles = (int)(duration * loop_rate);
+  double* out = new double[cycles];
+  Response mean_resp, jerk_resp;
+
+  // mode "mean": only cycles with a new command produce output, the output holds in between
+  double start = wallTime();
+  for (int rep = 0; rep < repetitions; rep++)
+  {
+    VelocityWindow window(capacity, store_delay);
+    window.fillWithZeros(0.0);
+    double last_out = 0.0;
+    double next_input = 0.0;
+    bool have_out = false;
+
+    for (int i = 0; i < cycles; i++)
+    {
+      double now = i * dt;
+      if (now >= next_input)
+      {
+        next_input += 1.0 / input_rate;
+
+        if (window.outOfDate(now))
+        {
+          window.fillWithZeros(now);
+          window.push(now, step, 0.0, 0.0);
+        }
+        else
+        {
+          window.evictOutdated(now);
+          if (window.empty())
+            window.fillWithZeros(now);
+          window.push(now, step, 0.0, 0.0);
+        }
+
+        double result = window.mean(VelocityWindow::X);
+        double delta_time = (window.size() > 1) ? now - window.timeAt(2) : 0.0;
+        if (have_out && delta_time > 0.0 && std::fabs(result - last_out) > acc_limit)
+          result = last_out + ((result - last_out < 0.0) ? -acc_limit : acc_limit);
+        last_out = result;
+        have_out = true;
+      }
+      out[i] = last_out;
+    }
+  }
+  mean_resp.ns_per_cycle = (wallTime() - start) * 1e9 / ((double)repetitions * cycles);
+  evaluate(out, cycles, dt, step, mean_resp);
+
+  // mode "jerk_limited": every cycle steps the generator
+  start = wallTime();
+  for (int rep = 0; rep < repetitions; rep++)
+  {
+    JerkLimiter limiter(max_acc, max_jerk);
+    for (int i = 0; i < cycles; i++)
+      out[i] = limiter.step(step, dt);
+  }
+  jerk_resp.ns_per_cycle = (wallTime() - start) * 1e9 / ((double)repetitions * cycles);
+  evaluate(out, cycles, dt, step, jerk_resp);
+
+  printf("loop_rate %.1f Hz, input_rate %.1f Hz, step %.3f, capacity %d, thresh_max_acc %.3f, max_acc %.3f, max_jerk %.3f\n",
+         loop_rate, input_rate, step, capacity, acc_limit, max_acc, max_jerk);
+  printf("%-13s %10s %12s %12s %12s %12s\n", "mode", "t90 [s]", "t_settle [s]", "max acc", "max jerk", "ns/cycle");
+  print("mean", mean_resp);
+  print("jerk_limited", jerk_resp);
+
+  delete[] out;
+  return 0;
+}
@@ -0,0 +1,218 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_base_velocity_smoother
+ * Description: Time-windowed running mean of velocity commands.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <velocity_window.h>
+
+#include <cmath>
+
+VelocityWindow::VelocityWindow(unsigned long capacity, double store_delay)
+{
+  size_ = 0;
+  next_seq_ = 0;
+  configure(capacity, store_delay);
+  clear();
+}
+
+void VelocityWindow::configure(unsigned long capacity, double store_delay)
+{
+  capacity_ = (capacity > 0) ? capacity : 1;
+  store_delay_ = store_delay;
+}
+
+void VelocityWindow::clear()
+{
+  entries_.clear();
+  for (int a = 0; a < NUM_AXES; a++)
+  {
+    min_[a].clear();
+    max_[a].clear();
+    sum_[a] = 0.0;
+  }
+  size_ = 0;
+}
+
+void VelocityWindow::fillWithZeros(double now)
+{
+  clear();
+  push(now, 0.0, 0.0, 0.0, capacity_);
+}
+
+void VelocityWindow::push(double now, double x, double y, double theta, unsigned long count)
+{
+  if (count == 0)
+    return;
+  // more copies than the window holds leave only copies of this command
+  if (count >= capacity_)
+  {
+    clear();
+    count = capacity_;
+  }
+
+  Entry e;
+  e.seq = next_seq_++;
+  e.time = now;
+  e.value[X] = x;
+  e.value[Y] = y;
+  e.value[THETA] = theta;
+  e.count = count;
+
+  // make room first, so the queues below never refer to dropped entries
+  unsigned long overflow = (size_ + count > capacity_) ? size_ + count - capacity_ : 0;
+  while (overflow > 0)
+  {
+    unsigned long oldest = entries_.front().count;
+    if (oldest <= overflow)
+    {
+      popOldest();
+      overflow -= oldest;
+    }
+    else
+    {
+      shrinkOldest(overflow);
+      overflow = 0;
+    }
+  }
+
+  entries_.push_back(e);
+  size_ += count;
+
+  for (int a = 0; a < NUM_AXES; a++)
+  {
+    sum_[a] += e.value[a] * count;
+
+    // ">=" / "<=" drop equal older values, so the queues keep the newest occurrence
+    while (!min_[a].empty() && entry(min_[a].back()).value[a] >= e.value[a])
+      min_[a].pop_back();
+    min_[a].push_back(e.seq);
+    while (!max_[a].empty() && entry(max_[a].back()).value[a] <= e.value[a])
+      max_[a].pop_back();
+    max_[a].push_back(e.seq);
+  }
+}
+
+void VelocityWindow::popOldest()
+{
+  const Entry& e = entries_.front();
+  for (int a = 0; a < NUM_AXES; a++)
+  {
+    if (min_[a].front() == e.seq)
+      min_[a].pop_front();
+    if (max_[a].front() == e.seq)
+      max_[a].pop_front();
+  }
+  size_ -= e.count;
+  entries_.pop_front();
+
+  // recompute the sums exactly where it is cheap, so rounding errors cannot pile up
+  if (entries_.size() == 1)
+    for (int a = 0; a < NUM_AXES; a++)
+      sum_[a] = entries_.front().value[a] * entries_.front().count;
+  else if (entries_.empty())
+    for (int a = 0; a < NUM_AXES; a++)
+      sum_[a] = 0.0;
+  else
+    for (int a = 0; a < NUM_AXES; a++)
+      sum_[a] -= e.value[a] * e.count;
+}
+
+void VelocityWindow::shrinkOldest(unsigned long count)
+{
+  Entry& e = entries_.front();
+  e.count -= count;
+  size_ -= count;
+  for (int a = 0; a < NUM_AXES; a++)
+    sum_[a] -= e.value[a] * count;
+}
+
+void VelocityWindow::evictOutdated(double now)
+{
+  while (!entries_.empty() && now - entries_.front().time >= store_delay_)
+    popOldest();
+}
+
+bool VelocityWindow::outOfDate(double now) const
+{
+  // time stamps increase towards the back, so the newest entry decides
+  return entries_.empty() || now - entries_.back().time >= store_delay_;
+}
+
+double VelocityWindow::mean(Axis axis) const
+{
+  if (size_ == 0)
+    return 0.0;
+
+  double mean = sum_[axis] / size_;
+  if (size_ == 1)
+    return mean;
+
+  const Entry& lo = entry(min_[axis].front());
+  const Entry& hi = entry(max_[axis].front());
+  double dist_lo = std::fabs(mean - lo.value[axis]);
+  double dist_hi = std::fabs(mean - hi.value[axis]);
+
+  double outlier;
+  if (dist_lo > dist_hi || (dist_lo == dist_hi && lo.seq > hi.seq))
+    outlier = lo.value[axis];
+  else
+    outlier = hi.value[axis];
+
+  return (sum_[axis] - outlier) / (size_ - 1);
+}
+
+double VelocityWindow::timeAt(unsigned long index) const
+{
+  for (std::deque<Entry>::const_reverse_iterator it = entries_.rbegin(); it != entries_.rend(); ++it)
+  {
+    if (index < it->count)
+      return it->time;
+    index -= it->count;
+  }
+  return entries_.empty() ? 0.0 : entries_.front().time;
+}
@@ -64,9 +64,11 @@
 #ifdef __LINUX__
 	#include "cob_vision_utils/CameraSensorDefines.h"
 	#include "cob_vision_utils/CameraSensorTypes.h"
+	#include "cob_camera_sensors/RayTable.h"
 #else
 	#include "cob_common/cob_vision_utils/common/include/cob_vision_utils/CameraSensorDefines.h"
 	#include "cob_common/cob_vision_utils/common/include/cob_vision_utils/CameraSensorTypes.h"
+	#include "cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/RayTable.h"
 #endif
 
 #include <opencv/cv.h>
@@ -200,7 +202,8 @@ public:
 	/// Assignes intrinsics to the range sensor.
 	/// Intrinsics are read from the configuration file by the camera toolbox.
 	/// Intrinsics are needed to calculat range values 
-	/// based on own calibration.
+	/// based on own calibration. The ray table of the undistorted image is rebuilt
+	/// from the intrinsics and the size of the undistortion maps.
 	/// @param intrinsicMatrix The intrinsic matrix
 	/// @param undistortMapX undistortMapX The undistortion map for x direction
 	/// @param undistortMapY undistortMapY The undistortion map for y direction
@@ -208,6 +211,10 @@ public:
 	virtual unsigned long SetIntrinsics(cv::Mat& intrinsicMatrix,
 		cv::Mat& undistortMapX, cv::Mat& undistortMapY);
 
+	/// Returns the ray directions of the undistorted image, built by <code>SetIntrinsics</code>.
+	/// @return The ray table
+	virtual const RayTable& GetRayTable() const {return m_RayTable;}
+
 	/// Returns the number of images in the directory
 	/// @return The number of images in the directory
 	virtual int GetNumberOfImages() {return std::numeric_limits<int>::max();};
@@ -234,6 +241,7 @@ protected:
 	cv::Mat m_intrinsicMatrix;		///< Intrinsic parameters [fx 0 cx; 0 fy cy; 0 0 1]
 	cv::Mat m_undistortMapX;		///< The output array of x coordinates for the undistortion map
 	cv::Mat m_undistortMapY;		///< The output array of Y coordinates for the undistortion map
+	RayTable m_RayTable;			///< Ray directions of the undistorted image, calculated from m_intrinsicMatrix
 
 private:
 	
@@ -0,0 +1,141 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_camera_sensors
+ * Description: Per-pixel ray directions of a calibrated camera.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+/// @file RayTable.h
+/// Per-pixel ray directions for the conversion of depth values to cartesian coordinates.
+/// @date October 2026
+
+#ifndef __IPA_RAYTABLE_H__
+#define __IPA_RAYTABLE_H__
+
+#include "StdAfx.h"
+
+#ifdef __LINUX__
+	#include "cob_vision_utils/CameraSensorDefines.h"
+#else
+	#include "cob_common/cob_vision_utils/common/include/cob_vision_utils/CameraSensorDefines.h"
+#endif
+
+#include <opencv/cv.h>
+
+#include <vector>
+
+namespace ipa_CameraSensors {
+
+/// @ingroup RangeCameraDriver
+/// Holds the ray direction (x/z, y/z) of every pixel, so that a depth value z is converted to
+/// cartesian coordinates by x = z*rayX, y = z*rayY without any division per pixel.
+/// Without distortion parameters the rays are those of the undistorted (remapped) image,
+/// i.e. ((u-cx)/fx, (v-cy)/fy). With distortion parameters the rays are those of the pixels
+/// of the distorted image, for depth images that are not remapped.
+class __DLL_LIBCAMERASENSORS__ RayTable
+{
+public:
+
+	RayTable();
+
+	/// Calculates the rays of all pixels.
+	/// @param intrinsicMatrix Intrinsic parameters [fx 0 cx; 0 fy cy; 0 0 1] (CV_64FC1)
+	/// @param imageSize Image size in pixels
+	/// @param distortionParameters Optional distortion parameters k1, k2, p1, p2[, k3] (CV_64FC1)
+	/// @return Return code
+	unsigned long Init(const cv::Mat& intrinsicMatrix, cv::Size imageSize,
+		const cv::Mat& distortionParameters = cv::Mat());
+
+	/// Returns true after a successful <code>Init</code>.
+	bool IsInitialized() const {return m_Width > 0;}
+
+	/// Returns true, if the table has been initialized with the given parameters.
+	/// Used to rebuild the table only when the camera calibration changes.
+	bool IsInitialized(const cv::Mat& intrinsicMatrix, cv::Size imageSize,
+		const cv::Mat& distortionParameters = cv::Mat()) const;
+
+	/// Discards the table.
+	void Clear();
+
+	int GetWidth() const {return m_Width;}
+	int GetHeight() const {return m_Height;}
+
+	/// Returns the rays of one image row, as interleaved pairs (rayX, rayY) for every column.
+	const float* GetRays(int row) const {return &m_Rays[2*row*m_Width];}
+
+	/// Converts one row of depth values to cartesian coordinates.
+	/// @param row The image row
+	/// @param z The depth values of the row
+	/// @param xyz Output with 3 floats (x, y, z) per column
+	void GetXYZ(int row, const float* z, float* xyz) const
+	{
+		const float* rays = GetRays(row);
+		for (int col=0; col<m_Width; col++)
+		{
+			float zCol = z[col];
+			xyz[3*col] = zCol*rays[2*col];
+			xyz[3*col + 1] = zCol*rays[2*col + 1];
+			xyz[3*col + 2] = zCol;
+		}
+	}
+
+private:
+
+	/// Copies intrinsics and distortion parameters in the order fx, fy, cx, cy, k1, k2, ...
+	/// @return Return code
+	static unsigned long GetParameters(const cv::Mat& intrinsicMatrix,
+		const cv::Mat& distortionParameters, std::vector<double>& parameters);
+
+	int m_Width;
+	int m_Height;
+
+	std::vector<double> m_Parameters;	///< fx, fy, cx, cy and the distortion parameters the table has been built for
+	std::vector<float> m_Rays;			///< (x/z, y/z) for every pixel, row by row
+};
+
+} // End namespace ipa_CameraSensors
+#endif // __IPA_RAYTABLE_H__
@@ -78,8 +78,10 @@ typedef unsigned long DWORD;
 
 #ifdef __LINUX__
 	#include <cob_camera_sensors/AbstractRangeImagingSensor.h>
+	#include <cob_camera_sensors/ToFCalibration.h>
 #else
 	#include <cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/AbstractRangeImagingSensor.h>
+	#include <cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/ToFCalibration.h>
 #endif
 
 #include <stdio.h>
@@ -136,6 +138,10 @@ public:
 
 	unsigned long SaveParameters(const char* filename);
 
+	/// Assigns the intrinsics and discards the prepared MATLAB calibration.
+	unsigned long SetIntrinsics(cv::Mat& intrinsicMatrix,
+		cv::Mat& undistortMapX, cv::Mat& undistortMapY);
+
 	bool isInitialized() {return m_initialized;}
 	bool isOpen() {return m_open;}
 
@@ -144,9 +150,7 @@ private:
 	// Camera specific members
 	//*******************************************************************************
 
-	unsigned long GetCalibratedZMatlab(int u, int v, float zRaw, float& zCalibrated);
 	unsigned long GetCalibratedZSwissranger(int u, int v, int width, float& zCalibrated);
-	unsigned long GetCalibratedXYMatlab(int u, int v, float z, float& x, float& y);
 	unsigned long GetCalibratedXYSwissranger(int u, int v, int width, float& x, float& y);
 
 	/// Load general Swissranger parameters and previously determined calibration parameters.
@@ -184,6 +188,8 @@ private:
 	cv::Mat m_CoeffsA4; ///< a4 z-calibration parameters. One matrix entry corresponds to one pixel
 	cv::Mat m_CoeffsA5; ///< a5 z-calibration parameters. One matrix entry corresponds to one pixel
 	cv::Mat m_CoeffsA6; ///< a6 z-calibration parameters. One matrix entry corresponds to one pixel
+
+	ToFCalibration m_ToFCalibration; ///< m_CoeffsA0..A6 and undistortion prepared for the MATLAB calibration, set up on first use
 };
 
 /// Creates, intializes and returns a smart pointer object for the camera.
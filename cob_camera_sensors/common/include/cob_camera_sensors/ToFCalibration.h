@@ -0,0 +1,135 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_camera_sensors
+ * Description: Fused z-calibration, undistortion and back-projection of ToF images.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+/// @file ToFCalibration.h
+/// Fused per-pixel calibration of raw ToF depth values to a cartesian image.
+/// @date October 2026
+
+#ifndef __IPA_TOFCALIBRATION_H__
+#define __IPA_TOFCALIBRATION_H__
+
+#include "StdAfx.h"
+
+#ifdef __LINUX__
+	#include "cob_vision_utils/CameraSensorDefines.h"
+#else
+	#include "cob_common/cob_vision_utils/common/include/cob_vision_utils/CameraSensorDefines.h"
+#endif
+
+#ifdef __LINUX__
+	#include "cob_camera_sensors/RayTable.h"
+#else
+	#include "cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/RayTable.h"
+#endif
+
+#include <opencv/cv.h>
+
+#include <vector>
+
+namespace ipa_CameraSensors {
+
+/// @ingroup RangeCameraDriver
+/// Calculates the calibrated cartesian image from raw depth values, like the MATLAB calibration
+/// of the range cameras does with a 6 degree polynomial per pixel, cv::remap() and the intrinsics.
+/// All per-pixel data is prepared once by <code>Init</code>:
+///  - the coefficients a0..a6 of the z-polynomial in float, the 7 coefficients of a pixel stored together
+///    in blocks of 8 pixels, evaluated with Horner's method on a normalized raw value
+///  - the source pixel and the 4 weights of the bilinear interpolation of the undistortion map
+///    (constant border 0 like cv::remap). The weights are exact, cv::remap quantizes them to
+///    1/32 pixel. This is intended, but the results differ from cv::remap by the depth difference
+///    of neighbouring pixels times up to 1/64, e.g. about 1 mm at the border of an object.
+/// The ray directions of the undistorted image are taken from the <code>RayTable</code> of the sensor.
+/// <code>GetCalibratedXYZ</code> then needs no divisions, branches or type conversions per pixel.
+class __DLL_LIBCAMERASENSORS__ ToFCalibration
+{
+public:
+
+	ToFCalibration();
+
+	/// Prepares the calibration.
+	/// @param coeffs Array of the 7 z-calibration matrices a0..a6 (CV_64FC1), one entry per pixel.
+	/// @param rayTable Rays of the undistorted image. Must stay valid until <code>Clear</code>.
+	/// @param undistortMapX The undistortion map for x direction (CV_32FC1)
+	/// @param undistortMapY The undistortion map for y direction (CV_32FC1)
+	/// @param maxRawZ Largest raw depth value, used to normalize the polynomial
+	/// @return Return code
+	unsigned long Init(const cv::Mat* coeffs, const RayTable& rayTable,
+		const cv::Mat& undistortMapX, const cv::Mat& undistortMapY, double maxRawZ = 65535.);
+
+	/// Returns true after a successful <code>Init</code>.
+	bool IsInitialized() const {return m_Width > 0;}
+
+	/// Discards the prepared data, e.g. when the intrinsics change and the ray table is rebuilt.
+	void Clear();
+
+	/// Calculates the undistorted cartesian image in meters.
+	/// @param rawZ Raw depth values of the distorted image, row by row without padding.
+	/// @param cartesianImage Output image with 3 floats (x, y, z) per pixel.
+	/// @param widthStepCartesian The stride of a row of the cartesian image.
+	/// @return Return code
+	unsigned long GetCalibratedXYZ(const unsigned short* rawZ, char* cartesianImage, int widthStepCartesian);
+
+private:
+
+	enum {BLOCK_SIZE = 8};	///< Number of pixels evaluated together by the polynomial
+
+	int m_Width;
+	int m_Height;
+	float m_RawZScale;		///< Normalizes the raw depth to [0, 1]
+
+	std::vector<float> m_Coeffs;		///< Per block of 8 pixels: a6[8], a5[8], ... a0[8] of the normalized polynomial
+	std::vector<int> m_SrcIndex;		///< Upper left source pixel of the bilinear interpolation for every pixel
+	std::vector<float> m_SrcWeights;	///< Weights of the 2x2 source pixels for every pixel, 0 outside of the image
+	const RayTable* m_RayTable;			///< Rays of the undistorted image
+	std::vector<float> m_ZDistorted;	///< Calibrated z of the distorted image
+};
+
+} // End namespace ipa_CameraSensors
+#endif // __IPA_TOFCALIBRATION_H__
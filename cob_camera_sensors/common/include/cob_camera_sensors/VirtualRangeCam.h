@@ -143,7 +143,6 @@ private:
 	inline void FindSourceImageFormat(std::map<std::string, int>::iterator& itCounter, std::string& ext);
 
 	unsigned long GetCalibratedZMatlab(int u, int v, float zRaw, float& zCalibrated);
-	unsigned long GetCalibratedXYMatlab(int u, int v, float z, float& x, float& y);
 	
 	/// Load general range camera parameters .
 	/// @param filename Configuration file-path and file-name.
@@ -74,6 +74,18 @@ unsigned long AbstractRangeImagingSensor::SetIntrinsics(cv::Mat& intrinsicMatrix
 	m_undistortMapX = undistortMapX.clone();
 	m_undistortMapY = undistortMapY.clone();
 
+	m_RayTable.Clear();
+	if (m_undistortMapX.empty())
+	{
+		return RET_OK;
+	}
+	if (m_RayTable.Init(m_intrinsicMatrix, m_undistortMapX.size()) & RET_FAILED)
+	{
+		std::cerr << "ERROR - AbstractRangeImagingSensor::SetIntrinsics:" << std::endl;
+		std::cerr << "\t ... Could not build ray table.\n";
+		return RET_FAILED;
+	}
+
 	return RET_OK; 
 }
 
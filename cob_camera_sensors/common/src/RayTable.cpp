@@ -0,0 +1,199 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_camera_sensors
+ * Description: Per-pixel ray directions of a calibrated camera.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#include "../include/cob_camera_sensors/StdAfx.h"
+#ifdef __LINUX__
+	#include "cob_camera_sensors/RayTable.h"
+#else
+	#include "cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/RayTable.h"
+#endif
+
+#include <iostream>
+
+using namespace ipa_CameraSensors;
+
+RayTable::RayTable()
+{
+	Clear();
+}
+
+void RayTable::Clear()
+{
+	m_Width = 0;
+	m_Height = 0;
+
+	m_Parameters.clear();
+	m_Rays.clear();
+}
+
+unsigned long RayTable::GetParameters(const cv::Mat& intrinsicMatrix,
+		const cv::Mat& distortionParameters, std::vector<double>& parameters)
+{
+	parameters.clear();
+	if (intrinsicMatrix.type() != CV_64FC1 || intrinsicMatrix.rows != 3 || intrinsicMatrix.cols != 3)
+	{
+		std::cerr << "ERROR - RayTable::GetParameters:" << std::endl;
+		std::cerr << "\t ... Intrinsic matrix must be 3x3 CV_64FC1.\n";
+		return RET_FAILED;
+	}
+	parameters.push_back(intrinsicMatrix.at<double>(0, 0));
+	parameters.push_back(intrinsicMatrix.at<double>(1, 1));
+	parameters.push_back(intrinsicMatrix.at<double>(0, 2));
+	parameters.push_back(intrinsicMatrix.at<double>(1, 2));
+
+	if (distortionParameters.empty())
+	{
+		return RET_OK;
+	}
+	if (distortionParameters.type() != CV_64FC1)
+	{
+		std::cerr << "ERROR - RayTable::GetParameters:" << std::endl;
+		std::cerr << "\t ... Distortion parameters must be CV_64FC1.\n";
+		return RET_FAILED;
+	}
+	for (int row=0; row<distortionParameters.rows; row++)
+	{
+		for (int col=0; col<distortionParameters.cols; col++)
+		{
+			parameters.push_back(distortionParameters.at<double>(row, col));
+		}
+	}
+	return RET_OK;
+}
+
+bool RayTable::IsInitialized(const cv::Mat& intrinsicMatrix, cv::Size imageSize,
+		const cv::Mat& distortionParameters) const
+{
+	if (!IsInitialized() || imageSize.width != m_Width || imageSize.height != m_Height)
+	{
+		return false;
+	}
+
+	std::vector<double> parameters;
+	if (GetParameters(intrinsicMatrix, distortionParameters, parameters) & RET_FAILED)
+	{
+		return false;
+	}
+	return parameters == m_Parameters;
+}
+
+unsigned long RayTable::Init(const cv::Mat& intrinsicMatrix, cv::Size imageSize,
+		const cv::Mat& distortionParameters)
+{
+	Clear();
+
+	std::vector<double> parameters;
+	if (GetParameters(intrinsicMatrix, distortionParameters, parameters) & RET_FAILED)
+	{
+		std::cerr << "ERROR - RayTable::Init:" << std::endl;
+		std::cerr << "\t ... Could not read camera parameters.\n";
+		return RET_FAILED;
+	}
+
+	double fx = parameters[0];
+	double fy = parameters[1];
+	double cx = parameters[2];
+	double cy = parameters[3];
+	if (fx == 0 || fy == 0)
+	{
+		std::cerr << "ERROR - RayTable::Init:" << std::endl;
+		std::cerr << "\t ... fx or fy is 0.\n";
+		return RET_FAILED;
+	}
+
+	int width = imageSize.width;
+	int height = imageSize.height;
+	if (width <= 0 || height <= 0)
+	{
+		std::cerr << "ERROR - RayTable::Init:" << std::endl;
+		std::cerr << "\t ... Image size must not be empty.\n";
+		return RET_FAILED;
+	}
+
+	int numPixels = width*height;
+	m_Rays.resize(2*numPixels);
+	if (distortionParameters.empty())
+	{
+		// Fundamental equations: u = (fx*x)/z + cx, v = (fy*y)/z + cy
+		for (int row=0; row<height; row++)
+		{
+			float rayY = (float) ((row-cy)/fy);
+			float* rays = &m_Rays[2*row*width];
+			for (int col=0; col<width; col++)
+			{
+				rays[2*col] = (float) ((col-cx)/fx);
+				rays[2*col + 1] = rayY;
+			}
+		}
+	}
+	else
+	{
+		// Invert the distortion model of every pixel.
+		// Without a new camera matrix, cv::undistortPoints returns normalized coordinates x/z, y/z.
+		cv::Mat distortedPoints(1, numPixels, CV_32FC2);
+		float* points = distortedPoints.ptr<float>(0);
+		for (int i=0; i<numPixels; i++)
+		{
+			points[2*i] = (float) (i % width);
+			points[2*i + 1] = (float) (i / width);
+		}
+		cv::Mat undistortedPoints;
+		cv::undistortPoints(distortedPoints, undistortedPoints, intrinsicMatrix, distortionParameters);
+		const float* rays = undistortedPoints.ptr<float>(0);
+		m_Rays.assign(rays, rays + 2*numPixels);
+	}
+
+	m_Parameters = parameters;
+	m_Width = width;
+	m_Height = height;
+
+	return RET_OK;
+}
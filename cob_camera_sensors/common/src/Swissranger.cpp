@@ -831,7 +831,6 @@ unsigned long Swissranger::AcquireImages(int widthStepRange, int widthStepGray,
 	{
 		float x = -1;
 		float y = -1;
-		float zRaw = -1;
 		float* zCalibratedPtr = 0;
 		float zCalibrated = -1;
 		float* f_ptr = 0;
@@ -840,56 +839,20 @@ unsigned long Swissranger::AcquireImages(int widthStepRange, int widthStepGray,
 		{
 			if (m_CoeffsInitialized)
 			{
-				// Calculate calibrated z values (in meter) based on 6 degree polynomial approximation
-				cv::Mat distortedData( height, width, CV_32FC1 );
-				for(unsigned int row=0; row<(unsigned int)height; row++)
+				// z based on 6 degree polynomial approximation, undistortion and x, y in one pass
+				if (!m_ToFCalibration.IsInitialized())
 				{
-					f_ptr = distortedData.ptr<float>(row);
-					for (unsigned int col=0; col<(unsigned int)width; col++)
+					assert (!m_undistortMapX.empty() && !m_undistortMapY.empty());
+					cv::Mat coeffs[7] = {m_CoeffsA0, m_CoeffsA1, m_CoeffsA2, m_CoeffsA3, m_CoeffsA4, m_CoeffsA5, m_CoeffsA6};
+					if (m_ToFCalibration.Init(coeffs, m_RayTable, m_undistortMapX, m_undistortMapY) & RET_FAILED)
 					{
-						zRaw = (float)(pixels[width*row + col]);
-						GetCalibratedZMatlab(col, row, zRaw, zCalibrated);
-						f_ptr[col] = zCalibrated;
-					}	
-				}
-				/*IplImage dummy;
-				IplImage *z = cvGetImage(distortedData, &dummy);
-				IplImage *image = cvCreateImage(cvGetSize(z), IPL_DEPTH_8U, 3);
-				ipa_Utils::ConvertToShowImage(z, image, 1);
-				cvNamedWindow("Z");
-				cvShowImage("Z", image);
-				cvWaitKey();
-				*/
-
-				// Undistort
-				cv::Mat undistortedData;
-	 			assert (!m_undistortMapX.empty() && !m_undistortMapY.empty());
-				cv::remap(distortedData, undistortedData, m_undistortMapX, m_undistortMapY, cv::INTER_LINEAR);
-				
-				/*IplImage dummy;
-				IplImage* z = cvGetImage(undistortedData, &dummy);
-				IplImage* image = cvCreateImage(cvGetSize(z), IPL_DEPTH_8U, 3);
-				ipa_utils::ConvertToShowImage(z, image, 1);
-				cvNamedWindow("Z");
-				cvShowImage("Z", image);
-				cvWaitKey();*/
-
-				// Calculate X and Y based on instrinsic rotation and translation
-				for(unsigned int row=0; row<(unsigned int)height; row++)
-				{
-					zCalibratedPtr = undistortedData.ptr<float>(row);
-					f_ptr = (float*)(cartesianImageData + row*widthStepCartesian);
-
-					for (unsigned int col=0; col<(unsigned int)width; col++)
-					{
-						int colTimes3 = 3*col;
-						GetCalibratedXYMatlab(col, row, zCalibratedPtr[col], x, y);
-
-						f_ptr[colTimes3] = x;
-						f_ptr[colTimes3 + 1] = y;
-						f_ptr[colTimes3 + 2] = zCalibratedPtr[col];
+						std::cerr << "ERROR - Swissranger::AcquireImages:" << std::endl;
+						std::cerr << "\t ... Preparing the MATLAB calibration failed.\n";
+						return RET_FAILED;
 					}
 				}
+
+				m_ToFCalibration.GetCalibratedXYZ(pixels, cartesianImageData, widthStepCartesian);
 			}
 			else
 			{
@@ -920,20 +883,12 @@ unsigned long Swissranger::AcquireImages(int widthStepRange, int widthStepGray,
 			cv::remap(distortedData, undistortedData, m_undistortMapX, m_undistortMapY, cv::INTER_LINEAR);
 
 			// Calculate X and Y based on instrinsic rotation and translation
+			assert (m_RayTable.GetWidth() == width && m_RayTable.GetHeight() == height);
 			for(unsigned int row=0; row<(unsigned int)height; row++)
 			{
 				zCalibratedPtr = undistortedData.ptr<float>(row);
 				f_ptr = (float*)(cartesianImageData + row*widthStepCartesian);
-
-				for (unsigned int col=0; col<(unsigned int)width; col++)
-				{
-					int colTimes3 = 3*col;
-					GetCalibratedXYMatlab(col, row, zCalibratedPtr[col], x, y);
-
-					f_ptr[colTimes3] = x;
-					f_ptr[colTimes3 + 1] = y;
-					f_ptr[colTimes3 + 2] = zCalibratedPtr[col];
-				}
+				m_RayTable.GetXYZ(row, zCalibratedPtr, f_ptr);
 			}
 		}
 		else if(m_CalibrationMethod==NATIVE)
@@ -972,16 +927,11 @@ unsigned long Swissranger::SaveParameters(const char* filename)
 	return RET_FUNCTION_NOT_IMPLEMENTED;
 }
 
-unsigned long Swissranger::GetCalibratedZMatlab(int u, int v, float zRaw, float& zCalibrated)
+unsigned long Swissranger::SetIntrinsics(cv::Mat& intrinsicMatrix,
+		cv::Mat& undistortMapX, cv::Mat& undistortMapY)
 {
-
-	double c[7] = {m_CoeffsA0.at<double>(v,u), m_CoeffsA1.at<double>(v,u), m_CoeffsA2.at<double>(v,u), 
-		m_CoeffsA3.at<double>(v,u), m_CoeffsA4.at<double>(v,u), m_CoeffsA5.at<double>(v,u), m_CoeffsA6.at<double>(v,u)};
-	double y = 0;
-	ipa_Utils::EvaluatePolynomial((double) zRaw, 6, &c[0], &y);
-	zCalibrated = (float) y;
-
-	return RET_OK;
+	m_ToFCalibration.Clear();
+	return AbstractRangeImagingSensor::SetIntrinsics(intrinsicMatrix, undistortMapX, undistortMapY);
 }
 
 // Return value is in m
@@ -992,46 +942,6 @@ unsigned long Swissranger::GetCalibratedZSwissranger(int u, int v, int width, fl
 	return RET_OK;
 }
 
-// u and v are assumed to be distorted coordinates
-unsigned long Swissranger::GetCalibratedXYMatlab(int u, int v, float z, float& x, float& y)
-{
-	// Conversion form m to mm
-	z *= 1000;
-
-	// Use intrinsic camera parameters
-	double fx, fy, cx, cy;
-
-	fx = m_intrinsicMatrix.at<double>(0, 0);
-	fy = m_intrinsicMatrix.at<double>(1, 1);
-
-	cx = m_intrinsicMatrix.at<double>(0, 2);
-	cy = m_intrinsicMatrix.at<double>(1, 2);
-
-	// Fundamental equation: u = (fx*x)/z + cx
-	if (fx == 0)
-	{
-		std::cerr << "ERROR - Swissranger::GetCalibratedXYZ:" << std::endl;
-		std::cerr << "\t ... fx is 0.\n";
-		return RET_FAILED;
-	}
-	x = (float) (z*(u-cx)/fx) ; 
-	
-	// Fundamental equation: v = (fy*y)/z + cy
-	if (fy == 0)
-	{
-		std::cerr << "ERROR - Swissranger::GetCalibratedXYZ:" << std::endl;
-		std::cerr << "\t ... fy is 0.\n";
-		return RET_FAILED;
-	}
-	y = (float) (z*(v-cy)/fy); 
-
-	// Conversion from mm to m
-	x /= 1000;
-	y /= 1000;
-
-	return RET_OK;
-}
-
 unsigned long Swissranger::GetCalibratedXYSwissranger(int u, int v, int width, float& x, float& y)
 {
 	// make sure, that m_X, m_Y and m_Z have been initialized by Acquire image
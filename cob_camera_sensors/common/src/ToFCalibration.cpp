@@ -0,0 +1,254 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_camera_sensors
+ * Description: Fused z-calibration, undistortion and back-projection of ToF images.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include "../include/cob_camera_sensors/StdAfx.h"
+#ifdef __LINUX__
+	#include "cob_camera_sensors/ToFCalibration.h"
+#else
+	#include "cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/ToFCalibration.h"
+#endif
+
+#include <algorithm>
+#include <iostream>
+
+using namespace ipa_CameraSensors;
+
+ToFCalibration::ToFCalibration()
+{
+	Clear();
+}
+
+void ToFCalibration::Clear()
+{
+	m_Width = 0;
+	m_Height = 0;
+	m_RawZScale = 1;
+	m_RayTable = 0;
+
+	m_Coeffs.clear();
+	m_SrcIndex.clear();
+	m_SrcWeights.clear();
+	m_ZDistorted.clear();
+}
+
+unsigned long ToFCalibration::Init(const cv::Mat* coeffs, const RayTable& rayTable,
+		const cv::Mat& undistortMapX, const cv::Mat& undistortMapY, double maxRawZ)
+{
+	Clear();
+
+	int width = coeffs[0].cols;
+	int height = coeffs[0].rows;
+
+	for (int k=0; k<7; k++)
+	{
+		if (coeffs[k].type() != CV_64FC1 || coeffs[k].cols != width || coeffs[k].rows != height)
+		{
+			std::cerr << "ERROR - ToFCalibration::Init:" << std::endl;
+			std::cerr << "\t ... z-calibration coefficients a" << k << " missing or of wrong size.\n";
+			return RET_FAILED;
+		}
+	}
+	if (undistortMapX.type() != CV_32FC1 || undistortMapY.type() != CV_32FC1 ||
+		undistortMapX.size() != coeffs[0].size() || undistortMapY.size() != coeffs[0].size())
+	{
+		std::cerr << "ERROR - ToFCalibration::Init:" << std::endl;
+		std::cerr << "\t ... Undistortion maps must be CV_32FC1 of image size.\n";
+		return RET_FAILED;
+	}
+
+	if (rayTable.GetWidth() != width || rayTable.GetHeight() != height)
+	{
+		std::cerr << "ERROR - ToFCalibration::Init:" << std::endl;
+		std::cerr << "\t ... Ray table not initialized for image size.\n";
+		return RET_FAILED;
+	}
+
+	// z-polynomial of t = zRaw/maxRawZ: the coefficient of t^k is a_k*maxRawZ^k.
+	// This keeps t^k in [0, 1], so the polynomial can be evaluated in float.
+	int numPixels = width*height;
+	int numBlocks = (numPixels + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	m_RawZScale = (float) (1./maxRawZ);
+	m_Coeffs.assign(numBlocks*7*BLOCK_SIZE, 0.f);
+	for (int i=0; i<numPixels; i++)
+	{
+		int row = i / width;
+		int col = i % width;
+		float* blockCoeffs = &m_Coeffs[(i / BLOCK_SIZE) * 7*BLOCK_SIZE];
+		double scale = 1;
+		for (int k=0; k<7; k++)
+		{
+			// highest coefficient first, as needed by Horner's method
+			blockCoeffs[(6-k)*BLOCK_SIZE + i%BLOCK_SIZE] = (float) (coeffs[k].at<double>(row, col) * scale);
+			scale *= maxRawZ;
+		}
+	}
+	m_ZDistorted.assign(numBlocks*BLOCK_SIZE, 0.f);
+
+	// bilinear interpolation of the undistortion map.
+	// The 2x2 source window is moved into the image at the border, the weights of
+	// source pixels outside of the image are 0.
+	m_SrcIndex.resize(numPixels);
+	m_SrcWeights.resize(4*numPixels);
+	for (int row=0; row<height; row++)
+	{
+		const float* mapX = undistortMapX.ptr<float>(row);
+		const float* mapY = undistortMapY.ptr<float>(row);
+		for (int col=0; col<width; col++)
+		{
+			int i = row*width + col;
+			int x0 = cvFloor(mapX[col]);
+			int y0 = cvFloor(mapY[col]);
+			float ax = mapX[col] - x0;
+			float ay = mapY[col] - y0;
+			int bx = std::max(0, std::min(width-2, x0));
+			int by = std::max(0, std::min(height-2, y0));
+
+			float* weights = &m_SrcWeights[4*i];
+			weights[0] = weights[1] = weights[2] = weights[3] = 0;
+			for (int dy=0; dy<2; dy++)
+			{
+				for (int dx=0; dx<2; dx++)
+				{
+					int x = x0 + dx;
+					int y = y0 + dy;
+					if (x < 0 || x >= width || y < 0 || y >= height)
+					{
+						continue;
+					}
+					weights[2*(y-by) + (x-bx)] += (dx ? ax : 1-ax) * (dy ? ay : 1-ay);
+				}
+			}
+			m_SrcIndex[i] = by*width + bx;
+		}
+	}
+
+	m_RayTable = &rayTable;
+	m_Width = width;
+	m_Height = height;
+
+	return RET_OK;
+}
+
+unsigned long ToFCalibration::GetCalibratedXYZ(const unsigned short* rawZ, char* cartesianImage, int widthStepCartesian)
+{
+	if (!IsInitialized())
+	{
+		std::cerr << "ERROR - ToFCalibration::GetCalibratedXYZ:" << std::endl;
+		std::cerr << "\t ... Not initialized.\n";
+		return RET_FAILED;
+	}
+
+	// calibrated z of the distorted image.
+	// The 8 pixels of a block are independent, so the compiler evaluates them in SIMD registers.
+	int numPixels = m_Width*m_Height;
+	int numBlocks = (int) m_ZDistorted.size() / BLOCK_SIZE;
+	const float* coeffs = &m_Coeffs[0];
+	float* zDistorted = &m_ZDistorted[0];
+	for (int block=0; block<numBlocks; block++)
+	{
+		int first = block*BLOCK_SIZE;
+		float t[BLOCK_SIZE];
+		if (first + BLOCK_SIZE <= numPixels)
+		{
+			for (int j=0; j<BLOCK_SIZE; j++)
+			{
+				t[j] = rawZ[first + j] * m_RawZScale;
+			}
+		}
+		else
+		{
+			for (int j=0; j<BLOCK_SIZE; j++)
+			{
+				t[j] = (first + j < numPixels) ? rawZ[first + j] * m_RawZScale : 0.f;
+			}
+		}
+
+		float z[BLOCK_SIZE];
+		for (int j=0; j<BLOCK_SIZE; j++)
+		{
+			z[j] = coeffs[j];
+		}
+		for (int k=1; k<7; k++)
+		{
+			for (int j=0; j<BLOCK_SIZE; j++)
+			{
+				z[j] = z[j]*t[j] + coeffs[k*BLOCK_SIZE + j];
+			}
+		}
+		for (int j=0; j<BLOCK_SIZE; j++)
+		{
+			zDistorted[first + j] = z[j];
+		}
+		coeffs += 7*BLOCK_SIZE;
+	}
+
+	// undistortion and back-projection
+	for (int row=0; row<m_Height; row++)
+	{
+		float* f_ptr = (float*) (cartesianImage + row*widthStepCartesian);
+		const int* srcIndex = &m_SrcIndex[row*m_Width];
+		const float* weights = &m_SrcWeights[4*row*m_Width];
+		const float* rays = m_RayTable->GetRays(row);
+
+		for (int col=0; col<m_Width; col++)
+		{
+			const float* src = zDistorted + srcIndex[col];
+			const float* w = weights + 4*col;
+			float z = w[0]*src[0] + w[1]*src[1] + w[2]*src[m_Width] + w[3]*src[m_Width + 1];
+
+			int colTimes3 = 3*col;
+			f_ptr[colTimes3] = z*rays[2*col];
+			f_ptr[colTimes3 + 1] = z*rays[2*col + 1];
+			f_ptr[colTimes3 + 2] = z;
+		}
+	}
+
+	return RET_OK;
+}
@@ -752,8 +752,6 @@ unsigned long VirtualRangeCam::AcquireImages(int widthStepRange, int widthStepGr
 ///***********************************************************************
 	if(cartesianImageData)
 	{
-		float x = -1;
-		float y = -1;
 		float zCalibrated = -1;
 		float* f_ptr = 0;
 		float* f_ptr_dst = 0;
@@ -788,20 +786,21 @@ unsigned long VirtualRangeCam::AcquireImages(int widthStepRange, int widthStepGr
 				CV_Assert(false);
 			}
 
+			assert (m_RayTable.GetWidth() == m_ImageWidth && m_RayTable.GetHeight() == m_ImageHeight);
 			for(unsigned int row=0; row<(unsigned int)m_ImageHeight; row++)
 			{
 				f_ptr = (float*) (coordinateImage->imageData + row*coordinateImage->widthStep);
 				f_ptr_dst = (float*) (cartesianImageData + row*widthStepCartesian);
+				const float* rays = m_RayTable.GetRays(row);
 
 				for (unsigned int col=0; col<(unsigned int)m_ImageWidth; col++)
 				{
 					int colTimes3 = 3*col;
 
 					zCalibrated = f_ptr[colTimes3+2];
-					GetCalibratedXYMatlab(col, row, zCalibrated, x, y);
 
-					f_ptr_dst[colTimes3] = x;
-					f_ptr_dst[colTimes3 + 1] = y;
+					f_ptr_dst[colTimes3] = zCalibrated*rays[2*col];
+					f_ptr_dst[colTimes3 + 1] = zCalibrated*rays[2*col + 1];
 					f_ptr_dst[colTimes3 + 2] = zCalibrated;
 
 					if (f_ptr_dst[colTimes3 + 2] < 0)
@@ -918,45 +917,6 @@ unsigned long VirtualRangeCam::GetCalibratedZMatlab(int u, int v, float zRaw, fl
 	return RET_OK;
 }
 
-unsigned long VirtualRangeCam::GetCalibratedXYMatlab(int u, int v, float z, float& x, float& y)
-{
-	// Conversion form m to mm
-	z *= 1000;
-
-	// Use intrinsic camera parameters
-	double fx, fy, cx, cy;
-
-	fx = m_intrinsicMatrix.at<double>(0, 0);
-	fy = m_intrinsicMatrix.at<double>(1, 1);
-
-	cx = m_intrinsicMatrix.at<double>(0, 2);
-	cy = m_intrinsicMatrix.at<double>(1, 2);
-
-	// Fundamental equation: u = (fx*x)/z + cx
-	if (fx == 0)
-	{
-		std::cerr << "VirtualRangeCam::GetCalibratedXYMatlab:" << std::endl;
-		std::cerr << "\t ... fx is 0.\n";
-		return RET_FAILED;
-	}
-	x = (float) (z*(u-cx)/fx) ;
-
-	// Fundamental equation: v = (fy*y)/z + cy
-	if (fy == 0)
-	{
-		std::cerr << "VirtualRangeCam::GetCalibratedXYMatlab:" << std::endl;
-		std::cerr << "\t ... fy is 0.\n";
-		return RET_FAILED;
-	}
-	y = (float) (z*(v-cy)/fy);
-
-	// Conversion from mm to m
-	x /= 1000;
-	y /= 1000;
-
-	return RET_OK;
-}
-
 unsigned long VirtualRangeCam::GetCalibratedUV(double x, double y, double z, double& u, double& v)
 {
 	if(m_CalibrationMethod==MATLAB || m_CalibrationMethod==MATLAB_NO_Z)
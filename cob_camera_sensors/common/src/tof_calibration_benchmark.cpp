@@ -0,0 +1,288 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_camera_sensors
+ * Description: Benchmark of the MATLAB calibration of ToF images.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+/// @file tof_calibration_benchmark.cpp
+/// Compares the former per-pixel MATLAB calibration of Swissranger::AcquireImages()
+/// (GetCalibratedZMatlab(), cv::remap(), GetCalibratedXYMatlab()) with ToFCalibration,
+/// and the former back-projection alone with RayTable.
+/// The coefficients, intrinsics and distortion are synthetic, of the size of a SR-3000 image,
+/// or loaded from a camera directory with MatlabCalibrationData/PMD/ZCoeffsA0..6.xml.
+/// The synthetic coefficients and the raw depth image vary smoothly over the image, like those
+/// of a real camera and scene. The difference of both paths is then dominated by the weights of
+/// cv::remap, which are quantized to 1/32 pixel, while ToFCalibration uses exact weights.
+/// With uncorrelated random depths neighbouring pixels differ by meters and so would the results.
+///
+/// usage: tof_calibration_benchmark [calibration_directory] [iterations]
+///
+/// Prints the time per image and the largest difference of x, y, z.
+
+#include "../include/cob_camera_sensors/StdAfx.h"
+#ifdef __LINUX__
+	#include "cob_camera_sensors/RayTable.h"
+	#include "cob_camera_sensors/ToFCalibration.h"
+	#include "cob_vision_utils/VisionUtils.h"
+#else
+	#include "cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/RayTable.h"
+	#include "cob_driver/cob_camera_sensors/common/include/cob_camera_sensors/ToFCalibration.h"
+	#include "cob_common/cob_vision_utils/common/include/cob_vision_utils/VisionUtils.h"
+#endif
+
+#include <opencv/cv.h>
+
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+using namespace ipa_CameraSensors;
+
+static const int WIDTH = 176;
+static const int HEIGHT = 144;
+
+static double GetTimeSec()
+{
+	timeval t;
+	gettimeofday(&t, 0);
+	return t.tv_sec + 1e-6*t.tv_usec;
+}
+
+/// The former GetCalibratedXYMatlab() of the undistorted z image
+static void BackProjectReference(const cv::Mat& undistortedData, const cv::Mat& intrinsicMatrix, cv::Mat& cartesianImage)
+{
+	for (int row=0; row<HEIGHT; row++)
+	{
+		const float* zCalibratedPtr = undistortedData.ptr<float>(row);
+		float* f_ptr = cartesianImage.ptr<float>(row);
+		for (int col=0; col<WIDTH; col++)
+		{
+			float z = zCalibratedPtr[col]*1000;
+			double fx = intrinsicMatrix.at<double>(0, 0);
+			double fy = intrinsicMatrix.at<double>(1, 1);
+			double cx = intrinsicMatrix.at<double>(0, 2);
+			double cy = intrinsicMatrix.at<double>(1, 2);
+			if (fx == 0 || fy == 0)
+			{
+				return;
+			}
+			float x = (float) (z*(col-cx)/fx);
+			float y = (float) (z*(row-cy)/fy);
+
+			f_ptr[3*col] = x/1000;
+			f_ptr[3*col + 1] = y/1000;
+			f_ptr[3*col + 2] = zCalibratedPtr[col];
+		}
+	}
+}
+
+/// Largest difference of two cartesian images
+static double GetMaxError(const cv::Mat& a, const cv::Mat& b)
+{
+	double maxError = 0;
+	for (int row=0; row<HEIGHT; row++)
+	{
+		const float* a_ptr = a.ptr<float>(row);
+		const float* b_ptr = b.ptr<float>(row);
+		for (int i=0; i<3*WIDTH; i++)
+		{
+			maxError = std::max(maxError, (double) fabs(a_ptr[i] - b_ptr[i]));
+		}
+	}
+	return maxError;
+}
+
+/// The former calibration of Swissranger::AcquireImages(), MATLAB method
+static void CalibrateReference(const unsigned short* pixels, const cv::Mat* coeffs, const cv::Mat& intrinsicMatrix,
+	const cv::Mat& undistortMapX, const cv::Mat& undistortMapY, cv::Mat& cartesianImage)
+{
+	// GetCalibratedZMatlab()
+	cv::Mat distortedData(HEIGHT, WIDTH, CV_32FC1);
+	for (int row=0; row<HEIGHT; row++)
+	{
+		float* f_ptr = distortedData.ptr<float>(row);
+		for (int col=0; col<WIDTH; col++)
+		{
+			double c[7] = {coeffs[0].at<double>(row,col), coeffs[1].at<double>(row,col), coeffs[2].at<double>(row,col),
+				coeffs[3].at<double>(row,col), coeffs[4].at<double>(row,col), coeffs[5].at<double>(row,col), coeffs[6].at<double>(row,col)};
+			double y = 0;
+			ipa_Utils::EvaluatePolynomial((double) pixels[WIDTH*row + col], 6, &c[0], &y);
+			f_ptr[col] = (float) y;
+		}
+	}
+
+	cv::Mat undistortedData;
+	cv::remap(distortedData, undistortedData, undistortMapX, undistortMapY, cv::INTER_LINEAR);
+
+	BackProjectReference(undistortedData, intrinsicMatrix, cartesianImage);
+}
+
+int main(int argc, char** argv)
+{
+	std::string directory = (argc > 1) ? argv[1] : "";
+	int iterations = (argc > 2) ? atoi(argv[2]) : 200;
+
+	// z-calibration coefficients
+	cv::Mat coeffs[7];
+	double base[7] = {0.02, 7.6e-5, 2e-10, -3e-15, 1e-20, -2e-25, 1e-30};
+	for (int k=0; k<7; k++)
+	{
+		if (!directory.empty())
+		{
+			char filename[32];
+			sprintf(filename, "ZCoeffsA%d.xml", k);
+			CvMat* c_mat = (CvMat*)cvLoad((directory + "MatlabCalibrationData/PMD/" + filename).c_str());
+			if (!c_mat)
+			{
+				std::cerr << "ERROR - tof_calibration_benchmark:" << std::endl;
+				std::cerr << "\t ... Error while loading " << directory + "MatlabCalibrationData/PMD/" + filename << std::endl;
+				return 1;
+			}
+			coeffs[k] = cv::Mat(c_mat).clone();
+			cvReleaseMat(&c_mat);
+		}
+		else
+		{
+			// +-2.5% radial variation, like the vignetting of the illumination
+			coeffs[k].create(HEIGHT, WIDTH, CV_64FC1);
+			for (int row=0; row<HEIGHT; row++)
+			{
+				for (int col=0; col<WIDTH; col++)
+				{
+					double dx = (col - 0.5*WIDTH) / WIDTH;
+					double dy = (row - 0.5*HEIGHT) / HEIGHT;
+					coeffs[k].at<double>(row, col) = base[k] * (1.025 - 0.1*(dx*dx + dy*dy));
+				}
+			}
+		}
+	}
+
+	// intrinsics and radial distortion of a SR-3000
+	cv::Mat intrinsicMatrix = (cv::Mat_<double>(3, 3) << 250., 0., 88.3, 0., 251., 71.7, 0., 0., 1.);
+	cv::Mat distortionCoeffs = (cv::Mat_<double>(1, 4) << -0.3, 0.1, 0., 0.);
+	cv::Mat undistortMapX, undistortMapY;
+	cv::initUndistortRectifyMap(intrinsicMatrix, distortionCoeffs, cv::Mat(), intrinsicMatrix,
+		cv::Size(WIDTH, HEIGHT), CV_32FC1, undistortMapX, undistortMapY);
+
+	// raw depth of a tilted wall with a round object in front of it, about 1.5 to 4 m
+	std::vector<unsigned short> pixels(WIDTH*HEIGHT);
+	for (int row=0; row<HEIGHT; row++)
+	{
+		for (int col=0; col<WIDTH; col++)
+		{
+			double dx = (col - 0.6*WIDTH) / (0.2*WIDTH);
+			double dy = (row - 0.5*HEIGHT) / (0.2*HEIGHT);
+			double raw = 40000. + 10000.*col/WIDTH - 20000.*exp(-(dx*dx + dy*dy));
+			pixels[WIDTH*row + col] = (unsigned short) raw;
+		}
+	}
+
+	cv::Mat referenceImage(HEIGHT, WIDTH, CV_32FC3);
+	cv::Mat fusedImage(HEIGHT, WIDTH, CV_32FC3);
+
+	double t0 = GetTimeSec();
+	for (int i=0; i<iterations; i++)
+	{
+		CalibrateReference(&pixels[0], coeffs, intrinsicMatrix, undistortMapX, undistortMapY, referenceImage);
+	}
+	double t1 = GetTimeSec();
+
+	RayTable rayTable;
+	ToFCalibration calibration;
+	if ((rayTable.Init(intrinsicMatrix, cv::Size(WIDTH, HEIGHT)) & RET_FAILED) ||
+		(calibration.Init(coeffs, rayTable, undistortMapX, undistortMapY) & RET_FAILED))
+	{
+		return 1;
+	}
+	double t2 = GetTimeSec();
+	for (int i=0; i<iterations; i++)
+	{
+		calibration.GetCalibratedXYZ(&pixels[0], (char*) fusedImage.data, fusedImage.step);
+	}
+	double t3 = GetTimeSec();
+
+	// back-projection of an undistorted z image alone
+	cv::Mat zImage(HEIGHT, WIDTH, CV_32FC1);
+	for (int row=0; row<HEIGHT; row++)
+	{
+		for (int col=0; col<WIDTH; col++)
+		{
+			zImage.at<float>(row, col) = referenceImage.at<cv::Vec3f>(row, col)[2];
+		}
+	}
+	cv::Mat referenceXYZ(HEIGHT, WIDTH, CV_32FC3);
+	cv::Mat rayTableXYZ(HEIGHT, WIDTH, CV_32FC3);
+
+	double t4 = GetTimeSec();
+	for (int i=0; i<iterations; i++)
+	{
+		BackProjectReference(zImage, intrinsicMatrix, referenceXYZ);
+	}
+	double t5 = GetTimeSec();
+	for (int i=0; i<iterations; i++)
+	{
+		for (int row=0; row<HEIGHT; row++)
+		{
+			rayTable.GetXYZ(row, zImage.ptr<float>(row), rayTableXYZ.ptr<float>(row));
+		}
+	}
+	double t6 = GetTimeSec();
+
+	printf("per-pixel calibration   %8.3f ms per image\n", 1000*(t1-t0)/iterations);
+	printf("ToFCalibration          %8.3f ms per image (setup %.1f ms)\n", 1000*(t3-t2)/iterations, 1000*(t2-t1));
+	printf("largest difference      %8.2g m\n", GetMaxError(referenceImage, fusedImage));
+	printf("per-pixel back-projection %6.3f ms per image\n", 1000*(t5-t4)/iterations);
+	printf("RayTable back-projection  %6.3f ms per image\n", 1000*(t6-t5)/iterations);
+	printf("largest difference      %8.2g m\n", GetMaxError(referenceXYZ, rayTableXYZ));
+
+	return 0;
+}
@@ -228,18 +228,53 @@ public:
 	}
 
 	/// Enables the user to modify camera parameters.
+	/// The intrinsics and distortion are passed to the tof camera, which
+	/// rebuilds its undistortion maps and ray table.
 	/// @param req Requested camera parameters
 	/// @param rsp Response, telling if requested parameters have been set
 	/// @return <code>True</code>
 	bool setCameraInfo(sensor_msgs::SetCameraInfo::Request& req,
                     sensor_msgs::SetCameraInfo::Response& rsp)
 	{
-		/// TODO: Enable the setting of intrinsic parameters
-		camera_info_msg_ = req.camera_info;
+		boost::mutex::scoped_lock lock(service_mutex_);
+		const sensor_msgs::CameraInfo& camera_info = req.camera_info;
+
+		if (camera_info.width != camera_info_msg_.width || camera_info.height != camera_info_msg_.height)
+		{
+			rsp.success = false;
+			rsp.status_message = "[tof_camera] Image size of camera info does not match tof camera resolution";
+			return true;
+		}
+
+		cv::Mat intrinsic_mat(3, 3, CV_64FC1);
+		for (int i=0; i<9; i++)
+		{
+			intrinsic_mat.at<double>(i/3, i%3) = camera_info.K[i];
+		}
+		cv::Mat distortion_mat;
+		if (camera_info.D.size() > 0)
+		{
+			distortion_mat.create(1, camera_info.D.size(), CV_64FC1);
+			for (unsigned int i=0; i<camera_info.D.size(); i++)
+			{
+				distortion_mat.at<double>(0, i) = camera_info.D[i];
+			}
+		}
+
+		cv::Mat distortion_map_X;
+		cv::Mat distortion_map_Y;
+		cv::initUndistortRectifyMap(intrinsic_mat, distortion_mat, cv::Mat(), intrinsic_mat,
+			cv::Size(camera_info.width, camera_info.height), CV_32FC1, distortion_map_X, distortion_map_Y);
+		if (tof_camera_->SetIntrinsics(intrinsic_mat, distortion_map_X, distortion_map_Y) & ipa_Utils::RET_FAILED)
+		{
+			rsp.success = false;
+			rsp.status_message = "[tof_camera] Could not set intrinsic parameters";
+			return true;
+		}
 
-		rsp.success = false;
-		rsp.status_message = "[tof_camera] Setting camera parameters through ROS not implemented";
+		camera_info_msg_ = camera_info;
 
+		rsp.success = true;
 		return true;
 	}
 
@@ -71,6 +71,8 @@
 #include <opencv/cv.h>
 #include <opencv/highgui.h>
 
+#include <cob_camera_sensors/RayTable.h>
+
 using namespace message_filters;
 
 typedef sync_policies::ApproximateTime<sensor_msgs::PointCloud2, sensor_msgs::CameraInfo> SyncPolicy;
@@ -87,6 +89,8 @@ private:
 	message_filters::Synchronizer<SyncPolicy> sub_sync_;
 	ros::Publisher pub_pc2_;
 
+	ipa_CameraSensors::RayTable ray_table_;	///< Rays of the undistorted image, rebuilt when the camera info changes
+
 public:
 	UndistortTOF(const ros::NodeHandle& node_handle)
 	: node_handle_(node_handle),
@@ -99,47 +103,6 @@ public:
 		pub_pc2_ = node_handle_.advertise<sensor_msgs::PointCloud2>("point_cloud_undistorted", 1);
 	  }
 
-	// Return value is in m
-	unsigned long GetCalibratedZSwissranger(int u, int v, int width, float& zCalibrated)
-	{
-		//zCalibrated = (float) m_Z[v*width + u];
-
-		//return RET_OK;
-	}
-
-	// u and v are assumed to be distorted coordinates
-	unsigned long GetCalibratedXYMatlab(int u, int v, float z, float& x, float& y)
-	{
-		// Use intrinsic camera parameters
-		/*double fx, fy, cx, cy;
-
-		fx = m_intrinsicMatrix.at<double>(0, 0);
-		fy = m_intrinsicMatrix.at<double>(1, 1);
-
-		cx = m_intrinsicMatrix.at<double>(0, 2);
-		cy = m_intrinsicMatrix.at<double>(1, 2);
-
-		// Fundamental equation: u = (fx*x)/z + cx
-		if (fx == 0)
-		{
-			std::cerr << "ERROR - Swissranger::GetCalibratedXYZ:" << std::endl;
-			std::cerr << "\t ... fx is 0.\n";
-			return RET_FAILED;
-		}
-		x = (float) (z*(u-cx)/fx) ;
-
-		// Fundamental equation: v = (fy*y)/z + cy
-		if (fy == 0)
-		{
-			std::cerr << "ERROR - Swissranger::GetCalibratedXYZ:" << std::endl;
-			std::cerr << "\t ... fy is 0.\n";
-			return RET_FAILED;
-		}
-		y = (float) (z*(v-cy)/fy);
-
-		return RET_OK;*/
-	}
-
 	//void Undistort(const sensor_msgs::PointCloud2ConstPtr& tof_camera_data, const sensor_msgs::CameraInfoConstPtr& camera_info)
 	void Undistort(const boost::shared_ptr<sensor_msgs::PointCloud2 const>& tof_camera_data, const sensor_msgs::CameraInfoConstPtr& camera_info)
 	{
@@ -197,30 +160,29 @@ public:
 
 		sensor_msgs::PointCloud2 pc_pub = *(tof_camera_data.get());
 		// Calculate X and Y based on instrinsic rotation and translation
-		double fx, fy, cx, cy;
-
-		fx = cam_matrix.at<double>(0,0);
-		fy = cam_matrix.at<double>(1, 1);
-
-		cx = cam_matrix.at<double>(0, 2);
-		cy = cam_matrix.at<double>(1, 2);
-
-
-		for (size_t d = 0; d < pc_pub.fields.size(); ++d)
+		cv::Size image_size(pc_pub.width, pc_pub.height);
+		if (!ray_table_.IsInitialized(cam_matrix, image_size))
 		{
+			if (ray_table_.Init(cam_matrix, image_size) & ipa_CameraSensors::RET_FAILED)
+			{
+				ROS_ERROR("[undistort_tof] Could not build ray table from camera info");
+				return;
+			}
 		}
+
 		for(unsigned int row=0; row<pc_pub.height; row++)
 		{
 			float* z =  z_image_undistorted.ptr<float>(row);
-			//f_ptr = (float*)(cartesianImageData + row*widthStepCartesianImage);
+			const float* rays = ray_table_.GetRays(row);
 
 			for (unsigned int col=0; col<pc_pub.width; col++)
 			{
-				memcpy(&pc_pub.data[row * col * pc_pub.point_step + z_offset], &z[col], sizeof(float));
-				float x = (float) (z[col]*(col-cx)/fx);
-				float y =  (float) (z[col]*(row-cy)/fy);
-				memcpy(&pc_pub.data[row * col * pc_pub.point_step + x_offset], &x, sizeof(float));
-				memcpy(&pc_pub.data[row * col * pc_pub.point_step + y_offset], &y, sizeof(float));
+				unsigned char* point = &pc_pub.data[row * pc_pub.row_step + col * pc_pub.point_step];
+				float x = z[col]*rays[2*col];
+				float y = z[col]*rays[2*col + 1];
+				memcpy(point + z_offset, &z[col], sizeof(float));
+				memcpy(point + x_offset, &x, sizeof(float));
+				memcpy(point + y_offset, &y, sizeof(float));
 			}
 		}
 		pub_pc2_.publish(pc_pub);
@@ -60,8 +60,11 @@
 //-----------------------------------------------
 #include <cob_canopen_motor/CanDriveItf.h>
 #include <cob_utilities/TimeStamp.h>
+#include <boost/function.hpp>
 
 #include <cob_canopen_motor/SDOSegmented.h>
+#include <cob_canopen_motor/SDOClient.h>
+#include <cob_canopen_motor/VelocityEstimator.h>
 #include <cob_canopen_motor/ElmoRecorder.h>
 //-----------------------------------------------
 
@@ -110,7 +113,7 @@ public:
 	/**
 	 * Sets the CAN interface.
 	 */
-	void setCanItf(CanItf* pCanItf){ m_pCanCtrl = pCanItf; }
+	void setCanItf(CanItf* pCanItf){ m_pCanCtrl = pCanItf; m_SDOClient.setCanItf(pCanItf); }
 
 	/**
 	 * Initializes the driver.
@@ -238,10 +241,27 @@ public:
 	 */
 	void getGearPosRad(double* pdPosGearRad);
 
+	/**
+	 * Returns the velocity and the acceleration estimated from the positions sampled at the SYNC msgs.
+	 * Compared to the velocity measured by the drive it has no delay of the velocity
+	 * measurement period and gives the acceleration, too.
+	 * @param pdVelGearRadS estimated velocity
+	 * @param pdAccGearRadS2 estimated acceleration
+	 */
+	void getGearVelAccEstim(double* pdVelGearRadS, double* pdAccGearRadS2);
+
+	/**
+	 * Returns the position and the velocity as received from the drive, i.e. unconverted.
+	 * Used to convert the values of all drives at once with a DriveConversionBatch.
+	 * @param piPosMotIncr position in encoder increments
+	 * @param piVelMotIncrPeriod velocity in encoder increments per measurement period
+	 */
+	void getPosVelMotIncr(int* piPosMotIncr, int* piVelMotIncrPeriod);
+
 	/**
 	 * Sets the drive parameter.
 	 */
-	void setDriveParam(DriveParam driveParam) { m_DriveParam = driveParam; }
+	void setDriveParam(DriveParam driveParam);
 
 	/**
 	 * Returns true if an error has been detected.
@@ -298,6 +318,11 @@ public:
 	 * @param iRxSDO receive service data object
 	 */
 	void setCanOpenParam( int iTxPDO1, int iTxPDO2, int iRxPDO2, int iTxSDO, int iRxSDO);
+
+	/**
+	 * Returns the CAN identifiers set by setCanOpenParam().
+	 */
+	const ParamCanOpenType& getCanOpenParam() const { return m_ParamCanOpen; }
 	
 	/**
 	 * Sends an integer value to the Harmonica using the built in interpreter.
@@ -348,8 +373,13 @@ public:
 	 * 0: Configure the Recorder to record the sources Main Speed(1), Main position(2), Active current(10), Speed command(16). With iParam = iRecordingGap you specify every which time quantum (4*90usec) a new data point (of 1024 points in total) is recorded; 
 	 * 1: Query Upload of recorded source (1=Main Speed, 2=Main position, 10=Active Current, 16=Speed command) with iParam and log data to file sParam = file prefix. Filename is extended with _MotorNumber_RecordedSource.log
 	 * 2: Request status of ongoing readout process
+	 * 3: Pace the block upload of following readouts: iParam > 0 sets the number of segments per block (1..127) and holds back the confirmation of every block until it is released with flag 4. iParam = 0 confirms every block immediately with 127 segments per block (default).
+	 * 4: Release the held back confirmation of the current block, the device sends the next block
+	 * 5: Select the log format of following readouts with iParam: 1 = text logfile (.log), 2 = binary trace file (.trace, default), 3 = both
+	 * 6: Request the result of the last readout, once flag 2 returns 0
 	 * 99: Abort and clear current SDO readout process
-	 * @return 0: Success, 1: Recorder hasn't been configured yet, 2: data collection still in progress
+	 * @return 0: Success, 1: Recorder hasn't been configured yet, 2: data collection still in progress (flag 4: no block is waiting for its confirmation)
+	 * (flag 6: ElmoRecorder::UploadResult)
 	 *
 	*/
 	int setRecorder(int iFlag, int iParam = 0, std::string sParam = "/home/MyLog_");
@@ -367,6 +397,15 @@ public:
 	 * CANopen: Uploads a service data object (device to master). (in expedited transfer mode, means in only one message)
 	 */
 	void sendSDOUpload(int iObjIndex, int iObjSub);
+
+	/**
+	 * CANopen: Requests a block upload (CiA 301 block transfer) of a service data object. The device sends up to iBlockSize segments
+	 * of 7 bytes before it waits for a confirmation, instead of one confirmation per segment in the segmented transfer.
+	 * If the device rejects the block upload, the object is requested again with the segmented transfer.
+	 * The data is collected in the SDOSegmented container like a segmented upload.
+	 * The number of segments per block is set with setRecorder(3, ..).
+	 */
+	void sendSDOBlockUpload(int iObjIndex, int iObjSub);
 	
     /**
 	 * CANopen: This protocol cancels an active segmented transmission due to the given Error Code
@@ -377,6 +416,69 @@ public:
 	 * CANopen: Downloads a service data object (master to device). (in expedited transfer mode, means in only one message)
 	 */
 	void sendSDODownload(int iObjIndex, int iObjSub, int iData);
+
+	/**
+	 * CANopen: Client for tracked SDO requests with completion callbacks, timeouts and retries.
+	 * Its requests are sent by evalReceivedMsg() one after the other as soon as the previous reply arrived,
+	 * but not while a segmented or block upload uses the SDO channel.
+	 */
+	SDOClient& getSDOClient() { return m_SDOClient; }
+
+	/**
+	 * Reads the CAN bus until all requests of the SDO client have completed, instead of a fixed delay.
+	 * Messages of other nodes received meanwhile are dropped, so use it during initialization only.
+	 * @return false if a request failed or the requests didn't complete within dTimeoutSec (they are cancelled then)
+	 */
+	bool waitForSDOClient(double dTimeoutSec);
+
+	/**
+	 * Uploads the statusword (0x6041) and waits for it with waitForSDOClient(),
+	 * e.g. to wait until the drive answers SDOs again after start() instead of a fixed delay.
+	 * @param piStatusword the statusword, if not NULL
+	 * @return false if the drive didn't answer within dTimeoutSec
+	 */
+	bool waitForStatusword(double dTimeoutSec, int* piStatusword = NULL);
+
+	/**
+	 * Sends the next request of the SDO client and checks its timeouts (also done by evalReceivedMsg()).
+	 */
+	void updateSDOClient();
+
+	/**
+	 * Queues the configuration of the watchdog at the SDO client and returns immediately.
+	 * startWatchdog() does the same and waits for the replies.
+	 */
+	void requestWatchdog(bool bStarted);
+
+	/**
+	 * State of the non-blocking bring-up, see beginBringUp()
+	 */
+	enum BringUpState
+	{
+		BRINGUP_IDLE,
+		BRINGUP_RUNNING,
+		BRINGUP_DONE,
+		BRINGUP_FAILED
+	};
+
+	/**
+	 * Starts the initialization and start of the drive like init() and start(), but without blocking:
+	 * every call of updateBringUp() sends the next commands as soon as the previous step is done,
+	 * meanwhile the received CAN messages have to be passed to evalReceivedMsg(). So all drives of a bus can be brought up at the same time.
+	 * @param bInit true: init() and start(), false: start() only
+	 */
+	void beginBringUp(bool bInit = true);
+
+	/**
+	 * Advances the bring-up, call it cyclically after the received CAN messages have been evaluated.
+	 * @return BringUpState
+	 */
+	int updateBringUp();
+
+	/**
+	 * @return duration of the last successful bring-up in sec
+	 */
+	double getBringUpDuration() { return m_dBringUpDurationSec; }
 	
 	/**
 	 * CANopen: Evaluates a service data object and gives back object and sub-object ID
@@ -387,6 +489,33 @@ public:
 	 * Internal use.
 	 */
 	int getSDODataInt32(CanMsg& CMsg);
+
+	/**
+	 * Replies of the binary interpreter known to evalReceivedMsg(), all others count as INTPRT_UNKNOWN.
+	 */
+	enum IntprtReply
+	{
+		INTPRT_UNKNOWN,
+		INTPRT_PX, INTPRT_PA, INTPRT_JV, INTPRT_BG, INTPRT_UM, INTPRT_IP, INTPRT_SR,
+		INTPRT_MF, INTPRT_PM, INTPRT_AC, INTPRT_DC, INTPRT_HM, INTPRT_IQ,
+		INTPRT_NUM_REPLIES
+	};
+
+	/**
+	 * Receives the replies of the binary interpreter, e.g. to print them for debugging.
+	 * It is called within evalReceivedMsg(), so it should return quickly.
+	 */
+	typedef boost::function<void (int iDriveIdent, char cCmdChar1, char cCmdChar2, int iData)> IntprtTraceSink;
+
+	/**
+	 * Sets the trace sink of the binary interpreter replies, an empty function disables the trace (default).
+	 */
+	void setIntprtTraceSink(IntprtTraceSink sink) { m_IntprtTraceSink = sink; }
+
+	/**
+	 * @return number of received replies of type iReply (IntprtReply)
+	 */
+	unsigned int getIntprtReplyCount(int iReply) const;
 	
     
 protected:
@@ -398,7 +527,6 @@ protected:
 
 	// ------------------------- Variables
 	CanItf* m_pCanCtrl;
-	CanMsg m_CanMsgLast;
 
 	ElmoRecorder* ElmoRec;
 
@@ -408,19 +536,20 @@ protected:
 
 	TimeStamp m_CurrentTime;
 	TimeStamp m_WatchdogTime;
-	TimeStamp m_VelCalcTime;
+	TimeStamp m_SyncTime;
 	TimeStamp m_FailureStartTime;
 	TimeStamp m_SendTime;
 	TimeStamp m_StartTime;
 
 	double m_dAngleGearRadMem;
-	double m_dVelGearMeasRadS;
-	double m_dPosGearMeasRad;
+	int m_iPosMotIncrMeas;
+	int m_iVelMotIncrPeriodMeas;
 
 	bool m_bLimSwLeft;
 	bool m_bLimSwRight;
 
-	double m_dOldPos;
+	VelocityEstimator m_VelEstimator;
+	bool m_bSyncPending;
 
 	std::string m_sErrorMessage;
 
@@ -443,12 +572,77 @@ protected:
 
 	segData seg_Data;
 
+	SDOClient m_SDOClient;
+
+	/**
+	 * Segments per block of SDO block uploads
+	 */
+	int m_iSDOBlockSize;
+
+	/**
+	 * Hold back the confirmation of every block until setRecorder(4) releases it
+	 */
+	bool m_bSDOBlockAckHold;
+
+
+	unsigned int m_iIntprtReplyCount[INTPRT_NUM_REPLIES];
+	IntprtTraceSink m_IntprtTraceSink;
+	int m_iIntprtPosCnt;
+	bool m_bStatusOk;
+
+	// steps of the bring-up
+	enum
+	{
+		BRINGUP_STEP_INIT = 0,
+		BRINGUP_STEP_START = 10
+	};
+	int m_iBringUpState;
+	int m_iBringUpStep;
+	TimeStamp m_BringUpStartTime;
+	TimeStamp m_BringUpStepTime;
+	double m_dBringUpWaitSec;
+	unsigned int m_iBringUpReplyCount;
+	unsigned int m_iBringUpSDOFailed;
+	double m_dBringUpDurationSec;
+
 
 	// ------------------------- Member functions
-	double estimVel(double dPos);
+	void sendSync();
 
 	bool evalStatusRegister(int iStatus);
 	void evalMotorFailure(int iFailure);
+
+	/**
+	 * Commands of setTypeMotion(MOTIONTYPE_VELCTRL), without the delay after them.
+	 */
+	void sendTypeMotionVelCtrl();
+
+	/**
+	 * Queues the mapping of position and velocity to TPDO1 at the SDO client.
+	 */
+	void requestPDOMapping();
+
+	void nextBringUpStep(double dWaitSec);
+	int failBringUp(const char* pcReason);
+
+	/**
+	 * Handlers of the binary interpreter replies, iData is the 32 bit value of the reply (bytes 4..7).
+	 */
+	typedef void (CanDriveHarmonica::*IntprtReplyHandler)(int iData);
+	static const IntprtReplyHandler s_IntprtReplyHandler[INTPRT_NUM_REPLIES];
+
+	/**
+	 * Maps the command characters of a reply to its IntprtReply.
+	 */
+	static int getIntprtReply(int iCmdChar1, int iCmdChar2);
+
+	void evalIntprtIgnore(int iData);
+	void evalIntprtPosCnt(int iData);
+	void evalIntprtDigIn(int iData);
+	void evalIntprtStatus(int iData);
+	void evalIntprtFailure(int iData);
+	void evalIntprtHoming(int iData);
+	void evalIntprtMotorCurrent(int iData);
 	
 	int m_iPartnerDriveRatio;
 	int m_iDistSteerAxisToDriveWheelMM;
@@ -498,6 +692,35 @@ protected:
 	 */
 	void finishedSDOSegmentedTransfer();
 
+	/**
+	 * CANopen: Block upload initiated by the device, it contains the number of bytes to be uploaded.
+	 * Function is called by evalReceivedMsg. Reserves the receive buffer and requests the first block.
+	 * @see sendSDOBlockUpload()
+	 */
+	int receivedSDOBlockInitiation(CanMsg& msg);
+
+	/**
+	 * CANopen: Segment of a block upload. Segments out of sequence are dropped, the device repeats them after the confirmation of the block.
+	 * Function is called by evalReceivedMsg. Confirms the block after its last segment with sendSDOBlockAck().
+	 */
+	int receivedSDOBlockSegment(CanMsg& msg);
+
+	/**
+	 * CANopen: End of a block upload, removes the unused bytes of the last segment, checks the CRC and passes the data to finishedSDOSegmentedTransfer().
+	 * Function is called by evalReceivedMsg.
+	 */
+	int receivedSDOBlockEnd(CanMsg& msg);
+
+	/**
+	 * CANopen: Confirms the segments of the current block up to the last one received in sequence and sets the size of the next block.
+	 */
+	void sendSDOBlockAck();
+
+	/**
+	 * CRC over the uploaded data as used by the SDO block transfer (CRC-16-CCITT, polynomial 0x1021, start value 0).
+	 */
+	static unsigned short calcSDOBlockCRC(const std::vector<unsigned char>& data);
+
 };
 //-----------------------------------------------
 #endif
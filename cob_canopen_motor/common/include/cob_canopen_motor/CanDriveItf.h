@@ -78,6 +78,11 @@ public:
 		MOTIONTYPE_POSCTRL
 	};
 
+	/**
+	 * The drives are deleted through the interface.
+	 */
+	virtual ~CanDriveItf() {}
+
 	/**
 	 * Sets the CAN interface.
 	 */
@@ -0,0 +1,126 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Batch conversion of the measurements of all drives of a platform.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef DRIVECONVERSION_INCLUDEDEF_H
+#define DRIVECONVERSION_INCLUDEDEF_H
+
+//-----------------------------------------------
+#include <vector>
+
+#include <cob_canopen_motor/DriveParam.h>
+
+//-----------------------------------------------
+
+/**
+ * Converts the measurements of all drives of a platform at once.
+ * The conversion factors (including the signs) of the drives are stored in arrays,
+ * so the conversion of the PDOs of one CAN cycle is a single loop the compiler can vectorize.
+ */
+class DriveConversionBatch
+{
+public:
+	/**
+	 * Removes all drives.
+	 */
+	void clear()
+	{
+		m_vdPosMotIncrToPosGearRad.clear();
+		m_vdVelMotIncrPeriodToVelGearRadS.clear();
+	}
+
+	/**
+	 * Adds a drive.
+	 * @return index of the drive in the arrays passed to the conversions
+	 */
+	int add(const DriveParam& param)
+	{
+		m_vdPosMotIncrToPosGearRad.push_back(param.getPosMotIncrToPosGearRadSign());
+		m_vdVelMotIncrPeriodToVelGearRadS.push_back(param.getVelMotIncrPeriodToVelGearRadSSign());
+		return (int)m_vdPosMotIncrToPosGearRad.size() - 1;
+	}
+
+	/**
+	 * Returns the number of drives.
+	 */
+	int size() const { return (int)m_vdPosMotIncrToPosGearRad.size(); }
+
+	/**
+	 * Converts the positions and velocities of all drives.
+	 * All arrays have size() elements.
+	 * @param piPosMotIncr positions in encoder increments
+	 * @param piVelMotIncrPeriod velocities in encoder increments per measurement period
+	 * @param pdPosGearRad converted positions in rad
+	 * @param pdVelGearRadS converted velocities in rad/s
+	 */
+	void convertPosVel(const int* piPosMotIncr, const int* piVelMotIncrPeriod,
+		double* pdPosGearRad, double* pdVelGearRadS) const
+	{
+		int iNum = size();
+		if(iNum == 0)
+			return;
+
+		const double* pdPosFactor = &m_vdPosMotIncrToPosGearRad[0];
+		const double* pdVelFactor = &m_vdVelMotIncrPeriodToVelGearRadS[0];
+
+		for(int i = 0; i < iNum; i++)
+			pdPosGearRad[i] = piPosMotIncr[i] * pdPosFactor[i];
+
+		for(int i = 0; i < iNum; i++)
+			pdVelGearRadS[i] = piVelMotIncrPeriod[i] * pdVelFactor[i];
+	}
+
+private:
+	std::vector<double> m_vdPosMotIncrToPosGearRad;
+	std::vector<double> m_vdVelMotIncrPeriodToVelGearRadS;
+};
+
+//-----------------------------------------------
+#endif
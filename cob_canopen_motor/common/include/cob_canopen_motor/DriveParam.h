@@ -84,6 +84,34 @@ private:
     double m_dCurrToTorque;		// factor to convert motor active current [A] into torque [Nm]
 	double m_dCurrMax;		// max. current allowed
 
+	// conversion factors, calculated once by setParam()
+	double m_dPosMotIncrToPosGearRad;
+	double m_dVelGearRadSToVelMotIncrPeriod;
+	double m_dVelMotIncrPeriodToVelGearRadS;
+	// the same including the sign of the motion direction
+	double m_dPosMotIncrToPosGearRadSign;
+	double m_dVelGearRadSToVelMotIncrPeriodSign;
+	double m_dVelMotIncrPeriodToVelGearRadSSign;
+
+	/**
+	 * Precalculates the conversion factors from the gear parameters and the sign.
+	 */
+	void calcConversionFactors()
+	{
+		double dPI = 3.14159265358979323846;
+
+		m_dPosGearRadToPosMotIncr = m_iEncIncrPerRevMot * m_dGearRatio
+			* m_dBeltRatio / (2. * dPI);
+
+		m_dPosMotIncrToPosGearRad = 1.0 / m_dPosGearRadToPosMotIncr;
+		m_dVelGearRadSToVelMotIncrPeriod = m_dPosGearRadToPosMotIncr / m_dVelMeasFrqHz;
+		m_dVelMotIncrPeriodToVelGearRadS = m_dVelMeasFrqHz / m_dPosGearRadToPosMotIncr;
+
+		m_dPosMotIncrToPosGearRadSign = m_iSign * m_dPosMotIncrToPosGearRad;
+		m_dVelGearRadSToVelMotIncrPeriodSign = m_iSign * m_dVelGearRadSToVelMotIncrPeriod;
+		m_dVelMotIncrPeriodToVelGearRadSSign = m_iSign * m_dVelMotIncrPeriodToVelGearRadS;
+	}
+
 public:
 
 	/**
@@ -93,7 +121,13 @@ public:
 	{
 	
 		m_bIsSteer = true; //has to be set, because it is checked for absolute / relative positioning
-	
+
+		m_iEncIncrPerRevMot = 1;
+		m_dVelMeasFrqHz = 1;
+		m_dGearRatio = 1;
+		m_dBeltRatio = 1;
+		m_iSign = 1;
+		calcConversionFactors();
 	}
 
 	/**
@@ -132,10 +166,7 @@ public:
 		
 		m_iHomingDigIn = 11; //for Cob3
 		
-		double dPI = 3.14159265358979323846;
-
-		m_dPosGearRadToPosMotIncr = m_iEncIncrPerRevMot * m_dGearRatio
-			* m_dBeltRatio / (2. * dPI);
+		calcConversionFactors();
 	}
 
 	//Overloaded Method for CoB3
@@ -169,10 +200,7 @@ public:
 		
 		m_iHomingDigIn = 11; //for Cob3
 
-		double dPI = 3.14159265358979323846;
-
-		m_dPosGearRadToPosMotIncr = m_iEncIncrPerRevMot * m_dGearRatio
-			* m_dBeltRatio / (2. * dPI);
+		calcConversionFactors();
 
         m_dCurrToTorque = dCurrToTorque;
 		m_dCurrMax = dCurrMax;
@@ -208,10 +236,7 @@ public:
 		m_iEncOffsetIncr = iEncOffsetIncr;
 		m_bIsSteer = bIsSteer;
 
-		double dPI = 3.14159265358979323846;
-
-		m_dPosGearRadToPosMotIncr = m_iEncIncrPerRevMot * m_dGearRatio
-			* m_dBeltRatio / (2. * dPI);
+		calcConversionFactors();
 
         m_dCurrToTorque = dCurrToTorque;
 		m_dCurrMax = dCurrMax;
@@ -237,7 +262,7 @@ public:
 	/**
 	 * Gets the maximum velocity of the drive in increments per second.
 	 */
-	double getVelMax()
+	double getVelMax() const
 	{
 		return m_dVelMaxEncIncrS;
 	}
@@ -281,20 +306,47 @@ public:
 	/// Conversions of encoder increments to gear position in radians.
 	double PosMotIncrToPosGearRad(int iPosIncr)
 	{
-		return ((double)iPosIncr / m_dPosGearRadToPosMotIncr);
+		return ((double)iPosIncr * m_dPosMotIncrToPosGearRad);
 	}
 	
 	/// Conversions of gear velocity in rad/s to encoder increments per measurment period.
 	int VelGearRadSToVelMotIncrPeriod(double dVelGearRadS)
 	{
-		return ((int)(dVelGearRadS * m_dPosGearRadToPosMotIncr / m_dVelMeasFrqHz));
+		return ((int)(dVelGearRadS * m_dVelGearRadSToVelMotIncrPeriod));
 	}
 	
 	/// Conversions of  encoder increments per measurment period to gear velocity in rad/s.
 	double VelMotIncrPeriodToVelGearRadS(int iVelMotIncrPeriod)
 	{
-		return ((double)iVelMotIncrPeriod / m_dPosGearRadToPosMotIncr * m_dVelMeasFrqHz);
+		return ((double)iVelMotIncrPeriod * m_dVelMotIncrPeriodToVelGearRadS);
+	}
+
+	/// Conversion of encoder increments to gear position in radians, including the sign of the motion direction.
+	double PosMotIncrToPosGearRadSign(int iPosIncr) const
+	{
+		return ((double)iPosIncr * m_dPosMotIncrToPosGearRadSign);
 	}
+
+	/// Conversion of gear velocity in rad/s to encoder increments per measurement period, including the sign.
+	int VelGearRadSToVelMotIncrPeriodSign(double dVelGearRadS) const
+	{
+		return ((int)(dVelGearRadS * m_dVelGearRadSToVelMotIncrPeriodSign));
+	}
+
+	/// Conversion of encoder increments per measurement period to gear velocity in rad/s, including the sign.
+	double VelMotIncrPeriodToVelGearRadSSign(int iVelMotIncrPeriod) const
+	{
+		return ((double)iVelMotIncrPeriod * m_dVelMotIncrPeriodToVelGearRadSSign);
+	}
+
+	/// Factor of PosMotIncrToPosGearRadSign().
+	double getPosMotIncrToPosGearRadSign() const { return m_dPosMotIncrToPosGearRadSign; }
+
+	/// Factor of VelGearRadSToVelMotIncrPeriodSign().
+	double getVelGearRadSToVelMotIncrPeriodSign() const { return m_dVelGearRadSToVelMotIncrPeriodSign; }
+
+	/// Factor of VelMotIncrPeriodToVelGearRadSSign().
+	double getVelMotIncrPeriodToVelGearRadSSign() const { return m_dVelMotIncrPeriodToVelGearRadSSign; }
 	
 	/**
 	 * Set the maximum acceleration.
@@ -116,6 +116,43 @@ class ElmoRecorder {
 		* @param sLogFileprefix Path (to an existing directory!) and file-prefix for the created logfile. It is extended with _MotorNumber_RecordedSource.log
 		*/
 		int setLogFilename(std::string sLogFileprefix);
+
+		enum LogFormat
+		{
+			LOG_TEXT = 1,
+			LOG_BINARY = 2
+		};
+
+		/**
+		* @param iLogFormat Combination of LogFormat: LOG_BINARY writes a binary trace file _MotorNumber_RecordedSource.trace (default, see ElmoTrace.h),
+		* LOG_TEXT writes the text logfile _MotorNumber_RecordedSource.log
+		*/
+		int setLogFormat(int iLogFormat);
+
+		/**
+		* Largest upload of object 0x2030: the header counts the samples in 16 bit, a sample has at most 4 bytes
+		*/
+		enum { MAX_UPLOAD_BYTES = 7 + 4 * 0xFFFF };
+
+		enum UploadResult
+		{
+			UPLOAD_PENDING = 0, /**< read-out requested, the data hasn't been processed yet */
+			UPLOAD_SUCCEEDED = 1, /**< data uploaded and logged */
+			UPLOAD_NO_DATA = 2, /**< the recorder had no finished record to upload */
+			UPLOAD_CRC_ERROR = 3, /**< the CRC of the block upload didn't match, the data has been dropped */
+			UPLOAD_ABORTED = 4, /**< the transfer has been aborted by the device or the master */
+			UPLOAD_WRITE_ERROR = 5 /**< data uploaded, but the log file couldn't be written */
+		};
+
+		/**
+		* @return UploadResult of the last read-out requested with readoutRecorderTry()
+		*/
+		int getUploadResult() { return m_iUploadResult; }
+
+		/**
+		* Called by CanDriveHarmonica if the transfer of the current read-out fails.
+		*/
+		void setUploadResult(int iUploadResult) { m_iUploadResult = iUploadResult; }
 		
 	private:
 		/**
@@ -126,11 +163,18 @@ class ElmoRecorder {
 		float m_fRecordingStepSec;
 		
 		std::string m_sLogFilename;
+
+		int m_iLogFormat;
 		
 		/**
 		* A flag that tells, whether we are waiting for read-out until the confirmation by SR, that the recorder is ready for read-out
 		*/
 		int m_iReadoutRecorderTry;
+
+		/**
+		* UploadResult of the last read-out
+		*/
+		int m_iUploadResult;
 	
 		CanDriveHarmonica* m_pHarmonicaDrive;
 		
@@ -153,8 +197,17 @@ class ElmoRecorder {
 		* After processing the collected Recorder data log it to a file.
 		* @param vtValues[] A 2 x N vector with a time stamp in the first column and the according data point value in teh second
 		* @param filename Path and file-prefix to an existing directory! It is extended with _MotorNumber_RecordedSource.log
+		* @return true if the file has been written completely
 		*/
 		int logToFile(std::string filename, std::vector<float> vtValues[]);
+
+		/**
+		* Log the raw recorder data to a binary trace file.
+		* @param pSamples iNumSamples samples of iSampleType as sent by the drive
+		* @param filename Path and file-prefix to an existing directory! It is extended with _MotorNumber_RecordedSource.trace
+		* @return true if the file has been written completely
+		*/
+		int logToTraceFile(std::string filename, int iSampleType, unsigned int iNumSamples, float fScaleFactor, const unsigned char* pSamples);
 		
 		/**
 		* Convert the 32bit binary representation of a float to an actual 32bit float value
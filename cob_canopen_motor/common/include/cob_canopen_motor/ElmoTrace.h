@@ -0,0 +1,180 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Binary trace files of the ElmoRecorder: writer and reader for fast offline analysis of many recordings.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef _ElmoTrace_H
+#define _ElmoTrace_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Header of an ElmoRecorder trace file.
+ *
+ * File layout, all values little endian:
+ *  Byte 0..3   "ELTR"
+ *  Byte 4..5   format version (1)
+ *  Byte 6..7   sample type (see ElmoTraceFile::SampleType)
+ *  Byte 8..11  drive ID
+ *  Byte 12..15 recorded object (sub index of 0x2030)
+ *  Byte 16..19 number of samples
+ *  Byte 20..23 scale factor (float), value = scale factor * sample
+ *  Byte 24..31 sample period in sec (double), time of sample i = i * sample period
+ *  Byte 32..   raw samples as sent by the drive
+ */
+struct ElmoTraceHeader
+{
+	int iDriveID;
+	int iObject;
+	int iSampleType;
+	unsigned int iNumSamples;
+	float fScaleFactor;
+	double dSamplePeriodSec;
+};
+
+/**
+ * Writes ElmoRecorder trace files.
+ */
+class ElmoTraceFile
+{
+public:
+	enum SampleType
+	{
+		SAMPLE_INT32 = 1,
+		SAMPLE_FLOAT32 = 2,
+		SAMPLE_FLOAT16 = 3
+	};
+
+	static const unsigned int HEADER_SIZE = 32;
+
+	/**
+	 * @return size of one sample in bytes, 0 for an unknown type
+	 */
+	static unsigned int getSampleSize(int iSampleType);
+
+	/**
+	 * Writes a trace file.
+	 * @param pSamples header.iNumSamples raw little endian samples of header.iSampleType
+	 * @return true on success
+	 */
+	static bool write(const std::string& sFilename, const ElmoTraceHeader& header, const unsigned char* pSamples);
+
+	/**
+	 * Converts a raw sample to float, without the scale factor.
+	 */
+	static float decodeSample(int iSampleType, const unsigned char* pSample);
+};
+
+/**
+ * Reads ElmoRecorder trace files.
+ * The file is mapped into memory if possible, otherwise it is read at once.
+ */
+class ElmoTraceReader
+{
+public:
+	ElmoTraceReader();
+	~ElmoTraceReader();
+
+	/**
+	 * Opens a trace file and checks its header.
+	 * @param bMemoryMapped true: map the file, false: read it into a buffer
+	 * @return true on success
+	 */
+	bool open(const std::string& sFilename, bool bMemoryMapped = true);
+
+	void close();
+
+	bool isOpen() const { return m_pData != NULL; }
+
+	const ElmoTraceHeader& getHeader() const { return m_Header; }
+
+	/**
+	 * @return the raw samples, valid until close()
+	 */
+	const unsigned char* getRawSamples() const { return m_pData + ElmoTraceFile::HEADER_SIZE; }
+
+	double getTime(unsigned int iSample) const { return iSample * m_Header.dSamplePeriodSec; }
+
+	/**
+	 * Converts the samples to scaled values.
+	 * @param pfValues array of getHeader().iNumSamples values
+	 */
+	void getValues(float* pfValues) const;
+
+	void getValues(std::vector<float>& vfValues) const;
+
+	/**
+	 * Writes the trace as text, one line "time value" per sample, like the text log of the ElmoRecorder.
+	 * @return true on success
+	 */
+	bool exportToText(const std::string& sFilename) const;
+
+	/**
+	 * Loads many trace files into one column of values.
+	 * The values of file i start at viOffset[i] and end at viOffset[i+1] in vfValues.
+	 * Files which can't be read are reported and left empty.
+	 * @return number of files which have been read
+	 */
+	static int loadTraces(const std::vector<std::string>& vsFilenames, std::vector<ElmoTraceHeader>& vHeaders,
+		std::vector<float>& vfValues, std::vector<unsigned int>& viOffset);
+
+private:
+	ElmoTraceReader(const ElmoTraceReader&);
+	ElmoTraceReader& operator=(const ElmoTraceReader&);
+
+	ElmoTraceHeader m_Header;
+	const unsigned char* m_pData;
+	size_t m_iSize;
+	bool m_bMapped;
+	std::vector<unsigned char> m_vBuffer;
+};
+
+#endif
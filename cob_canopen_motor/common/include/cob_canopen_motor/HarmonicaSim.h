@@ -0,0 +1,158 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Simulated ELMO Harmonica drive for CanSimBus or a vcan interface.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef HARMONICASIM_INCLUDEDEF_H
+#define HARMONICASIM_INCLUDEDEF_H
+
+//-----------------------------------------------
+#include <map>
+#include <vector>
+
+#include <cob_generic_can/CanSimBus.h>
+
+//-----------------------------------------------
+
+/**
+ * Simulated ELMO Harmonica drive, as far as CanDriveHarmonica uses it:
+ * - binary interpreter on RxPDO2: every command is answered on TxPDO2, set commands with
+ *   their echo, get commands (4 bytes, except BG) with the value. MO, UM, JV, SP, PA, PR, BG, PX, SR,
+ *   HM, RR and IP are simulated, all other variables are just stored.
+ * - TxPDO1 with position and velocity in reply to every SYNC
+ * - expedited SDO up- and downloads of an object dictionary that accepts every object
+ * - segmented and block upload of the recorder data (object 0x2030)
+ *
+ * The motor follows the commanded velocity (or position) without dynamics.
+ * The homing switch is hit when the position passes setHomingSwitch().
+ */
+class HarmonicaSim : public CanSimNode
+{
+public:
+	/**
+	 * Constructor with the default CANopen identifiers of the node.
+	 * @param iNodeID node id 1..127
+	 */
+	HarmonicaSim(int iNodeID);
+
+	/**
+	 * Sets the CAN identifiers, see CanDriveHarmonica::setCanOpenParam().
+	 */
+	void setCanOpenParam(int iTxPDO1, int iTxPDO2, int iRxPDO2, int iTxSDO, int iRxSDO);
+
+	/**
+	 * Sets the position of the homing switch in encoder increments.
+	 */
+	void setHomingSwitch(int iPosIncr) { m_iHomingSwitchIncr = iPosIncr; }
+
+	void evalMsg(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies);
+
+	/**
+	 * Returns the position in encoder increments.
+	 */
+	int getPosIncr() { return (int)m_dPosIncr; }
+
+	/**
+	 * Returns the velocity in encoder increments per second.
+	 */
+	int getVelIncrS() { return (int)m_dVelIncrS; }
+
+	/**
+	 * Returns true if the motor is on (MO = 1).
+	 */
+	bool isMotorOn() { return m_bMotorOn; }
+
+private:
+	int m_iTxPDO1;
+	int m_iTxPDO2;
+	int m_iRxPDO2;
+	int m_iTxSDO;
+	int m_iRxSDO;
+
+	// motion
+	double m_dTimeSec;
+	double m_dPosIncr;
+	double m_dVelIncrS;
+	bool m_bMotorOn;
+	bool m_bPosMode;
+	double m_dTargetIncr;
+	double m_dNextTargetIncr;
+	int m_iHomingSwitchIncr;
+
+	// interpreter variables (command and index) and object dictionary (index and subindex)
+	std::map<int, int> m_Intprt;
+	std::map<int, int> m_ObjDict;
+
+	// recorder
+	double m_dRecStartSec;
+	double m_dRecPosIncr;
+	double m_dRecVelIncrS;
+	bool m_bRecActive;
+
+	// upload of the recorder data
+	std::vector<unsigned char> m_vUpload;
+	unsigned int m_iUploadPos;
+	unsigned int m_iBlockStartPos;
+	int m_iUploadIndex;
+	int m_iUploadSubIndex;
+	bool m_bUploadToggle;
+	int m_iBlockSize;
+
+	int getIntprt(int c1, int c2, int iIndex);
+	void move(double dTimeSec);
+	void evalIntprt(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies);
+	void evalSDO(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies);
+	void prepareRecorderData(int iSubIndex);
+	void sendBlock(std::vector<CanMsg>& vReplies);
+
+	CanMsg makeSDO(int iCmd, int iIndex, int iSubIndex, int iData);
+};
+
+//-----------------------------------------------
+#endif
@@ -0,0 +1,179 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: CANopen SDO client which tracks the requests to one node, with timeouts, retries and completion callbacks.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef SDOCLIENT_INCLUDEDEF_H
+#define SDOCLIENT_INCLUDEDEF_H
+
+//-----------------------------------------------
+#include <deque>
+#include <boost/function.hpp>
+
+#include <cob_generic_can/CanItf.h>
+#include <cob_utilities/TimeStamp.h>
+
+//-----------------------------------------------
+
+/**
+ * Client for the expedited SDO transfers (up to 4 bytes) to one CANopen node.
+ *
+ * A node serves one SDO request at a time, so the requests are queued and the next one is sent
+ * as soon as the reply of the previous one has been evaluated (no fixed delays in between).
+ * Requests to different nodes run in parallel, each node has its own client.
+ * Every request completes exactly once: with the reply, with an abort of the node, after it
+ * timed out on all retries or when it is cancelled.
+ *
+ * The client does not read from the bus itself. The owner passes the received SDO messages
+ * to evalReceivedMsg() and calls update() cyclically to send queued requests and to detect timeouts.
+ */
+class SDOClient
+{
+public:
+	enum Result
+	{
+		SDO_OK,
+		SDO_ABORTED,
+		SDO_TIMEOUT,
+		SDO_CANCELLED
+	};
+
+	/**
+	 * Called when a request has completed.
+	 * @param iResult Result of the request
+	 * @param iData uploaded data (upload only), abort code (SDO_ABORTED)
+	 */
+	typedef boost::function<void (int iResult, int iObjIndex, int iObjSubIndex, unsigned int iData)> CallbackType;
+
+	SDOClient();
+
+	void setCanItf(CanItf* pCanItf) { m_pCanCtrl = pCanItf; }
+
+	/**
+	 * @param iRxSDO COB-ID of the SDOs received by the node (requests)
+	 * @param iTxSDO COB-ID of the SDOs transmitted by the node (replies)
+	 */
+	void setCanIDs(int iRxSDO, int iTxSDO);
+
+	/**
+	 * @param dTimeoutSec time to wait for a reply before the request is sent again
+	 * @param iNumRetries number of repetitions before the request fails with SDO_TIMEOUT
+	 */
+	void setTimeout(double dTimeoutSec, int iNumRetries);
+
+	/**
+	 * Queues an expedited download (master to node) of iData.
+	 */
+	void download(int iObjIndex, int iObjSubIndex, int iData, CallbackType callback = CallbackType());
+
+	/**
+	 * Queues an expedited upload (node to master).
+	 */
+	void upload(int iObjIndex, int iObjSubIndex, CallbackType callback = CallbackType());
+
+	/**
+	 * Evaluates a message received from the node.
+	 * @return true if the message is the reply to the request in progress
+	 */
+	bool evalReceivedMsg(CanMsg& msg);
+
+	/**
+	 * Sends the next request and repeats or fails the request in progress after its timeout.
+	 * @param bChannelFree false while the SDO channel of the node is used by another transfer (e.g. a segmented upload),
+	 * no new request is sent then
+	 */
+	void update(bool bChannelFree = true);
+
+	/**
+	 * Drops all requests, they complete with SDO_CANCELLED.
+	 */
+	void cancel();
+
+	bool isIdle() const { return m_Requests.empty(); }
+
+	/**
+	 * @return true if a request has been sent and waits for its reply
+	 */
+	bool isBusy() const { return m_bSent; }
+
+	unsigned int getNumPending() const { return m_Requests.size(); }
+
+	/**
+	 * @return number of requests which did not complete with SDO_OK
+	 */
+	unsigned int getNumFailed() const { return m_iNumFailed; }
+
+private:
+	struct Request
+	{
+		bool bUpload;
+		int iObjIndex;
+		int iObjSubIndex;
+		int iData;
+		CallbackType callback;
+		int iNumTries;
+	};
+
+	void transmit(Request& request);
+	void complete(int iResult, unsigned int iData);
+
+	CanItf* m_pCanCtrl;
+	int m_iRxSDO;
+	int m_iTxSDO;
+	double m_dTimeoutSec;
+	int m_iNumRetries;
+
+	std::deque<Request> m_Requests;
+	bool m_bSent;
+	TimeStamp m_SendTime;
+	unsigned int m_iNumFailed;
+};
+
+//-----------------------------------------------
+#endif
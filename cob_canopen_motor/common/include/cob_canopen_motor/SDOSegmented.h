@@ -79,6 +79,8 @@ class segData {
 			objectSubID = 0x00;
 			toggleBit = false;
 			statusFlag = SDO_SEG_FREE;
+			numTotalBytes = 0;
+			resetBlockTransfer();
 		}
 
 		~segData() {}
@@ -92,6 +94,19 @@ class segData {
 			objectSubID = 0x00;
 			toggleBit = false;
 			statusFlag = SDO_SEG_FREE;
+			resetBlockTransfer();
+		}
+
+		/**
+		* Clear the state of a block transfer, the collected data is kept
+		*/
+		void resetBlockTransfer() {
+			blockTransfer = false;
+			blockSize = 127;
+			blockSeqNo = 0;
+			blockLastSegment = false;
+			blockCRC = false;
+			blockAckPending = false;
 		}
 
 		//public attributes
@@ -127,9 +142,39 @@ class segData {
 		unsigned int numTotalBytes;
 
 		/**
-		* This vector holds the received data byte-wise
+		* This vector holds the received data byte-wise. Its capacity is reserved from the announced number of bytes.
 		*/
 		std::vector<unsigned char> data;
+
+		/**
+		* The upload uses the SDO block transfer (CiA 301) instead of the segmented transfer
+		*/
+		bool blockTransfer;
+
+		/**
+		* Number of segments per block, that is requested from the device (1..127)
+		*/
+		unsigned char blockSize;
+
+		/**
+		* Sequence number of the last segment that has been received in order in the current block
+		*/
+		unsigned char blockSeqNo;
+
+		/**
+		* The segment with the last data has been received, the device sends the end of the block upload next
+		*/
+		bool blockLastSegment;
+
+		/**
+		* Client and device support the CRC over the uploaded data
+		*/
+		bool blockCRC;
+
+		/**
+		* A block is complete, its confirmation is held back until the transfer is paced on
+		*/
+		bool blockAckPending;
 };
 
 #endif
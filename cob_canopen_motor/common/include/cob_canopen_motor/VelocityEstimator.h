@@ -0,0 +1,153 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Alpha-beta-gamma tracker estimating velocity and acceleration of a drive from time stamped position samples.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef VELOCITYESTIMATOR_INCLUDEDEF_H
+#define VELOCITYESTIMATOR_INCLUDEDEF_H
+
+//-----------------------------------------------
+
+/**
+ * Estimates position, velocity and acceleration of a drive from position samples.
+ *
+ * The estimator is an alpha-beta-gamma tracker. Its gains are the closed-form steady state
+ * solution of the Kalman filter for a position measured with white noise and a randomly
+ * changing acceleration (tracking index of Kalata). They are recomputed for the time
+ * between every two samples, so samples do not have to be equidistant.
+ * The samples have to be stamped with the time they were taken (e.g. the SYNC msg which
+ * triggered the PDO), not with the time they are processed. Otherwise the jitter of the
+ * processing time is turned into velocity noise.
+ *
+ * Every update takes constant time and does not allocate memory.
+ */
+class VelocityEstimator
+{
+public:
+	/**
+	 * Default constructor.
+	 */
+	VelocityEstimator();
+
+	/**
+	 * Sets the noise model of the tracker.
+	 * @param dSigmaAcc standard deviation of the acceleration (process noise), e.g. rad/s^2
+	 * @param dSigmaPos standard deviation of the position measurement, e.g. rad.
+	 *		For a quantized encoder use one increment / sqrt(12).
+	 */
+	void setParam(double dSigmaAcc, double dSigmaPos);
+
+	/**
+	 * Sets the limits of the time between two samples.
+	 * Samples closer than dMinDtSec to the previous one are ignored (e.g. several replies to the same SYNC).
+	 * After a gap longer than dMaxDtSec the tracker is restarted with the new sample.
+	 */
+	void setDtLimits(double dMinDtSec, double dMaxDtSec);
+
+	/**
+	 * Forgets all samples. The next sample restarts the tracker.
+	 */
+	void reset();
+
+	/**
+	 * Adds a position sample.
+	 * @param dPos measured position
+	 * @param dSampleTimeSec time the position was sampled, in seconds of any monotonic clock
+	 * @return true if the sample has been used by the tracker
+	 */
+	bool update(double dPos, double dSampleTimeSec);
+
+	/**
+	 * Returns the filtered position at the time of the last sample.
+	 */
+	double getPos() { return m_dPos; }
+
+	/**
+	 * Returns the estimated velocity at the time of the last sample.
+	 */
+	double getVel() { return m_dVel; }
+
+	/**
+	 * Returns the estimated acceleration at the time of the last sample.
+	 */
+	double getAcc() { return m_dAcc; }
+
+	/**
+	 * Returns the time of the last sample used.
+	 */
+	double getSampleTime() { return m_dSampleTimeSec; }
+
+	/**
+	 * Returns true as soon as two samples have been used, i.e. the velocity is valid.
+	 */
+	bool isValid() { return m_iNumSamples >= 2; }
+
+private:
+	double m_dSigmaAcc;
+	double m_dSigmaPos;
+	double m_dMinDtSec;
+	double m_dMaxDtSec;
+
+	// gains of the last sample interval
+	double m_dGainDtSec;
+	double m_dAlpha;
+	double m_dBeta;
+	double m_dGamma;
+
+	double m_dPos;
+	double m_dVel;
+	double m_dAcc;
+	double m_dSampleTimeSec;
+	int m_iNumSamples;
+
+	void calcGains(double dt);
+};
+
+//-----------------------------------------------
+#endif
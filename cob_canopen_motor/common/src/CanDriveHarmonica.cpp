@@ -56,7 +56,11 @@
 
 #include <assert.h>
 #include <cob_canopen_motor/CanDriveHarmonica.h>
-#include <unistd.h> 
+#include <unistd.h>
+#include <string.h> 
+#include <math.h>
+#include <algorithm>
+#include <boost/bind.hpp>
 
 //-----------------------------------------------
 CanDriveHarmonica::CanDriveHarmonica()
@@ -69,11 +73,11 @@ CanDriveHarmonica::CanDriveHarmonica()
 	m_pCanCtrl = NULL;
 
 	m_iStatusCtrl = 0;
-	m_dPosGearMeasRad = 0;
+	m_iPosMotIncrMeas = 0;
+	m_iVelMotIncrPeriodMeas = 0;
 	m_dAngleGearRadMem  = 0;
-	m_dVelGearMeasRadS = 0;
 
-	m_VelCalcTime.SetNow();
+	m_bSyncPending = false;
 
 	m_bLimSwLeft = false;
 	m_bLimSwRight = false;
@@ -96,7 +100,20 @@ CanDriveHarmonica::CanDriveHarmonica()
 	
 
 	ElmoRec = new ElmoRecorder(this);
-
+	m_iSDOBlockSize = 127;
+	m_bSDOBlockAckHold = false;
+
+	for(int i = 0; i < INTPRT_NUM_REPLIES; i++)
+		m_iIntprtReplyCount[i] = 0;
+	m_iIntprtPosCnt = 0;
+	m_bStatusOk = false;
+
+	m_iBringUpState = BRINGUP_IDLE;
+	m_iBringUpStep = 0;
+	m_dBringUpWaitSec = 0;
+	m_iBringUpReplyCount = 0;
+	m_iBringUpSDOFailed = 0;
+	m_dBringUpDurationSec = 0;
 }
 
 //-----------------------------------------------
@@ -108,36 +125,36 @@ void CanDriveHarmonica::setCanOpenParam( int iTxPDO1, int iTxPDO2, int iRxPDO2,
 	m_ParamCanOpen.iTxSDO = iTxSDO;
 	m_ParamCanOpen.iRxSDO = iRxSDO;
 
+	m_SDOClient.setCanIDs(iRxSDO, iTxSDO);
 }
 
 //-----------------------------------------------
 bool CanDriveHarmonica::evalReceivedMsg(CanMsg& msg)
 {
 	bool bRet = false;
-	int iDigIn;
-	int iFailure;
-	int iPara;
-
-	int iHomeDigIn = 0x0001; // 0x0001 for CoB3 steering drive homing input; 0x0400 for Scara
 	int iTemp1, iTemp2;
-	
-	m_CanMsgLast = msg;
 
 	//-----------------------
 	// eval answers from PDO1 - transmitted on SYNC msg
 	if (msg.m_iID == m_ParamCanOpen.iTxPDO1)
 	{
+		// keep the increments, they are converted when requested
 		iTemp1 = (msg.getAt(3) << 24) | (msg.getAt(2) << 16)
 				| (msg.getAt(1) << 8) | (msg.getAt(0) );
 
-		m_dPosGearMeasRad = m_DriveParam.getSign() * m_DriveParam.
-			PosMotIncrToPosGearRad(iTemp1);
+		m_iPosMotIncrMeas = iTemp1;
 
 		iTemp2 = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
 				| (msg.getAt(5) << 8) | (msg.getAt(4) );
 		
-		m_dVelGearMeasRadS = m_DriveParam.getSign() * m_DriveParam.
-			VelMotIncrPeriodToVelGearRadS(iTemp2);
+		m_iVelMotIncrPeriodMeas = iTemp2;
+
+		// the position has been sampled at the SYNC msg, not now
+		if(m_bSyncPending)
+		{
+			m_VelEstimator.update(m_DriveParam.PosMotIncrToPosGearRadSign(iTemp1), m_SyncTime - m_StartTime);
+			m_bSyncPending = false;
+		}
 
 		m_WatchdogTime.SetNow();
 
@@ -148,113 +165,15 @@ bool CanDriveHarmonica::evalReceivedMsg(CanMsg& msg)
 	// eval answers from binary interpreter
 	if (msg.m_iID == m_ParamCanOpen.iTxPDO2)
 	{
-		if( (msg.getAt(0) == 'P') && (msg.getAt(1) == 'X') ) // current pos
-		{
-		}
-
-		else if( (msg.getAt(0) == 'P') && (msg.getAt(1) == 'A') ) // position absolute
-		{
-		}
+		int iReply = getIntprtReply(msg.getAt(0), msg.getAt(1));
+		int iData = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
+			| (msg.getAt(5) << 8) | (msg.getAt(4) );
 
-		else if( (msg.getAt(0) == 'J') && (msg.getAt(1) == 'V') ) // current velocity
-		{
-		}
-
-		else if( (msg.getAt(0) == 'B') && (msg.getAt(1) == 'G') ) // begin motion
-		{
-		}
-
-		else if( (msg.getAt(0) == 'U') && (msg.getAt(1) == 'M') ) // user mode
-		{
-			iDigIn = 0x1FFFFF & ( (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4)) );
-		}
+		m_iIntprtReplyCount[iReply]++;
+		(this->*s_IntprtReplyHandler[iReply])(iData);
 
-		else if( (msg.getAt(0) == 'I') && (msg.getAt(1) == 'P') ) // digital in == limit switches
-		{
-			iDigIn = 0x1FFFFF & ( (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4)) );
-			iDigIn = 0x1FFFFF & ( (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4)) );
-
-			if( (iDigIn & iHomeDigIn) != 0x0000 )
-			{
-				m_bLimSwRight = true;
-			}			
-		}
-
-		else if( (msg.getAt(0) == 'S') && (msg.getAt(1) == 'R') ) // status
-		{
-			m_iStatusCtrl = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4) );
-
-			evalStatusRegister(m_iStatusCtrl);
-			ElmoRec->readoutRecorderTryStatus(m_iStatusCtrl, seg_Data);
-			
-		}
-
-		else if( (msg.getAt(0) == 'M') && (msg.getAt(1) == 'F') ) // motor failure
-		{
-			iFailure = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4) );
-
-			evalMotorFailure(iFailure);
-		}
-
-		// debug eval
-		else if( (msg.getAt(0) == 'U') && (msg.getAt(1) == 'M') )
-		{
-			iPara = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4) );
-
-			std::cout << "um " << iPara << std::endl;
-		}
-		
-		else if( (msg.getAt(0) == 'P') && (msg.getAt(1) == 'M') )
-		{
-			iPara = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4) );
-
-			std::cout << "pm " << iPara << std::endl;
-		}
-
-		else if( (msg.getAt(0) == 'A') && (msg.getAt(1) == 'C') )
-		{
-			iPara = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4) );
-
-			std::cout << "ac " << iPara << std::endl;
-		}
-
-		else if( (msg.getAt(0) == 'D') && (msg.getAt(1) == 'C') )
-		{
-			iPara = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4) );
-
-			std::cout << "dc " << iPara << std::endl;
-		}
-		else if( (msg.getAt(0) == 'H') && (msg.getAt(1) == 'M') )
-		{
-			// status message (homing armed = 1 / disarmed = 0) is encoded in 5th byte
-			if(msg.getAt(4) == 0)
-			{
-				// if 0 received: elmo disarmed homing after receiving the defined event
-				m_bLimSwRight = true;
-			}
-		}
-		else if( (msg.getAt(0) == 'I') && (msg.getAt(1) == 'Q') )
-		{
-			int iVal=0;
-			iVal = (msg.getAt(7) << 24) | (msg.getAt(6) << 16)
-				| (msg.getAt(5) << 8) | (msg.getAt(4) );
-			float* pfVal;
-			pfVal=(float*)&iVal;
-			m_dMotorCurr = *pfVal;			
-		}
-
-		else
-		{
-		}
+		if(m_IntprtTraceSink)
+			m_IntprtTraceSink(m_DriveParam.getDriveIdent(), msg.getAt(0), msg.getAt(1), iData);
 
 		m_WatchdogTime.SetNow();
 
@@ -267,7 +186,20 @@ bool CanDriveHarmonica::evalReceivedMsg(CanMsg& msg)
 	{
 		m_WatchdogTime.SetNow();
 
-		if( (msg.getAt(0) >> 5) == 0) { //Received Upload SDO Segment (scs = 0)
+		if(m_SDOClient.evalReceivedMsg(msg)) {
+			//Reply to a request of the SDO client
+
+		} else if(seg_Data.blockTransfer && (seg_Data.statusFlag == segData::SDO_SEG_COLLECTING) && !seg_Data.blockLastSegment && (msg.getAt(0) != 0x80)) {
+			//Block upload in progress: byte 0 is the sequence number of the segment (0x80 would be an abort)
+			receivedSDOBlockSegment(msg);
+
+		} else if( (msg.getAt(0) & 0xE1) == 0xC0) { //Received Initiate Block Upload response (scs = 6, ss = 0)
+			receivedSDOBlockInitiation(msg);
+
+		} else if( (msg.getAt(0) & 0xE1) == 0xC1) { //Received End Block Upload request (scs = 6, ss = 1)
+			receivedSDOBlockEnd(msg);
+
+		} else if( (msg.getAt(0) >> 5) == 0) { //Received Upload SDO Segment (scs = 0)
 			//std::cout << "SDO Upload Segment received" << std::endl;
 			receivedSDODataSegment(msg);
 			
@@ -283,9 +215,174 @@ bool CanDriveHarmonica::evalReceivedMsg(CanMsg& msg)
 		bRet = true;
 	}
 
+	//send the next request of the SDO client right after the reply, check for timeouts
+	if(bRet)
+		m_SDOClient.update(seg_Data.statusFlag == segData::SDO_SEG_FREE);
+
 	return bRet;
 }
 
+//-----------------------------------------------
+bool CanDriveHarmonica::waitForSDOClient(double dTimeoutSec)
+{
+	CanMsg Msg;
+	TimeStamp StartTime, Now;
+	unsigned int iNumFailed = m_SDOClient.getNumFailed();
+
+	StartTime.SetNow();
+	m_SDOClient.update(seg_Data.statusFlag == segData::SDO_SEG_FREE);
+
+	while(!m_SDOClient.isIdle())
+	{
+		if(m_pCanCtrl->receiveMsg(&Msg))
+			evalReceivedMsg(Msg);
+		else
+			usleep(1000);
+
+		m_SDOClient.update(seg_Data.statusFlag == segData::SDO_SEG_FREE);
+
+		Now.SetNow();
+		if( (Now - StartTime) > dTimeoutSec )
+		{
+			std::cout << "CanDriveHarmonica: SDO requests not finished in time, " << m_SDOClient.getNumPending() << " cancelled" << std::endl;
+			m_SDOClient.cancel();
+			return false;
+		}
+	}
+
+	return m_SDOClient.getNumFailed() == iNumFailed;
+}
+
+//-----------------------------------------------
+// stores the uploaded data of a successful SDO request
+static void storeSDOData(int* piData, int iResult, int, int, unsigned int iData)
+{
+	if(iResult == SDOClient::SDO_OK)
+		*piData = iData;
+}
+
+//-----------------------------------------------
+bool CanDriveHarmonica::waitForStatusword(double dTimeoutSec, int* piStatusword)
+{
+	if(piStatusword != NULL)
+		m_SDOClient.upload(0x6041, 0, boost::bind(&storeSDOData, piStatusword, _1, _2, _3, _4));
+	else
+		m_SDOClient.upload(0x6041, 0);
+
+	return waitForSDOClient(dTimeoutSec);
+}
+
+//-----------------------------------------------
+// command characters of a binary interpreter reply as one number
+#define INTPRT_CODE(c1, c2) (((c1) << 8) | (c2))
+
+int CanDriveHarmonica::getIntprtReply(int iCmdChar1, int iCmdChar2)
+{
+	switch(INTPRT_CODE(iCmdChar1, iCmdChar2))
+	{
+	case INTPRT_CODE('P', 'X'): return INTPRT_PX; // current pos
+	case INTPRT_CODE('P', 'A'): return INTPRT_PA; // position absolute
+	case INTPRT_CODE('J', 'V'): return INTPRT_JV; // current velocity
+	case INTPRT_CODE('B', 'G'): return INTPRT_BG; // begin motion
+	case INTPRT_CODE('U', 'M'): return INTPRT_UM; // user mode
+	case INTPRT_CODE('I', 'P'): return INTPRT_IP; // digital in == limit switches
+	case INTPRT_CODE('S', 'R'): return INTPRT_SR; // status
+	case INTPRT_CODE('M', 'F'): return INTPRT_MF; // motor failure
+	case INTPRT_CODE('P', 'M'): return INTPRT_PM; // profiler mode
+	case INTPRT_CODE('A', 'C'): return INTPRT_AC; // acceleration
+	case INTPRT_CODE('D', 'C'): return INTPRT_DC; // deceleration
+	case INTPRT_CODE('H', 'M'): return INTPRT_HM; // homing
+	case INTPRT_CODE('I', 'Q'): return INTPRT_IQ; // active current
+	default: return INTPRT_UNKNOWN;
+	}
+}
+
+#undef INTPRT_CODE
+
+// same order as IntprtReply
+const CanDriveHarmonica::IntprtReplyHandler CanDriveHarmonica::s_IntprtReplyHandler[INTPRT_NUM_REPLIES] =
+{
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_UNKNOWN
+	&CanDriveHarmonica::evalIntprtPosCnt,		// INTPRT_PX
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_PA
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_JV
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_BG
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_UM
+	&CanDriveHarmonica::evalIntprtDigIn,		// INTPRT_IP
+	&CanDriveHarmonica::evalIntprtStatus,		// INTPRT_SR
+	&CanDriveHarmonica::evalIntprtFailure,		// INTPRT_MF
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_PM
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_AC
+	&CanDriveHarmonica::evalIntprtIgnore,		// INTPRT_DC
+	&CanDriveHarmonica::evalIntprtHoming,		// INTPRT_HM
+	&CanDriveHarmonica::evalIntprtMotorCurrent	// INTPRT_IQ
+};
+
+//-----------------------------------------------
+unsigned int CanDriveHarmonica::getIntprtReplyCount(int iReply) const
+{
+	if( (iReply < 0) || (iReply >= INTPRT_NUM_REPLIES) )
+		return 0;
+	return m_iIntprtReplyCount[iReply];
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::evalIntprtIgnore(int)
+{
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::evalIntprtPosCnt(int iData)
+{
+	m_iIntprtPosCnt = iData;
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::evalIntprtDigIn(int iData)
+{
+	int iHomeDigIn = 0x0001; // 0x0001 for CoB3 steering drive homing input; 0x0400 for Scara
+	int iDigIn = 0x1FFFFF & iData;
+
+	if( (iDigIn & iHomeDigIn) != 0x0000 )
+	{
+		m_bLimSwRight = true;
+	}
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::evalIntprtStatus(int iData)
+{
+	m_iStatusCtrl = iData;
+
+	m_bStatusOk = evalStatusRegister(m_iStatusCtrl);
+	ElmoRec->readoutRecorderTryStatus(m_iStatusCtrl, seg_Data);
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::evalIntprtFailure(int iData)
+{
+	evalMotorFailure(iData);
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::evalIntprtHoming(int iData)
+{
+	// status message (homing armed = 1 / disarmed = 0) is encoded in 5th byte
+	if( (iData & 0xFF) == 0 )
+	{
+		// if 0 received: elmo disarmed homing after receiving the defined event
+		m_bLimSwRight = true;
+	}
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::evalIntprtMotorCurrent(int iData)
+{
+	float fVal;
+	memcpy(&fVal, &iData, sizeof(fVal));
+	m_dMotorCurr = fVal;
+}
+
 //-----------------------------------------------
 bool CanDriveHarmonica::init()
 {
@@ -321,8 +418,8 @@ bool CanDriveHarmonica::init()
 			iPosCnt = (Msg.getAt(7) << 24) | (Msg.getAt(6) << 16)
 				| (Msg.getAt(5) << 8) | (Msg.getAt(4) );
 			
-			m_dPosGearMeasRad = m_DriveParam.getSign() * m_DriveParam.PosMotIncrToPosGearRad(iPosCnt);
-			m_dAngleGearRadMem  = m_dPosGearMeasRad;
+			m_iPosMotIncrMeas = iPosCnt;
+			m_dAngleGearRadMem  = m_DriveParam.PosMotIncrToPosGearRadSign(iPosCnt);
 			break;
 		}
 
@@ -338,32 +435,211 @@ bool CanDriveHarmonica::init()
 	}
 
 	// ---------- set PDO mapping
+	requestPDOMapping();
+	if( !waitForSDOClient(1.0) )
+	{
+		std::cout << "CanDriveHarmonica: PDO mapping failed" << std::endl;
+		bRet = false;
+	}
+
+	m_bWatchdogActive = false;
+	
+	if( bRet )
+		m_bIsInitialized = true;
+	 
+	return bRet;	
+}
+//-----------------------------------------------
+void CanDriveHarmonica::requestPDOMapping()
+{
 	// Mapping of TPDO1:
 	// - position
 	// - velocity
 	
 	// stop all emissions of TPDO1
-	sendSDODownload(0x1A00, 0, 0);
+	m_SDOClient.download(0x1A00, 0, 0);
 	
 	// position 4 byte of TPDO1
-	sendSDODownload(0x1A00, 1, 0x60640020);
+	m_SDOClient.download(0x1A00, 1, 0x60640020);
 
 	// velocity 4 byte of TPDO1
-	sendSDODownload(0x1A00, 2, 0x60690020);
+	m_SDOClient.download(0x1A00, 2, 0x60690020);
 	
 	// transmission type "synch"
-	sendSDODownload(0x1800, 2, 1);
+	m_SDOClient.download(0x1800, 2, 1);
 	
 	// activate mapped objects
-	sendSDODownload(0x1A00, 0, 2);
+	m_SDOClient.download(0x1A00, 0, 2);
+}
 
-	m_bWatchdogActive = false;
-	
-	if( bRet )
-		m_bIsInitialized = true;
-	 
-	return bRet;	
+//-----------------------------------------------
+void CanDriveHarmonica::beginBringUp(bool bInit)
+{
+	m_BringUpStartTime.SetNow();
+	m_BringUpStepTime = m_BringUpStartTime;
+	m_dBringUpWaitSec = 0;
+	m_dBringUpDurationSec = 0;
+	m_iBringUpState = BRINGUP_RUNNING;
+
+	if(bInit)
+	{
+		m_iMotorState = ST_PRE_INITIALIZED;
+		m_bIsInitialized = false;
+		m_iBringUpStep = BRINGUP_STEP_INIT;
+	}
+	else
+		m_iBringUpStep = BRINGUP_STEP_START;
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::nextBringUpStep(double dWaitSec)
+{
+	m_iBringUpStep++;
+	m_BringUpStepTime.SetNow();
+	m_dBringUpWaitSec = dWaitSec;
+}
+
+//-----------------------------------------------
+int CanDriveHarmonica::failBringUp(const char* pcReason)
+{
+	std::cout << "CanDriveHarmonica: bring-up of drive " << m_DriveParam.getDriveIdent() << " failed: " << pcReason << std::endl;
+	m_iBringUpState = BRINGUP_FAILED;
+	return m_iBringUpState;
+}
+
+//-----------------------------------------------
+int CanDriveHarmonica::updateBringUp()
+{
+	// same gaps and timeouts as init() and start()
+	const double c_dIntprtGapSec = 0.02;
+	const double c_dTypeMotionGapSec = 0.1;
+	const double c_dReplyTimeoutSec = 3.0;
+	const double c_dSDOTimeoutSec = 1.0;
+
+	if(m_iBringUpState != BRINGUP_RUNNING)
+		return m_iBringUpState;
+
+	updateSDOClient();
+
+	TimeStamp Now;
+	Now.SetNow();
+	double dStepTime = Now - m_BringUpStepTime;
+	if(dStepTime < m_dBringUpWaitSec)
+		return m_iBringUpState;
+
+	int iIncrRevWheel;
+
+	switch(m_iBringUpStep)
+	{
+	case BRINGUP_STEP_INIT:
+		// Set Values for Modulo-Counting, see init()
+		IntprtSetInt(8, 'M', 'O', 0, 0);
+		nextBringUpStep(c_dIntprtGapSec);
+		break;
+
+	case BRINGUP_STEP_INIT + 1:
+		iIncrRevWheel = int( (double)m_DriveParam.getGearRatio() * (double)m_DriveParam.getBeltRatio()
+			* (double)m_DriveParam.getEncIncrPerRevMot() * 3 );
+		IntprtSetInt(8, 'X', 'M', 2, iIncrRevWheel * 5000);
+		nextBringUpStep(c_dIntprtGapSec);
+		break;
+
+	case BRINGUP_STEP_INIT + 2:
+		iIncrRevWheel = int( (double)m_DriveParam.getGearRatio() * (double)m_DriveParam.getBeltRatio()
+			* (double)m_DriveParam.getEncIncrPerRevMot() * 3 );
+		IntprtSetInt(8, 'X', 'M', 1, -iIncrRevWheel * 5000);
+		nextBringUpStep(c_dIntprtGapSec);
+		break;
+
+	case BRINGUP_STEP_INIT + 3:
+		sendTypeMotionVelCtrl();
+		m_iTypeMotion = MOTIONTYPE_VELCTRL;
+		nextBringUpStep(c_dTypeMotionGapSec);
+		break;
+
+	case BRINGUP_STEP_INIT + 4:
+		// set position counter to zero, wait for the answer
+		m_iBringUpReplyCount = m_iIntprtReplyCount[INTPRT_PX];
+		IntprtSetInt(8, 'P', 'X', 0, 0);
+		nextBringUpStep(0);
+		break;
+
+	case BRINGUP_STEP_INIT + 5:
+		if(m_iIntprtReplyCount[INTPRT_PX] != m_iBringUpReplyCount)
+		{
+			m_iPosMotIncrMeas = m_iIntprtPosCnt;
+			m_dAngleGearRadMem = m_DriveParam.PosMotIncrToPosGearRadSign(m_iIntprtPosCnt);
+
+			m_iBringUpSDOFailed = m_SDOClient.getNumFailed();
+			requestPDOMapping();
+			updateSDOClient();
+			nextBringUpStep(0);
+		}
+		else if(dStepTime > c_dReplyTimeoutSec)
+			return failBringUp("initial position not set");
+		break;
+
+	case BRINGUP_STEP_INIT + 6:
+		if(m_SDOClient.isIdle())
+		{
+			if(m_SDOClient.getNumFailed() != m_iBringUpSDOFailed)
+				return failBringUp("PDO mapping failed");
+
+			m_bWatchdogActive = false;
+			m_bIsInitialized = true;
+			m_iBringUpStep = BRINGUP_STEP_START;
+			m_dBringUpWaitSec = 0;
+		}
+		else if(dStepTime > c_dSDOTimeoutSec)
+		{
+			m_SDOClient.cancel();
+			return failBringUp("PDO mapping not confirmed");
+		}
+		break;
+
+	case BRINGUP_STEP_START:
+		// motor on
+		IntprtSetInt(8, 'M', 'O', 0, 1);
+		nextBringUpStep(c_dIntprtGapSec);
+		break;
+
+	case BRINGUP_STEP_START + 1:
+		// request status, wait for the answer
+		m_iBringUpReplyCount = m_iIntprtReplyCount[INTPRT_SR];
+		IntprtSetInt(4, 'S', 'R', 0, 0);
+		nextBringUpStep(0);
+		break;
+
+	case BRINGUP_STEP_START + 2:
+		if(m_iIntprtReplyCount[INTPRT_SR] != m_iBringUpReplyCount)
+		{
+			if(!m_bStatusOk)
+				return failBringUp("drive reports an error");
+
+			// start watchdog timer
+			m_WatchdogTime.SetNow();
+			m_SendTime.SetNow();
+
+			m_dBringUpDurationSec = Now - m_BringUpStartTime;
+			m_iBringUpState = BRINGUP_DONE;
+		}
+		else if(dStepTime > c_dReplyTimeoutSec)
+			return failBringUp("no answer on status request");
+		break;
+
+	default:
+		return failBringUp("unknown step");
+	}
+
+	return m_iBringUpState;
 }
+
+//-----------------------------------------------
+void CanDriveHarmonica::updateSDOClient()
+{
+	m_SDOClient.update(seg_Data.statusFlag == segData::SDO_SEG_FREE);
+}
+
 //-----------------------------------------------
 bool CanDriveHarmonica::stop()
 {	
@@ -458,6 +734,16 @@ bool CanDriveHarmonica::shutdown()
 
 //-----------------------------------------------
 bool CanDriveHarmonica::startWatchdog(bool bStarted)
+{
+	requestWatchdog(bStarted);
+	if( !waitForSDOClient(1.0) )
+		std::cout << "CanDriveHarmonica: configuration of the watchdog failed" << std::endl;
+
+	return true;
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::requestWatchdog(bool bStarted)
 {
 	if (bStarted == true)
 	{
@@ -471,20 +757,18 @@ bool CanDriveHarmonica::startWatchdog(bool bStarted)
 		const int c_iNMTNodeID = 0x00;
 		
 		// consumer (PC) heartbeat time
-		sendSDODownload(0x1016, 1, (c_iNMTNodeID << 16) | c_iHeartbeatTimeMS);
+		m_SDOClient.download(0x1016, 1, (c_iNMTNodeID << 16) | c_iHeartbeatTimeMS);
  		
 		// error behavior after failure: 0=pre-operational, 1=no state change, 2=stopped"	
-		sendSDODownload(0x1029, 1, 2);
+		m_SDOClient.download(0x1029, 1, 2);
 		
 		// motor behavior after heartbeat failre: "quick stop"
-		sendSDODownload(0x6007, 0, 3);
+		m_SDOClient.download(0x6007, 0, 3);
 
 		// acivate emergency events: "heartbeat event"
 		// Object 0x2F21 = "Emergency Events" which cause an Emergency Message
 		// Bit 3 is responsible for Heartbeart-Failure.--> Hex 0x08
-		sendSDODownload(0x2F21, 0, 0x08);
-		usleep(20000);
- 
+		m_SDOClient.download(0x2F21, 0, 0x08);
 	}
 	else
 	{	
@@ -492,21 +776,16 @@ bool CanDriveHarmonica::startWatchdog(bool bStarted)
 		m_bWatchdogActive = false;
 
 		//Motor action after Hearbeat-Error: No Action		
-		sendSDODownload(0x6007, 0, 0);
+		m_SDOClient.download(0x6007, 0, 0);
 
 		//Error Behavior: No state change
-		sendSDODownload(0x1029, 1, 1);
+		m_SDOClient.download(0x1029, 1, 1);
 
 		// Deacivate emergency events: "heartbeat event"
 		// Object 0x2F21 = "Emergency Events" which cause an Emergency Message
 		// Bit 3 is responsible for Heartbeart-Failure.
-		sendSDODownload(0x2F21, 0, 0x00);
-		usleep(25000);
-			
-		
+		m_SDOClient.download(0x2F21, 0, 0x00);
 	}
-
-	return true;
 }
 
 //-----------------------------------------------
@@ -695,11 +974,7 @@ void CanDriveHarmonica::setGearPosVelRadS(double dPosGearRad, double dVelGearRad
 	
 	// request pos and vel by TPDO1, triggered by SYNC msg
 	// (to request pos by SDO usesendSDOUpload(0x6064, 0) )
-	CanMsg msg;
-	msg.m_iID  = 0x80;
-	msg.m_iLen = 0;
-	msg.set(0,0,0,0,0,0,0,0);
-	m_pCanCtrl->transmitMsg(msg);
+	sendSync();
 }
 
 //-----------------------------------------------
@@ -708,7 +983,7 @@ void CanDriveHarmonica::setGearVelRadS(double dVelGearRadS)
 	int iVelEncIncrPeriod;
 	
 	// calc motor velocity from joint velocity
-	iVelEncIncrPeriod = m_DriveParam.getSign() * m_DriveParam.VelGearRadSToVelMotIncrPeriod(dVelGearRadS);
+	iVelEncIncrPeriod = m_DriveParam.VelGearRadSToVelMotIncrPeriodSign(dVelGearRadS);
 
 	if(iVelEncIncrPeriod > m_DriveParam.getVelMax())
 	{
@@ -727,14 +1002,10 @@ void CanDriveHarmonica::setGearVelRadS(double dVelGearRadS)
 
 	// request pos and vel by TPDO1, triggered by SYNC msg
 	// (to request pos by SDO use sendSDOUpload(0x6064, 0) )
-	// sync msg is: iID 0x80 with msg (0,0,0,0,0,0,0,0)
-	CanMsg msg;
-	msg.m_iID  = 0x80;
-	msg.m_iLen = 0;
-	msg.set(0,0,0,0,0,0,0,0);
-	m_pCanCtrl->transmitMsg(msg);
+	sendSync();
 
 	// send heartbeat to keep watchdog inactive
+	CanMsg msg;
 	msg.m_iID  = 0x700;
 	msg.m_iLen = 5;
 	msg.set(0x00,0,0,0,0,0,0,0);
@@ -762,30 +1033,39 @@ void CanDriveHarmonica::setGearVelRadS(double dVelGearRadS)
 //-----------------------------------------------
 void CanDriveHarmonica::getGearPosRad(double* dGearPosRad)
 {
-	*dGearPosRad = m_dPosGearMeasRad;
+	*dGearPosRad = m_DriveParam.PosMotIncrToPosGearRadSign(m_iPosMotIncrMeas);
 }
 
 //-----------------------------------------------
 void CanDriveHarmonica::getGearPosVelRadS(double* pdAngleGearRad, double* pdVelGearRadS)
 {
-	*pdAngleGearRad = m_dPosGearMeasRad;
-	*pdVelGearRadS = m_dVelGearMeasRadS;
+	*pdAngleGearRad = m_DriveParam.PosMotIncrToPosGearRadSign(m_iPosMotIncrMeas);
+	*pdVelGearRadS = m_DriveParam.VelMotIncrPeriodToVelGearRadSSign(m_iVelMotIncrPeriodMeas);
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::getPosVelMotIncr(int* piPosMotIncr, int* piVelMotIncrPeriod)
+{
+	*piPosMotIncr = m_iPosMotIncrMeas;
+	*piVelMotIncrPeriod = m_iVelMotIncrPeriodMeas;
 }
 
 //-----------------------------------------------
 void CanDriveHarmonica::getGearDeltaPosVelRadS(double* pdAngleGearRad, double* pdVelGearRadS)
 {
-	*pdAngleGearRad = m_dPosGearMeasRad - m_dAngleGearRadMem;
-	*pdVelGearRadS = m_dVelGearMeasRadS;
-	m_dAngleGearRadMem = m_dPosGearMeasRad;
+	double dPosGearRad = m_DriveParam.PosMotIncrToPosGearRadSign(m_iPosMotIncrMeas);
+
+	*pdAngleGearRad = dPosGearRad - m_dAngleGearRadMem;
+	*pdVelGearRadS = m_DriveParam.VelMotIncrPeriodToVelGearRadSSign(m_iVelMotIncrPeriodMeas);
+	m_dAngleGearRadMem = dPosGearRad;
 }
 
 //-----------------------------------------------
 void CanDriveHarmonica::getData(double* pdPosGearRad, double* pdVelGearRadS,
 								int* piTorqueCtrl, int* piStatusCtrl)
 {
-	*pdPosGearRad = m_dPosGearMeasRad;
-	*pdVelGearRadS = m_dVelGearMeasRadS;
+	*pdPosGearRad = m_DriveParam.PosMotIncrToPosGearRadSign(m_iPosMotIncrMeas);
+	*pdVelGearRadS = m_DriveParam.VelMotIncrPeriodToVelGearRadSSign(m_iVelMotIncrPeriodMeas);
 	*piTorqueCtrl = m_iTorqueCtrl;
 	*piStatusCtrl = m_iStatusCtrl;
 }
@@ -794,12 +1074,32 @@ void CanDriveHarmonica::getData(double* pdPosGearRad, double* pdVelGearRadS,
 void CanDriveHarmonica::requestPosVel()
 {
 	// request pos and vel by TPDO1, triggered by SYNC msg
+	sendSync();
+	// (to request pos by SDO use sendSDOUpload(0x6064, 0) )
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::sendSync()
+{
+	// sync msg is: iID 0x80 with msg (0,0,0,0,0,0,0,0)
 	CanMsg msg;
 	msg.m_iID  = 0x80;
 	msg.m_iLen = 0;
 	msg.set(0,0,0,0,0,0,0,0);
+
+	// The first PDO1 received afterwards is taken as sampled at this SYNC. If other drives on
+	// the bus send SYNC msgs, too, it can be the reply to one of them sent shortly before.
+	// This offset is nearly constant from cycle to cycle and therefore adds no noise.
+	m_SyncTime.SetNow();
+	m_bSyncPending = true;
 	m_pCanCtrl->transmitMsg(msg);
-	// (to request pos by SDO use sendSDOUpload(0x6064, 0) )
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::getGearVelAccEstim(double* pdVelGearRadS, double* pdAccGearRadS2)
+{
+	*pdVelGearRadS = m_VelEstimator.getVel();
+	*pdAccGearRadS2 = m_VelEstimator.getAcc();
 }
 
 //-----------------------------------------------
@@ -899,17 +1199,7 @@ bool CanDriveHarmonica::setTypeMotion(int iType)
 	else
 	{
 		//Default Motion Type = VelocityControled
-		// switch off Motor to change Unit-Mode
-		IntprtSetInt(8, 'M', 'O', 0, 0);
-		// switch Unit-Mode
-		IntprtSetInt(8, 'U', 'M', 0, 2);
-		// set profiler Mode (only if Unit Mode = 2)
-		IntprtSetInt(8, 'P', 'M', 0, 1);
-
-		// set maximum Acceleration to X Incr/s^2		
-		IntprtSetInt(8, 'A', 'C', 0, iMaxAcc);
-		// set maximum decceleration to X Incr/s^2
-		IntprtSetInt(8, 'D', 'C', 0, iMaxDcc);	
+		sendTypeMotionVelCtrl();
 		usleep(100000);
 	}
 	
@@ -917,6 +1207,25 @@ bool CanDriveHarmonica::setTypeMotion(int iType)
 	return true;
 }
 
+//-----------------------------------------------
+void CanDriveHarmonica::sendTypeMotionVelCtrl()
+{
+	int iMaxAcc = int(m_DriveParam.getMaxAcc());
+	int iMaxDcc = int(m_DriveParam.getMaxDec());
+
+	// switch off Motor to change Unit-Mode
+	IntprtSetInt(8, 'M', 'O', 0, 0);
+	// switch Unit-Mode
+	IntprtSetInt(8, 'U', 'M', 0, 2);
+	// set profiler Mode (only if Unit Mode = 2)
+	IntprtSetInt(8, 'P', 'M', 0, 1);
+
+	// set maximum Acceleration to X Incr/s^2		
+	IntprtSetInt(8, 'A', 'C', 0, iMaxAcc);
+	// set maximum decceleration to X Incr/s^2
+	IntprtSetInt(8, 'D', 'C', 0, iMaxDcc);	
+}
+
 
 //-----------------------------------------------
 void CanDriveHarmonica::IntprtSetInt(int iDataLen, char cCmdChar1, char cCmdChar2, int iIndex, int iData)
@@ -995,6 +1304,19 @@ void CanDriveHarmonica::sendSDOAbort(int iObjIndex, int iObjSubIndex, unsigned i
 //-----------------------------------------------
 void CanDriveHarmonica::receivedSDOTransferAbort(unsigned int iErrorCode){
 	std::cout << "SDO Abort Transfer received with error code: " << iErrorCode;
+
+	if(seg_Data.blockTransfer && (seg_Data.statusFlag == segData::SDO_SEG_WAITING)) {
+		//Device does not support the block upload, request the object segmented instead
+		std::cout << ", retrying with segmented upload" << std::endl;
+		seg_Data.resetBlockTransfer();
+		sendSDOUpload(seg_Data.objectID, seg_Data.objectSubID);
+		return;
+	}
+	std::cout << std::endl;
+
+	if(seg_Data.statusFlag != segData::SDO_SEG_FREE)
+		ElmoRec->setUploadResult(ElmoRecorder::UPLOAD_ABORTED);
+	seg_Data.resetBlockTransfer();
 	seg_Data.statusFlag = segData::SDO_SEG_FREE;
 }
 
@@ -1022,6 +1344,40 @@ void CanDriveHarmonica::sendSDOUpload(int iObjIndex, int iObjSubIndex)
 	m_pCanCtrl->transmitMsg(CMsgTr);
 }
 
+//-----------------------------------------------
+void CanDriveHarmonica::sendSDOBlockUpload(int iObjIndex, int iObjSubIndex)
+{
+	CanMsg CMsgTr;
+	const int ciInitBlockUploadReq = 0xA0; //ccs = 5, cs = 0
+	const int ciCRCSupported = 0x04;
+	const int ciNoProtocolSwitch = 0x00;
+	int iBlockSize = m_iSDOBlockSize;
+
+	//remember the object for the fallback to segmented upload
+	seg_Data.objectID = iObjIndex;
+	seg_Data.objectSubID = iObjSubIndex;
+	seg_Data.resetBlockTransfer();
+	seg_Data.blockTransfer = true;
+	seg_Data.blockSize = iBlockSize;
+
+	CMsgTr.m_iLen = 8;
+	CMsgTr.m_iID = m_ParamCanOpen.iRxSDO;
+
+	unsigned char cMsg[8];
+
+	cMsg[0] = ciInitBlockUploadReq | ciCRCSupported;
+	cMsg[1] = iObjIndex;
+	cMsg[2] = iObjIndex >> 8;
+	cMsg[3] = iObjSubIndex;
+	cMsg[4] = iBlockSize;
+	cMsg[5] = ciNoProtocolSwitch;
+	cMsg[6] = 0x00;
+	cMsg[7] = 0x00;
+
+	CMsgTr.set(cMsg[0], cMsg[1], cMsg[2], cMsg[3], cMsg[4], cMsg[5], cMsg[6], cMsg[7]);
+	m_pCanCtrl->transmitMsg(CMsgTr);
+}
+
 //-----------------------------------------------
 void CanDriveHarmonica::sendSDODownload(int iObjIndex, int iObjSubIndex, int iData)
 {
@@ -1080,6 +1436,8 @@ int CanDriveHarmonica::receivedSDOSegmentedInitiation(CanMsg& msg) {
 		if( (msg.getAt(0) & 0x01) == 1) {
 			seg_Data.numTotalBytes = msg.getAt(7) << 24 | msg.getAt(6) << 16 | msg.getAt(5) << 8 | msg.getAt(4);
 		} else seg_Data.numTotalBytes = 0;
+		//collect without reallocations, the announced size is not trusted beyond the largest recorder upload
+		seg_Data.data.reserve(std::min(seg_Data.numTotalBytes, (unsigned int)ElmoRecorder::MAX_UPLOAD_BYTES));
 
 		sendSDOUploadSegmentConfirmation(seg_Data.toggleBit);
 	}
@@ -1100,6 +1458,8 @@ int CanDriveHarmonica::receivedSDODataSegment(CanMsg& msg){
 	if( (msg.getAt(0) & 0x10) != (seg_Data.toggleBit << 4) ) { 
 		std::cout << "Toggle Bit error, send Abort SDO with \"Toggle bit not alternated\" error" << std::endl;
 		sendSDOAbort(seg_Data.objectID, seg_Data.objectSubID, 0x05030000); //Send SDO Abort with error code Toggle-Bit not alternated
+		ElmoRec->setUploadResult(ElmoRecorder::UPLOAD_ABORTED);
+		seg_Data.resetTransferData();
 		return 1;
 	}
 		
@@ -1113,9 +1473,9 @@ int CanDriveHarmonica::receivedSDODataSegment(CanMsg& msg){
 	numEmptyBytes = (msg.getAt(0) >> 1) & 0x07;
 	//std::cout << "NUM empty bytes in SDO :" << numEmptyBytes << std::endl;
 	
-	for(int i=1; i<=7-numEmptyBytes; i++) {
-		seg_Data.data.push_back(msg.getAt(i));
-	}
+	unsigned char cData[8];
+	msg.get(&cData[0], &cData[1], &cData[2], &cData[3], &cData[4], &cData[5], &cData[6], &cData[7]);
+	seg_Data.data.insert(seg_Data.data.end(), cData + 1, cData + 8 - numEmptyBytes);
 
 	if(seg_Data.statusFlag == segData::SDO_SEG_PROCESSING) {
 		finishedSDOSegmentedTransfer();		
@@ -1168,22 +1528,160 @@ void CanDriveHarmonica::finishedSDOSegmentedTransfer() {
 }
 
 //-----------------------------------------------
-double CanDriveHarmonica::estimVel(double dPos)
-{
-	double dVel;
-	double dt;
+int CanDriveHarmonica::receivedSDOBlockInitiation(CanMsg& msg) {
 
-	m_CurrentTime.SetNow();
+	if(!seg_Data.blockTransfer || seg_Data.statusFlag != segData::SDO_SEG_WAITING) {
+		//no block upload requested
+		sendSDOAbort((msg.getAt(2) << 8) | msg.getAt(1), msg.getAt(3), 0x05040001); //Client/server command specifier not valid
+		return 1;
+	}
 
-	dt = m_CurrentTime - m_VelCalcTime;
+	//Byte 0: SSS XX C S 0 | SSS=Cmd-Specifier (6), C=CRC supported, S=Size indicated
+	//Byte 1 to 3: Object, Byte 4 to 7: Number of bytes
+	seg_Data.data.clear();
+	seg_Data.toggleBit = false;
+	seg_Data.statusFlag = segData::SDO_SEG_COLLECTING;
+	evalSDO(msg, &seg_Data.objectID, &seg_Data.objectSubID);
+	seg_Data.blockCRC = (msg.getAt(0) & 0x04) != 0;
+	seg_Data.blockSeqNo = 0;
+	seg_Data.blockLastSegment = false;
+
+	if( (msg.getAt(0) & 0x02) != 0) {
+		seg_Data.numTotalBytes = getSDODataInt32(msg);
+	} else seg_Data.numTotalBytes = 0;
+	if(seg_Data.numTotalBytes > ElmoRecorder::MAX_UPLOAD_BYTES) {
+		std::cout << "SDO block upload of " << seg_Data.numTotalBytes << " bytes exceeds the largest recorder upload, aborted" << std::endl;
+		sendSDOAbort(seg_Data.objectID, seg_Data.objectSubID, 0x05040005); //Out of memory
+		ElmoRec->setUploadResult(ElmoRecorder::UPLOAD_ABORTED);
+		seg_Data.resetTransferData();
+		return 1;
+	}
+	//the last segment is collected completely, its unused bytes are removed at the end
+	seg_Data.data.reserve(seg_Data.numTotalBytes + 7);
 
-	dVel = (dPos - m_dOldPos)/dt;
+	//Start upload: ccs = 5, cs = 3
+	CanMsg CMsgTr;
+	CMsgTr.m_iLen = 8;
+	CMsgTr.m_iID = m_ParamCanOpen.iRxSDO;
+	CMsgTr.set(0xA3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00);
+	m_pCanCtrl->transmitMsg(CMsgTr);
+
+	return 0;
+}
 
-	m_dOldPos = dPos;
-	m_VelCalcTime.SetNow();
+//-----------------------------------------------
+int CanDriveHarmonica::receivedSDOBlockSegment(CanMsg& msg) {
+
+	//Byte 0: C SSSSSSS | C=Last segment, SSSSSSS=Sequence number 1..blockSize
+	//Byte 1 to 7: Data
+	int iSeqNo = msg.getAt(0) & 0x7F;
+	bool bLast = (msg.getAt(0) & 0x80) != 0;
+
+	if(iSeqNo == seg_Data.blockSeqNo + 1) {
+		unsigned char cData[8];
+		msg.get(&cData[0], &cData[1], &cData[2], &cData[3], &cData[4], &cData[5], &cData[6], &cData[7]);
+		seg_Data.data.insert(seg_Data.data.end(), cData + 1, cData + 8);
+		seg_Data.blockSeqNo = iSeqNo;
+		if(bLast) seg_Data.blockLastSegment = true;
+	}
 
-	return dVel;
+	//the device waits for the confirmation after the last segment of a block
+	if(bLast || iSeqNo >= seg_Data.blockSize) {
+		if(m_bSDOBlockAckHold)
+			seg_Data.blockAckPending = true;
+		else
+			sendSDOBlockAck();
+	}
+
+	return 0;
 }
+
+//-----------------------------------------------
+void CanDriveHarmonica::sendSDOBlockAck() {
+
+	CanMsg CMsgTr;
+	const int ciBlockUploadResponse = 0xA2; //ccs = 5, cs = 2
+
+	CMsgTr.m_iLen = 8;
+	CMsgTr.m_iID = m_ParamCanOpen.iRxSDO;
+	//Byte 1: last segment received in sequence, the device repeats the ones after it
+	//Byte 2: number of segments of the next block
+	CMsgTr.set(ciBlockUploadResponse, seg_Data.blockSeqNo, seg_Data.blockSize, 0x00, 0x00, 0x00, 0x00, 0x00);
+	m_pCanCtrl->transmitMsg(CMsgTr);
+
+	seg_Data.blockSeqNo = 0;
+	seg_Data.blockAckPending = false;
+}
+
+//-----------------------------------------------
+int CanDriveHarmonica::receivedSDOBlockEnd(CanMsg& msg) {
+
+	if(!seg_Data.blockTransfer || !seg_Data.blockLastSegment) {
+		return 1;
+	}
+
+	//Byte 0: SSS NNN X 1 | SSS=Cmd-Specifier (6), NNN=num of empty bytes in the last segment
+	//Byte 1, 2: CRC
+	unsigned int iNumEmptyBytes = (msg.getAt(0) >> 2) & 0x07;
+	if(iNumEmptyBytes <= seg_Data.data.size()) {
+		seg_Data.data.resize(seg_Data.data.size() - iNumEmptyBytes);
+	}
+
+	if(seg_Data.blockCRC) {
+		unsigned short iCRC = msg.getAt(1) | (msg.getAt(2) << 8);
+		if(iCRC != calcSDOBlockCRC(seg_Data.data)) {
+			std::cout << "CRC error in SDO block upload, send Abort SDO" << std::endl;
+			sendSDOAbort(seg_Data.objectID, seg_Data.objectSubID, 0x05040004); //CRC error
+			ElmoRec->setUploadResult(ElmoRecorder::UPLOAD_CRC_ERROR);
+			seg_Data.resetTransferData();
+			return 1;
+		}
+	}
+
+	//End block upload response: ccs = 5, cs = 1
+	CanMsg CMsgTr;
+	CMsgTr.m_iLen = 8;
+	CMsgTr.m_iID = m_ParamCanOpen.iRxSDO;
+	CMsgTr.set(0xA1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00);
+	m_pCanCtrl->transmitMsg(CMsgTr);
+
+	seg_Data.resetBlockTransfer();
+	finishedSDOSegmentedTransfer();
+
+	return 0;
+}
+
+//-----------------------------------------------
+unsigned short CanDriveHarmonica::calcSDOBlockCRC(const std::vector<unsigned char>& data) {
+	unsigned short iCRC = 0;
+
+	for(unsigned int i = 0; i < data.size(); i++) {
+		iCRC ^= data[i] << 8;
+		for(int iBit = 0; iBit < 8; iBit++) {
+			if(iCRC & 0x8000)
+				iCRC = (iCRC << 1) ^ 0x1021;
+			else
+				iCRC = iCRC << 1;
+		}
+	}
+
+	return iCRC;
+}
+
+//-----------------------------------------------
+void CanDriveHarmonica::setDriveParam(DriveParam driveParam)
+{
+	m_DriveParam = driveParam;
+
+	// measurement noise is the quantization of the encoder,
+	// motion noise the largest acceleration of the drive
+	double dIncrToRad = fabs(m_DriveParam.PosMotIncrToPosGearRad(1));
+	double dAccMax = std::max(fabs(m_DriveParam.getMaxAcc()), fabs(m_DriveParam.getMaxDec()));
+	if(dAccMax > 0)
+		m_VelEstimator.setParam(dAccMax * dIncrToRad, dIncrToRad / sqrt(12.0));
+	m_VelEstimator.reset();
+}
+
 //-----------------------------------------------
 bool CanDriveHarmonica::evalStatusRegister(int iStatus)
 {
@@ -1345,11 +1843,7 @@ void CanDriveHarmonica::setMotorTorque(double dTorqueNm)
 	IntprtSetFloat(8, 'T', 'C', 0, fMotCurr);
 
 	// request pos and vel by TPDO1, triggered by SYNC msg
-	CanMsg msg;
-	msg.m_iID  = 0x80;
-	msg.m_iLen = 0;
-	msg.set(0,0,0,0,0,0,0,0);
-	m_pCanCtrl->transmitMsg(msg);
+	sendSync();
 
 	// send heartbeat to keep watchdog inactive
 	sendHeartbeat();
@@ -1401,7 +1895,7 @@ int CanDriveHarmonica::setRecorder(int iFlag, int iParam, std::string sParam) {
 		case 1: //Query upload of previous recorded data, data is being proceeded after complete upload, param = recorded ID, filename
 			if(!ElmoRec->isInitialized(false)) return 1;
 			
-			if(seg_Data.statusFlag == segData::SDO_SEG_FREE) {
+			if(seg_Data.statusFlag == segData::SDO_SEG_FREE && m_SDOClient.isIdle()) { //the SDO channel is not shared with the SDO client
 				if( (iParam != 1) && (iParam != 2) && (iParam != 10) && (iParam != 16) ) {
 					iParam = 1;
 					std::cout << "Changed the Readout object to #1 as your selected object hasn't been recorded!" << std::endl;
@@ -1433,9 +1927,38 @@ int CanDriveHarmonica::setRecorder(int iFlag, int iParam, std::string sParam) {
 			
 			break;
 			
+		case 3: //Pace block uploads, param = segments per block, 0 for unpaced uploads
+			if(iParam > 127) iParam = 127;
+			if(iParam > 0) {
+				m_iSDOBlockSize = iParam;
+				m_bSDOBlockAckHold = true;
+			} else {
+				m_iSDOBlockSize = 127;
+				m_bSDOBlockAckHold = false;
+				//do not leave a held back block behind
+				if(seg_Data.blockAckPending) sendSDOBlockAck();
+			}
+			return 0;
+
+		case 4: //Release the confirmation of the current block
+			if(seg_Data.blockTransfer && seg_Data.blockAckPending) {
+				sendSDOBlockAck();
+				return 0;
+			}
+			return 2;
+
+		case 5: //Select the log format of following readouts, param = ElmoRecorder::LogFormat
+			ElmoRec->setLogFormat(iParam);
+			return 0;
+
+		case 6: //Result of the last readout, see ElmoRecorder::UploadResult
+			return ElmoRec->getUploadResult();
+
 		case 99: //Abort ongoing SDO data Transmission and clear collected data
+			if(seg_Data.statusFlag != segData::SDO_SEG_FREE)
+				ElmoRec->setUploadResult(ElmoRecorder::UPLOAD_ABORTED);
 			sendSDOAbort(0x2030, 0x00, 0x08000020); //send general error abort
-			seg_Data.resetTransferData(); //!overwrites previous collected data (even from other processes)
+			seg_Data.resetTransferData(); //also ends a block upload //!overwrites previous collected data (even from other processes)
 			return 0;
 	}
 
@@ -55,7 +55,9 @@
 #include <vector>
 #include <stdio.h>
 #include <sstream>
+#include <algorithm>
 #include <cob_canopen_motor/ElmoRecorder.h>
+#include <cob_canopen_motor/ElmoTrace.h>
 #include <cob_canopen_motor/CanDriveHarmonica.h>
 
 ElmoRecorder::ElmoRecorder(CanDriveHarmonica * pParentHarmonicaDrive) {
@@ -63,6 +65,8 @@ ElmoRecorder::ElmoRecorder(CanDriveHarmonica * pParentHarmonicaDrive) {
 	
 	m_bIsInitialized = false;
 	m_iReadoutRecorderTry = 0;
+	m_iUploadResult = UPLOAD_PENDING;
+	m_iLogFormat = LOG_BINARY;
 }
 
 ElmoRecorder::~ElmoRecorder() {
@@ -110,6 +114,7 @@ int ElmoRecorder::readoutRecorderTry(int iObjSubIndex) {
 	
 	m_iReadoutRecorderTry = 1;
 	m_iCurrentObject = iObjSubIndex;
+	m_iUploadResult = UPLOAD_PENDING;
 	
 	m_pHarmonicaDrive->requestStatus();
 	
@@ -126,9 +131,11 @@ int ElmoRecorder::readoutRecorderTryStatus(int iStatusReg, segData& SDOData) {
 
 	if(iRecorderStatus == 0) {
 		std::cout << "Recorder " << m_iDriveID << " inactive with no valid data to upload" << std::endl;
+		m_iUploadResult = UPLOAD_NO_DATA;
 		SDOData.statusFlag = segData::SDO_SEG_FREE;
 	} else if(iRecorderStatus == 1) {
 		std::cout << "Recorder " << m_iDriveID << " waiting for a trigger event" << std::endl;
+		m_iUploadResult = UPLOAD_NO_DATA;
 		SDOData.statusFlag = segData::SDO_SEG_FREE;
 	} else if(iRecorderStatus == 2) {
 		std::cout << "Recorder " << m_iDriveID << " finished, valid data ready for use" << std::endl;
@@ -136,6 +143,7 @@ int ElmoRecorder::readoutRecorderTryStatus(int iStatusReg, segData& SDOData) {
 		//already set to SDOData.statusFlag = segData::SDO_SEG_WAITING;
 	} else if(iRecorderStatus == 3) {
 		std::cout << "Recorder " << m_iDriveID << " is still recording" << std::endl;
+		m_iUploadResult = UPLOAD_NO_DATA;
 		SDOData.statusFlag = segData::SDO_SEG_FREE;
 	}
 	
@@ -146,7 +154,8 @@ int ElmoRecorder::readoutRecorder(int iObjSubIndex){
 	//initialize Upload of Recorded Data (object 0x2030)
 	int iObjIndex = 0x2030;
 
-	m_pHarmonicaDrive->sendSDOUpload(iObjIndex, iObjSubIndex);
+	//block upload: one confirmation per block of segments instead of one per segment
+	m_pHarmonicaDrive->sendSDOBlockUpload(iObjIndex, iObjSubIndex);
 	m_iCurrentObject = iObjSubIndex;
 	
 	return 0;
@@ -157,6 +166,7 @@ int ElmoRecorder::processData(segData& SDOData) {
 	int iItemCount = 0;
 	unsigned int iNumDataItems = 0;
 	bool bCollectFloats = true;
+	int iSampleType = ElmoTraceFile::SAMPLE_INT32;
 	float fFloatingPointFactor = 0;
 	
 	std::vector<float> vfResData[2];
@@ -173,23 +183,34 @@ int ElmoRecorder::processData(segData& SDOData) {
 	//
 	//Byte 7 to Byte (7+ iNumdataItems * 4) contain data
 	
+	if(SDOData.data.size() < 7) {
+		std::cout << "Recorder " << m_iDriveID << " uploaded " << SDOData.data.size() << " bytes, no header" << std::endl;
+		m_iUploadResult = UPLOAD_NO_DATA;
+		SDOData.statusFlag = segData::SDO_SEG_FREE;
+		return 0;
+	}
+
 	//B[0]: Time quantum and data type
 	switch ((SDOData.data[0] >> 4) ) {
 		case 4:
 			bCollectFloats = false;
 			iItemSize = 4;
+			iSampleType = ElmoTraceFile::SAMPLE_INT32;
 			break;
 		case 5:
 			bCollectFloats = true;
 			iItemSize = 4;
+			iSampleType = ElmoTraceFile::SAMPLE_FLOAT32;
 			break;
 		case 1:
 			bCollectFloats = true;
 			iItemSize = 2;
+			iSampleType = ElmoTraceFile::SAMPLE_FLOAT16;
 			break;
 		default:
 			bCollectFloats = false;
 			iItemSize = 4;
+			iSampleType = ElmoTraceFile::SAMPLE_INT32;
 			break;
 	}
 	std::cout << ">>>>>ElmoRec: HEADER INFOS<<<<<\nData type is: " << (SDOData.data[0] >> 4) << std::endl;
@@ -211,6 +232,21 @@ int ElmoRecorder::processData(segData& SDOData) {
 	//END HEADER
 	//--------------------------------------
 
+	bool bWritten = true;
+	if(m_iLogFormat & LOG_BINARY) {
+		//the samples are stored as sent by the drive, the trace reader converts them
+		unsigned int iNumSamples = 0;
+		if(SDOData.data.size() > 7)
+			iNumSamples = std::min(iNumDataItems, (unsigned int)((SDOData.data.size() - 7) / iItemSize));
+		bWritten = logToTraceFile(m_sLogFilename, iSampleType, iNumSamples, fFloatingPointFactor, (iNumSamples > 0) ? &SDOData.data[7] : NULL);
+	}
+
+	if((m_iLogFormat & LOG_TEXT) == 0) {
+		m_iUploadResult = bWritten ? UPLOAD_SUCCEEDED : UPLOAD_WRITE_ERROR;
+		SDOData.statusFlag = segData::SDO_SEG_FREE;
+		return 0;
+	}
+
 	vfResData[0].assign(iNumDataItems, 0.0);
 	vfResData[1].assign(iNumDataItems, 0.0);
 	iItemCount = 0;
@@ -235,8 +271,10 @@ int ElmoRecorder::processData(segData& SDOData) {
 		vfResData[0][iItemCount] = m_fRecordingStepSec * iItemCount;
 	}
 	
-	logToFile(m_sLogFilename, vfResData);
+	if(!logToFile(m_sLogFilename, vfResData))
+		bWritten = false;
 
+	m_iUploadResult = bWritten ? UPLOAD_SUCCEEDED : UPLOAD_WRITE_ERROR;
 	SDOData.statusFlag = segData::SDO_SEG_FREE;
 	return 0;
 }
@@ -246,6 +284,12 @@ int ElmoRecorder::setLogFilename(std::string sLogFileprefix) {
 	return 0;
 }
 
+int ElmoRecorder::setLogFormat(int iLogFormat) {
+	if((iLogFormat & (LOG_TEXT | LOG_BINARY)) == 0) iLogFormat = LOG_BINARY;
+	m_iLogFormat = iLogFormat & (LOG_TEXT | LOG_BINARY);
+	return 0;
+}
+
 
 
 float ElmoRecorder::convertBinaryToFloat(unsigned int iBinaryRepresentation) {
@@ -315,14 +359,33 @@ int ElmoRecorder::logToFile(std::string filename, std::vector<float> vtValues[])
 	if( pFile == NULL ) 
 	{	
 		std::cout << "Error while writing file: " << outputFileName.str() << " Maybe the selected folder does'nt exist." << std::endl;
+		return false;
 	} 
-	else 
-	{
-		// write all data from vector to file
-		for (unsigned int i = 0; i < vtValues[0].size(); i++)
-			fprintf(pFile, "%e %e\n", vtValues[0][i], vtValues[1][i]);
-		fclose(pFile);
-	}
-	
-	return true;
+
+	// write all data from vector to file
+	bool bOk = true;
+	for (unsigned int i = 0; i < vtValues[0].size() && bOk; i++)
+		bOk = (fprintf(pFile, "%e %e\n", vtValues[0][i], vtValues[1][i]) > 0);
+	if(fclose(pFile) != 0)
+		bOk = false;
+
+	if(!bOk)
+		std::cout << "Error while writing file: " << outputFileName.str() << std::endl;
+	return bOk;
+}
+
+// Function for writing the binary trace file
+int ElmoRecorder::logToTraceFile(std::string filename, int iSampleType, unsigned int iNumSamples, float fScaleFactor, const unsigned char* pSamples) {
+	std::stringstream outputFileName;
+	outputFileName << filename << "mot_" << m_iDriveID << "_" << m_iCurrentObject << ".trace";
+
+	ElmoTraceHeader header;
+	header.iDriveID = m_iDriveID;
+	header.iObject = m_iCurrentObject;
+	header.iSampleType = iSampleType;
+	header.iNumSamples = iNumSamples;
+	header.fScaleFactor = fScaleFactor;
+	header.dSamplePeriodSec = m_fRecordingStepSec;
+
+	return ElmoTraceFile::write(outputFileName.str(), header, pSamples);
 }
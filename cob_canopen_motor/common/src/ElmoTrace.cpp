@@ -0,0 +1,367 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Binary trace files of the ElmoRecorder: writer and reader for fast offline analysis of many recordings.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#include <cob_canopen_motor/ElmoTrace.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char c_cTraceMagic[4] = {'E', 'L', 'T', 'R'};
+static const unsigned int c_iTraceVersion = 1;
+
+//-----------------------------------------------
+// little endian helpers, independent of the host byte order
+static void putUInt16(unsigned char* p, unsigned int i)
+{
+	p[0] = i & 0xFF;
+	p[1] = (i >> 8) & 0xFF;
+}
+
+static void putUInt32(unsigned char* p, unsigned int i)
+{
+	p[0] = i & 0xFF;
+	p[1] = (i >> 8) & 0xFF;
+	p[2] = (i >> 16) & 0xFF;
+	p[3] = (i >> 24) & 0xFF;
+}
+
+static unsigned int getUInt16(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static unsigned int getUInt32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static float uint32ToFloat(unsigned int i)
+{
+	float f;
+	memcpy(&f, &i, sizeof(f));
+	return f;
+}
+
+//-----------------------------------------------
+unsigned int ElmoTraceFile::getSampleSize(int iSampleType)
+{
+	switch(iSampleType)
+	{
+	case SAMPLE_INT32:
+	case SAMPLE_FLOAT32:
+		return 4;
+	case SAMPLE_FLOAT16:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+//-----------------------------------------------
+float ElmoTraceFile::decodeSample(int iSampleType, const unsigned char* pSample)
+{
+	unsigned int iRaw;
+	switch(iSampleType)
+	{
+	case SAMPLE_INT32:
+		return (float)(int)getUInt32(pSample);
+	case SAMPLE_FLOAT32:
+		return uint32ToFloat(getUInt32(pSample));
+	case SAMPLE_FLOAT16:
+	{
+		//IEEE 754 half precision
+		iRaw = getUInt16(pSample);
+		unsigned int iSign = (iRaw & 0x8000) << 16;
+		unsigned int iExponent = (iRaw >> 10) & 0x1F;
+		unsigned int iMantissa = iRaw & 0x3FF;
+		if(iExponent == 0)
+		{
+			//zero and subnormal numbers
+			float f = ldexpf((float)iMantissa, -24);
+			return iSign ? -f : f;
+		}
+		if(iExponent == 0x1F)
+			return uint32ToFloat(iSign | 0x7F800000 | (iMantissa << 13));
+		return uint32ToFloat(iSign | ((iExponent + 127 - 15) << 23) | (iMantissa << 13));
+	}
+	default:
+		return 0.0f;
+	}
+}
+
+//-----------------------------------------------
+bool ElmoTraceFile::write(const std::string& sFilename, const ElmoTraceHeader& header, const unsigned char* pSamples)
+{
+	unsigned int iSampleSize = getSampleSize(header.iSampleType);
+	if(iSampleSize == 0)
+	{
+		std::cout << "ElmoTrace: unknown sample type " << header.iSampleType << std::endl;
+		return false;
+	}
+
+	unsigned char cHeader[HEADER_SIZE];
+	memcpy(cHeader, c_cTraceMagic, 4);
+	putUInt16(cHeader + 4, c_iTraceVersion);
+	putUInt16(cHeader + 6, header.iSampleType);
+	putUInt32(cHeader + 8, header.iDriveID);
+	putUInt32(cHeader + 12, header.iObject);
+	putUInt32(cHeader + 16, header.iNumSamples);
+	unsigned int iScale;
+	memcpy(&iScale, &header.fScaleFactor, 4);
+	putUInt32(cHeader + 20, iScale);
+	unsigned long long iPeriod;
+	memcpy(&iPeriod, &header.dSamplePeriodSec, 8);
+	putUInt32(cHeader + 24, (unsigned int)(iPeriod & 0xFFFFFFFF));
+	putUInt32(cHeader + 28, (unsigned int)(iPeriod >> 32));
+
+	FILE* pFile = fopen(sFilename.c_str(), "wb");
+	if(pFile == NULL)
+	{
+		std::cout << "Error while writing file: " << sFilename << " Maybe the selected folder does'nt exist." << std::endl;
+		return false;
+	}
+
+	size_t iDataSize = (size_t)header.iNumSamples * iSampleSize;
+	bool bOk = (fwrite(cHeader, 1, HEADER_SIZE, pFile) == HEADER_SIZE);
+	if(bOk && iDataSize > 0)
+		bOk = (fwrite(pSamples, 1, iDataSize, pFile) == iDataSize);
+	if(fclose(pFile) != 0)
+		bOk = false;
+
+	if(!bOk)
+		std::cout << "Error while writing file: " << sFilename << std::endl;
+	return bOk;
+}
+
+//-----------------------------------------------
+ElmoTraceReader::ElmoTraceReader()
+{
+	memset(&m_Header, 0, sizeof(m_Header));
+	m_pData = NULL;
+	m_iSize = 0;
+	m_bMapped = false;
+}
+
+ElmoTraceReader::~ElmoTraceReader()
+{
+	close();
+}
+
+//-----------------------------------------------
+bool ElmoTraceReader::open(const std::string& sFilename, bool bMemoryMapped)
+{
+	close();
+
+	int iFd = ::open(sFilename.c_str(), O_RDONLY);
+	if(iFd < 0)
+	{
+		std::cout << "ElmoTrace: can't open " << sFilename << std::endl;
+		return false;
+	}
+
+	struct stat fileStat;
+	if(fstat(iFd, &fileStat) != 0 || (size_t)fileStat.st_size < ElmoTraceFile::HEADER_SIZE)
+	{
+		std::cout << "ElmoTrace: " << sFilename << " is no trace file" << std::endl;
+		::close(iFd);
+		return false;
+	}
+	m_iSize = fileStat.st_size;
+
+	if(bMemoryMapped)
+	{
+		void* pMap = mmap(NULL, m_iSize, PROT_READ, MAP_PRIVATE, iFd, 0);
+		if(pMap != MAP_FAILED)
+		{
+			m_pData = (const unsigned char*)pMap;
+			m_bMapped = true;
+		}
+	}
+
+	if(m_pData == NULL)
+	{
+		m_vBuffer.resize(m_iSize);
+		size_t iRead = 0;
+		while(iRead < m_iSize)
+		{
+			ssize_t iRet = read(iFd, &m_vBuffer[iRead], m_iSize - iRead);
+			if(iRet <= 0)
+				break;
+			iRead += iRet;
+		}
+		if(iRead == m_iSize)
+			m_pData = &m_vBuffer[0];
+	}
+	::close(iFd);
+
+	if(m_pData == NULL)
+	{
+		std::cout << "ElmoTrace: error while reading " << sFilename << std::endl;
+		close();
+		return false;
+	}
+
+	//check the header
+	if(memcmp(m_pData, c_cTraceMagic, 4) != 0 || getUInt16(m_pData + 4) != c_iTraceVersion)
+	{
+		std::cout << "ElmoTrace: " << sFilename << " is no trace file of version " << c_iTraceVersion << std::endl;
+		close();
+		return false;
+	}
+
+	m_Header.iSampleType = getUInt16(m_pData + 6);
+	m_Header.iDriveID = (int)getUInt32(m_pData + 8);
+	m_Header.iObject = (int)getUInt32(m_pData + 12);
+	m_Header.iNumSamples = getUInt32(m_pData + 16);
+	m_Header.fScaleFactor = uint32ToFloat(getUInt32(m_pData + 20));
+	unsigned long long iPeriod = getUInt32(m_pData + 24) | ((unsigned long long)getUInt32(m_pData + 28) << 32);
+	memcpy(&m_Header.dSamplePeriodSec, &iPeriod, 8);
+
+	unsigned int iSampleSize = ElmoTraceFile::getSampleSize(m_Header.iSampleType);
+	if(iSampleSize == 0 || (m_iSize - ElmoTraceFile::HEADER_SIZE) / iSampleSize < m_Header.iNumSamples)
+	{
+		std::cout << "ElmoTrace: " << sFilename << " is truncated or has an unknown sample type" << std::endl;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------
+void ElmoTraceReader::close()
+{
+	if(m_bMapped)
+		munmap((void*)m_pData, m_iSize);
+	m_pData = NULL;
+	m_iSize = 0;
+	m_bMapped = false;
+	std::vector<unsigned char>().swap(m_vBuffer);
+	memset(&m_Header, 0, sizeof(m_Header));
+}
+
+//-----------------------------------------------
+void ElmoTraceReader::getValues(float* pfValues) const
+{
+	const unsigned char* pSample = getRawSamples();
+	unsigned int iSampleSize = ElmoTraceFile::getSampleSize(m_Header.iSampleType);
+	float fScale = m_Header.fScaleFactor;
+	int iType = m_Header.iSampleType;
+
+	for(unsigned int i = 0; i < m_Header.iNumSamples; i++, pSample += iSampleSize)
+		pfValues[i] = fScale * ElmoTraceFile::decodeSample(iType, pSample);
+}
+
+void ElmoTraceReader::getValues(std::vector<float>& vfValues) const
+{
+	vfValues.resize(m_Header.iNumSamples);
+	if(m_Header.iNumSamples > 0)
+		getValues(&vfValues[0]);
+}
+
+//-----------------------------------------------
+bool ElmoTraceReader::exportToText(const std::string& sFilename) const
+{
+	if(!isOpen())
+		return false;
+
+	FILE* pFile = fopen(sFilename.c_str(), "w");
+	if(pFile == NULL)
+	{
+		std::cout << "Error while writing file: " << sFilename << " Maybe the selected folder does'nt exist." << std::endl;
+		return false;
+	}
+
+	std::vector<float> vfValues;
+	getValues(vfValues);
+	for(unsigned int i = 0; i < vfValues.size(); i++)
+		fprintf(pFile, "%e %e\n", (float)getTime(i), vfValues[i]);
+	fclose(pFile);
+
+	return true;
+}
+
+//-----------------------------------------------
+int ElmoTraceReader::loadTraces(const std::vector<std::string>& vsFilenames, std::vector<ElmoTraceHeader>& vHeaders,
+	std::vector<float>& vfValues, std::vector<unsigned int>& viOffset)
+{
+	int iNumRead = 0;
+	ElmoTraceReader reader;
+
+	vHeaders.resize(vsFilenames.size());
+	viOffset.resize(vsFilenames.size() + 1);
+	vfValues.clear();
+	viOffset[0] = 0;
+
+	for(unsigned int i = 0; i < vsFilenames.size(); i++)
+	{
+		if(reader.open(vsFilenames[i]))
+		{
+			vHeaders[i] = reader.getHeader();
+			unsigned int iStart = vfValues.size();
+			vfValues.resize(iStart + vHeaders[i].iNumSamples);
+			if(vHeaders[i].iNumSamples > 0)
+				reader.getValues(&vfValues[iStart]);
+			iNumRead++;
+		}
+		else
+			memset(&vHeaders[i], 0, sizeof(ElmoTraceHeader));
+
+		viOffset[i + 1] = vfValues.size();
+	}
+
+	return iNumRead;
+}
@@ -0,0 +1,507 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Simulated ELMO Harmonica drive for CanSimBus or a vcan interface.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+//-----------------------------------------------
+#include <cob_canopen_motor/HarmonicaSim.h>
+#include <string.h>
+#include <math.h>
+
+//-----------------------------------------------
+#define INTPRT_KEY(c1, c2, iIndex) (((c1) << 24) | ((c2) << 16) | (iIndex))
+
+// sampling time of the drive, the recorder gap is a multiple of it
+static const double c_dTSSec = 90e-6;
+
+//-----------------------------------------------
+static unsigned short calcCRC(const std::vector<unsigned char>& data)
+{
+	// CRC of the SDO block transfer (CCITT, see CanDriveHarmonica::calcSDOBlockCRC)
+	unsigned short iCRC = 0;
+
+	for(unsigned int i = 0; i < data.size(); i++)
+	{
+		iCRC ^= data[i] << 8;
+		for(int iBit = 0; iBit < 8; iBit++)
+		{
+			if(iCRC & 0x8000)
+				iCRC = (iCRC << 1) ^ 0x1021;
+			else
+				iCRC = iCRC << 1;
+		}
+	}
+
+	return iCRC;
+}
+
+//-----------------------------------------------
+HarmonicaSim::HarmonicaSim(int iNodeID)
+{
+	setCanOpenParam(0x180 + iNodeID, 0x280 + iNodeID, 0x300 + iNodeID, 0x580 + iNodeID, 0x600 + iNodeID);
+
+	m_dTimeSec = 0;
+	m_dPosIncr = 0;
+	m_dVelIncrS = 0;
+	m_bMotorOn = false;
+	m_bPosMode = false;
+	m_dTargetIncr = 0;
+	m_dNextTargetIncr = 0;
+	m_iHomingSwitchIncr = 10000;
+
+	m_Intprt[INTPRT_KEY('U', 'M', 0)] = 2;
+	m_Intprt[INTPRT_KEY('R', 'L', 0)] = 1024;
+	m_Intprt[INTPRT_KEY('R', 'G', 0)] = 1;
+
+	m_dRecStartSec = -1;
+	m_dRecPosIncr = 0;
+	m_dRecVelIncrS = 0;
+	m_bRecActive = false;
+
+	m_iUploadPos = 0;
+	m_iBlockStartPos = 0;
+	m_iUploadIndex = 0;
+	m_iUploadSubIndex = 0;
+	m_bUploadToggle = false;
+	m_iBlockSize = 0;
+}
+
+//-----------------------------------------------
+void HarmonicaSim::setCanOpenParam(int iTxPDO1, int iTxPDO2, int iRxPDO2, int iTxSDO, int iRxSDO)
+{
+	m_iTxPDO1 = iTxPDO1;
+	m_iTxPDO2 = iTxPDO2;
+	m_iRxPDO2 = iRxPDO2;
+	m_iTxSDO = iTxSDO;
+	m_iRxSDO = iRxSDO;
+}
+
+//-----------------------------------------------
+void HarmonicaSim::evalMsg(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies)
+{
+	if(msg.m_iID == 0x80)
+	{
+		// SYNC -> position and velocity by TxPDO1
+		move(dTimeSec);
+
+		int iPos = (int)m_dPosIncr;
+		int iVel = (int)m_dVelIncrS;
+		CanMsg reply;
+		reply.m_iID = m_iTxPDO1;
+		reply.m_iLen = 8;
+		reply.set(iPos, iPos >> 8, iPos >> 16, iPos >> 24, iVel, iVel >> 8, iVel >> 16, iVel >> 24);
+		vReplies.push_back(reply);
+	}
+	else if(msg.m_iID == m_iRxPDO2)
+	{
+		evalIntprt(msg, dTimeSec, vReplies);
+	}
+	else if(msg.m_iID == m_iRxSDO)
+	{
+		evalSDO(msg, dTimeSec, vReplies);
+	}
+}
+
+//-----------------------------------------------
+int HarmonicaSim::getIntprt(int c1, int c2, int iIndex)
+{
+	std::map<int, int>::iterator it = m_Intprt.find(INTPRT_KEY(c1, c2, iIndex));
+	return (it != m_Intprt.end()) ? it->second : 0;
+}
+
+//-----------------------------------------------
+void HarmonicaSim::move(double dTimeSec)
+{
+	double dt = dTimeSec - m_dTimeSec;
+	if(dt <= 0)
+		return;
+	m_dTimeSec = dTimeSec;
+
+	if(!m_bMotorOn)
+	{
+		m_dVelIncrS = 0;
+		return;
+	}
+
+	double dPosOld = m_dPosIncr;
+
+	if(m_bPosMode)
+	{
+		double dDist = m_dTargetIncr - m_dPosIncr;
+		double dStep = fabs((double)getIntprt('S', 'P', 0)) * dt;
+		if(fabs(dDist) <= dStep)
+		{
+			m_dPosIncr = m_dTargetIncr;
+			m_dVelIncrS = 0;
+		}
+		else
+		{
+			m_dVelIncrS = (dDist > 0) ? fabs((double)getIntprt('S', 'P', 0)) : -fabs((double)getIntprt('S', 'P', 0));
+			m_dPosIncr += m_dVelIncrS * dt;
+		}
+	}
+	else
+		m_dPosIncr += m_dVelIncrS * dt;
+
+	// armed homing: the switch has been passed -> load the position counter and disarm
+	if( (getIntprt('H', 'M', 1) == 1)
+		&& (std::min(dPosOld, m_dPosIncr) <= m_iHomingSwitchIncr) && (std::max(dPosOld, m_dPosIncr) >= m_iHomingSwitchIncr) )
+	{
+		m_Intprt[INTPRT_KEY('H', 'M', 1)] = 0;
+		if(getIntprt('H', 'M', 5) == 0)
+		{
+			double dOffset = getIntprt('H', 'M', 2) - m_iHomingSwitchIncr;
+			m_dPosIncr += dOffset;
+			m_dTargetIncr += dOffset;
+		}
+		if(getIntprt('H', 'M', 4) == 0)
+			m_dVelIncrS = 0;
+	}
+}
+
+//-----------------------------------------------
+void HarmonicaSim::evalIntprt(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies)
+{
+	int c1 = msg.getAt(0);
+	int c2 = msg.getAt(1);
+	int iIndex = msg.getAt(2) | ((msg.getAt(3) & 0x3F) << 8);
+	int iData = msg.getAt(4) | (msg.getAt(5) << 8) | (msg.getAt(6) << 16) | (msg.getAt(7) << 24);
+	bool bFloat = (msg.getAt(3) & 0x80) != 0;
+
+	move(dTimeSec);
+
+	// BG is executed without data, all other commands with 4 bytes are requests
+	bool bExecute = (msg.m_iLen == 8) || ((c1 == 'B') && (c2 == 'G'));
+
+	if(bExecute)
+	{
+		// set command
+		if(msg.m_iLen == 8)
+			m_Intprt[INTPRT_KEY(c1, c2, iIndex)] = iData;
+
+		switch(INTPRT_KEY(c1, c2, 0))
+		{
+		case INTPRT_KEY('M', 'O', 0):
+			m_bMotorOn = (iData == 1);
+			if(!m_bMotorOn)
+				m_dVelIncrS = 0;
+			break;
+		case INTPRT_KEY('U', 'M', 0):
+			m_bPosMode = (iData == 5);
+			break;
+		case INTPRT_KEY('P', 'A', 0):
+			m_dNextTargetIncr = iData;
+			break;
+		case INTPRT_KEY('P', 'R', 0):
+			m_dNextTargetIncr = m_dTargetIncr + iData;
+			break;
+		case INTPRT_KEY('B', 'G', 0):
+			if(!m_bMotorOn)
+				break;
+			if(m_bPosMode)
+				m_dTargetIncr = m_dNextTargetIncr;
+			else
+				m_dVelIncrS = getIntprt('J', 'V', 0);
+			break;
+		case INTPRT_KEY('P', 'X', 0):
+			m_dPosIncr = iData;
+			m_dTargetIncr = iData;
+			m_dNextTargetIncr = iData;
+			break;
+		case INTPRT_KEY('R', 'R', 0):
+			// 1 starts at the next BG, 2 immediately, both start at once here
+			m_bRecActive = (iData != 0);
+			if(m_bRecActive)
+			{
+				m_dRecStartSec = dTimeSec;
+				m_dRecPosIncr = m_dPosIncr;
+				m_dRecVelIncrS = m_dVelIncrS;
+			}
+			break;
+		}
+	}
+	else
+	{
+		// get command
+		switch(INTPRT_KEY(c1, c2, 0))
+		{
+		case INTPRT_KEY('P', 'X', 0):
+			iData = (int)m_dPosIncr;
+			break;
+		case INTPRT_KEY('V', 'X', 0):
+			iData = (int)m_dVelIncrS;
+			break;
+		case INTPRT_KEY('S', 'R', 0):
+		{
+			// bit 4 motor on, bits 16-17 recorder state
+			int iRecState = 0;
+			if(m_dRecStartSec >= 0)
+			{
+				double dRecDurationSec = getIntprt('R', 'L', 0) * getIntprt('R', 'G', 0) * c_dTSSec;
+				iRecState = (m_bRecActive && (dTimeSec - m_dRecStartSec < dRecDurationSec)) ? 3 : 2;
+			}
+			iData = (m_bMotorOn ? 0x10 : 0) | (iRecState << 16);
+			break;
+		}
+		case INTPRT_KEY('I', 'P', 0):
+			// homing input while the motor is near the switch
+			iData = (fabs(m_dPosIncr - m_iHomingSwitchIncr) < 500) ? 0x0001 : 0;
+			break;
+		case INTPRT_KEY('I', 'Q', 0):
+		{
+			float fCurr = 0;
+			memcpy(&iData, &fCurr, sizeof(iData));
+			bFloat = true;
+			break;
+		}
+		case INTPRT_KEY('M', 'F', 0):
+			iData = 0;
+			break;
+		default:
+			iData = getIntprt(c1, c2, iIndex);
+			break;
+		}
+	}
+
+	CanMsg reply;
+	reply.m_iID = m_iTxPDO2;
+	reply.m_iLen = 8;
+	reply.set(c1, c2, iIndex, ((iIndex >> 8) & 0x3F) | (bFloat ? 0x80 : 0),
+		iData, iData >> 8, iData >> 16, iData >> 24);
+	vReplies.push_back(reply);
+}
+
+//-----------------------------------------------
+CanMsg HarmonicaSim::makeSDO(int iCmd, int iIndex, int iSubIndex, int iData)
+{
+	CanMsg msg;
+	msg.m_iID = m_iTxSDO;
+	msg.m_iLen = 8;
+	msg.set(iCmd, iIndex, iIndex >> 8, iSubIndex, iData, iData >> 8, iData >> 16, iData >> 24);
+	return msg;
+}
+
+//-----------------------------------------------
+void HarmonicaSim::evalSDO(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies)
+{
+	int iCmd = msg.getAt(0);
+	int iIndex = msg.getAt(1) | (msg.getAt(2) << 8);
+	int iSubIndex = msg.getAt(3);
+	int iData = msg.getAt(4) | (msg.getAt(5) << 8) | (msg.getAt(6) << 16) | (msg.getAt(7) << 24);
+
+	move(dTimeSec);
+
+	switch(iCmd >> 5)
+	{
+	case 1:
+		// initiate download, expedited
+		m_ObjDict[(iIndex << 8) | iSubIndex] = iData;
+		vReplies.push_back(makeSDO(0x60, iIndex, iSubIndex, 0));
+		break;
+
+	case 2:
+		// initiate upload
+		if(iIndex == 0x2030)
+		{
+			prepareRecorderData(iSubIndex);
+			vReplies.push_back(makeSDO(0x41, iIndex, iSubIndex, m_vUpload.size()));
+		}
+		else if(iIndex == 0x6064)
+			vReplies.push_back(makeSDO(0x43, iIndex, iSubIndex, (int)m_dPosIncr));
+		else if(iIndex == 0x6069)
+			vReplies.push_back(makeSDO(0x43, iIndex, iSubIndex, (int)m_dVelIncrS));
+		else if(iIndex == 0x6041)
+			vReplies.push_back(makeSDO(0x43, iIndex, iSubIndex, m_bMotorOn ? 0x0237 : 0x0250));
+		else if(m_ObjDict.find((iIndex << 8) | iSubIndex) != m_ObjDict.end())
+			vReplies.push_back(makeSDO(0x43, iIndex, iSubIndex, m_ObjDict[(iIndex << 8) | iSubIndex]));
+		else
+			vReplies.push_back(makeSDO(0x80, iIndex, iSubIndex, 0x06020000)); // object does not exist
+		break;
+
+	case 3:
+	{
+		// upload segment
+		if(m_iUploadPos >= m_vUpload.size())
+		{
+			vReplies.push_back(makeSDO(0x80, m_iUploadIndex, m_iUploadSubIndex, 0x08000020));
+			break;
+		}
+		int iToggle = (iCmd >> 4) & 0x01;
+		unsigned int iNum = std::min((unsigned int)7, (unsigned int)m_vUpload.size() - m_iUploadPos);
+		bool bLast = (m_iUploadPos + iNum >= m_vUpload.size());
+
+		CanMsg reply;
+		reply.m_iID = m_iTxSDO;
+		reply.m_iLen = 8;
+		reply.set((iToggle << 4) | ((7 - iNum) << 1) | (bLast ? 1 : 0));
+		for(unsigned int i = 0; i < iNum; i++)
+			reply.setAt(m_vUpload[m_iUploadPos + i], i + 1);
+		m_iUploadPos += iNum;
+		vReplies.push_back(reply);
+		break;
+	}
+
+	case 4:
+		// abort by the client
+		m_vUpload.clear();
+		m_iUploadPos = 0;
+		break;
+
+	case 5:
+		// block upload
+		switch(iCmd & 0x03)
+		{
+		case 0:
+			// initiate
+			if(iIndex != 0x2030)
+			{
+				vReplies.push_back(makeSDO(0x80, iIndex, iSubIndex, 0x06010000)); // unsupported access
+				break;
+			}
+			prepareRecorderData(iSubIndex);
+			m_iBlockSize = msg.getAt(4);
+			// scs = 6, CRC supported, size indicated
+			vReplies.push_back(makeSDO(0xC6, iIndex, iSubIndex, m_vUpload.size()));
+			break;
+
+		case 3:
+			// start
+			sendBlock(vReplies);
+			break;
+
+		case 2:
+		{
+			// confirmation of a block: the segments after the acknowledged one are repeated
+			m_iUploadPos = std::min((unsigned int)m_vUpload.size(), m_iBlockStartPos + 7 * msg.getAt(1));
+			m_iBlockSize = msg.getAt(2);
+			if(m_iUploadPos < m_vUpload.size())
+			{
+				sendBlock(vReplies);
+				break;
+			}
+			// end: number of unused bytes of the last segment and CRC
+			int iNumEmpty = (7 - m_vUpload.size() % 7) % 7;
+			unsigned short iCRC = calcCRC(m_vUpload);
+			CanMsg reply;
+			reply.m_iID = m_iTxSDO;
+			reply.m_iLen = 8;
+			reply.set(0xC1 | (iNumEmpty << 2), iCRC & 0xFF, iCRC >> 8);
+			vReplies.push_back(reply);
+			break;
+		}
+
+		case 1:
+			// end confirmed
+			m_vUpload.clear();
+			m_iUploadPos = 0;
+			break;
+		}
+		break;
+	}
+}
+
+//-----------------------------------------------
+void HarmonicaSim::sendBlock(std::vector<CanMsg>& vReplies)
+{
+	m_iBlockStartPos = m_iUploadPos;
+
+	for(int iSeqNo = 1; iSeqNo <= m_iBlockSize; iSeqNo++)
+	{
+		unsigned int iNum = std::min((unsigned int)7, (unsigned int)m_vUpload.size() - m_iUploadPos);
+		bool bLast = (m_iUploadPos + iNum >= m_vUpload.size());
+
+		CanMsg reply;
+		reply.m_iID = m_iTxSDO;
+		reply.m_iLen = 8;
+		reply.set(iSeqNo | (bLast ? 0x80 : 0));
+		for(unsigned int i = 0; i < iNum; i++)
+			reply.setAt(m_vUpload[m_iUploadPos + i], i + 1);
+		m_iUploadPos += iNum;
+		vReplies.push_back(reply);
+
+		if(bLast)
+			break;
+	}
+}
+
+//-----------------------------------------------
+void HarmonicaSim::prepareRecorderData(int iSubIndex)
+{
+	// header as described in ElmoRecorder::processData(): long int samples, gap, number of samples, factor
+	int iNumSamples = getIntprt('R', 'L', 0);
+	int iGap = getIntprt('R', 'G', 0);
+	float fFactor = 1.0f;
+	unsigned int iFactor;
+	memcpy(&iFactor, &fFactor, sizeof(iFactor));
+
+	m_vUpload.resize(7 + 4 * iNumSamples);
+	m_vUpload[0] = (4 << 4) | (iGap & 0x0F);
+	m_vUpload[1] = iNumSamples;
+	m_vUpload[2] = iNumSamples >> 8;
+	m_vUpload[3] = iFactor;
+	m_vUpload[4] = iFactor >> 8;
+	m_vUpload[5] = iFactor >> 16;
+	m_vUpload[6] = iFactor >> 24;
+
+	// the motion since the start of the recorder, velocity for source 1, position otherwise
+	for(int i = 0; i < iNumSamples; i++)
+	{
+		double dt = i * iGap * c_dTSSec;
+		int iValue = (iSubIndex == 1) ? (int)m_dRecVelIncrS : (int)(m_dRecPosIncr + m_dRecVelIncrS * dt);
+		m_vUpload[7 + 4 * i] = iValue;
+		m_vUpload[8 + 4 * i] = iValue >> 8;
+		m_vUpload[9 + 4 * i] = iValue >> 16;
+		m_vUpload[10 + 4 * i] = iValue >> 24;
+	}
+
+	m_iUploadIndex = 0x2030;
+	m_iUploadSubIndex = iSubIndex;
+	m_iUploadPos = 0;
+	m_iBlockStartPos = 0;
+	m_bUploadToggle = false;
+}
@@ -0,0 +1,253 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: CANopen SDO client which tracks the requests to one node, with timeouts, retries and completion callbacks.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+//-----------------------------------------------
+#include <cob_canopen_motor/SDOClient.h>
+#include <iostream>
+
+//-----------------------------------------------
+SDOClient::SDOClient()
+{
+	m_pCanCtrl = NULL;
+	m_iRxSDO = 0;
+	m_iTxSDO = 0;
+	m_dTimeoutSec = 0.1;
+	m_iNumRetries = 2;
+	m_bSent = false;
+	m_iNumFailed = 0;
+}
+
+//-----------------------------------------------
+void SDOClient::setCanIDs(int iRxSDO, int iTxSDO)
+{
+	m_iRxSDO = iRxSDO;
+	m_iTxSDO = iTxSDO;
+}
+
+//-----------------------------------------------
+void SDOClient::setTimeout(double dTimeoutSec, int iNumRetries)
+{
+	m_dTimeoutSec = dTimeoutSec;
+	m_iNumRetries = (iNumRetries < 0) ? 0 : iNumRetries;
+}
+
+//-----------------------------------------------
+void SDOClient::download(int iObjIndex, int iObjSubIndex, int iData, CallbackType callback)
+{
+	Request request;
+	request.bUpload = false;
+	request.iObjIndex = iObjIndex;
+	request.iObjSubIndex = iObjSubIndex;
+	request.iData = iData;
+	request.callback = callback;
+	request.iNumTries = 0;
+	m_Requests.push_back(request);
+}
+
+//-----------------------------------------------
+void SDOClient::upload(int iObjIndex, int iObjSubIndex, CallbackType callback)
+{
+	Request request;
+	request.bUpload = true;
+	request.iObjIndex = iObjIndex;
+	request.iObjSubIndex = iObjSubIndex;
+	request.iData = 0;
+	request.callback = callback;
+	request.iNumTries = 0;
+	m_Requests.push_back(request);
+}
+
+//-----------------------------------------------
+void SDOClient::transmit(Request& request)
+{
+	const int ciInitDownloadReq = 0x20;
+	const int ciInitUploadReq = 0x40;
+	const int ciExpedited = 0x02;
+	const int ciDataSizeInd = 0x01;
+	CanMsg CMsgTr;
+
+	CMsgTr.m_iLen = 8;
+	CMsgTr.m_iID = m_iRxSDO;
+
+	if(request.bUpload)
+	{
+		CMsgTr.set(ciInitUploadReq, request.iObjIndex, request.iObjIndex >> 8, request.iObjSubIndex, 0, 0, 0, 0);
+	}
+	else
+	{
+		CMsgTr.set(ciInitDownloadReq | ciExpedited | ciDataSizeInd, request.iObjIndex, request.iObjIndex >> 8, request.iObjSubIndex,
+			request.iData, request.iData >> 8, request.iData >> 16, request.iData >> 24);
+	}
+
+	request.iNumTries++;
+	m_bSent = true;
+	m_SendTime.SetNow();
+	m_pCanCtrl->transmitMsg(CMsgTr);
+}
+
+//-----------------------------------------------
+void SDOClient::complete(int iResult, unsigned int iData)
+{
+	// remove the request before the callback, it may queue new requests
+	Request request = m_Requests.front();
+	m_Requests.pop_front();
+	m_bSent = false;
+
+	if(iResult != SDO_OK)
+		m_iNumFailed++;
+
+	if(request.callback)
+		request.callback(iResult, request.iObjIndex, request.iObjSubIndex, iData);
+}
+
+//-----------------------------------------------
+bool SDOClient::evalReceivedMsg(CanMsg& msg)
+{
+	const int ciDownloadResp = 0x60;
+	const int ciUploadResp = 0x40;
+	const int ciAbort = 0x80;
+
+	if( !m_bSent || (msg.m_iID != m_iTxSDO) )
+		return false;
+
+	Request& request = m_Requests.front();
+	int iCmd = msg.getAt(0);
+	int iObjIndex = (msg.getAt(2) << 8) | msg.getAt(1);
+	int iObjSubIndex = msg.getAt(3);
+	unsigned int iData = (msg.getAt(7) << 24) | (msg.getAt(6) << 16) | (msg.getAt(5) << 8) | msg.getAt(4);
+
+	if( (iObjIndex != request.iObjIndex) || (iObjSubIndex != request.iObjSubIndex) )
+		return false;
+
+	if(iCmd == ciAbort)
+	{
+		complete(SDO_ABORTED, iData);
+		return true;
+	}
+
+	if( !request.bUpload && (iCmd == ciDownloadResp) )
+	{
+		complete(SDO_OK, 0);
+		return true;
+	}
+
+	if( request.bUpload && ((iCmd & 0xE0) == ciUploadResp) )
+	{
+		if( (iCmd & 0x02) == 0 )
+		{
+			// the node wants a segmented transfer, this client handles up to 4 bytes only,
+			// so the transfer is aborted at the node, too (length of service parameter does not match)
+			std::cout << "SDOClient: object " << std::hex << iObjIndex << std::dec << " is too large for an expedited upload" << std::endl;
+			unsigned int iAbortCode = 0x06070010;
+			CanMsg CMsgTr;
+			CMsgTr.m_iLen = 8;
+			CMsgTr.m_iID = m_iRxSDO;
+			CMsgTr.set(ciAbort, iObjIndex, iObjIndex >> 8, iObjSubIndex,
+				iAbortCode, iAbortCode >> 8, iAbortCode >> 16, iAbortCode >> 24);
+			m_pCanCtrl->transmitMsg(CMsgTr);
+			complete(SDO_ABORTED, iAbortCode);
+			return true;
+		}
+
+		// remove the unused bytes if the size is indicated
+		if(iCmd & 0x01)
+		{
+			int iNumUnused = (iCmd >> 2) & 0x03;
+			if(iNumUnused > 0)
+				iData &= 0xFFFFFFFFu >> (8 * iNumUnused);
+		}
+		complete(SDO_OK, iData);
+		return true;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------
+void SDOClient::update(bool bChannelFree)
+{
+	if(m_bSent)
+	{
+		TimeStamp now;
+		now.SetNow();
+		if( (now - m_SendTime) < m_dTimeoutSec )
+			return;
+
+		if(m_Requests.front().iNumTries <= m_iNumRetries)
+		{
+			transmit(m_Requests.front());
+			return;
+		}
+
+		std::cout << "SDOClient: no reply for object " << std::hex << m_Requests.front().iObjIndex << std::dec
+			<< " sub " << m_Requests.front().iObjSubIndex << std::endl;
+		complete(SDO_TIMEOUT, 0);
+	}
+
+	if( bChannelFree && !m_Requests.empty() && (m_pCanCtrl != NULL) )
+		transmit(m_Requests.front());
+}
+
+//-----------------------------------------------
+void SDOClient::cancel()
+{
+	// the callbacks may queue new requests, they are kept
+	std::deque<Request> requests;
+	requests.swap(m_Requests);
+	m_bSent = false;
+
+	for(unsigned int i = 0; i < requests.size(); i++)
+	{
+		m_iNumFailed++;
+		if(requests[i].callback)
+			requests[i].callback(SDO_CANCELLED, requests[i].iObjIndex, requests[i].iObjSubIndex, 0);
+	}
+}
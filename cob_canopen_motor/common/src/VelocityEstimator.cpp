@@ -0,0 +1,173 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Alpha-beta-gamma tracker estimating velocity and acceleration of a drive from time stamped position samples.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+//-----------------------------------------------
+#include <cob_canopen_motor/VelocityEstimator.h>
+#include <math.h>
+
+//-----------------------------------------------
+VelocityEstimator::VelocityEstimator()
+{
+	m_dSigmaAcc = 10;
+	m_dSigmaPos = 1e-4;
+	m_dMinDtSec = 0.0005;
+	m_dMaxDtSec = 0.5;
+
+	reset();
+}
+
+//-----------------------------------------------
+void VelocityEstimator::setParam(double dSigmaAcc, double dSigmaPos)
+{
+	m_dSigmaAcc = fabs(dSigmaAcc);
+	m_dSigmaPos = fabs(dSigmaPos);
+
+	// force recalculation of the gains
+	m_dGainDtSec = 0;
+}
+
+//-----------------------------------------------
+void VelocityEstimator::setDtLimits(double dMinDtSec, double dMaxDtSec)
+{
+	m_dMinDtSec = dMinDtSec;
+	m_dMaxDtSec = dMaxDtSec;
+}
+
+//-----------------------------------------------
+void VelocityEstimator::reset()
+{
+	m_dGainDtSec = 0;
+	m_dAlpha = 1;
+	m_dBeta = 0;
+	m_dGamma = 0;
+
+	m_dPos = 0;
+	m_dVel = 0;
+	m_dAcc = 0;
+	m_dSampleTimeSec = 0;
+	m_iNumSamples = 0;
+}
+
+//-----------------------------------------------
+bool VelocityEstimator::update(double dPos, double dSampleTimeSec)
+{
+	double dt = dSampleTimeSec - m_dSampleTimeSec;
+
+	if( (m_iNumSamples == 0) || (dt > m_dMaxDtSec) || (dt < -m_dMaxDtSec) )
+	{
+		// (re)start with the position, velocity unknown
+		m_dPos = dPos;
+		m_dVel = 0;
+		m_dAcc = 0;
+		m_dSampleTimeSec = dSampleTimeSec;
+		m_iNumSamples = 1;
+		return true;
+	}
+
+	if(dt < m_dMinDtSec)
+		return false;
+
+	if(m_iNumSamples == 1)
+	{
+		// second sample: difference quotient
+		m_dVel = (dPos - m_dPos) / dt;
+		m_dPos = dPos;
+		m_dSampleTimeSec = dSampleTimeSec;
+		m_iNumSamples = 2;
+		return true;
+	}
+
+	// gains change slowly with dt, so a jitter of 1% reuses the last ones
+	if(fabs(dt - m_dGainDtSec) > 0.01 * dt)
+		calcGains(dt);
+
+	// predict
+	double dPosPred = m_dPos + dt * (m_dVel + 0.5 * dt * m_dAcc);
+	double dVelPred = m_dVel + dt * m_dAcc;
+
+	// correct
+	double dResidual = dPos - dPosPred;
+	m_dPos = dPosPred + m_dAlpha * dResidual;
+	m_dVel = dVelPred + m_dBeta / dt * dResidual;
+	m_dAcc = m_dAcc + m_dGamma / (0.5 * dt * dt) * dResidual;
+
+	m_dSampleTimeSec = dSampleTimeSec;
+	if(m_iNumSamples < 3)
+		m_iNumSamples++;
+
+	return true;
+}
+
+//-----------------------------------------------
+void VelocityEstimator::calcGains(double dt)
+{
+	m_dGainDtSec = dt;
+
+	if(m_dSigmaPos <= 0)
+	{
+		// exact measurement
+		m_dAlpha = 1;
+		m_dBeta = 1;
+		m_dGamma = 0.5;
+		return;
+	}
+
+	// tracking index: ratio of the motion uncertainty to the measurement uncertainty
+	double dLambda = m_dSigmaAcc * dt * dt / m_dSigmaPos;
+
+	// steady state alpha-beta gains (Kalata)
+	double dR = (4 + dLambda - sqrt(8 * dLambda + dLambda * dLambda)) / 4;
+	m_dAlpha = 1 - dR * dR;
+	m_dBeta = 2 * (2 - m_dAlpha) - 4 * sqrt(1 - m_dAlpha);
+
+	// acceleration gain matched to alpha and beta (Gray and Murray)
+	m_dGamma = m_dBeta * m_dBeta / (4 * m_dAlpha);
+}
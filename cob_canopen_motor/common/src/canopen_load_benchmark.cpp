@@ -0,0 +1,203 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Control rate and bus load of the Harmonica driver over the number of drives.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+/****************************************************************
+ * Runs CanDriveHarmonica against simulated drives on a CanSimBus, without hardware.
+ * For 1..N drives on one bus all drives are brought up, then the control cycle
+ * of the platform is repeated as fast as possible:
+ *  - setGearVelRadS() for every drive (JV, BG, SYNC, heartbeat)
+ *  - evalReceivedMsg() until all replies of the cycle have arrived
+ *
+ * usage: canopen_load_benchmark [max_drives] [baudrate_kbit] [cycles]
+ *
+ * Prints the frames per cycle, the cycle time and the bus utilization.
+ * The simulated bus serializes the frames at the given bitrate in real time,
+ * so the cycle time is what the bus allows, not what the host CPU allows.
+ ****************************************************************/
+
+#include <cob_canopen_motor/CanDriveHarmonica.h>
+#include <cob_canopen_motor/HarmonicaSim.h>
+#include <cob_generic_can/CanSimBus.h>
+#include <cob_utilities/TimeStamp.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+
+//-----------------------------------------------
+static bool bringUp(CanSimBus& bus, std::vector<CanDriveHarmonica*>& vpDrives, double* pdDurationSec)
+{
+	TimeStamp StartTime, Now;
+	StartTime.SetNow();
+
+	for(unsigned int i = 0; i < vpDrives.size(); i++)
+		vpDrives[i]->beginBringUp(true);
+
+	bool bRunning;
+	do
+	{
+		CanMsg msg;
+		while(bus.receiveMsg(&msg))
+			for(unsigned int i = 0; i < vpDrives.size(); i++)
+				vpDrives[i]->evalReceivedMsg(msg);
+
+		bRunning = false;
+		for(unsigned int i = 0; i < vpDrives.size(); i++)
+		{
+			int iState = vpDrives[i]->updateBringUp();
+			if(iState == CanDriveHarmonica::BRINGUP_FAILED)
+				return false;
+			if(iState == CanDriveHarmonica::BRINGUP_RUNNING)
+				bRunning = true;
+		}
+
+		Now.SetNow();
+		if(Now - StartTime > 10.0)
+			return false;
+
+		usleep(1000);
+	} while(bRunning);
+
+	*pdDurationSec = Now - StartTime;
+	return true;
+}
+
+//-----------------------------------------------
+int main(int argc, char** argv)
+{
+	int iMaxDrives = (argc > 1) ? atoi(argv[1]) : 8;
+	int iBaudrateKbit = (argc > 2) ? atoi(argv[2]) : 1000;
+	int iNumCycles = (argc > 3) ? atoi(argv[3]) : 200;
+
+	printf("%d kbit/s, %d cycles, %.1f us per 8 byte frame\n\n", iBaudrateKbit, iNumCycles,
+		1e6 * CanSimBus(iBaudrateKbit).getFrameTime(8));
+	printf("drives  bring-up  frames/cycle  cycle avg  cycle max  rate      bus load  lost\n");
+
+	for(int iNumDrives = 1; iNumDrives <= iMaxDrives; iNumDrives++)
+	{
+		CanSimBus bus(iBaudrateKbit);
+		std::vector<CanDriveHarmonica*> vpDrives;
+
+		for(int i = 0; i < iNumDrives; i++)
+		{
+			int iID = i + 1;
+			bus.addNode(new HarmonicaSim(iID));
+
+			DriveParam param;
+			// 4096 incr/rev, gear 37, 188000 incr/s, 1e6 incr/s^2
+			param.setParam(i, 4096, 1, 1, 37, 1, 188000, 1000000, 1000000);
+
+			CanDriveHarmonica* pDrive = new CanDriveHarmonica();
+			pDrive->setCanItf(&bus);
+			pDrive->setCanOpenParam(0x180 + iID, 0x280 + iID, 0x300 + iID, 0x580 + iID, 0x600 + iID);
+			pDrive->setDriveParam(param);
+			vpDrives.push_back(pDrive);
+		}
+
+		double dBringUpSec = 0;
+		if(!bringUp(bus, vpDrives, &dBringUpSec))
+		{
+			printf("%6d  bring-up failed\n", iNumDrives);
+			break;
+		}
+
+		// every drive sends its own SYNC, which all drives answer by PDO1,
+		// plus the echo of JV and BG of every drive
+		int iNumReplies = iNumDrives * iNumDrives + 2 * iNumDrives;
+
+		bus.resetStatistics();
+		double dSumSec = 0;
+		double dMaxSec = 0;
+		int iNumLost = 0;
+
+		for(int iCycle = 0; iCycle < iNumCycles; iCycle++)
+		{
+			TimeStamp StartTime, Now;
+			StartTime.SetNow();
+
+			for(unsigned int i = 0; i < vpDrives.size(); i++)
+				vpDrives[i]->setGearVelRadS(1.0);
+
+			int iNumReceived = 0;
+			CanMsg msg;
+			while(iNumReceived < iNumReplies)
+			{
+				if(!bus.receiveMsgRetry(&msg, 10))
+				{
+					iNumLost += iNumReplies - iNumReceived;
+					break;
+				}
+				for(unsigned int i = 0; i < vpDrives.size(); i++)
+					vpDrives[i]->evalReceivedMsg(msg);
+				iNumReceived++;
+			}
+
+			Now.SetNow();
+			double dCycleSec = Now - StartTime;
+			dSumSec += dCycleSec;
+			if(dCycleSec > dMaxSec)
+				dMaxSec = dCycleSec;
+		}
+
+		unsigned int iFramesHost, iFramesNodes;
+		bus.getNumFrames(&iFramesHost, &iFramesNodes);
+		double dAvgSec = dSumSec / iNumCycles;
+
+		printf("%6d  %5.0f ms  %12.1f  %6.2f ms  %6.2f ms  %5.0f Hz  %6.1f %%  %4d\n",
+			iNumDrives, 1000 * dBringUpSec, (double)(iFramesHost + iFramesNodes) / iNumCycles,
+			1000 * dAvgSec, 1000 * dMaxSec, 1 / dAvgSec, 100 * bus.getBusLoad(), iNumLost);
+
+		for(unsigned int i = 0; i < vpDrives.size(); i++)
+			delete vpDrives[i];
+	}
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Simulated ELMO Harmonica drives on a SocketCAN interface.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+/****************************************************************
+ * Serves simulated Harmonica drives on a SocketCAN interface, so the real
+ * platform node can be run against a virtual bus:
+ *
+ *   modprobe vcan
+ *   ip link add dev vcan0 type vcan && ip link set up vcan0
+ *   harmonica_sim vcan0 1 8
+ *
+ * and TypeCan = 4, SocketDevice = vcan0 in CanCtrl.ini.
+ *
+ * usage: harmonica_sim [device] [first_node_id] [num_drives]
+ ****************************************************************/
+
+#include <cob_canopen_motor/HarmonicaSim.h>
+#include <cob_generic_can/CanSocket.h>
+#include <cob_utilities/TimeStamp.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+	std::string sDevice = (argc > 1) ? argv[1] : "vcan0";
+	int iFirstID = (argc > 2) ? atoi(argv[2]) : 1;
+	int iNumDrives = (argc > 3) ? atoi(argv[3]) : 1;
+
+	CanSocket can(sDevice);
+	if(!can.isOpen())
+	{
+		printf("harmonica_sim: can't open %s\n", sDevice.c_str());
+		return 1;
+	}
+
+	std::vector<HarmonicaSim*> vpDrives;
+	for(int i = 0; i < iNumDrives; i++)
+		vpDrives.push_back(new HarmonicaSim(iFirstID + i));
+
+	printf("harmonica_sim: %d drives with node ids %d..%d on %s\n", iNumDrives, iFirstID, iFirstID + iNumDrives - 1, sDevice.c_str());
+
+	TimeStamp StartTime;
+	StartTime.SetNow();
+
+	CanMsg msg;
+	std::vector<CanMsg> vReplies;
+	while(true)
+	{
+		if(!can.receiveMsgRetry(&msg, 100))
+			continue;
+
+		TimeStamp Now;
+		Now.SetNow();
+		double dTimeSec = Now - StartTime;
+
+		vReplies.clear();
+		for(unsigned int i = 0; i < vpDrives.size(); i++)
+			vpDrives[i]->evalMsg(msg, dTimeSec, vReplies);
+
+		for(unsigned int i = 0; i < vReplies.size(); i++)
+			can.transmitMsg(vReplies[i]);
+	}
+
+	return 0;
+}
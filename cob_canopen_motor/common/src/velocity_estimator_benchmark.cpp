@@ -0,0 +1,288 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Replays encoder positions and compares the velocity estimation of VelocityEstimator with the difference quotient over the processing time.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+/****************************************************************
+ * Offline comparison of the velocity estimation of a drive, without CAN.
+ * The positions are taken from an ElmoRecorder trace of the position (object 2)
+ * or, without a file, from a synthetic motion of a quantized encoder.
+ * They are decimated to the SYNC cycle and "processed" with a random delay
+ * like a loaded CPU would do.
+ *
+ *  - "diff quotient": difference of two positions over the processing times
+ *    (the former CanDriveHarmonica::estimVel)
+ *  - "tracker": VelocityEstimator fed with the sample times
+ *
+ * usage: velocity_estimator_benchmark [file.trace|-] [cycle_sec] [jitter_sec] [sigma_acc]
+ *
+ * jitter_sec is limited to half the cycle, load peaks delay a sample up to 0.9 cycles,
+ * so the samples are processed in order.
+ *
+ * Prints the RMS and peak error against the reference velocity, the lag at which
+ * the estimate matches the reference best and the cost per update.
+ * The reference is the exact velocity of the synthetic motion or the central
+ * difference quotient of the (undecimated) recording.
+ ****************************************************************/
+
+#include <cob_canopen_motor/VelocityEstimator.h>
+#include <cob_canopen_motor/ElmoTrace.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/time.h>
+
+struct Result
+{
+	double dRms;
+	double dPeak;
+	double dLagSec;
+	double dNsPerUpdate;
+};
+
+static double wallTime()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// uniform random number in [0, 1)
+static double uniform()
+{
+	return rand() / (RAND_MAX + 1.0);
+}
+
+// error and lag of vdEst against vdRef, both given every dCycleSec
+static void evaluate(const std::vector<double>& vdEst, const std::vector<double>& vdRef,
+	double dCycleSec, int iSkip, Result& r)
+{
+	// mean square error for the estimate shifted back by iShift cycles
+	const int iMinShift = -5;
+	const int iMaxShift = 20;
+	double dMse[iMaxShift - iMinShift + 1];
+	int iBest = 0;
+
+	for(int iShift = iMinShift; iShift <= iMaxShift; iShift++)
+	{
+		double dSum = 0;
+		int iNum = 0;
+		for(unsigned int i = iSkip + iMaxShift; i + 5 < vdEst.size(); i++)
+		{
+			double dErr = vdEst[i] - vdRef[i - iShift];
+			dSum += dErr * dErr;
+			iNum++;
+		}
+		int k = iShift - iMinShift;
+		dMse[k] = dSum / iNum;
+		if(dMse[k] < dMse[iBest])
+			iBest = k;
+	}
+
+	// vertex of the parabola through the neighbours of the best shift
+	double dShift = iBest + iMinShift;
+	if((iBest > 0) && (iBest < iMaxShift - iMinShift))
+	{
+		double dDen = dMse[iBest - 1] - 2 * dMse[iBest] + dMse[iBest + 1];
+		if(dDen > 0)
+			dShift += 0.5 * (dMse[iBest - 1] - dMse[iBest + 1]) / dDen;
+	}
+	r.dLagSec = dShift * dCycleSec;
+
+	double dSum = 0;
+	r.dPeak = 0;
+	for(unsigned int i = iSkip; i < vdEst.size(); i++)
+	{
+		double dErr = fabs(vdEst[i] - vdRef[i]);
+		dSum += dErr * dErr;
+		if(dErr > r.dPeak)
+			r.dPeak = dErr;
+	}
+	r.dRms = sqrt(dSum / (vdEst.size() - iSkip));
+}
+
+static void print(const char* pcName, const Result& r)
+{
+	printf("%-15s %14.3f %14.3f %10.2f %12.1f\n", pcName, r.dRms, r.dPeak, r.dLagSec * 1000, r.dNsPerUpdate);
+}
+
+int main(int argc, char** argv)
+{
+	const char* pcFile = (argc > 1) ? argv[1] : "-";
+	double dCycleSec = (argc > 2) ? atof(argv[2]) : 0.01;
+	double dJitterSec = (argc > 3) ? atof(argv[3]) : 0.003;
+	double dSigmaAcc = (argc > 4) ? atof(argv[4]) : 0;
+
+	const double dDurationSec = 20.0;
+	const int iRepetitions = 50;
+
+	// positions in encoder increments and reference velocity in increments/s, every dCycleSec
+	std::vector<double> vdPos, vdRef;
+
+	if(strcmp(pcFile, "-") != 0)
+	{
+		ElmoTraceReader reader;
+		if(!reader.open(pcFile))
+		{
+			printf("cannot read %s\n", pcFile);
+			return 1;
+		}
+		std::vector<float> vfValues;
+		reader.getValues(vfValues);
+		double dPeriodSec = reader.getHeader().dSamplePeriodSec;
+		int iDecim = (int)(dCycleSec / dPeriodSec + 0.5);
+		if(iDecim < 1)
+			iDecim = 1;
+		dCycleSec = iDecim * dPeriodSec;
+
+		for(unsigned int i = iDecim; i + iDecim < vfValues.size(); i += iDecim)
+		{
+			vdPos.push_back(vfValues[i]);
+			vdRef.push_back((vfValues[i + 1] - vfValues[i - 1]) / (2 * dPeriodSec));
+		}
+		printf("trace %s: drive %d, %u samples of %.6f s, decimated by %d\n", pcFile,
+			reader.getHeader().iDriveID, reader.getHeader().iNumSamples, dPeriodSec, iDecim);
+	}
+	else
+	{
+		// wheel moving back and forth with up to 10 rev/s of the motor, 4096 increments per rev
+		const double dAmplIncr = 100000;
+		const double dFrqHz = 0.25;
+		int iNum = (int)(dDurationSec / dCycleSec);
+		for(int i = 0; i < iNum; i++)
+		{
+			double t = i * dCycleSec;
+			double w = 2 * M_PI * dFrqHz;
+			vdPos.push_back(floor(dAmplIncr * sin(w * t) * sin(0.3 * w * t)));
+			vdRef.push_back(dAmplIncr * w * (cos(w * t) * sin(0.3 * w * t) + 0.3 * sin(w * t) * cos(0.3 * w * t)));
+		}
+		printf("synthetic motion: %d samples\n", iNum);
+	}
+
+	if(vdPos.size() < 100)
+	{
+		printf("too few samples\n");
+		return 1;
+	}
+
+	if(dSigmaAcc <= 0)
+	{
+		// acceleration noise from the largest change of the reference velocity
+		for(unsigned int i = 1; i < vdRef.size(); i++)
+			dSigmaAcc = std::max(dSigmaAcc, fabs(vdRef[i] - vdRef[i - 1]) / dCycleSec);
+		dSigmaAcc *= 0.5;
+	}
+
+	// the delays stay below the cycle, otherwise samples would be processed out of order
+	// and the difference quotient would divide by dt <= 0 instead of showing the timing noise
+	const double dMaxDelaySec = 0.9 * dCycleSec;
+	dJitterSec = std::min(dJitterSec, 0.5 * dCycleSec);
+
+	printf("cycle %.4f s, processing delay up to %.4f s, load peaks up to %.4f s, sigma_acc %.1f incr/s^2\n\n",
+		dCycleSec, dJitterSec, dMaxDelaySec, dSigmaAcc);
+
+	// processing times: samples are evaluated with a random delay after the SYNC,
+	// now and then (load peaks) late in the cycle
+	std::vector<double> vdProcTime(vdPos.size());
+	srand(1);
+	for(unsigned int i = 0; i < vdPos.size(); i++)
+	{
+		double dDelay = dJitterSec * uniform();
+		if(uniform() < 0.02)
+			dDelay = dJitterSec + (dMaxDelaySec - dJitterSec) * uniform();
+		vdProcTime[i] = i * dCycleSec + dDelay;
+	}
+
+	std::vector<double> vdEst(vdPos.size());
+	Result res;
+	int iSkip = 20;
+
+	printf("%-15s %14s %14s %10s %12s\n", "method", "rms [incr/s]", "peak [incr/s]", "lag [ms]", "ns/update");
+
+	// difference quotient over the processing time
+	double dStart = wallTime();
+	for(int iRep = 0; iRep < iRepetitions; iRep++)
+	{
+		vdEst[0] = 0;
+		for(unsigned int i = 1; i < vdPos.size(); i++)
+			vdEst[i] = (vdPos[i] - vdPos[i - 1]) / (vdProcTime[i] - vdProcTime[i - 1]);
+	}
+	res.dNsPerUpdate = (wallTime() - dStart) * 1e9 / (iRepetitions * vdPos.size());
+	evaluate(vdEst, vdRef, dCycleSec, iSkip, res);
+	print("diff quotient", res);
+
+	// difference quotient over the sample time, to separate quantization from timing noise
+	for(unsigned int i = 1; i < vdPos.size(); i++)
+		vdEst[i] = (vdPos[i] - vdPos[i - 1]) / dCycleSec;
+	res.dNsPerUpdate = 0;
+	evaluate(vdEst, vdRef, dCycleSec, iSkip, res);
+	print("diff (sample t)", res);
+
+	// tracker fed with the sample time
+	VelocityEstimator estim;
+	estim.setParam(dSigmaAcc, 1.0 / sqrt(12.0));
+	dStart = wallTime();
+	for(int iRep = 0; iRep < iRepetitions; iRep++)
+	{
+		estim.reset();
+		for(unsigned int i = 0; i < vdPos.size(); i++)
+		{
+			estim.update(vdPos[i], i * dCycleSec);
+			vdEst[i] = estim.getVel();
+		}
+	}
+	res.dNsPerUpdate = (wallTime() - dStart) * 1e9 / (iRepetitions * vdPos.size());
+	evaluate(vdEst, vdRef, dCycleSec, iSkip, res);
+	print("tracker", res);
+
+	return 0;
+}
@@ -0,0 +1,293 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Test fixture with a CanDriveHarmonica connected to a simulated drive.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef HARMONICASIMTEST_INCLUDEDEF_H
+#define HARMONICASIMTEST_INCLUDEDEF_H
+
+//-----------------------------------------------
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+#include <cob_canopen_motor/CanDriveHarmonica.h>
+#include <cob_canopen_motor/HarmonicaSim.h>
+#include <cob_generic_can/CanSimBus.h>
+#include <cob_utilities/TimeStamp.h>
+
+//-----------------------------------------------
+
+/**
+ * Gives the tests access to the collected SDO upload, it is kept until the next upload starts.
+ */
+class HarmonicaTestDrive : public CanDriveHarmonica
+{
+public:
+	const segData& getSegData() const { return seg_Data; }
+};
+
+//-----------------------------------------------
+
+/**
+ * Passes the messages to a simulated drive (node 1), logs its SDO requests and injects the faults of the tests.
+ */
+class FaultyHarmonicaSim : public CanSimNode
+{
+public:
+	FaultyHarmonicaSim(HarmonicaSim* pSim) : m_pSim(pSim)
+	{
+		bCorruptCRC = false;
+		bRejectBlockUpload = false;
+		bMuteSDO = false;
+		bOversizeUpload = false;
+		iNumBlockInits = 0;
+		iNumSegmentRequests = 0;
+		iAbortCode = 0;
+	}
+
+	~FaultyHarmonicaSim() { delete m_pSim; }
+
+	void evalMsg(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies)
+	{
+		int iCmd = msg.getAt(0);
+		if(msg.m_iID == 0x601)
+		{
+			vSDORequests.push_back(msg);
+			if(bMuteSDO)
+				return;
+
+			if((iCmd & 0xE3) == 0xA0)
+			{
+				// initiate block upload
+				iNumBlockInits++;
+				if(bRejectBlockUpload)
+				{
+					CanMsg reply;
+					reply.m_iID = 0x581;
+					reply.m_iLen = 8;
+					reply.set(0x80, msg.getAt(1), msg.getAt(2), msg.getAt(3), 0x01, 0x00, 0x04, 0x05); // command specifier not valid
+					vReplies.push_back(reply);
+					return;
+				}
+			}
+			else if((iCmd >> 5) == 3)
+				iNumSegmentRequests++;
+			else if((iCmd >> 5) == 4)
+				iAbortCode = msg.getAt(4) | (msg.getAt(5) << 8) | (msg.getAt(6) << 16) | (msg.getAt(7) << 24);
+		}
+
+		unsigned int iNumReplies = vReplies.size();
+		m_pSim->evalMsg(msg, dTimeSec, vReplies);
+
+		// the end of the block upload is the only reply to the confirmation of the last block
+		if(bCorruptCRC && msg.m_iID == 0x601 && iCmd == 0xA2
+			&& vReplies.size() == iNumReplies + 1 && (vReplies.back().getAt(0) & 0xE3) == 0xC1)
+		{
+			vReplies.back().setAt(vReplies.back().getAt(1) ^ 0xFF, 1);
+		}
+
+		// the initiation of the block upload announces 4 GByte
+		if(bOversizeUpload && msg.m_iID == 0x601 && (iCmd & 0xE3) == 0xA0
+			&& vReplies.size() == iNumReplies + 1 && (vReplies.back().getAt(0) & 0xE3) == 0xC2)
+		{
+			for(int i = 4; i < 8; i++)
+				vReplies.back().setAt(0xFF, i);
+		}
+	}
+
+	// the CRC of the block upload is wrong
+	bool bCorruptCRC;
+	// the block upload is aborted, the drive supports the segmented upload only
+	bool bRejectBlockUpload;
+	// SDO requests are not answered
+	bool bMuteSDO;
+	// the block upload announces more data than a recorder can hold
+	bool bOversizeUpload;
+
+	int iNumBlockInits;
+	int iNumSegmentRequests;
+	// last abort sent by the host
+	unsigned int iAbortCode;
+	std::vector<CanMsg> vSDORequests;
+
+private:
+	HarmonicaSim* m_pSim;
+};
+
+//-----------------------------------------------
+
+/**
+ * One CanDriveHarmonica (node 1) on a CanSimBus at 1 Mbit/s.
+ * The simulated drive is connected by SetUp() through a FaultyHarmonicaSim.
+ */
+class HarmonicaSimTest : public ::testing::Test
+{
+protected:
+	HarmonicaSimTest() : m_Bus(1000), m_pSim(NULL), m_pFaulty(NULL)
+	{
+		std::ostringstream sPrefix;
+		sPrefix << "/tmp/cob_canopen_motor_test_" << getpid() << "_";
+		m_sLogPrefix = sPrefix.str();
+	}
+
+	virtual void SetUp()
+	{
+		m_pSim = new HarmonicaSim(1);
+		m_pFaulty = new FaultyHarmonicaSim(m_pSim);
+		m_Bus.addNode(m_pFaulty);
+
+		DriveParam param;
+		// 4096 incr/rev, gear 37, 188000 incr/s, 1e6 incr/s^2
+		param.setParam(0, 4096, 1, 1, 37, 1, 188000, 1000000, 1000000);
+		m_Drive.setCanItf(&m_Bus);
+		m_Drive.setCanOpenParam(0x181, 0x281, 0x301, 0x581, 0x601);
+		m_Drive.setDriveParam(param);
+	}
+
+	virtual void TearDown()
+	{
+		for(int i = 0; i < 20; i++)
+			remove(getTraceFilename(i).c_str());
+	}
+
+	/**
+	 * Passes the received messages to the drive for dDurationSec.
+	 */
+	void spin(double dDurationSec)
+	{
+		TimeStamp StartTime, Now;
+		StartTime.SetNow();
+		do
+		{
+			receive();
+			usleep(1000);
+			Now.SetNow();
+		} while(Now - StartTime < dDurationSec);
+	}
+
+	/**
+	 * Passes the received messages to the drive until the recorder upload has ended.
+	 * @return false on timeout
+	 */
+	bool spinRecorderUpload(double dTimeoutSec)
+	{
+		TimeStamp StartTime, Now;
+		StartTime.SetNow();
+		do
+		{
+			receive();
+			if(m_Drive.setRecorder(2) == 0)
+				return true;
+			usleep(1000);
+			Now.SetNow();
+		} while(Now - StartTime < dTimeoutSec);
+		return false;
+	}
+
+	/**
+	 * Runs the non-blocking bring-up.
+	 * @return CanDriveHarmonica::BringUpState at the end
+	 */
+	int bringUp()
+	{
+		TimeStamp StartTime, Now;
+		StartTime.SetNow();
+		m_Drive.beginBringUp(true);
+
+		int iState;
+		do
+		{
+			receive();
+			iState = m_Drive.updateBringUp();
+			usleep(1000);
+			Now.SetNow();
+		} while(iState == CanDriveHarmonica::BRINGUP_RUNNING && Now - StartTime < 10.0);
+
+		return iState;
+	}
+
+	/**
+	 * Lets the motor turn and records it: the position (source 2) is a ramp then.
+	 */
+	void record()
+	{
+		m_Drive.setGearVelRadS(1.0);
+		spin(0.05);
+		m_Drive.setRecorder(0, 1);
+		// 1024 samples of one time quantum (90 usec), and a margin for the replies
+		spin(0.2);
+	}
+
+	std::string getTraceFilename(int iObjSubIndex)
+	{
+		std::ostringstream sFilename;
+		sFilename << m_sLogPrefix << "mot_0_" << iObjSubIndex << ".trace";
+		return sFilename.str();
+	}
+
+	// declared first, so the bus (and the simulated drive) is deleted after the driver
+	CanSimBus m_Bus;
+	HarmonicaSim* m_pSim;
+	FaultyHarmonicaSim* m_pFaulty;
+	HarmonicaTestDrive m_Drive;
+	std::string m_sLogPrefix;
+
+private:
+	void receive()
+	{
+		CanMsg msg;
+		while(m_Bus.receiveMsg(&msg))
+			m_Drive.evalReceivedMsg(msg);
+	}
+};
+
+//-----------------------------------------------
+#endif
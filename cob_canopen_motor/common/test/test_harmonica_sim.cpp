@@ -0,0 +1,114 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: Bring-up, SDO requests and recorder upload of the Harmonica driver against the simulated drive.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+//-----------------------------------------------
+#include "HarmonicaSimTest.h"
+#include <cob_canopen_motor/ElmoTrace.h>
+#include <boost/bind.hpp>
+
+//-----------------------------------------------
+TEST_F(HarmonicaSimTest, BringUp)
+{
+	EXPECT_EQ(CanDriveHarmonica::BRINGUP_DONE, bringUp());
+	EXPECT_TRUE(m_Drive.isInitialized());
+	EXPECT_TRUE(m_pSim->isMotorOn());
+}
+
+//-----------------------------------------------
+struct SDOResult
+{
+	SDOResult() : iNumCalls(0), iResult(-1), iData(0) {}
+	void set(int iRes, int, int, unsigned int iDat) { iNumCalls++; iResult = iRes; iData = iDat; }
+
+	int iNumCalls;
+	int iResult;
+	unsigned int iData;
+};
+
+TEST_F(HarmonicaSimTest, SDOClientUpload)
+{
+	ASSERT_EQ(CanDriveHarmonica::BRINGUP_DONE, bringUp());
+
+	SDOResult result;
+	m_Drive.getSDOClient().upload(0x6041, 0, boost::bind(&SDOResult::set, &result, _1, _2, _3, _4));
+	EXPECT_TRUE(m_Drive.waitForSDOClient(1.0));
+
+	EXPECT_EQ(1, result.iNumCalls);
+	EXPECT_EQ(SDOClient::SDO_OK, result.iResult);
+	// operation enabled
+	EXPECT_EQ(0x0237u, result.iData);
+}
+
+//-----------------------------------------------
+TEST_F(HarmonicaSimTest, RecorderBlockUpload)
+{
+	ASSERT_EQ(CanDriveHarmonica::BRINGUP_DONE, bringUp());
+	record();
+
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	ASSERT_TRUE(spinRecorderUpload(2.0));
+	EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+
+	ElmoTraceReader reader;
+	ASSERT_TRUE(reader.open(getTraceFilename(2)));
+	EXPECT_EQ(1024u, reader.getHeader().iNumSamples);
+
+	// position ramp of the turning motor
+	std::vector<float> vfPos;
+	reader.getValues(vfPos);
+	EXPECT_GT(vfPos.back() - vfPos.front(), 0);
+}
+
+//-----------------------------------------------
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,230 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: SDO block upload of the recorder data: normal transfer, CRC error, fallback and short last segment.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+//-----------------------------------------------
+#include "HarmonicaSimTest.h"
+#include <cob_canopen_motor/ElmoTrace.h>
+
+//-----------------------------------------------
+class SDOBlockUploadTest : public HarmonicaSimTest
+{
+protected:
+	/**
+	 * Records iNumSamples positions, the upload has 7 + 4 * iNumSamples bytes.
+	 */
+	void recordSamples(int iNumSamples)
+	{
+		ASSERT_EQ(CanDriveHarmonica::BRINGUP_DONE, bringUp());
+		record();
+		m_Drive.IntprtSetInt(8, 'R', 'L', 0, iNumSamples);
+		spin(0.01);
+	}
+
+	/**
+	 * Checks the upload and the trace of the recorded position: iNumSamples samples of the ramp.
+	 */
+	void checkTrace(unsigned int iNumSamples)
+	{
+		// header and samples, without the unused bytes of the last segment
+		EXPECT_EQ(7 + 4 * iNumSamples, m_Drive.getSegData().data.size());
+
+
+		ElmoTraceReader reader;
+		ASSERT_TRUE(reader.open(getTraceFilename(2)));
+		ASSERT_EQ(iNumSamples, reader.getHeader().iNumSamples);
+
+		std::vector<float> vfPos;
+		reader.getValues(vfPos);
+		double dIncrPerSample = m_pSim->getVelIncrS() * 90e-6;
+		ASSERT_GT(dIncrPerSample, 0);
+		for(unsigned int i = 0; i < vfPos.size(); i++)
+			ASSERT_NEAR(vfPos[0] + i * dIncrPerSample, vfPos[i], 1.0) << "sample " << i;
+	}
+};
+
+//-----------------------------------------------
+TEST_F(SDOBlockUploadTest, NormalTransfer)
+{
+	// 7 + 4 * 1022 = 585 full segments
+	recordSamples(1022);
+
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	ASSERT_TRUE(spinRecorderUpload(2.0));
+
+	EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+	EXPECT_EQ(1, m_pFaulty->iNumBlockInits);
+	EXPECT_EQ(0, m_pFaulty->iNumSegmentRequests);
+	EXPECT_EQ(0u, m_pFaulty->iAbortCode);
+	checkTrace(1022);
+}
+
+//-----------------------------------------------
+TEST_F(SDOBlockUploadTest, PacedTransfer)
+{
+	recordSamples(1022);
+
+	// confirm every block of 16 segments by hand
+	m_Drive.setRecorder(3, 16);
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+
+	int iNumBlocks = 0;
+	for(int i = 0; i < 1000 && m_Drive.setRecorder(2) != 0; i++)
+	{
+		spin(0.002);
+		if(m_Drive.setRecorder(4) == 0)
+			iNumBlocks++;
+	}
+
+	EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+	// 585 segments in blocks of 16, the confirmation of the last block ends the upload
+	EXPECT_EQ(37, iNumBlocks);
+	checkTrace(1022);
+}
+
+//-----------------------------------------------
+TEST_F(SDOBlockUploadTest, CRCMismatch)
+{
+	recordSamples(1022);
+	m_pFaulty->bCorruptCRC = true;
+
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	ASSERT_TRUE(spinRecorderUpload(2.0));
+
+	EXPECT_EQ(ElmoRecorder::UPLOAD_CRC_ERROR, m_Drive.setRecorder(6));
+	// the abort still has to pass the bus
+	spin(0.01);
+	EXPECT_EQ(0x05040004u, m_pFaulty->iAbortCode);
+	ElmoTraceReader reader;
+	EXPECT_FALSE(reader.open(getTraceFilename(2)));
+
+	// the SDO channel is free again, the next upload succeeds
+	m_pFaulty->bCorruptCRC = false;
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	ASSERT_TRUE(spinRecorderUpload(2.0));
+	EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+	checkTrace(1022);
+}
+
+//-----------------------------------------------
+TEST_F(SDOBlockUploadTest, OversizeUploadIsAborted)
+{
+	recordSamples(1022);
+	m_pFaulty->bOversizeUpload = true;
+
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	ASSERT_TRUE(spinRecorderUpload(2.0));
+
+	EXPECT_EQ(ElmoRecorder::UPLOAD_ABORTED, m_Drive.setRecorder(6));
+	spin(0.01);
+	EXPECT_EQ(0x05040005u, m_pFaulty->iAbortCode);
+	EXPECT_LT(m_Drive.getSegData().data.capacity(), (size_t)ElmoRecorder::MAX_UPLOAD_BYTES);
+
+	// the SDO channel is free again, the next upload succeeds
+	m_pFaulty->bOversizeUpload = false;
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	ASSERT_TRUE(spinRecorderUpload(2.0));
+	EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+	checkTrace(1022);
+}
+
+//-----------------------------------------------
+TEST_F(SDOBlockUploadTest, WriteErrorIsReported)
+{
+	recordSamples(1022);
+
+	// the upload itself succeeds, the trace file can't be created
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix + "no_such_dir/"));
+	ASSERT_TRUE(spinRecorderUpload(2.0));
+
+	EXPECT_EQ(ElmoRecorder::UPLOAD_WRITE_ERROR, m_Drive.setRecorder(6));
+}
+
+//-----------------------------------------------
+TEST_F(SDOBlockUploadTest, AbortFallsBackToSegmented)
+{
+	recordSamples(1022);
+	m_pFaulty->bRejectBlockUpload = true;
+
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	ASSERT_TRUE(spinRecorderUpload(5.0));
+
+	EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+	EXPECT_EQ(1, m_pFaulty->iNumBlockInits);
+	// one request per segment
+	EXPECT_EQ(585, m_pFaulty->iNumSegmentRequests);
+	checkTrace(1022);
+}
+
+//-----------------------------------------------
+TEST_F(SDOBlockUploadTest, ShortLastSegment)
+{
+	// 7 + 4 * n bytes leave 1..6 bytes for the last segment
+	const int ciNumSamples[] = { 1023, 1024, 1025, 1019, 1020, 1021 };
+
+	recordSamples(ciNumSamples[0]);
+	for(int i = 0; i < 6; i++)
+	{
+		SCOPED_TRACE(ciNumSamples[i]);
+		m_Drive.IntprtSetInt(8, 'R', 'L', 0, ciNumSamples[i]);
+		spin(0.01);
+
+		ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+		ASSERT_TRUE(spinRecorderUpload(2.0));
+		EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+		checkTrace(ciNumSamples[i]);
+	}
+}
+
+//-----------------------------------------------
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
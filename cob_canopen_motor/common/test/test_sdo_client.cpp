@@ -0,0 +1,271 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_canopen_motor
+ * Description: SDOClient of the Harmonica driver: expedited and segmented transfers, timeouts and the statusword request.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+//-----------------------------------------------
+#include "HarmonicaSimTest.h"
+#include <boost/bind.hpp>
+
+//-----------------------------------------------
+
+/**
+ * Collects the completed requests.
+ */
+struct SDOResults
+{
+	struct Result
+	{
+		int iResult;
+		int iObjIndex;
+		int iObjSubIndex;
+		unsigned int iData;
+	};
+
+	void add(int iResult, int iObjIndex, int iObjSubIndex, unsigned int iData)
+	{
+		Result result = { iResult, iObjIndex, iObjSubIndex, iData };
+		vResults.push_back(result);
+	}
+
+	SDOClient::CallbackType callback() { return boost::bind(&SDOResults::add, this, _1, _2, _3, _4); }
+
+	std::vector<Result> vResults;
+};
+
+//-----------------------------------------------
+class SDOClientTest : public HarmonicaSimTest
+{
+protected:
+	virtual void SetUp()
+	{
+		HarmonicaSimTest::SetUp();
+		ASSERT_EQ(CanDriveHarmonica::BRINGUP_DONE, bringUp());
+		m_pFaulty->vSDORequests.clear();
+	}
+
+	SDOClient& client() { return m_Drive.getSDOClient(); }
+
+	SDOResults m_Results;
+};
+
+//-----------------------------------------------
+TEST_F(SDOClientTest, ExpeditedTransfers)
+{
+	// pipelined: every request is sent after the reply to the previous one
+	for(int i = 0; i < 8; i++)
+		client().download(0x2F00, i + 1, 0x12345600 + i, m_Results.callback());
+	for(int i = 0; i < 8; i++)
+		client().upload(0x2F00, i + 1, m_Results.callback());
+	client().upload(0x6064, 0, m_Results.callback());
+
+	EXPECT_TRUE(m_Drive.waitForSDOClient(1.0));
+	EXPECT_EQ(17u, m_pFaulty->vSDORequests.size());
+
+	ASSERT_EQ(17u, m_Results.vResults.size());
+	for(int i = 0; i < 16; i++)
+	{
+		SCOPED_TRACE(i);
+		EXPECT_EQ(SDOClient::SDO_OK, m_Results.vResults[i].iResult);
+		EXPECT_EQ(0x2F00, m_Results.vResults[i].iObjIndex);
+		EXPECT_EQ(i % 8 + 1, m_Results.vResults[i].iObjSubIndex);
+	}
+	for(int i = 8; i < 16; i++)
+		EXPECT_EQ(0x12345600u + i - 8, m_Results.vResults[i].iData);
+
+	// position of the drive
+	EXPECT_EQ(SDOClient::SDO_OK, m_Results.vResults[16].iResult);
+	EXPECT_EQ((unsigned int)m_pSim->getPosIncr(), m_Results.vResults[16].iData);
+}
+
+//-----------------------------------------------
+TEST_F(SDOClientTest, AbortedByDrive)
+{
+	unsigned int iNumFailed = client().getNumFailed();
+
+	client().upload(0x2F01, 0, m_Results.callback());
+	client().upload(0x6041, 0, m_Results.callback());
+	EXPECT_FALSE(m_Drive.waitForSDOClient(1.0));
+
+	// the abort fails the first request only
+	ASSERT_EQ(2u, m_Results.vResults.size());
+	EXPECT_EQ(SDOClient::SDO_ABORTED, m_Results.vResults[0].iResult);
+	EXPECT_EQ(0x06020000u, m_Results.vResults[0].iData); // object does not exist
+	EXPECT_EQ(SDOClient::SDO_OK, m_Results.vResults[1].iResult);
+	EXPECT_EQ(iNumFailed + 1, client().getNumFailed());
+}
+
+//-----------------------------------------------
+TEST_F(SDOClientTest, SegmentedReplyIsAborted)
+{
+	// the recorder data needs a segmented upload, the client aborts it at the drive
+	m_Drive.setRecorder(0, 1);
+	spin(0.2);
+	client().upload(0x2030, 2, m_Results.callback());
+	client().upload(0x6041, 0, m_Results.callback());
+	EXPECT_FALSE(m_Drive.waitForSDOClient(1.0));
+
+	ASSERT_EQ(2u, m_Results.vResults.size());
+	EXPECT_EQ(SDOClient::SDO_ABORTED, m_Results.vResults[0].iResult);
+	EXPECT_EQ(0x06070010u, m_pFaulty->iAbortCode);
+	EXPECT_EQ(SDOClient::SDO_OK, m_Results.vResults[1].iResult);
+}
+
+//-----------------------------------------------
+TEST_F(SDOClientTest, WaitsForSegmentedUpload)
+{
+	// the drive supports the segmented upload of the recorder only
+	m_pFaulty->bRejectBlockUpload = true;
+	record();
+
+	ASSERT_EQ(0, m_Drive.setRecorder(1, 2, m_sLogPrefix));
+	// queued while the SDO channel is used by the recorder upload
+	client().upload(0x6064, 0, m_Results.callback());
+	client().download(0x2F00, 1, 5, m_Results.callback());
+
+	ASSERT_TRUE(spinRecorderUpload(5.0));
+	EXPECT_EQ(ElmoRecorder::UPLOAD_SUCCEEDED, m_Drive.setRecorder(6));
+	EXPECT_TRUE(m_Drive.waitForSDOClient(1.0));
+
+	ASSERT_EQ(2u, m_Results.vResults.size());
+	EXPECT_EQ(SDOClient::SDO_OK, m_Results.vResults[0].iResult);
+	EXPECT_EQ(SDOClient::SDO_OK, m_Results.vResults[1].iResult);
+
+	// no request of the client in between the segments of the upload
+	std::vector<CanMsg>& vRequests = m_pFaulty->vSDORequests;
+	ASSERT_GE(vRequests.size(), 2u);
+	EXPECT_EQ(0x40, vRequests[vRequests.size() - 2].getAt(0));
+	EXPECT_EQ(0x64, vRequests[vRequests.size() - 2].getAt(1));
+	for(unsigned int i = 0; i < vRequests.size() - 2; i++)
+	{
+		bool bRecorder = ((vRequests[i].getAt(0) >> 5) == 3) || ((vRequests[i].getAt(1) == 0x30) && (vRequests[i].getAt(2) == 0x20));
+		EXPECT_TRUE(bRecorder) << "request " << i << " is not for the recorder";
+	}
+}
+
+//-----------------------------------------------
+TEST_F(SDOClientTest, Timeout)
+{
+	m_pFaulty->bMuteSDO = true;
+	client().setTimeout(0.05, 2);
+
+	TimeStamp StartTime, Now;
+	StartTime.SetNow();
+	client().upload(0x6041, 0, m_Results.callback());
+	client().upload(0x6064, 0, m_Results.callback());
+	// 2 x 3 tries of 50 ms
+	EXPECT_FALSE(m_Drive.waitForSDOClient(1.0));
+	Now.SetNow();
+
+	ASSERT_EQ(2u, m_Results.vResults.size());
+	EXPECT_EQ(SDOClient::SDO_TIMEOUT, m_Results.vResults[0].iResult);
+	EXPECT_EQ(SDOClient::SDO_TIMEOUT, m_Results.vResults[1].iResult);
+	EXPECT_EQ(6u, m_pFaulty->vSDORequests.size());
+	// the requests end on their own timeout, not on the one of the wait
+	EXPECT_GT(Now - StartTime, 0.29);
+	EXPECT_LT(Now - StartTime, 0.9);
+	EXPECT_TRUE(client().isIdle());
+}
+
+//-----------------------------------------------
+TEST_F(SDOClientTest, WaitTimeoutCancels)
+{
+	m_pFaulty->bMuteSDO = true;
+	client().setTimeout(0.1, 10);
+
+	client().upload(0x6041, 0, m_Results.callback());
+	client().upload(0x6064, 0, m_Results.callback());
+	EXPECT_FALSE(m_Drive.waitForSDOClient(0.3));
+
+	ASSERT_EQ(2u, m_Results.vResults.size());
+	EXPECT_EQ(SDOClient::SDO_CANCELLED, m_Results.vResults[0].iResult);
+	EXPECT_EQ(SDOClient::SDO_CANCELLED, m_Results.vResults[1].iResult);
+	EXPECT_TRUE(client().isIdle());
+}
+
+//-----------------------------------------------
+// ElmoCtrl::Init() waits for the statusword after start() instead of Sleep(1000)
+TEST_F(SDOClientTest, Statusword)
+{
+	TimeStamp StartTime, Now;
+	StartTime.SetNow();
+	int iStatusword = 0;
+	EXPECT_TRUE(m_Drive.waitForStatusword(1.0, &iStatusword));
+	Now.SetNow();
+
+	// operation enabled, answered long before the former fixed delay of 1 s
+	EXPECT_EQ(0x0237, iStatusword);
+	EXPECT_LT(Now - StartTime, 0.5);
+	ASSERT_EQ(1u, m_pFaulty->vSDORequests.size());
+	EXPECT_EQ(0x41, m_pFaulty->vSDORequests[0].getAt(1));
+	EXPECT_EQ(0x60, m_pFaulty->vSDORequests[0].getAt(2));
+}
+
+//-----------------------------------------------
+TEST_F(SDOClientTest, StatuswordNoAnswer)
+{
+	m_pFaulty->bMuteSDO = true;
+
+	TimeStamp StartTime, Now;
+	StartTime.SetNow();
+	int iStatusword = -1;
+	EXPECT_FALSE(m_Drive.waitForStatusword(1.0, &iStatusword));
+	Now.SetNow();
+
+	// the default timeout of the client (3 x 100 ms) ends the request before the wait does
+	EXPECT_EQ(-1, iStatusword);
+	EXPECT_LT(Now - StartTime, 0.9);
+	EXPECT_TRUE(m_Drive.getSDOClient().isIdle());
+}
+
+//-----------------------------------------------
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
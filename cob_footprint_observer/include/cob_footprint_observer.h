@@ -49,7 +49,8 @@
  * @file  cob_footprint_observer.h
  * @brief  observes the footprint of care-o-bot
  *
- * Generates rectangular footprint of care-o-bot depending on setup
+ * Generates the footprint polygon of care-o-bot (convex hull of the
+ * initial footprint and the checked frames) depending on setup
  * of tray and arm.
  *
  ****************************************************************/
@@ -75,6 +76,8 @@
 #include <boost/algorithm/string.hpp>
 
 #include <cob_footprint_observer/GetFootprint.h>
+#include <footprint_frame_tracker.h>
+#include <footprint_hull.h>
 ///
 /// @class FootprintObserver
 /// @brief checks the footprint of care-o-bot and advertises a service to get the adjusted footprint
@@ -123,6 +126,12 @@ class FootprintObserver
     ///
     void publishFootprint();
 
+    ///
+    /// @brief  checks whether the hull moved noticeably compared to the published footprint
+    /// @return true if the Hausdorff distance of hull and published footprint exceeds footprint_change_threshold_
+    ///
+    bool footprintChanged(const std::vector<FootprintHull::Point>& hull);
+
     ///
     /// @brief  computes the sign of x
     /// @param  x - number
@@ -137,6 +146,13 @@ class FootprintObserver
     tf::TransformListener tf_listener_;
     std::string frames_to_check_;
     std::string robot_base_frame_;
+    boost::shared_ptr<FootprintFrameTracker> frame_tracker_;
+    std::vector<tf::Vector3> frame_positions_;
+    std::vector<bool> frame_available_;
+    FootprintHull footprint_hull_;
+    std::vector<double> frame_radii_;
+    double footprint_change_threshold_;
+    bool footprint_published_;
 
     pthread_mutex_t m_mutex;
 
@@ -0,0 +1,162 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_navigation
+ * ROS package name: cob_footprint_observer
+ *                
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *      
+ * Date of creation: 19.10.2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Fraunhofer Institute for Manufacturing 
+ *     Engineering and Automation (IPA) nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as 
+ * published by the Free Software Foundation, either version 3 of the 
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License LGPL along with this program. 
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file  footprint_frame_tracker.h
+ * @brief  looks up the positions of many frames relative to the robot base
+ *
+ * Resolves the tf chain of every checked frame once and fetches each
+ * edge of the union of all chains once per cycle.
+ *
+ ****************************************************************/
+#ifndef FOOTPRINT_FRAME_TRACKER_H
+#define FOOTPRINT_FRAME_TRACKER_H
+
+//##################
+//#### includes ####
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ros/ros.h>
+#include <tf/transform_listener.h>
+
+///
+/// @class FootprintFrameTracker
+/// @brief computes the positions of a fixed list of frames in the robot base frame
+///
+/// The frames to check typically share most of their chain to the base frame
+/// (e.g. all links of an arm). Instead of one full tf lookup per frame, the
+/// chains are resolved once into a tree of frames and every edge of that tree is
+/// looked up once per update. Edges to frames listed as static (e.g. a mounted
+/// tray) are looked up only once and then served from a cache. Frames which
+/// are not below the base frame (e.g. in a sibling subtree) are looked up directly.
+///
+class FootprintFrameTracker
+{
+  public:
+    ///
+    /// @brief  constructor
+    /// @param  tf_listener - listener used for all lookups
+    /// @param  base_frame - frame in which the positions are returned
+    ///
+    FootprintFrameTracker(tf::TransformListener& tf_listener, const std::string& base_frame);
+
+    ///
+    /// @brief  sets the frames to track, replacing all previous ones
+    /// @param  frames - frame ids
+    /// @param  static_frames - frames whose transform to their parent never changes
+    ///
+    void setFrames(const std::vector<std::string>& frames, const std::vector<std::string>& static_frames);
+
+    ///
+    /// @brief  looks up all tracked frames in one pass
+    /// @param  positions - origin of every tracked frame in the base frame
+    /// @param  available - false for frames which could not be transformed
+    /// @return number of available frames
+    ///
+    unsigned int update(std::vector<tf::Vector3>& positions, std::vector<bool>& available);
+
+    ///
+    /// @brief  returns the tracked frame ids in the order used by update()
+    ///
+    const std::vector<std::string>& frames() const { return frames_; }
+
+    ///
+    /// @brief  returns the number of edge lookups done by the last update()
+    ///
+    unsigned int lookupsLastUpdate() const { return lookups_; }
+
+  private:
+    /// a frame on the chain from a tracked frame to the base frame
+    struct Node
+    {
+      std::string frame;
+      int parent;               // index of the parent node, -1 for the base frame or a direct lookup
+      bool is_static;
+      bool edge_cached;         // edge_ holds a valid transform from a previous cycle
+      tf::Transform edge;       // transform parent <- frame
+      unsigned int stamp;       // cycle in which to_base was computed
+      bool to_base_valid;
+      tf::Transform to_base;    // transform base <- frame
+    };
+
+    ///
+    /// @brief  resolves the chain of a tracked frame into nodes
+    ///
+    /// If the base frame is not an ancestor of the frame, the frame gets a node
+    /// which is looked up directly in the base frame.
+    ///
+    /// @return index of the node of the frame, -1 if the frame cannot be transformed (yet)
+    ///
+    int resolveChain(const std::string& frame);
+
+    ///
+    /// @brief  returns the node of a frame, creating it if necessary
+    ///
+    int getNode(const std::string& frame);
+
+    ///
+    /// @brief  computes the transform base <- node for the current cycle
+    /// @return false if an edge on the chain is not available
+    ///
+    bool toBase(int node);
+
+    tf::TransformListener& tf_listener_;
+    std::string base_frame_;
+
+    std::vector<std::string> frames_;
+    std::vector<int> frame_nodes_;      // node per tracked frame, -1 if not resolved
+    std::vector<ros::Time> next_resolve_;  // earliest retry per unresolved frame
+    std::vector<std::string> static_frames_;
+
+    std::vector<Node> nodes_;
+    std::map<std::string, int> node_index_;
+
+    unsigned int cycle_;
+    unsigned int lookups_;
+};
+
+#endif
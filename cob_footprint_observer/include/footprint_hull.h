@@ -0,0 +1,136 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_navigation
+ * ROS package name: cob_footprint_observer
+ *                
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *      
+ * Date of creation: 19.10.2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Fraunhofer Institute for Manufacturing 
+ *     Engineering and Automation (IPA) nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as 
+ * published by the Free Software Foundation, either version 3 of the 
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License LGPL along with this program. 
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file  footprint_hull.h
+ * @brief  convex hull of the robot footprint and the checked frames
+ *
+ * Keeps the hull of the initial footprint and inserts the frame positions
+ * of every cycle incrementally.
+ *
+ ****************************************************************/
+#ifndef FOOTPRINT_HULL_H
+#define FOOTPRINT_HULL_H
+
+//##################
+//#### includes ####
+
+#include <vector>
+
+///
+/// @class FootprintHull
+/// @brief convex polygon (counter-clockwise) grown incrementally by points and circles
+///
+/// The hull of the initial footprint is computed once (monotone chain). Every
+/// cycle starts from it again and the frame positions are inserted one by one:
+/// a binary search over the fan of triangles from the first vertex rejects a point
+/// inside the hull in O(log n) and otherwise yields an edge visible from it, from
+/// which the chain of visible edges is grown and replaced by the point. The first
+/// vertex of equal hulls depends on the insertion order. Frames with a radius are
+/// inserted as a circumscribed regular polygon, so the hull never underestimates
+/// the circle.
+///
+class FootprintHull
+{
+  public:
+    struct Point
+    {
+      double x;
+      double y;
+    };
+
+    ///
+    /// @brief  constructor
+    /// @param  circle_segments - number of vertices used to approximate a circle
+    ///
+    FootprintHull(unsigned int circle_segments = 8);
+
+    ///
+    /// @brief  sets the initial footprint, its hull is the start of every cycle
+    /// @param  points - vertices of the initial footprint (any order)
+    ///
+    void setBase(const std::vector<Point>& points);
+
+    ///
+    /// @brief  resets the hull to the hull of the initial footprint
+    ///
+    void reset();
+
+    ///
+    /// @brief  grows the hull to contain (x, y)
+    ///
+    void insert(double x, double y);
+
+    ///
+    /// @brief  grows the hull to contain the circle around (x, y)
+    ///
+    void insertCircle(double x, double y, double radius);
+
+    ///
+    /// @brief  returns the vertices of the hull in counter-clockwise order
+    ///
+    const std::vector<Point>& points() const { return hull_; }
+
+    ///
+    /// @brief  computes the convex hull of arbitrary points (monotone chain)
+    /// @param  points - input points
+    /// @param  hull - vertices of the hull in counter-clockwise order
+    ///
+    static void computeHull(std::vector<Point> points, std::vector<Point>& hull);
+
+    ///
+    /// @brief  symmetric Hausdorff distance of two convex polygons (as areas)
+    /// @param  a, b - vertices in counter-clockwise order, the start vertex does not matter
+    /// @return largest distance of a point of one polygon to the other polygon
+    ///
+    static double distance(const std::vector<Point>& a, const std::vector<Point>& b);
+
+  private:
+    std::vector<Point> base_;
+    std::vector<Point> hull_;
+    std::vector<Point> scratch_;
+    std::vector<double> circle_cos_, circle_sin_;
+};
+
+#endif
@@ -49,7 +49,8 @@
  * @file  cob_footprint_observer.cpp
  * @brief  observes the footprint of care-o-bot
  *
- * Generates rectangular footprint of care-o-bot depending on setup of
+ * Generates the footprint polygon of care-o-bot (convex hull of the
+ * initial footprint and the checked frames) depending on setup of
  * arm and tray
  *
  ****************************************************************/
@@ -62,8 +63,8 @@ FootprintObserver::FootprintObserver()
 
   m_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-  // publish footprint
-  topic_pub_footprint_ = nh_.advertise<geometry_msgs::PolygonStamped>("adjusted_footprint",1);
+  // publish footprint (latched, it is only republished when it changes)
+  topic_pub_footprint_ = nh_.advertise<geometry_msgs::PolygonStamped>("adjusted_footprint",1,true);
   
   // advertise service
   srv_get_footprint_ = nh_.advertiseService("/get_footprint", &FootprintObserver::getFootprintCB, this);
@@ -78,8 +79,14 @@ FootprintObserver::FootprintObserver()
   
   // load the robot footprint from the parameter server if its available in the local costmap namespace
   robot_footprint_ = loadRobotFootprint(footprint_source_nh_);
-  if(robot_footprint_.size() > 4) 
-    ROS_WARN("You have set more than 4 points as robot_footprint, cob_footprint_observer can deal only with rectangular footprints so far!");
+
+  // the hull of the initial footprint is the start of the hull in every cycle
+  std::vector<FootprintHull::Point> base_points(robot_footprint_.size());
+  for(unsigned int i=0; i<robot_footprint_.size(); ++i) {
+    base_points[i].x = robot_footprint_[i].x;
+    base_points[i].y = robot_footprint_[i].y;
+  }
+  footprint_hull_.setBase(base_points);
   
   // get the frames for which to check the footprint
   if(!nh_.hasParam("frames_to_check")) ROS_WARN("No frames to check for footprint observer. Only using initial footprint!");
@@ -88,6 +95,53 @@ FootprintObserver::FootprintObserver()
   if(!nh_.hasParam("robot_base_frame")) ROS_WARN("No parameter robot_base_frame on parameter server. Using default [/base_link].");
   nh_.param("robot_base_frame", robot_base_frame_, std::string("/base_link"));
 
+  // frames whose transform to their parent never changes, these are looked up only once
+  std::string static_frames;
+  nh_.param("static_frames", static_frames, std::string(""));
+
+  // minimal change of the footprint borders that is republished
+  if(!nh_.hasParam("footprint_change_threshold")) ROS_WARN("No parameter footprint_change_threshold on parameter server. Using default [0.01 in m].");
+  nh_.param("footprint_change_threshold", footprint_change_threshold_, 0.01);
+
+  // resolve the frame list once instead of parsing it in every cycle
+  std::vector<std::string> frames, static_frame_list;
+  std::string frame;
+  std::stringstream ss(frames_to_check_);
+  while(ss >> frame)
+    frames.push_back(frame);
+  std::stringstream ss_static(static_frames);
+  while(ss_static >> frame)
+    static_frame_list.push_back(frame);
+
+  frame_tracker_.reset(new FootprintFrameTracker(tf_listener_, robot_base_frame_));
+  frame_tracker_->setFrames(frames, static_frame_list);
+
+  // optional radius around each checked frame (e.g. size of the gripper), given as
+  // frame_radii: {arm_7_link: 0.1, ...}, all other frames use default_frame_radius
+  double default_frame_radius;
+  nh_.param("default_frame_radius", default_frame_radius, 0.0);
+  frame_radii_.assign(frames.size(), default_frame_radius);
+  XmlRpc::XmlRpcValue radii;
+  if(nh_.getParam("frame_radii", radii)) {
+    if(radii.getType() != XmlRpc::XmlRpcValue::TypeStruct) {
+      ROS_WARN("Parameter frame_radii has to be a dictionary frame: radius. Ignoring it.");
+    } else {
+      for(XmlRpc::XmlRpcValue::iterator it = radii.begin(); it != radii.end(); ++it) {
+        XmlRpc::XmlRpcValue& value = it->second;
+        if(value.getType() != XmlRpc::XmlRpcValue::TypeInt && value.getType() != XmlRpc::XmlRpcValue::TypeDouble) {
+          ROS_WARN("Radius of frame %s in frame_radii is not a number. Ignoring it.", it->first.c_str());
+          continue;
+        }
+        double radius = (value.getType() == XmlRpc::XmlRpcValue::TypeInt) ? (int)value : (double)value;
+        for(unsigned int i=0; i<frames.size(); ++i) {
+          if(tf_listener_.resolve(frames[i]) == tf_listener_.resolve(it->first))
+            frame_radii_[i] = radius;
+        }
+      }
+    }
+  }
+  footprint_published_ = false;
+
   last_tf_missing_ = ros::Time::now();
 }
 
@@ -103,12 +157,14 @@ bool FootprintObserver::getFootprintCB(cob_footprint_observer::GetFootprint::Req
   footprint_poly.header.frame_id = robot_base_frame_;
   footprint_poly.header.stamp = ros::Time::now();
   
+  pthread_mutex_lock(&m_mutex);
   footprint_poly.polygon.points.resize(robot_footprint_.size());
   for(unsigned int i=0; i<robot_footprint_.size(); ++i) {
     footprint_poly.polygon.points[i].x = robot_footprint_[i].x;
     footprint_poly.polygon.points[i].y = robot_footprint_[i].y;
     footprint_poly.polygon.points[i].z = robot_footprint_[i].z;   
   }
+  pthread_mutex_unlock(&m_mutex);
 
   resp.footprint = footprint_poly;
   resp.success.data = true;
@@ -273,69 +329,78 @@ std::vector<geometry_msgs::Point> FootprintObserver::loadRobotFootprint(ros::Nod
 
 // checks if footprint has to be adjusted and does so if necessary
 void FootprintObserver::checkFootprint(){
-  // check each frame
-  std::string frame;
-  std::stringstream ss;
-  ss << frames_to_check_; 
+  // get the positions of all frames in one pass over their tf chains
+  frame_tracker_->update(frame_positions_, frame_available_);
 
-  double x_rear, x_front, y_left, y_right;
-  x_front = footprint_front_initial_;
-  x_rear = footprint_rear_initial_;
-  y_left = footprint_left_initial_;
-  y_right = footprint_right_initial_;
+  // grow the hull of the initial footprint by all frames (including their radius)
+  footprint_hull_.reset();
 
   bool missing_frame_exists = false;
-  while(ss >> frame){
-    // get transform between robot base frame and frame
-    if(tf_listener_.canTransform(robot_base_frame_, frame, ros::Time(0))) {
-      tf::StampedTransform transform;
-      tf_listener_.lookupTransform(robot_base_frame_, frame, ros::Time(0), transform);
-      
-      tf::Vector3 frame_position = transform.getOrigin();
-
-      // check if frame position is outside of current footprint
-      if(frame_position.x() > x_front) x_front = frame_position.x();
-      if(frame_position.x() < x_rear) x_rear = frame_position.x();
-      if(frame_position.y() > y_left) y_left = frame_position.y();
-      if(frame_position.y() < y_right) y_right = frame_position.y();
+  const std::vector<std::string>& frames = frame_tracker_->frames();
+  for(unsigned int i=0; i<frames.size(); ++i) {
+    if(frame_available_[i]) {
+      const tf::Vector3& frame_position = frame_positions_[i];
+      footprint_hull_.insertCircle(frame_position.x(), frame_position.y(), frame_radii_[i]);
     } else if ( (ros::Time::now() - last_tf_missing_).toSec() > 5.0) {
       missing_frame_exists = true;
       ROS_WARN("Footprint Observer: Transformation for %s not available! Frame %s not considered in adjusted footprint!",
-               frame.c_str(), frame.c_str());
+               frames[i].c_str(), frames[i].c_str());
     }
   }
   if (missing_frame_exists)
     last_tf_missing_ = ros::Time::now();
-  
-  pthread_mutex_lock(&m_mutex);
-  // adjust footprint
-  footprint_front_ = x_front; 
-  footprint_rear_ = x_rear;
-  footprint_left_ = y_left;
-  footprint_right_ = y_right;
-  pthread_mutex_unlock(&m_mutex);
+
+  // only adjust and republish the footprint if it changed noticeably
+  const std::vector<FootprintHull::Point>& hull = footprint_hull_.points();
+  if(footprint_published_ && !footprintChanged(hull))
+    return;
 
   // create new footprint vector
   geometry_msgs::Point point;
   std::vector<geometry_msgs::Point> points;
+  double x_rear, x_front, y_left, y_right;
+  x_front = footprint_front_initial_;
+  x_rear = footprint_rear_initial_;
+  y_left = footprint_left_initial_;
+  y_right = footprint_right_initial_;
 
-  point.x = footprint_front_;
-  point.y = footprint_left_;
   point.z = 0;
-  points.push_back(point);
-  point.y = footprint_right_;
-  points.push_back(point);
-  point.x = footprint_rear_;
-  points.push_back(point);
-  point.y = footprint_left_;
-  points.push_back(point);
+  for(unsigned int i=0; i<hull.size(); ++i) {
+    point.x = hull[i].x;
+    point.y = hull[i].y;
+    points.push_back(point);
+
+    // keep track of the rectangular borders as well
+    if(point.x > x_front) x_front = point.x;
+    if(point.x < x_rear) x_rear = point.x;
+    if(point.y > y_left) y_left = point.y;
+    if(point.y < y_right) y_right = point.y;
+  }
 
   pthread_mutex_lock(&m_mutex);
+  // adjust footprint
+  footprint_front_ = x_front; 
+  footprint_rear_ = x_rear;
+  footprint_left_ = y_left;
+  footprint_right_ = y_right;
   robot_footprint_ = points;
   pthread_mutex_unlock(&m_mutex);
 
   // publish the adjusted footprint
   publishFootprint();
+  footprint_published_ = true;
+}
+
+// checks whether the hull moved noticeably compared to the published footprint
+bool FootprintObserver::footprintChanged(const std::vector<FootprintHull::Point>& hull){
+  // the vertex order and count of equal hulls depend on the insertion order of the frames,
+  // so the polygons are compared as areas
+  std::vector<FootprintHull::Point> published(robot_footprint_.size());
+  for(unsigned int i=0; i<robot_footprint_.size(); ++i) {
+    published[i].x = robot_footprint_[i].x;
+    published[i].y = robot_footprint_[i].y;
+  }
+  return FootprintHull::distance(hull, published) > footprint_change_threshold_;
 }
 
 // publishes the adjusted footprint
@@ -0,0 +1,207 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_navigation
+ * ROS package name: cob_footprint_observer
+ *                
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *      
+ * Date of creation: 19.10.2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Fraunhofer Institute for Manufacturing 
+ *     Engineering and Automation (IPA) nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as 
+ * published by the Free Software Foundation, either version 3 of the 
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License LGPL along with this program. 
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file  footprint_frame_tracker.cpp
+ * @brief  looks up the positions of many frames relative to the robot base
+ *
+ ****************************************************************/
+#include <footprint_frame_tracker.h>
+
+#include <algorithm>
+
+// period in which the chains of unresolved frames are retried
+static const double RESOLVE_RETRY_PERIOD = 1.0;  // s
+
+// Constructor
+FootprintFrameTracker::FootprintFrameTracker(tf::TransformListener& tf_listener, const std::string& base_frame) :
+  tf_listener_(tf_listener), cycle_(0), lookups_(0)
+{
+  base_frame_ = tf_listener_.resolve(base_frame);
+}
+
+// sets the frames to track
+void FootprintFrameTracker::setFrames(const std::vector<std::string>& frames, const std::vector<std::string>& static_frames)
+{
+  frames_.clear();
+  for(unsigned int i=0; i<frames.size(); ++i)
+    frames_.push_back(tf_listener_.resolve(frames[i]));
+
+  static_frames_.clear();
+  for(unsigned int i=0; i<static_frames.size(); ++i)
+    static_frames_.push_back(tf_listener_.resolve(static_frames[i]));
+
+  nodes_.clear();
+  node_index_.clear();
+  frame_nodes_.assign(frames_.size(), -1);
+  next_resolve_.assign(frames_.size(), ros::Time(0));
+}
+
+// returns the node of a frame, creating it if necessary
+int FootprintFrameTracker::getNode(const std::string& frame)
+{
+  std::map<std::string, int>::iterator it = node_index_.find(frame);
+  if(it != node_index_.end())
+    return it->second;
+
+  Node node;
+  node.frame = frame;
+  node.parent = -1;
+  node.is_static = std::find(static_frames_.begin(), static_frames_.end(), frame) != static_frames_.end();
+  node.edge_cached = false;
+  node.stamp = 0;
+  node.to_base_valid = false;
+  nodes_.push_back(node);
+  node_index_[frame] = nodes_.size() - 1;
+  return nodes_.size() - 1;
+}
+
+// walks up the tf tree from frame until the base frame is reached
+int FootprintFrameTracker::resolveChain(const std::string& frame)
+{
+  std::vector<std::string> chain;
+  std::string current = frame;
+  std::string parent;
+  bool below_base = true;
+
+  while(current != base_frame_) {
+    // stop at already resolved parts of the tree
+    if(node_index_.find(current) != node_index_.end())
+      break;
+    chain.push_back(current);
+    // frame unknown, base frame is not an ancestor or loop in the tree
+    if(!tf_listener_.getParent(current, ros::Time(0), parent) || chain.size() > 1000) {
+      below_base = false;
+      break;
+    }
+    current = tf_listener_.resolve(parent);
+  }
+
+  if(!below_base) {
+    // connected through a common parent: look the frame up directly
+    if(!tf_listener_.canTransform(base_frame_, frame, ros::Time(0)))
+      return -1;
+    int n = getNode(frame);
+    nodes_[n].parent = -1;
+    // the edge spans several transforms, it is static only if they all are
+    nodes_[n].is_static = false;
+    return n;
+  }
+
+  int parent_node = (current == base_frame_) ? -1 : node_index_[current];
+  for(int i=(int)chain.size()-1; i>=0; --i) {
+    int n = getNode(chain[i]);
+    nodes_[n].parent = parent_node;
+    parent_node = n;
+  }
+
+  return (frame == base_frame_) ? -1 : node_index_[frame];
+}
+
+// computes the transform base <- node for the current cycle
+bool FootprintFrameTracker::toBase(int n)
+{
+  Node& node = nodes_[n];
+  if(node.stamp == cycle_)
+    return node.to_base_valid;
+  node.stamp = cycle_;
+  node.to_base_valid = false;
+
+  if(!node.is_static || !node.edge_cached) {
+    std::string parent_frame = (node.parent < 0) ? base_frame_ : nodes_[node.parent].frame;
+    tf::StampedTransform transform;
+    try {
+      lookups_++;
+      tf_listener_.lookupTransform(parent_frame, node.frame, ros::Time(0), transform);
+    } catch(tf::TransformException& ex) {
+      return false;
+    }
+    node.edge = transform;
+    node.edge_cached = true;
+  }
+
+  if(node.parent < 0) {
+    node.to_base = node.edge;
+  } else {
+    if(!toBase(node.parent))
+      return false;
+    // nodes_ is not resized during an update, the reference stays valid
+    node.to_base = nodes_[node.parent].to_base * node.edge;
+  }
+  node.to_base_valid = true;
+  return true;
+}
+
+// looks up all tracked frames in one pass
+unsigned int FootprintFrameTracker::update(std::vector<tf::Vector3>& positions, std::vector<bool>& available)
+{
+  // resolve chains of frames which were not available so far, at most once per retry period
+  ros::Time now = ros::Time::now();
+  for(unsigned int i=0; i<frames_.size(); ++i) {
+    if(frame_nodes_[i] < 0 && frames_[i] != base_frame_ && now >= next_resolve_[i]) {
+      frame_nodes_[i] = resolveChain(frames_[i]);
+      next_resolve_[i] = now + ros::Duration(RESOLVE_RETRY_PERIOD);
+    }
+  }
+
+  cycle_++;
+  lookups_ = 0;
+  positions.resize(frames_.size());
+  available.assign(frames_.size(), false);
+
+  unsigned int count = 0;
+  for(unsigned int i=0; i<frames_.size(); ++i) {
+    if(frames_[i] == base_frame_) {
+      positions[i] = tf::Vector3(0.0, 0.0, 0.0);
+      available[i] = true;
+      count++;
+    } else if(frame_nodes_[i] >= 0 && toBase(frame_nodes_[i])) {
+      positions[i] = nodes_[frame_nodes_[i]].to_base.getOrigin();
+      available[i] = true;
+      count++;
+    }
+  }
+
+  return count;
+}
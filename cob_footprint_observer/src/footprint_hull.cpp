@@ -0,0 +1,275 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_navigation
+ * ROS package name: cob_footprint_observer
+ *                
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *      
+ * Date of creation: 19.10.2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Fraunhofer Institute for Manufacturing 
+ *     Engineering and Automation (IPA) nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as 
+ * published by the Free Software Foundation, either version 3 of the 
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License LGPL along with this program. 
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file  footprint_hull.cpp
+ * @brief  convex hull of the robot footprint and the checked frames
+ *
+ ****************************************************************/
+#include <footprint_hull.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // > 0 if c lies left of the line from a to b
+  inline double cross(const FootprintHull::Point& a, const FootprintHull::Point& b, const FootprintHull::Point& c)
+  {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+  }
+
+  // points closer than this (in m^2 of the cross product) to an edge count as lying on it,
+  // which keeps the visible range of edges contiguous despite rounding errors
+  const double EPSILON = 1e-9;
+
+  // distance of p to the segment from a to b
+  double distanceToSegment(const FootprintHull::Point& p, const FootprintHull::Point& a, const FootprintHull::Point& b)
+  {
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double len2 = dx * dx + dy * dy;
+    double t = 0.0;
+    if(len2 > 0.0)
+      t = std::max(0.0, std::min(1.0, ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2));
+    double ex = a.x + t * dx - p.x;
+    double ey = a.y + t * dy - p.y;
+    return sqrt(ex * ex + ey * ey);
+  }
+
+  // distance of p to the convex polygon (counter-clockwise), 0 inside
+  double distanceToPolygon(const FootprintHull::Point& p, const std::vector<FootprintHull::Point>& polygon)
+  {
+    unsigned int n = polygon.size();
+    if(n == 0)
+      return 0.0;
+    if(n == 1)
+      return distanceToSegment(p, polygon[0], polygon[0]);
+
+    bool inside = (n >= 3);
+    double dist = -1.0;
+    for(unsigned int i=0; i<n; ++i) {
+      const FootprintHull::Point& a = polygon[i];
+      const FootprintHull::Point& b = polygon[(i + 1) % n];
+      if(cross(a, b, p) < 0.0)
+        inside = false;
+      double d = distanceToSegment(p, a, b);
+      if(dist < 0.0 || d < dist)
+        dist = d;
+    }
+    return inside ? 0.0 : dist;
+  }
+
+  // largest distance of a vertex of a to the polygon b; for convex polygons this is
+  // the directed Hausdorff distance, as the distance to a convex area is convex
+  double directedDistance(const std::vector<FootprintHull::Point>& a, const std::vector<FootprintHull::Point>& b)
+  {
+    double dist = 0.0;
+    for(unsigned int i=0; i<a.size(); ++i)
+      dist = std::max(dist, distanceToPolygon(a[i], b));
+    return dist;
+  }
+
+  inline bool lessXY(const FootprintHull::Point& a, const FootprintHull::Point& b)
+  {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  }
+}
+
+// Constructor
+FootprintHull::FootprintHull(unsigned int circle_segments)
+{
+  if(circle_segments < 3)
+    circle_segments = 3;
+
+  // vertices of a regular polygon circumscribing the unit circle
+  double scale = 1.0 / cos(M_PI / circle_segments);
+  for(unsigned int i=0; i<circle_segments; ++i) {
+    double angle = 2.0 * M_PI * i / circle_segments;
+    circle_cos_.push_back(scale * cos(angle));
+    circle_sin_.push_back(scale * sin(angle));
+  }
+}
+
+// computes the convex hull of arbitrary points (Andrew's monotone chain)
+void FootprintHull::computeHull(std::vector<Point> points, std::vector<Point>& hull)
+{
+  hull.clear();
+  std::sort(points.begin(), points.end(), lessXY);
+
+  if(points.size() < 3) {
+    hull = points;
+    return;
+  }
+
+  hull.resize(2 * points.size());
+  unsigned int k = 0;
+  // lower hull
+  for(unsigned int i=0; i<points.size(); ++i) {
+    while(k >= 2 && cross(hull[k-2], hull[k-1], points[i]) <= 0.0)
+      k--;
+    hull[k++] = points[i];
+  }
+  // upper hull
+  for(int i=(int)points.size()-2, t=k+1; i>=0; --i) {
+    while((int)k >= t && cross(hull[k-2], hull[k-1], points[i]) <= 0.0)
+      k--;
+    hull[k++] = points[i];
+  }
+  // the last point equals the first one
+  hull.resize(k - 1);
+}
+
+// sets the initial footprint
+void FootprintHull::setBase(const std::vector<Point>& points)
+{
+  computeHull(points, base_);
+  reset();
+}
+
+// resets the hull to the hull of the initial footprint
+void FootprintHull::reset()
+{
+  hull_ = base_;
+}
+
+// grows the hull to contain (x, y)
+void FootprintHull::insert(double x, double y)
+{
+  Point p;
+  p.x = x;
+  p.y = y;
+
+  unsigned int n = hull_.size();
+  if(n < 3) {
+    // degenerate hull, recompute from scratch
+    scratch_ = hull_;
+    scratch_.push_back(p);
+    computeHull(scratch_, hull_);
+    return;
+  }
+
+  // locate p in the fan of triangles (hull_[0], hull_[k], hull_[k+1]) by a binary search:
+  // a point inside the hull is rejected in O(log n), for a point outside the edge
+  // (hull_[lo], hull_[hi]) is visible and the visible range is grown from there.
+  // Points on the outer rays of the fan are left to the linear search, vertices
+  // collinear with hull_[0] may lie there
+  int first_visible = -1;
+  if(cross(hull_[0], hull_[1], p) > EPSILON && cross(hull_[0], hull_[n-1], p) < -EPSILON) {
+    unsigned int lo = 1, hi = n - 1;
+    while(hi - lo > 1) {
+      unsigned int mid = (lo + hi) / 2;
+      if(cross(hull_[0], hull_[mid], p) >= 0.0)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    if(cross(hull_[lo], hull_[hi], p) >= -EPSILON)
+      return;
+    first_visible = lo;
+  } else {
+    // edge i runs from vertex i to vertex i+1 and is visible from p if p lies right of it;
+    // the visible edges form one contiguous (cyclic) range
+    for(unsigned int i=0; i<n; ++i) {
+      if(cross(hull_[i], hull_[(i + 1 < n) ? i + 1 : 0], p) < -EPSILON) {
+        first_visible = i;
+        break;
+      }
+    }
+    if(first_visible < 0)
+      return; // inside or on the border
+  }
+
+  // extend the range backwards and forwards
+  unsigned int start = first_visible;
+  for(unsigned int prev = (start > 0) ? start - 1 : n - 1;
+      prev != (unsigned int)first_visible && cross(hull_[prev], hull_[start], p) < -EPSILON;
+      prev = (start > 0) ? start - 1 : n - 1)
+    start = prev;
+  unsigned int end = first_visible;
+  for(unsigned int next = (end + 1 < n) ? end + 1 : 0;
+      next != start && cross(hull_[next], hull_[(next + 1 < n) ? next + 1 : 0], p) < -EPSILON;
+      next = (end + 1 < n) ? end + 1 : 0)
+    end = next;
+
+  // the vertices strictly inside the visible range (after start up to end) are replaced by p
+  if(start <= end) {
+    if(start == end) {
+      hull_.insert(hull_.begin() + start + 1, p);
+    } else {
+      hull_[start + 1] = p;
+      hull_.erase(hull_.begin() + start + 2, hull_.begin() + end + 1);
+    }
+    return;
+  }
+
+  // the range wraps around: keep the vertices from the end of the visible range to its start
+  scratch_.clear();
+  scratch_.push_back(p);
+  for(unsigned int i=(end + 1 < n) ? end + 1 : 0; ; i=(i + 1 < n) ? i + 1 : 0) {
+    scratch_.push_back(hull_[i]);
+    if(i == start)
+      break;
+  }
+  hull_.swap(scratch_);
+}
+
+// grows the hull to contain the circle around (x, y)
+void FootprintHull::insertCircle(double x, double y, double radius)
+{
+  if(radius <= 0.0) {
+    insert(x, y);
+    return;
+  }
+  for(unsigned int i=0; i<circle_cos_.size(); ++i)
+    insert(x + radius * circle_cos_[i], y + radius * circle_sin_[i]);
+}
+
+// symmetric Hausdorff distance of two convex polygons
+double FootprintHull::distance(const std::vector<Point>& a, const std::vector<Point>& b)
+{
+  if(a.empty() || b.empty())
+    return (a.empty() && b.empty()) ? 0.0 : HUGE_VAL;
+  return std::max(directedDistance(a, b), directedDistance(b, a));
+}
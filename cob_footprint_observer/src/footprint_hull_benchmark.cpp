@@ -0,0 +1,171 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_navigation
+ * ROS package name: cob_footprint_observer
+ *                
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *      
+ * Date of creation: 19.10.2026
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Fraunhofer Institute for Manufacturing 
+ *     Engineering and Automation (IPA) nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as 
+ * published by the Free Software Foundation, either version 3 of the 
+ * License, or (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public 
+ * License LGPL along with this program. 
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ * @file  footprint_hull_benchmark.cpp
+ * @brief  measures the cost of one footprint hull update
+ *
+ * Simulates arm-like chains of frames around a rectangular base and times
+ * the per-cycle update (reset and insertion of all frames) of FootprintHull
+ * against a full monotone chain hull and the former bounding box.
+ *
+ * usage: footprint_hull_benchmark [cycles] [frame_radius]
+ *
+ ****************************************************************/
+#include <footprint_hull.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+
+double wallTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+// positions of n frames on a few planar arms, moving with the cycle number
+void simulateFrames(unsigned int n, unsigned int cycle, std::vector<FootprintHull::Point>& frames)
+{
+  const unsigned int arms = 3;
+  frames.resize(n);
+  for(unsigned int i=0; i<n; ++i) {
+    unsigned int arm = i % arms;
+    unsigned int link = i / arms;
+    double angle = 0.3 + 2.0 * M_PI * arm / arms + 0.01 * cycle * (arm + 1);
+    double reach = 0.2 + 0.9 * (link + 1) / (n / arms + 1);
+    // joints bend the arm slightly so that inner links are not on the hull
+    double bend = 0.2 * sin(0.05 * cycle + link);
+    frames[i].x = reach * cos(angle + bend);
+    frames[i].y = reach * sin(angle + bend);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  unsigned int cycles = (argc > 1) ? atoi(argv[1]) : 20000;
+  double radius = (argc > 2) ? atof(argv[2]) : 0.0;
+
+  std::vector<FootprintHull::Point> base(4);
+  base[0].x = 0.3;  base[0].y = 0.3;
+  base[1].x = -0.3; base[1].y = 0.3;
+  base[2].x = -0.3; base[2].y = -0.3;
+  base[3].x = 0.3;  base[3].y = -0.3;
+
+  printf("cycles %u, frame radius %.3f\n", cycles, radius);
+  printf("%8s %18s %18s %18s %10s\n", "frames", "incremental [us]", "full hull [us]", "bounding box [us]", "vertices");
+
+  unsigned int frame_counts[] = { 10, 50, 100, 200, 500 };
+  for(unsigned int f=0; f<sizeof(frame_counts)/sizeof(frame_counts[0]); ++f) {
+    unsigned int n = frame_counts[f];
+    std::vector<std::vector<FootprintHull::Point> > frames(64);
+    for(unsigned int c=0; c<frames.size(); ++c)
+      simulateFrames(n, c, frames[c]);
+
+    // incremental update as done by the observer every cycle
+    FootprintHull hull;
+    hull.setBase(base);
+    unsigned long vertices = 0;
+    double start = wallTime();
+    for(unsigned int c=0; c<cycles; ++c) {
+      const std::vector<FootprintHull::Point>& pts = frames[c % frames.size()];
+      hull.reset();
+      for(unsigned int i=0; i<n; ++i)
+        hull.insertCircle(pts[i].x, pts[i].y, radius);
+      vertices += hull.points().size();
+    }
+    double t_incremental = (wallTime() - start) * 1e6 / cycles;
+
+    // full recomputation from all points, with the same circumscribed octagon as FootprintHull::insertCircle
+    std::vector<FootprintHull::Point> octagon(8);
+    for(unsigned int k=0; k<8; ++k) {
+      octagon[k].x = radius / cos(M_PI / 8) * cos(2.0 * M_PI * k / 8);
+      octagon[k].y = radius / cos(M_PI / 8) * sin(2.0 * M_PI * k / 8);
+    }
+    std::vector<FootprintHull::Point> all, full;
+    start = wallTime();
+    for(unsigned int c=0; c<cycles; ++c) {
+      const std::vector<FootprintHull::Point>& pts = frames[c % frames.size()];
+      all = base;
+      for(unsigned int i=0; i<n; ++i) {
+        if(radius <= 0.0) {
+          all.push_back(pts[i]);
+          continue;
+        }
+        for(unsigned int k=0; k<8; ++k) {
+          FootprintHull::Point q;
+          q.x = pts[i].x + octagon[k].x;
+          q.y = pts[i].y + octagon[k].y;
+          all.push_back(q);
+        }
+      }
+      FootprintHull::computeHull(all, full);
+    }
+    double t_full = (wallTime() - start) * 1e6 / cycles;
+
+    // former axis-aligned bounding box
+    double sink = 0.0;
+    start = wallTime();
+    for(unsigned int c=0; c<cycles; ++c) {
+      const std::vector<FootprintHull::Point>& pts = frames[c % frames.size()];
+      double front = 0.3, rear = -0.3, left = 0.3, right = -0.3;
+      for(unsigned int i=0; i<n; ++i) {
+        if(pts[i].x > front) front = pts[i].x;
+        if(pts[i].x < rear) rear = pts[i].x;
+        if(pts[i].y > left) left = pts[i].y;
+        if(pts[i].y < right) right = pts[i].y;
+      }
+      sink += front - rear + left - right;
+    }
+    double t_box = (wallTime() - start) * 1e6 / cycles;
+
+    printf("%8u %18.3f %18.3f %18.3f %10.1f\n", n, t_incremental, t_full, t_box, (double)vertices / cycles);
+    if(sink < 0.0)
+      printf("\n"); // keeps the bounding box loop from being optimized away
+  }
+
+  return 0;
+}
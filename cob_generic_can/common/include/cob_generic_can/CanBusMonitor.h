@@ -0,0 +1,223 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_generic_can
+ * Description: Bus load accounting and frame trace for any CanItf.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef CANBUSMONITOR_INCLUDEDEF_H
+#define CANBUSMONITOR_INCLUDEDEF_H
+
+//-----------------------------------------------
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Headers provided by other cob-packages
+#include <cob_generic_can/CanItf.h>
+#include <cob_utilities/TimeStamp.h>
+
+//-----------------------------------------------
+
+/**
+ * Decorator of a CanItf that accounts the frames and bits per COB-ID and traces the frames.
+ *
+ * Every frame sent or received through the monitor is counted with its length on the bus,
+ * including the worst case of stuff bits, and stored with its time stamp in a ring.
+ * The ring is written without locks, so the monitor can be shared by several threads.
+ * The ring can be dumped in the log format of candump (can-utils), e.g. for canplayer or log2asc.
+ *
+ * getBusLoad() and getStatistics() are meant to be called by one thread, e.g. the one publishing diagnostics.
+ * \ingroup DriversCanModul
+ */
+class CanBusMonitor : public CanItf
+{
+public:
+	/**
+	 * Statistics of one COB-ID.
+	 */
+	struct IDStatistics
+	{
+		int iID;
+		unsigned int iNumTx;
+		unsigned int iNumRx;
+		unsigned long long iNumBits;
+	};
+
+	/**
+	 * Largest number of frames kept in the trace.
+	 */
+	static const int MAX_TRACE_SIZE = 1 << 20;
+
+	/**
+	 * Constructor.
+	 * @param pCanItf monitored interface, deleted with the monitor
+	 * @param iBaudrateKbit bitrate of the bus
+	 * @param iTraceSize number of frames kept in the trace, rounded up to a power of 2 and limited to MAX_TRACE_SIZE,
+	 * values <= 0 disable the trace
+	 */
+	CanBusMonitor(CanItf* pCanItf, int iBaudrateKbit = 1000, int iTraceSize = 4096);
+
+	~CanBusMonitor();
+
+	void init() { m_pCanItf->init(); }
+	bool transmitMsg(CanMsg CMsg, bool bBlocking = true);
+	bool receiveMsg(CanMsg* pCMsg);
+	bool receiveMsgRetry(CanMsg* pCMsg, int iNrOfRetry);
+	bool isObjectMode() { return m_pCanItf->isObjectMode(); }
+
+	/**
+	 * Returns the monitored interface.
+	 */
+	CanItf* getCanItf() { return m_pCanItf; }
+
+	/**
+	 * Number of bits of a standard frame on the bus, with the worst case of stuff bits.
+	 * @param iLen number of data bytes
+	 */
+	static int getFrameBits(int iLen) { return 47 + 8 * iLen + (34 + 8 * iLen - 1) / 4; }
+
+	/**
+	 * Returns the bus load of the monitored frames, averaged over the given window.
+	 * The load is taken from the counters at the previous calls, so call it regularly,
+	 * e.g. with every publication of the diagnostics.
+	 * @param dWindowSec length of the window
+	 * @return share of the bitrate 0..1
+	 */
+	double getBusLoad(double dWindowSec = 1.0);
+
+	/**
+	 * Returns the number of frames per second, averaged like getBusLoad().
+	 */
+	double getFrameRate() { return m_dFrameRate; }
+
+	/**
+	 * Gets the statistics of all COB-IDs seen since the last resetStatistics(), the ones with most bits first.
+	 */
+	void getStatistics(std::vector<IDStatistics>& vStatistics);
+
+	/**
+	 * Returns the total number of monitored frames and the ones that could not be sent.
+	 */
+	void getNumFrames(unsigned int* piTx, unsigned int* piRx, unsigned int* piTxFailed);
+
+	/**
+	 * Clears the counters. The trace is kept.
+	 */
+	void resetStatistics();
+
+	/**
+	 * Writes the trace in the log format of candump, the oldest frame first:
+	 * "(1345212884.318850) can0 181#0011223344556677".
+	 * @param os stream to write to
+	 * @param sDevice interface name written to every line
+	 * @return number of frames written
+	 */
+	int dumpTrace(std::ostream& os, const std::string& sDevice = "can0");
+
+	/**
+	 * Writes the trace to a file, see dumpTrace(std::ostream&, const std::string&).
+	 * @return number of frames written, -1 if the file can't be opened
+	 */
+	int dumpTrace(const std::string& sFileName, const std::string& sDevice = "can0");
+
+private:
+	/**
+	 * Frame in the trace ring.
+	 * iSeq is the number of the write + 1 as soon as the entry is complete, 0 while it's written.
+	 */
+	struct TraceEntry
+	{
+		volatile unsigned int iSeq;
+		long lSec;
+		long lNSec;
+		int iID;
+		int iLen;
+		bool bTx;
+		unsigned char cData[8];
+	};
+
+	/**
+	 * Counters at a call of getBusLoad().
+	 */
+	struct LoadSample
+	{
+		double dTimeSec;
+		unsigned long long iNumBits;
+		unsigned int iNumFrames;
+	};
+
+	// COB-IDs of standard frames are 11 bit
+	static const int NUM_IDS = 2048;
+
+	CanItf* m_pCanItf;
+	int m_iBaudrateKbit;
+
+	// counters, incremented atomically
+	unsigned int m_iNumTx[NUM_IDS];
+	unsigned int m_iNumRx[NUM_IDS];
+	unsigned long long m_iNumBits[NUM_IDS];
+	unsigned long long m_iNumBitsTotal;
+	unsigned int m_iNumFramesTotal;
+	unsigned int m_iNumTxFailed;
+
+	// trace ring
+	std::vector<TraceEntry> m_vTrace;
+	unsigned int m_iTraceMask;
+	volatile unsigned int m_iTraceWrite;
+
+	// load over the window
+	std::deque<LoadSample> m_LoadSamples;
+	TimeStamp m_StartTime;
+	double m_dBusLoad;
+	double m_dFrameRate;
+
+	void account(CanMsg& msg, bool bTx);
+};
+
+//-----------------------------------------------
+#endif
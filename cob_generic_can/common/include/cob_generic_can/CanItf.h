@@ -70,7 +70,8 @@ public:
 		CAN_PEAK_USN = 1,
 		CAN_ESD = 2,
 		CAN_DUMMY = 3,
-		CAN_BECKHOFF = 4
+		CAN_BECKHOFF = 4,
+		CAN_SOCKET = 5
 	};
 	
 	/**
@@ -0,0 +1,203 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_generic_can
+ * Description: In-process CAN bus with simulated nodes, bit timing and latencies, for tests and benchmarks without hardware.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef CANSIMBUS_INCLUDEDEF_H
+#define CANSIMBUS_INCLUDEDEF_H
+
+//-----------------------------------------------
+#include <vector>
+#include <deque>
+
+// Headers provided by other cob-packages
+#include <cob_generic_can/CanItf.h>
+#include <cob_utilities/TimeStamp.h>
+
+// Headers provided by other cob-packages which should be avoided/removed
+#include <cob_utilities/Mutex.h>
+
+//-----------------------------------------------
+
+/**
+ * Simulated device on a CanSimBus (or on any CanItf, e.g. a vcan interface, see CanSocket).
+ */
+class CanSimNode
+{
+public:
+	virtual ~CanSimNode() {}
+
+	/**
+	 * Evaluates a message sent by the host.
+	 * @param msg received message, the node decides itself whether it is addressed
+	 * @param dTimeSec time of the reception
+	 * @param vReplies the messages to send in reply are appended
+	 */
+	virtual void evalMsg(CanMsg& msg, double dTimeSec, std::vector<CanMsg>& vReplies) = 0;
+};
+
+//-----------------------------------------------
+
+/**
+ * CAN interface which connects the host to simulated nodes in the same process.
+ *
+ * The bus is simulated in real time: every frame occupies the bus for its bit time
+ * (at the given baudrate, including the worst case of bit stuffing), frames waiting for the bus
+ * are arbitrated by their identifier and each node replies after its processing time.
+ * The host receives a reply only when it would have arrived on a real bus, so the
+ * control rate and the bus load of a setup can be measured without hardware.
+ *
+ * Messages of the nodes are delivered only to the host, not to the other nodes.
+ * The simulation runs in the calls of transmitMsg() and receiveMsg(), there is no thread.
+ */
+class CanSimBus : public CanItf
+{
+public:
+	/**
+	 * Constructor.
+	 * @param iBaudrateKbit bit rate of the bus in kbit/s
+	 */
+	CanSimBus(int iBaudrateKbit = 1000);
+
+	/**
+	 * Deletes the nodes.
+	 */
+	~CanSimBus();
+
+	void init() {}
+	bool transmitMsg(CanMsg CMsg, bool bBlocking = true);
+	bool receiveMsg(CanMsg* pCMsg);
+	bool receiveMsgRetry(CanMsg* pCMsg, int iNrOfRetry);
+	bool isObjectMode() { return false; }
+
+	/**
+	 * Connects a node to the bus. The bus takes the ownership.
+	 */
+	void addNode(CanSimNode* pNode);
+
+	/**
+	 * Sets the latencies.
+	 * @param dHostTxSec time from transmitMsg() until the frame competes for the bus (driver, USB)
+	 * @param dHostRxSec time from the end of a frame until receiveMsg() returns it
+	 * @param dNodeSec processing time of the nodes until they send their reply
+	 */
+	void setLatency(double dHostTxSec, double dHostRxSec, double dNodeSec);
+
+	/**
+	 * Sets the number of frames of the host which may wait for the bus.
+	 * If the queue is full, transmitMsg() waits (bBlocking = true) or fails.
+	 */
+	void setTxQueueSize(unsigned int iSize) { m_iTxQueueSize = iSize; }
+
+	/**
+	 * Returns the time one frame with iLen data bytes occupies the bus.
+	 */
+	double getFrameTime(int iLen);
+
+	/**
+	 * Returns the share of time the bus has been busy since the last resetStatistics().
+	 */
+	double getBusLoad();
+
+	/**
+	 * Returns the number of frames sent by the host and by the nodes since the last resetStatistics().
+	 */
+	void getNumFrames(unsigned int* piHost, unsigned int* piNodes);
+
+	/**
+	 * Returns the number of frames the host could not send because the tx queue was full.
+	 */
+	unsigned int getNumTxOverruns() { return m_iNumTxOverruns; }
+
+	void resetStatistics();
+
+private:
+	struct Frame
+	{
+		double dTimeSec;
+		bool bFromHost;
+		CanMsg msg;
+	};
+
+	int m_iBaudrateKbit;
+	double m_dHostTxLatencySec;
+	double m_dHostRxLatencySec;
+	double m_dNodeLatencySec;
+	unsigned int m_iTxQueueSize;
+
+	std::vector<CanSimNode*> m_vpNodes;
+
+	// frames waiting for the bus, time = ready to send
+	std::vector<Frame> m_vWaiting;
+	unsigned int m_iNumWaitingHost;
+	// frame on the bus, time = end of the frame
+	Frame m_OnBus;
+	bool m_bBusBusy;
+	double m_dBusFreeSec;
+	// frames for the host, time = visible for receiveMsg()
+	std::deque<Frame> m_RxQueue;
+
+	std::vector<CanMsg> m_vReplies;
+
+	TimeStamp m_StartTime;
+	double m_dStatStartSec;
+	double m_dBusyTimeSec;
+	unsigned int m_iNumFramesHost;
+	unsigned int m_iNumFramesNodes;
+	unsigned int m_iNumTxOverruns;
+
+	Mutex m_Mutex;
+
+	double getTime();
+	void runUntil(double dTimeSec);
+	void deliver(Frame& frame);
+};
+
+//-----------------------------------------------
+#endif
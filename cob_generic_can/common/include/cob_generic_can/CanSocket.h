@@ -0,0 +1,101 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_generic_can
+ * Description: Driver of Linux SocketCAN interfaces, e.g. virtual vcan interfaces for simulated drives.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+
+#ifndef CANSOCKET_INCLUDEDEF_H
+#define CANSOCKET_INCLUDEDEF_H
+
+//-----------------------------------------------
+// general includes
+#include <string>
+
+// Headers provided by other cob-packages
+#include <cob_generic_can/CanItf.h>
+
+//-----------------------------------------------
+/**
+ * Driver of a SocketCAN network interface of Linux (e.g. can0 or the virtual vcan0).
+ * The bit rate is set when the interface is configured (ip link), not by the driver.
+ */
+class CanSocket : public CanItf
+{
+public:
+	/**
+	 * Opens the interface given in the ini file, section "CanCtrl", key "SocketDevice" (default can0).
+	 */
+	CanSocket(const char* cIniFile);
+
+	/**
+	 * Opens the given interface.
+	 * @param sDevice name of the interface, e.g. "vcan0"
+	 */
+	CanSocket(const std::string& sDevice);
+
+	~CanSocket();
+
+	void init() {}
+	bool transmitMsg(CanMsg CMsg, bool bBlocking = true);
+	bool receiveMsg(CanMsg* pCMsg);
+	bool receiveMsgRetry(CanMsg* pCMsg, int iNrOfRetry);
+	bool isObjectMode() { return false; }
+
+	/**
+	 * Returns true if the interface has been opened.
+	 */
+	bool isOpen() { return m_iSocket >= 0; }
+
+private:
+	int m_iSocket;
+
+	void open(const std::string& sDevice);
+};
+
+//-----------------------------------------------
+#endif
@@ -0,0 +1,297 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_generic_can
+ * Description: Bus load accounting and frame trace for any CanItf.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+//-----------------------------------------------
+#include <cob_generic_can/CanBusMonitor.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+//-----------------------------------------------
+static bool compareBits(const CanBusMonitor::IDStatistics& a, const CanBusMonitor::IDStatistics& b)
+{
+	return a.iNumBits > b.iNumBits;
+}
+
+//-----------------------------------------------
+const int CanBusMonitor::MAX_TRACE_SIZE;
+
+//-----------------------------------------------
+CanBusMonitor::CanBusMonitor(CanItf* pCanItf, int iBaudrateKbit, int iTraceSize)
+{
+	m_pCanItf = pCanItf;
+	m_iBaudrateKbit = iBaudrateKbit;
+	setCanItfType(pCanItf->getCanItfType());
+
+	// power of 2, so the position in the ring is a mask of the write counter (which may wrap)
+	unsigned int iSize = 0;
+	if(iTraceSize > 0)
+	{
+		if(iTraceSize > MAX_TRACE_SIZE)
+		{
+			std::cout << "CanBusMonitor: TraceSize " << iTraceSize << " limited to " << MAX_TRACE_SIZE << std::endl;
+			iTraceSize = MAX_TRACE_SIZE;
+		}
+		iSize = 1;
+		while(iSize < (unsigned int)iTraceSize)
+			iSize <<= 1;
+	}
+	m_vTrace.resize(iSize);
+	for(unsigned int i = 0; i < iSize; i++)
+		m_vTrace[i].iSeq = 0;
+	m_iTraceMask = (iSize > 0) ? iSize - 1 : 0;
+	m_iTraceWrite = 0;
+
+	resetStatistics();
+}
+
+//-----------------------------------------------
+CanBusMonitor::~CanBusMonitor()
+{
+	delete m_pCanItf;
+}
+
+//-----------------------------------------------
+bool CanBusMonitor::transmitMsg(CanMsg CMsg, bool bBlocking)
+{
+	bool bRet = m_pCanItf->transmitMsg(CMsg, bBlocking);
+
+	if(bRet)
+		account(CMsg, true);
+	else
+		__sync_fetch_and_add(&m_iNumTxFailed, 1);
+
+	return bRet;
+}
+
+//-----------------------------------------------
+bool CanBusMonitor::receiveMsg(CanMsg* pCMsg)
+{
+	bool bRet = m_pCanItf->receiveMsg(pCMsg);
+
+	if(bRet)
+		account(*pCMsg, false);
+
+	return bRet;
+}
+
+//-----------------------------------------------
+bool CanBusMonitor::receiveMsgRetry(CanMsg* pCMsg, int iNrOfRetry)
+{
+	bool bRet = m_pCanItf->receiveMsgRetry(pCMsg, iNrOfRetry);
+
+	if(bRet)
+		account(*pCMsg, false);
+
+	return bRet;
+}
+
+//-----------------------------------------------
+void CanBusMonitor::account(CanMsg& msg, bool bTx)
+{
+	int iID = msg.m_iID & (NUM_IDS - 1);
+	int iLen = std::max(0, std::min(8, msg.m_iLen));
+	int iBits = getFrameBits(iLen);
+
+	if(bTx)
+		__sync_fetch_and_add(&m_iNumTx[iID], 1);
+	else
+		__sync_fetch_and_add(&m_iNumRx[iID], 1);
+	__sync_fetch_and_add(&m_iNumBits[iID], (unsigned long long)iBits);
+	__sync_fetch_and_add(&m_iNumBitsTotal, (unsigned long long)iBits);
+	__sync_fetch_and_add(&m_iNumFramesTotal, 1);
+
+	if(m_vTrace.empty())
+		return;
+
+	// reserve an entry, mark it as incomplete while it's written
+	unsigned int iWrite = __sync_fetch_and_add(&m_iTraceWrite, 1);
+	TraceEntry& entry = m_vTrace[iWrite & m_iTraceMask];
+	entry.iSeq = 0;
+	__sync_synchronize();
+
+	TimeStamp Now;
+	Now.SetNow();
+	Now.getTimeStamp(entry.lSec, entry.lNSec);
+	entry.iID = msg.m_iID;
+	entry.iLen = iLen;
+	entry.bTx = bTx;
+	for(int i = 0; i < iLen; i++)
+		entry.cData[i] = msg.getAt(i);
+
+	__sync_synchronize();
+	entry.iSeq = iWrite + 1;
+}
+
+//-----------------------------------------------
+double CanBusMonitor::getBusLoad(double dWindowSec)
+{
+	TimeStamp Now;
+	Now.SetNow();
+
+	LoadSample sample;
+	sample.dTimeSec = Now - m_StartTime;
+	sample.iNumBits = m_iNumBitsTotal;
+	sample.iNumFrames = m_iNumFramesTotal;
+
+	// keep one sample at or before the beginning of the window
+	while( (m_LoadSamples.size() > 1) && (m_LoadSamples[1].dTimeSec <= sample.dTimeSec - dWindowSec) )
+		m_LoadSamples.pop_front();
+
+	if(!m_LoadSamples.empty())
+	{
+		const LoadSample& first = m_LoadSamples.front();
+		double dt = sample.dTimeSec - first.dTimeSec;
+		if(dt > 0)
+		{
+			m_dBusLoad = (sample.iNumBits - first.iNumBits) / (dt * m_iBaudrateKbit * 1000.0);
+			m_dFrameRate = (sample.iNumFrames - first.iNumFrames) / dt;
+		}
+	}
+
+	m_LoadSamples.push_back(sample);
+
+	return m_dBusLoad;
+}
+
+//-----------------------------------------------
+void CanBusMonitor::getStatistics(std::vector<IDStatistics>& vStatistics)
+{
+	vStatistics.clear();
+
+	for(int i = 0; i < NUM_IDS; i++)
+	{
+		if( (m_iNumTx[i] == 0) && (m_iNumRx[i] == 0) )
+			continue;
+
+		IDStatistics stat;
+		stat.iID = i;
+		stat.iNumTx = m_iNumTx[i];
+		stat.iNumRx = m_iNumRx[i];
+		stat.iNumBits = m_iNumBits[i];
+		vStatistics.push_back(stat);
+	}
+
+	std::sort(vStatistics.begin(), vStatistics.end(), compareBits);
+}
+
+//-----------------------------------------------
+void CanBusMonitor::getNumFrames(unsigned int* piTx, unsigned int* piRx, unsigned int* piTxFailed)
+{
+	*piTx = 0;
+	*piRx = 0;
+	for(int i = 0; i < NUM_IDS; i++)
+	{
+		*piTx += m_iNumTx[i];
+		*piRx += m_iNumRx[i];
+	}
+	*piTxFailed = m_iNumTxFailed;
+}
+
+//-----------------------------------------------
+void CanBusMonitor::resetStatistics()
+{
+	memset(m_iNumTx, 0, sizeof(m_iNumTx));
+	memset(m_iNumRx, 0, sizeof(m_iNumRx));
+	memset(m_iNumBits, 0, sizeof(m_iNumBits));
+	m_iNumBitsTotal = 0;
+	m_iNumFramesTotal = 0;
+	m_iNumTxFailed = 0;
+
+	m_LoadSamples.clear();
+	m_StartTime.SetNow();
+	m_dBusLoad = 0;
+	m_dFrameRate = 0;
+}
+
+//-----------------------------------------------
+int CanBusMonitor::dumpTrace(std::ostream& os, const std::string& sDevice)
+{
+	if(m_vTrace.empty())
+		return 0;
+
+	unsigned int iEnd = m_iTraceWrite;
+	unsigned int iNum = std::min(iEnd, (unsigned int)m_vTrace.size());
+	int iNumWritten = 0;
+	char cLine[80];
+
+	for(unsigned int iRead = iEnd - iNum; iRead != iEnd; iRead++)
+	{
+		// copy the entry, skip it if it's being written or has been overwritten meanwhile
+		const TraceEntry& entry = m_vTrace[iRead & m_iTraceMask];
+		if(entry.iSeq != iRead + 1)
+			continue;
+		__sync_synchronize();
+		TraceEntry copy = entry;
+		__sync_synchronize();
+		if(entry.iSeq != iRead + 1)
+			continue;
+
+		int iPos = snprintf(cLine, sizeof(cLine), "(%ld.%06ld) %s %03X#", copy.lSec, copy.lNSec / 1000, sDevice.c_str(), copy.iID);
+		for(int i = 0; (i < copy.iLen) && (iPos < (int)sizeof(cLine) - 3); i++)
+			iPos += snprintf(cLine + iPos, sizeof(cLine) - iPos, "%02X", copy.cData[i]);
+		os << cLine << "\n";
+		iNumWritten++;
+	}
+
+	return iNumWritten;
+}
+
+//-----------------------------------------------
+int CanBusMonitor::dumpTrace(const std::string& sFileName, const std::string& sDevice)
+{
+	std::ofstream file(sFileName.c_str());
+	if(!file.is_open())
+		return -1;
+
+	return dumpTrace(file, sDevice);
+}
@@ -0,0 +1,291 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_generic_can
+ * Description: In-process CAN bus with simulated nodes, bit timing and latencies, for tests and benchmarks without hardware.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+// general includes
+#include <unistd.h>
+
+// Headers provided by other cob-packages
+#include <cob_generic_can/CanSimBus.h>
+#include <cob_generic_can/CanBusMonitor.h>
+
+//-----------------------------------------------
+CanSimBus::CanSimBus(int iBaudrateKbit)
+{
+	setCanItfType(CanItf::CAN_DUMMY);
+
+	m_iBaudrateKbit = iBaudrateKbit;
+	m_dHostTxLatencySec = 0.0001;
+	m_dHostRxLatencySec = 0.0001;
+	m_dNodeLatencySec = 0.0002;
+	m_iTxQueueSize = 64;
+
+	m_iNumWaitingHost = 0;
+	m_bBusBusy = false;
+	m_dBusFreeSec = 0;
+
+	m_StartTime.SetNow();
+	resetStatistics();
+}
+
+//-----------------------------------------------
+CanSimBus::~CanSimBus()
+{
+	for(unsigned int i = 0; i < m_vpNodes.size(); i++)
+		delete m_vpNodes[i];
+}
+
+//-----------------------------------------------
+void CanSimBus::addNode(CanSimNode* pNode)
+{
+	m_Mutex.lock();
+	m_vpNodes.push_back(pNode);
+	m_Mutex.unlock();
+}
+
+//-----------------------------------------------
+void CanSimBus::setLatency(double dHostTxSec, double dHostRxSec, double dNodeSec)
+{
+	m_dHostTxLatencySec = dHostTxSec;
+	m_dHostRxLatencySec = dHostRxSec;
+	m_dNodeLatencySec = dNodeSec;
+}
+
+//-----------------------------------------------
+double CanSimBus::getFrameTime(int iLen)
+{
+	return CanBusMonitor::getFrameBits(iLen) / (m_iBaudrateKbit * 1000.0);
+}
+
+//-----------------------------------------------
+bool CanSimBus::transmitMsg(CanMsg CMsg, bool bBlocking)
+{
+	m_Mutex.lock();
+	runUntil(getTime());
+
+	// the tx queue of the driver is full -> wait for the bus or give up
+	while(m_iNumWaitingHost >= m_iTxQueueSize)
+	{
+		if(!bBlocking)
+		{
+			m_iNumTxOverruns++;
+			m_Mutex.unlock();
+			return false;
+		}
+		m_Mutex.unlock();
+		usleep(100);
+		m_Mutex.lock();
+		runUntil(getTime());
+	}
+
+	Frame frame;
+	frame.dTimeSec = getTime() + m_dHostTxLatencySec;
+	frame.bFromHost = true;
+	frame.msg = CMsg;
+	m_vWaiting.push_back(frame);
+	m_iNumWaitingHost++;
+
+	m_Mutex.unlock();
+	return true;
+}
+
+//-----------------------------------------------
+bool CanSimBus::receiveMsg(CanMsg* pCMsg)
+{
+	bool bRet = false;
+
+	m_Mutex.lock();
+	double dNow = getTime();
+	runUntil(dNow);
+
+	if(!m_RxQueue.empty() && (m_RxQueue.front().dTimeSec <= dNow))
+	{
+		*pCMsg = m_RxQueue.front().msg;
+		m_RxQueue.pop_front();
+		bRet = true;
+	}
+
+	m_Mutex.unlock();
+	return bRet;
+}
+
+//-----------------------------------------------
+bool CanSimBus::receiveMsgRetry(CanMsg* pCMsg, int iNrOfRetry)
+{
+	// same timing as the hardware drivers: 10 ms between the attempts
+	for(int i = 0; i < iNrOfRetry; i++)
+	{
+		if(receiveMsg(pCMsg))
+			return true;
+		usleep(10000);
+	}
+	return false;
+}
+
+//-----------------------------------------------
+double CanSimBus::getBusLoad()
+{
+	m_Mutex.lock();
+	double dNow = getTime();
+	runUntil(dNow);
+	double dLoad = (dNow > m_dStatStartSec) ? m_dBusyTimeSec / (dNow - m_dStatStartSec) : 0;
+	m_Mutex.unlock();
+
+	return dLoad;
+}
+
+//-----------------------------------------------
+void CanSimBus::getNumFrames(unsigned int* piHost, unsigned int* piNodes)
+{
+	*piHost = m_iNumFramesHost;
+	*piNodes = m_iNumFramesNodes;
+}
+
+//-----------------------------------------------
+void CanSimBus::resetStatistics()
+{
+	m_dStatStartSec = getTime();
+	m_dBusyTimeSec = 0;
+	m_iNumFramesHost = 0;
+	m_iNumFramesNodes = 0;
+	m_iNumTxOverruns = 0;
+}
+
+//-----------------------------------------------
+double CanSimBus::getTime()
+{
+	TimeStamp Now;
+	Now.SetNow();
+	return Now - m_StartTime;
+}
+
+//-----------------------------------------------
+void CanSimBus::runUntil(double dTimeSec)
+{
+	while(true)
+	{
+		// frame on the bus finished -> receivers get it
+		if(m_bBusBusy)
+		{
+			if(m_OnBus.dTimeSec > dTimeSec)
+				break;
+			m_bBusBusy = false;
+			deliver(m_OnBus);
+		}
+
+		if(m_vWaiting.empty())
+			break;
+
+		// next frame starts as soon as the bus is free and a frame is ready
+		double dStartSec = m_vWaiting[0].dTimeSec;
+		for(unsigned int i = 1; i < m_vWaiting.size(); i++)
+		{
+			if(m_vWaiting[i].dTimeSec < dStartSec)
+				dStartSec = m_vWaiting[i].dTimeSec;
+		}
+		if(dStartSec < m_dBusFreeSec)
+			dStartSec = m_dBusFreeSec;
+		if(dStartSec > dTimeSec)
+			break;
+
+		// arbitration: the lowest identifier of the ready frames wins, equal ones in order
+		int iWinner = -1;
+		for(unsigned int i = 0; i < m_vWaiting.size(); i++)
+		{
+			if(m_vWaiting[i].dTimeSec > dStartSec)
+				continue;
+			if((iWinner < 0) || (m_vWaiting[i].msg.m_iID < m_vWaiting[iWinner].msg.m_iID))
+				iWinner = i;
+		}
+
+		m_OnBus = m_vWaiting[iWinner];
+		m_vWaiting.erase(m_vWaiting.begin() + iWinner);
+
+		double dFrameSec = getFrameTime(m_OnBus.msg.m_iLen);
+		m_OnBus.dTimeSec = dStartSec + dFrameSec;
+		m_dBusFreeSec = m_OnBus.dTimeSec;
+		m_bBusBusy = true;
+		m_dBusyTimeSec += dFrameSec;
+
+		if(m_OnBus.bFromHost)
+		{
+			m_iNumWaitingHost--;
+			m_iNumFramesHost++;
+		}
+		else
+			m_iNumFramesNodes++;
+	}
+}
+
+//-----------------------------------------------
+void CanSimBus::deliver(Frame& frame)
+{
+	if(!frame.bFromHost)
+	{
+		Frame rx = frame;
+		rx.dTimeSec += m_dHostRxLatencySec;
+		m_RxQueue.push_back(rx);
+		return;
+	}
+
+	for(unsigned int i = 0; i < m_vpNodes.size(); i++)
+	{
+		m_vReplies.clear();
+		m_vpNodes[i]->evalMsg(frame.msg, frame.dTimeSec, m_vReplies);
+
+		for(unsigned int j = 0; j < m_vReplies.size(); j++)
+		{
+			Frame reply;
+			reply.dTimeSec = frame.dTimeSec + m_dNodeLatencySec;
+			reply.bFromHost = false;
+			reply.msg = m_vReplies[j];
+			m_vWaiting.push_back(reply);
+		}
+	}
+}
@@ -0,0 +1,189 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_generic_can
+ * Description: Driver of Linux SocketCAN interfaces, e.g. virtual vcan interfaces for simulated drives.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+// general includes
+#include <iostream>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+// Headers provided by other cob-packages
+#include <cob_generic_can/CanSocket.h>
+
+// Headers provided by other cob-packages which should be avoided/removed
+#include <cob_utilities/IniFile.h>
+
+//-----------------------------------------------
+CanSocket::CanSocket(const char* cIniFile)
+{
+	IniFile iniFile;
+	std::string sDevice = "can0";
+
+	iniFile.SetFileName(cIniFile, "CanSocket.cpp");
+	iniFile.GetKeyString("CanCtrl", "SocketDevice", &sDevice, false);
+
+	open(sDevice);
+}
+
+//-----------------------------------------------
+CanSocket::CanSocket(const std::string& sDevice)
+{
+	open(sDevice);
+}
+
+//-----------------------------------------------
+CanSocket::~CanSocket()
+{
+	if(m_iSocket >= 0)
+		close(m_iSocket);
+}
+
+//-----------------------------------------------
+void CanSocket::open(const std::string& sDevice)
+{
+	setCanItfType(CanItf::CAN_SOCKET);
+
+	m_iSocket = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+	if(m_iSocket < 0)
+	{
+		std::cout << "error in CanSocket: cannot create socket: " << strerror(errno) << std::endl;
+		return;
+	}
+
+	struct ifreq ifr;
+	memset(&ifr, 0, sizeof(ifr));
+	strncpy(ifr.ifr_name, sDevice.c_str(), IFNAMSIZ - 1);
+	if(ioctl(m_iSocket, SIOCGIFINDEX, &ifr) < 0)
+	{
+		std::cout << "error in CanSocket: unknown interface " << sDevice << std::endl;
+		close(m_iSocket);
+		m_iSocket = -1;
+		return;
+	}
+
+	struct sockaddr_can addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.can_family = AF_CAN;
+	addr.can_ifindex = ifr.ifr_ifindex;
+	if(bind(m_iSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+	{
+		std::cout << "error in CanSocket: cannot bind to " << sDevice << ": " << strerror(errno) << std::endl;
+		close(m_iSocket);
+		m_iSocket = -1;
+		return;
+	}
+
+	std::cout << "CanSocket: opened " << sDevice << std::endl;
+}
+
+//-----------------------------------------------
+bool CanSocket::transmitMsg(CanMsg CMsg, bool bBlocking)
+{
+	if(m_iSocket < 0)
+		return false;
+
+	struct can_frame frame;
+	memset(&frame, 0, sizeof(frame));
+	frame.can_id = CMsg.m_iID & CAN_SFF_MASK;
+	frame.can_dlc = CMsg.m_iLen;
+	for(int i = 0; i < 8; i++)
+		frame.data[i] = CMsg.getAt(i);
+
+	int iFlags = bBlocking ? 0 : MSG_DONTWAIT;
+	if(send(m_iSocket, &frame, sizeof(frame), iFlags) != sizeof(frame))
+	{
+		std::cout << "error in CanSocket::transmitMsg: " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------
+bool CanSocket::receiveMsg(CanMsg* pCMsg)
+{
+	if(m_iSocket < 0)
+		return false;
+
+	struct can_frame frame;
+	if(recv(m_iSocket, &frame, sizeof(frame), MSG_DONTWAIT) != sizeof(frame))
+		return false;
+
+	pCMsg->m_iID = frame.can_id & CAN_SFF_MASK;
+	pCMsg->m_iLen = frame.can_dlc;
+	pCMsg->set(frame.data[0], frame.data[1], frame.data[2], frame.data[3],
+		frame.data[4], frame.data[5], frame.data[6], frame.data[7]);
+
+	return true;
+}
+
+//-----------------------------------------------
+bool CanSocket::receiveMsgRetry(CanMsg* pCMsg, int iNrOfRetry)
+{
+	// same timing as the other drivers: up to 10 ms per attempt
+	struct pollfd pfd;
+	pfd.fd = m_iSocket;
+	pfd.events = POLLIN;
+
+	for(int i = 0; i < iNrOfRetry; i++)
+	{
+		if(receiveMsg(pCMsg))
+			return true;
+		poll(&pfd, 1, 10);
+	}
+
+	return false;
+}
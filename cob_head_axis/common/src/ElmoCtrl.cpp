@@ -365,8 +365,11 @@ bool ElmoCtrl::Init(ElmoCtrlParams * params, bool home) { //home = true by defau
 					  m_Joint->setGearVelRadS(0);
 			  }
 	  }
-	  //ToDo: UHR: necessary?
-	  Sleep(1000);
+	  // wait until the drive answers its SDOs again instead of a fixed delay
+	  if (success && !m_Joint->waitForStatusword(1.0))
+	  {
+			  printf("ElmoCtrl: drive does not answer SDOs\n");
+	  }
 
 	  if (success && home)
 	  {
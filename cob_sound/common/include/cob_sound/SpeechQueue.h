@@ -0,0 +1,161 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: Prioritized utterance queue with synthesis, caching, playback
+ * and preemption.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef SPEECHQUEUE_H
+#define SPEECHQUEUE_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <cob_sound/Synthesizer.h>
+#include <cob_sound/WaveCache.h>
+
+/**
+ * Speaks utterances one after another from a priority queue.
+ * Utterances of equal priority are spoken in the order they were pushed.
+ * Pushing an utterance with a higher priority than the one currently spoken
+ * preempts (stops) the current one. Waveforms are taken from the cache if
+ * possible, otherwise synthesized and added to the cache.
+ */
+class SpeechQueue
+{
+public:
+	enum Result
+	{
+		PENDING,
+		SPOKEN,
+		FAILED,
+		PREEMPTED,
+		CANCELLED
+	};
+
+	/**
+	 * @param synthesizer back end used on cache misses, not owned
+	 * @param cache waveform cache, not owned
+	 * @param player_command command line of the audio player, the wave file is appended
+	 */
+	SpeechQueue(Synthesizer* synthesizer, WaveCache* cache, const std::string& player_command);
+	~SpeechQueue();
+
+	void start();
+	void stop();
+
+	/**
+	 * Queues an utterance.
+	 * @param track keep the result until it is fetched with wait()
+	 * @return id of the utterance
+	 */
+	unsigned long push(const std::string& text, const std::string& voice, int priority, bool track = true);
+
+	/**
+	 * Waits up to timeout_s seconds (negative = forever) for a tracked utterance.
+	 * Returns PENDING on timeout, otherwise the result, which is then forgotten.
+	 */
+	Result wait(unsigned long id, double timeout_s = -1.0);
+
+	/// Removes a queued utterance or stops it if it is currently spoken.
+	void cancel(unsigned long id);
+
+	/// Drops all queued utterances and stops the current one.
+	void cancelAll();
+
+	unsigned long queued();
+
+	/// Description of the last failure.
+	std::string getLastError();
+
+private:
+	struct Utterance
+	{
+		unsigned long id;
+		std::string text;
+		std::string voice;
+		int priority;
+		bool track;
+	};
+
+	enum Interrupt
+	{
+		INTERRUPT_NONE,
+		INTERRUPT_PREEMPT,
+		INTERRUPT_CANCEL
+	};
+
+	void run();
+	Result speak(const Utterance& utt);
+	Result play(const std::string& wav_file);
+	void finish(const Utterance& utt, Result result);
+	Result interruptResult();
+
+	Synthesizer* m_pSynthesizer;
+	WaveCache* m_pCache;
+	std::vector<std::string> m_PlayerArgv;
+
+	std::list<Utterance> m_Queue;
+	std::map<unsigned long, Result> m_Results;
+	unsigned long m_iNextId;
+
+	bool m_bSpeaking;
+	Utterance m_Current;
+	Interrupt m_Interrupt;
+	bool m_bStopRequested;
+	std::string m_sLastError;
+
+	boost::mutex m_Mutex;
+	boost::condition_variable m_QueueCond;
+	boost::condition_variable m_ResultCond;
+	boost::shared_ptr<boost::thread> m_Thread;
+};
+
+#endif
@@ -0,0 +1,159 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: Text-to-speech back ends (persistent worker process and
+ * one-shot command).
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef SYNTHESIZER_H
+#define SYNTHESIZER_H
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+/**
+ * Splits a command line at white space. Double quotes group words and are removed.
+ */
+std::vector<std::string> splitCommandLine(const std::string& command);
+
+/**
+ * Forks and executes argv[0] (searched in PATH) without a shell.
+ * If child_stdin / child_stdout are given, pipes are connected to the child's
+ * stdin / stdout and the parent's ends are returned through them.
+ * @return pid of the child or -1 on error
+ */
+pid_t spawnProcess(const std::vector<std::string>& argv, int* child_stdin = NULL, int* child_stdout = NULL);
+
+/**
+ * Interface of a text-to-speech back end that renders one utterance into a wave file.
+ */
+class Synthesizer
+{
+public:
+	virtual ~Synthesizer() {}
+
+	/// Renders text with the given voice (empty = default voice) into wav_file. Blocks until done.
+	virtual bool synthesize(const std::string& text, const std::string& voice, const std::string& wav_file) = 0;
+
+	const std::string& getLastError() const { return m_sLastError; }
+
+protected:
+	std::string m_sLastError;
+};
+
+/**
+ * Keeps one synthesizer process alive and feeds it utterances through a pipe,
+ * so the start-up cost of the synthesizer is paid only once.
+ *
+ * Two request dialects are supported:
+ * - DIALECT_FESTIVAL: the process is "festival --pipe"; each request is a
+ *   scheme expression which saves the wave and prints "OK" or "ERR".
+ * - DIALECT_LINE: each request is one line "<wav_file>\t<voice>\t<text>",
+ *   the process answers with one line starting with "OK" or "ERR".
+ *   This is what stub_synthesizer implements and what custom back ends
+ *   can implement as well.
+ *
+ * A worker that dies or does not answer within the timeout is killed and
+ * restarted with the next request.
+ */
+class SynthesisWorker : public Synthesizer
+{
+public:
+	enum Dialect
+	{
+		DIALECT_FESTIVAL,
+		DIALECT_LINE
+	};
+
+	SynthesisWorker(const std::string& command, Dialect dialect, double timeout_s = 30.0);
+	~SynthesisWorker();
+
+	/// Starts the worker process, e.g. during node start-up to hide its start-up time.
+	bool start();
+	void stop();
+	bool isRunning() const { return m_Pid > 0; }
+
+	bool synthesize(const std::string& text, const std::string& voice, const std::string& wav_file);
+
+	/// Number of times the worker process had to be (re)started.
+	unsigned long starts() const { return m_iStarts; }
+
+private:
+	std::string formatRequest(const std::string& text, const std::string& voice, const std::string& wav_file) const;
+	bool request(const std::string& line, std::string& reply);
+	bool readLine(std::string& line);
+
+	std::vector<std::string> m_Argv;
+	Dialect m_Dialect;
+	double m_dTimeout;
+
+	pid_t m_Pid;
+	int m_iFdRequest;
+	int m_iFdReply;
+	std::string m_sReadBuffer;
+	unsigned long m_iStarts;
+};
+
+/**
+ * Starts one process per utterance, for back ends without a pipe interface
+ * (e.g. Cepstral swift). The placeholders %t, %v and %o in the command are
+ * replaced by text, voice and output file; words containing only an empty
+ * voice are dropped together with a preceding option (e.g. "-n %v").
+ */
+class CommandSynthesizer : public Synthesizer
+{
+public:
+	CommandSynthesizer(const std::string& command);
+
+	bool synthesize(const std::string& text, const std::string& voice, const std::string& wav_file);
+
+private:
+	std::vector<std::string> m_Argv;
+};
+
+#endif
@@ -0,0 +1,125 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: LRU cache of synthesized waveforms on disk.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#ifndef WAVECACHE_H
+#define WAVECACHE_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <boost/thread/mutex.hpp>
+
+/**
+ * Least-recently-used cache of synthesized waveforms.
+ * The waveforms are kept as files inside a private cache directory, so a cache
+ * hit can be handed to the audio player without copying any sample data.
+ * Entries are keyed by voice and text; the oldest entries are deleted once the
+ * total size exceeds the configured byte budget.
+ */
+class WaveCache
+{
+public:
+	/**
+	 * @param max_bytes upper bound for the summed size of all cached files (0 disables caching)
+	 * @param directory cache directory; a fresh temporary directory is created if empty
+	 */
+	WaveCache(unsigned long max_bytes, const std::string& directory = "");
+	~WaveCache();
+
+	/// Returns the file of a cached waveform and marks it as recently used.
+	bool lookup(const std::string& text, const std::string& voice, std::string& wav_file);
+
+	/// Returns a new, unused file name inside the cache directory for the synthesizer to write to.
+	std::string reserve();
+
+	/**
+	 * Adds a freshly synthesized file (obtained from reserve()) to the cache.
+	 * Evicts least recently used entries as necessary. Returns false if the file
+	 * was not taken over; the caller then owns it and has to remove it.
+	 */
+	bool insert(const std::string& text, const std::string& voice, const std::string& wav_file);
+
+	/// Removes all cached files.
+	void clear();
+
+	unsigned long size() const { return m_iBytes; }
+	unsigned long entries() const { return m_Lru.size(); }
+	unsigned long hits() const { return m_iHits; }
+	unsigned long misses() const { return m_iMisses; }
+
+	const std::string& directory() const { return m_sDirectory; }
+
+private:
+	struct Entry
+	{
+		std::string key;
+		std::string file;
+		unsigned long bytes;
+	};
+	typedef std::list<Entry> EntryList;
+
+	static std::string makeKey(const std::string& text, const std::string& voice);
+	void evict(unsigned long bytes_needed);
+
+	EntryList m_Lru; // front = most recently used
+	std::map<std::string, EntryList::iterator> m_Index;
+
+	std::string m_sDirectory;
+	bool m_bOwnDirectory;
+	unsigned long m_iMaxBytes;
+	unsigned long m_iBytes;
+	unsigned long m_iSerial;
+	unsigned long m_iHits;
+	unsigned long m_iMisses;
+
+	boost::mutex m_Mutex;
+};
+
+#endif
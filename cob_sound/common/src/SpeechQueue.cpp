@@ -0,0 +1,305 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: Prioritized utterance queue with synthesis, caching, playback
+ * and preemption.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <cob_sound/SpeechQueue.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <boost/bind.hpp>
+
+SpeechQueue::SpeechQueue(Synthesizer* synthesizer, WaveCache* cache, const std::string& player_command) :
+	m_pSynthesizer(synthesizer), m_pCache(cache), m_PlayerArgv(splitCommandLine(player_command)),
+	m_iNextId(1), m_bSpeaking(false), m_Interrupt(INTERRUPT_NONE), m_bStopRequested(false)
+{
+}
+
+SpeechQueue::~SpeechQueue()
+{
+	stop();
+}
+
+void SpeechQueue::start()
+{
+	if (m_Thread)
+		return;
+	m_bStopRequested = false;
+	m_Thread.reset(new boost::thread(boost::bind(&SpeechQueue::run, this)));
+}
+
+void SpeechQueue::stop()
+{
+	if (!m_Thread)
+		return;
+	{
+		boost::mutex::scoped_lock lock(m_Mutex);
+		m_bStopRequested = true;
+		m_Interrupt = INTERRUPT_CANCEL;
+	}
+	m_QueueCond.notify_all();
+	m_Thread->join();
+	m_Thread.reset();
+	cancelAll();
+}
+
+unsigned long SpeechQueue::push(const std::string& text, const std::string& voice, int priority, bool track)
+{
+	Utterance utt;
+	utt.text = text;
+	utt.voice = voice;
+	utt.priority = priority;
+	utt.track = track;
+
+	{
+		boost::mutex::scoped_lock lock(m_Mutex);
+		utt.id = m_iNextId++;
+		if (track)
+			m_Results[utt.id] = PENDING;
+
+		// insert behind all utterances of the same or higher priority
+		std::list<Utterance>::iterator it = m_Queue.begin();
+		while (it != m_Queue.end() && it->priority >= priority)
+			++it;
+		m_Queue.insert(it, utt);
+
+		if (m_bSpeaking && priority > m_Current.priority && m_Interrupt == INTERRUPT_NONE)
+			m_Interrupt = INTERRUPT_PREEMPT;
+	}
+	m_QueueCond.notify_one();
+
+	return utt.id;
+}
+
+SpeechQueue::Result SpeechQueue::wait(unsigned long id, double timeout_s)
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+	boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds((long)(timeout_s * 1e6));
+
+	while (true)
+	{
+		std::map<unsigned long, Result>::iterator it = m_Results.find(id);
+		if (it == m_Results.end())
+			return FAILED; // unknown or untracked id
+		if (it->second != PENDING)
+		{
+			Result result = it->second;
+			m_Results.erase(it);
+			return result;
+		}
+
+		if (timeout_s < 0.0)
+			m_ResultCond.wait(lock);
+		else if (!m_ResultCond.timed_wait(lock, deadline))
+			return PENDING;
+	}
+}
+
+void SpeechQueue::cancel(unsigned long id)
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+
+	if (m_bSpeaking && m_Current.id == id)
+	{
+		m_Interrupt = INTERRUPT_CANCEL;
+		return;
+	}
+
+	for (std::list<Utterance>::iterator it = m_Queue.begin(); it != m_Queue.end(); ++it)
+	{
+		if (it->id == id)
+		{
+			if (it->track)
+				m_Results[id] = CANCELLED;
+			m_Queue.erase(it);
+			m_ResultCond.notify_all();
+			return;
+		}
+	}
+}
+
+void SpeechQueue::cancelAll()
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+
+	for (std::list<Utterance>::iterator it = m_Queue.begin(); it != m_Queue.end(); ++it)
+		if (it->track)
+			m_Results[it->id] = CANCELLED;
+	m_Queue.clear();
+	if (m_bSpeaking)
+		m_Interrupt = INTERRUPT_CANCEL;
+	m_ResultCond.notify_all();
+}
+
+unsigned long SpeechQueue::queued()
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+	return m_Queue.size();
+}
+
+std::string SpeechQueue::getLastError()
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+	return m_sLastError;
+}
+
+void SpeechQueue::run()
+{
+	while (true)
+	{
+		Utterance utt;
+		{
+			boost::mutex::scoped_lock lock(m_Mutex);
+			while (m_Queue.empty() && !m_bStopRequested)
+				m_QueueCond.wait(lock);
+			if (m_bStopRequested)
+				return;
+
+			utt = m_Queue.front();
+			m_Queue.pop_front();
+			m_Current = utt;
+			m_bSpeaking = true;
+			m_Interrupt = INTERRUPT_NONE;
+		}
+
+		Result result = speak(utt);
+		finish(utt, result);
+	}
+}
+
+SpeechQueue::Result SpeechQueue::interruptResult()
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+	if (m_Interrupt == INTERRUPT_PREEMPT)
+		return PREEMPTED;
+	if (m_Interrupt == INTERRUPT_CANCEL)
+		return CANCELLED;
+	return PENDING;
+}
+
+SpeechQueue::Result SpeechQueue::speak(const Utterance& utt)
+{
+	std::string wav_file;
+	bool owned = false;
+
+	if (!m_pCache->lookup(utt.text, utt.voice, wav_file))
+	{
+		wav_file = m_pCache->reserve();
+		if (!m_pSynthesizer->synthesize(utt.text, utt.voice, wav_file))
+		{
+			unlink(wav_file.c_str());
+			boost::mutex::scoped_lock lock(m_Mutex);
+			m_sLastError = m_pSynthesizer->getLastError();
+			return FAILED;
+		}
+		owned = !m_pCache->insert(utt.text, utt.voice, wav_file);
+	}
+
+	// synthesis cannot be interrupted, but the playback can be skipped
+	Result result = interruptResult();
+	if (result == PENDING)
+		result = play(wav_file);
+
+	if (owned)
+		unlink(wav_file.c_str());
+	return result;
+}
+
+SpeechQueue::Result SpeechQueue::play(const std::string& wav_file)
+{
+	std::vector<std::string> argv(m_PlayerArgv);
+	argv.push_back(wav_file);
+
+	pid_t pid = spawnProcess(argv);
+	if (pid <= 0)
+	{
+		boost::mutex::scoped_lock lock(m_Mutex);
+		m_sLastError = "could not start audio player";
+		return FAILED;
+	}
+
+	int status = 0;
+	while (true)
+	{
+		pid_t ret = waitpid(pid, &status, WNOHANG);
+		if (ret == pid)
+			break;
+		if (ret < 0 && errno != EINTR)
+			return FAILED;
+
+		Result interrupted = interruptResult();
+		if (interrupted != PENDING)
+		{
+			kill(pid, SIGTERM);
+			waitpid(pid, &status, 0);
+			return interrupted;
+		}
+		usleep(10000);
+	}
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+	{
+		boost::mutex::scoped_lock lock(m_Mutex);
+		m_sLastError = "audio player failed";
+		return FAILED;
+	}
+	return SPOKEN;
+}
+
+void SpeechQueue::finish(const Utterance& utt, Result result)
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+	m_bSpeaking = false;
+	m_Interrupt = INTERRUPT_NONE;
+	if (utt.track)
+		m_Results[utt.id] = result;
+	m_ResultCond.notify_all();
+}
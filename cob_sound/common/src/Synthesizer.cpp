@@ -0,0 +1,396 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: Text-to-speech back ends (persistent worker process and
+ * one-shot command).
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <cob_sound/Synthesizer.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+std::vector<std::string> splitCommandLine(const std::string& command)
+{
+	std::vector<std::string> words;
+	std::string word;
+	bool in_word = false;
+	bool quoted = false;
+
+	for (std::string::size_type i = 0; i < command.size(); i++)
+	{
+		char c = command[i];
+		if (c == '"')
+		{
+			quoted = !quoted;
+			in_word = true;
+		}
+		else if (!quoted && (c == ' ' || c == '\t' || c == '\n'))
+		{
+			if (in_word)
+				words.push_back(word);
+			word.clear();
+			in_word = false;
+		}
+		else
+		{
+			word.push_back(c);
+			in_word = true;
+		}
+	}
+	if (in_word)
+		words.push_back(word);
+
+	return words;
+}
+
+pid_t spawnProcess(const std::vector<std::string>& argv, int* child_stdin, int* child_stdout)
+{
+	if (argv.empty())
+		return -1;
+
+	int fd_in[2] = { -1, -1 };
+	int fd_out[2] = { -1, -1 };
+
+	if (child_stdin != NULL && pipe(fd_in) != 0)
+		return -1;
+	if (child_stdout != NULL && pipe(fd_out) != 0)
+	{
+		if (child_stdin != NULL)
+		{
+			close(fd_in[0]);
+			close(fd_in[1]);
+		}
+		return -1;
+	}
+
+	// build argv before forking, only async-signal-safe calls are allowed in the child
+	std::vector<char*> c_argv;
+	for (unsigned int i = 0; i < argv.size(); i++)
+		c_argv.push_back(const_cast<char*>(argv[i].c_str()));
+	c_argv.push_back(NULL);
+
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		if (child_stdin != NULL)
+		{
+			dup2(fd_in[0], STDIN_FILENO);
+			close(fd_in[0]);
+			close(fd_in[1]);
+		}
+		if (child_stdout != NULL)
+		{
+			dup2(fd_out[1], STDOUT_FILENO);
+			close(fd_out[0]);
+			close(fd_out[1]);
+		}
+		execvp(c_argv[0], &c_argv[0]);
+		_exit(127);
+	}
+
+	if (child_stdin != NULL)
+	{
+		close(fd_in[0]);
+		if (pid > 0)
+		{
+			fcntl(fd_in[1], F_SETFD, FD_CLOEXEC);
+			*child_stdin = fd_in[1];
+		}
+		else
+			close(fd_in[1]);
+	}
+	if (child_stdout != NULL)
+	{
+		close(fd_out[1]);
+		if (pid > 0)
+		{
+			fcntl(fd_out[0], F_SETFD, FD_CLOEXEC);
+			*child_stdout = fd_out[0];
+		}
+		else
+			close(fd_out[0]);
+	}
+
+	return pid;
+}
+
+//-----------------------------------------------
+
+SynthesisWorker::SynthesisWorker(const std::string& command, Dialect dialect, double timeout_s) :
+	m_Argv(splitCommandLine(command)), m_Dialect(dialect), m_dTimeout(timeout_s),
+	m_Pid(-1), m_iFdRequest(-1), m_iFdReply(-1), m_iStarts(0)
+{
+	// a dying worker must not take the node down with it
+	signal(SIGPIPE, SIG_IGN);
+}
+
+SynthesisWorker::~SynthesisWorker()
+{
+	stop();
+}
+
+bool SynthesisWorker::start()
+{
+	if (isRunning())
+		return true;
+
+	m_sReadBuffer.clear();
+	m_Pid = spawnProcess(m_Argv, &m_iFdRequest, &m_iFdReply);
+	if (m_Pid <= 0)
+	{
+		m_Pid = -1;
+		m_sLastError = "could not start synthesis worker " + (m_Argv.empty() ? std::string() : m_Argv[0]);
+		return false;
+	}
+	m_iStarts++;
+	return true;
+}
+
+void SynthesisWorker::stop()
+{
+	if (m_iFdRequest >= 0)
+		close(m_iFdRequest);
+	if (m_iFdReply >= 0)
+		close(m_iFdReply);
+	m_iFdRequest = -1;
+	m_iFdReply = -1;
+
+	if (m_Pid > 0)
+	{
+		kill(m_Pid, SIGTERM);
+		waitpid(m_Pid, NULL, 0);
+	}
+	m_Pid = -1;
+}
+
+std::string SynthesisWorker::formatRequest(const std::string& text, const std::string& voice, const std::string& wav_file) const
+{
+	std::string req;
+
+	if (m_Dialect == DIALECT_FESTIVAL)
+	{
+		std::string escaped;
+		for (std::string::size_type i = 0; i < text.size(); i++)
+		{
+			if (text[i] == '"' || text[i] == '\\')
+				escaped.push_back('\\');
+			escaped.push_back(text[i] == '\n' ? ' ' : text[i]);
+		}
+
+		req = "(unwind-protect (begin ";
+		if (!voice.empty())
+			req += "(voice_" + voice + ") ";
+		req += "(utt.save.wave (utt.synth (Utterance Text \"" + escaped + "\")) \"" + wav_file + "\" 'riff) ";
+		req += "(format t \"OK\\n\")) (format t \"ERR\\n\")) (fflush nil)\n";
+	}
+	else
+	{
+		std::string flat(text);
+		for (std::string::size_type i = 0; i < flat.size(); i++)
+			if (flat[i] == '\n' || flat[i] == '\t' || flat[i] == '\r')
+				flat[i] = ' ';
+		req = wav_file + "\t" + voice + "\t" + flat + "\n";
+	}
+
+	return req;
+}
+
+bool SynthesisWorker::synthesize(const std::string& text, const std::string& voice, const std::string& wav_file)
+{
+	std::string req = formatRequest(text, voice, wav_file);
+	std::string reply;
+
+	// a worker that died since the last request is restarted once
+	bool ok = false;
+	for (int attempt = 0; attempt < 2 && !ok; attempt++)
+	{
+		if (!start())
+			return false;
+		ok = request(req, reply);
+		if (!ok)
+			stop();
+	}
+	if (!ok)
+		return false;
+
+	if (reply.compare(0, 2, "OK") != 0)
+	{
+		m_sLastError = "synthesis failed: " + reply;
+		return false;
+	}
+	return true;
+}
+
+bool SynthesisWorker::request(const std::string& line, std::string& reply)
+{
+	std::string::size_type written = 0;
+	while (written < line.size())
+	{
+		ssize_t n = write(m_iFdRequest, line.data() + written, line.size() - written);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+		{
+			m_sLastError = "synthesis worker does not accept requests";
+			return false;
+		}
+		written += n;
+	}
+
+	// festival may print unrelated lines (e.g. warnings), skip them
+	do
+	{
+		if (!readLine(reply))
+			return false;
+	} while (reply.compare(0, 2, "OK") != 0 && reply.compare(0, 3, "ERR") != 0);
+
+	return true;
+}
+
+bool SynthesisWorker::readLine(std::string& line)
+{
+	struct timeval start, now;
+	gettimeofday(&start, NULL);
+
+	while (true)
+	{
+		std::string::size_type eol = m_sReadBuffer.find('\n');
+		if (eol != std::string::npos)
+		{
+			line = m_sReadBuffer.substr(0, eol);
+			m_sReadBuffer.erase(0, eol + 1);
+			return true;
+		}
+
+		gettimeofday(&now, NULL);
+		double elapsed = (now.tv_sec - start.tv_sec) + (now.tv_usec - start.tv_usec) * 1e-6;
+		int remaining_ms = (int)((m_dTimeout - elapsed) * 1000.0);
+		if (remaining_ms <= 0)
+		{
+			m_sLastError = "synthesis worker timed out";
+			return false;
+		}
+
+		struct pollfd pfd;
+		pfd.fd = m_iFdReply;
+		pfd.events = POLLIN;
+		int ret = poll(&pfd, 1, remaining_ms);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			continue; // the timeout is checked above
+
+		char buf[256];
+		ssize_t n = read(m_iFdReply, buf, sizeof(buf));
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+		{
+			m_sLastError = "synthesis worker terminated";
+			return false;
+		}
+		m_sReadBuffer.append(buf, n);
+	}
+}
+
+//-----------------------------------------------
+
+CommandSynthesizer::CommandSynthesizer(const std::string& command) :
+	m_Argv(splitCommandLine(command))
+{
+}
+
+bool CommandSynthesizer::synthesize(const std::string& text, const std::string& voice, const std::string& wav_file)
+{
+	std::vector<std::string> argv;
+	for (unsigned int i = 0; i < m_Argv.size(); i++)
+	{
+		if (m_Argv[i] == "%t")
+			argv.push_back(text);
+		else if (m_Argv[i] == "%o")
+			argv.push_back(wav_file);
+		else if (m_Argv[i] == "%v")
+		{
+			if (voice.empty())
+			{
+				// drop the option introducing the voice as well
+				if (!argv.empty() && argv.back().size() > 1 && argv.back()[0] == '-')
+					argv.pop_back();
+			}
+			else
+				argv.push_back(voice);
+		}
+		else
+			argv.push_back(m_Argv[i]);
+	}
+
+	pid_t pid = spawnProcess(argv);
+	if (pid <= 0)
+	{
+		m_sLastError = "could not start synthesizer";
+		return false;
+	}
+
+	int status = 0;
+	while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+		;
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+	{
+		m_sLastError = "synthesizer " + argv[0] + " failed";
+		return false;
+	}
+	return true;
+}
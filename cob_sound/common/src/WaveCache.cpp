@@ -0,0 +1,170 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: LRU cache of synthesized waveforms on disk.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+#include <cob_sound/WaveCache.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+WaveCache::WaveCache(unsigned long max_bytes, const std::string& directory) :
+	m_sDirectory(directory), m_bOwnDirectory(false), m_iMaxBytes(max_bytes),
+	m_iBytes(0), m_iSerial(0), m_iHits(0), m_iMisses(0)
+{
+	if (m_sDirectory.empty())
+	{
+		char tmpl[] = "/tmp/cob_sound_XXXXXX";
+		if (mkdtemp(tmpl) != NULL)
+		{
+			m_sDirectory = tmpl;
+			m_bOwnDirectory = true;
+		}
+		else
+			m_sDirectory = "/tmp";
+	}
+	else
+		mkdir(m_sDirectory.c_str(), 0755);
+}
+
+WaveCache::~WaveCache()
+{
+	clear();
+	if (m_bOwnDirectory)
+		rmdir(m_sDirectory.c_str());
+}
+
+std::string WaveCache::makeKey(const std::string& text, const std::string& voice)
+{
+	// voice names never contain a NUL character, so the key is unambiguous
+	std::string key(voice);
+	key.push_back('\0');
+	key.append(text);
+	return key;
+}
+
+bool WaveCache::lookup(const std::string& text, const std::string& voice, std::string& wav_file)
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+
+	std::map<std::string, EntryList::iterator>::iterator it = m_Index.find(makeKey(text, voice));
+	if (it == m_Index.end())
+	{
+		m_iMisses++;
+		return false;
+	}
+
+	// move to front, the iterator stays valid
+	m_Lru.splice(m_Lru.begin(), m_Lru, it->second);
+	wav_file = it->second->file;
+	m_iHits++;
+	return true;
+}
+
+std::string WaveCache::reserve()
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+
+	char name[64];
+	snprintf(name, sizeof(name), "/utt_%d_%lu.wav", (int)getpid(), m_iSerial++);
+	return m_sDirectory + name;
+}
+
+bool WaveCache::insert(const std::string& text, const std::string& voice, const std::string& wav_file)
+{
+	struct stat st;
+	if (stat(wav_file.c_str(), &st) != 0)
+		return false;
+	unsigned long bytes = (unsigned long)st.st_size;
+
+	boost::mutex::scoped_lock lock(m_Mutex);
+
+	if (bytes > m_iMaxBytes)
+		return false;
+
+	std::string key = makeKey(text, voice);
+	if (m_Index.find(key) != m_Index.end())
+		return false; // synthesized twice concurrently, keep the older one
+
+	evict(bytes);
+
+	Entry entry;
+	entry.key = key;
+	entry.file = wav_file;
+	entry.bytes = bytes;
+	m_Lru.push_front(entry);
+	m_Index[key] = m_Lru.begin();
+	m_iBytes += bytes;
+	return true;
+}
+
+void WaveCache::evict(unsigned long bytes_needed)
+{
+	while (!m_Lru.empty() && m_iBytes + bytes_needed > m_iMaxBytes)
+	{
+		Entry& oldest = m_Lru.back();
+		unlink(oldest.file.c_str());
+		m_iBytes -= oldest.bytes;
+		m_Index.erase(oldest.key);
+		m_Lru.pop_back();
+	}
+}
+
+void WaveCache::clear()
+{
+	boost::mutex::scoped_lock lock(m_Mutex);
+
+	for (EntryList::iterator it = m_Lru.begin(); it != m_Lru.end(); ++it)
+		unlink(it->file.c_str());
+	m_Lru.clear();
+	m_Index.clear();
+	m_iBytes = 0;
+}
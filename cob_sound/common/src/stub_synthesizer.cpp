@@ -0,0 +1,138 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: Stub synthesizer speaking the line protocol of SynthesisWorker.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+/**
+ * Stand-in for a real text-to-speech engine, used to exercise the synthesis
+ * worker, the cache and the queue of cob_sound without festival or a sound card.
+ * Run the node with mode "worker" and synthesizer_command "stub_synthesizer"
+ * together with a player_command like "true" or "aplay -q".
+ *
+ * Protocol (see SynthesisWorker::DIALECT_LINE): reads "<wav_file>\t<voice>\t<text>"
+ * lines from stdin, writes 10ms of silence per character into wav_file and
+ * answers "OK". Texts containing "<fail>" are answered with "ERR".
+ *
+ * Usage: stub_synthesizer [startup_delay_s] [synthesis_delay_s]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+static void putLE(FILE* f, unsigned long value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+		fputc((int)((value >> (8 * i)) & 0xFF), f);
+}
+
+static bool writeSilence(const std::string& file, unsigned long samples)
+{
+	const unsigned long rate = 8000;
+	FILE* f = fopen(file.c_str(), "wb");
+	if (f == NULL)
+		return false;
+
+	unsigned long data_bytes = samples * 2;
+	fwrite("RIFF", 1, 4, f);
+	putLE(f, 36 + data_bytes, 4);
+	fwrite("WAVEfmt ", 1, 8, f);
+	putLE(f, 16, 4);       // fmt chunk size
+	putLE(f, 1, 2);        // PCM
+	putLE(f, 1, 2);        // mono
+	putLE(f, rate, 4);
+	putLE(f, rate * 2, 4); // byte rate
+	putLE(f, 2, 2);        // block align
+	putLE(f, 16, 2);       // bits per sample
+	fwrite("data", 1, 4, f);
+	putLE(f, data_bytes, 4);
+	for (unsigned long i = 0; i < data_bytes; i++)
+		fputc(0, f);
+
+	return fclose(f) == 0;
+}
+
+int main(int argc, char** argv)
+{
+	double startup_delay = (argc > 1) ? atof(argv[1]) : 0.0;
+	double synthesis_delay = (argc > 2) ? atof(argv[2]) : 0.0;
+
+	usleep((useconds_t)(startup_delay * 1e6));
+
+	char line[4096];
+	while (fgets(line, sizeof(line), stdin) != NULL)
+	{
+		std::string req(line);
+		if (!req.empty() && req[req.size() - 1] == '\n')
+			req.erase(req.size() - 1);
+
+		std::string::size_type tab1 = req.find('\t');
+		std::string::size_type tab2 = (tab1 == std::string::npos) ? tab1 : req.find('\t', tab1 + 1);
+		if (tab2 == std::string::npos)
+		{
+			printf("ERR malformed request\n");
+			fflush(stdout);
+			continue;
+		}
+
+		std::string file = req.substr(0, tab1);
+		std::string text = req.substr(tab2 + 1);
+
+		usleep((useconds_t)(synthesis_delay * 1e6));
+
+		if (text.find("<fail>") != std::string::npos || !writeSilence(file, 80 * text.size()))
+			printf("ERR could not synthesize\n");
+		else
+			printf("OK\n");
+		fflush(stdout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,287 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_sound
+ * Description: SpeechQueue with a SynthesisWorker running stub_synthesizer: priority order,
+ * preemption, waveform cache hits and eviction.
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+
+//-----------------------------------------------
+#include <gtest/gtest.h>
+#include <cob_sound/SpeechQueue.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+
+//-----------------------------------------------
+
+/**
+ * The stub is built next to the test executable.
+ */
+static std::string stubSynthesizer()
+{
+	char path[4096];
+	ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	if (len <= 0)
+		return "stub_synthesizer";
+	path[len] = '\0';
+
+	std::string dir(path);
+	return dir.substr(0, dir.rfind('/') + 1) + "stub_synthesizer";
+}
+
+static bool fileExists(const std::string& file)
+{
+	struct stat st;
+	return stat(file.c_str(), &st) == 0;
+}
+
+//-----------------------------------------------
+class SpeechQueueTest : public testing::Test
+{
+protected:
+	SpeechQueueTest() : m_pWorker(NULL), m_pCache(NULL), m_pQueue(NULL) {}
+
+	virtual void SetUp()
+	{
+		char tmpl[] = "/tmp/test_speech_queue_XXXXXX";
+		ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+		m_sDir = tmpl;
+		m_sPlayLog = m_sDir + "/played.log";
+
+		m_pWorker = new SynthesisWorker(stubSynthesizer(), SynthesisWorker::DIALECT_LINE, 5.0);
+		ASSERT_TRUE(m_pWorker->start()) << m_pWorker->getLastError();
+	}
+
+	virtual void TearDown()
+	{
+		delete m_pQueue;
+		delete m_pCache;
+		delete m_pWorker;
+		unlink(m_sPlayLog.c_str());
+		rmdir((m_sDir + "/cache").c_str());
+		rmdir(m_sDir.c_str());
+	}
+
+	/// The player logs the played file and takes play_s seconds, unless it is killed.
+	void startQueue(unsigned long cache_bytes, double play_s)
+	{
+		m_pCache = new WaveCache(cache_bytes, m_sDir + "/cache");
+
+		std::ostringstream player;
+		player << "sh -c \"echo $0 >> " << m_sPlayLog << "; exec sleep " << play_s << "\"";
+		m_pQueue = new SpeechQueue(m_pWorker, m_pCache, player.str());
+		m_pQueue->start();
+	}
+
+	/// Waits until the queue has taken the next utterance.
+	bool waitUntilTaken(double timeout_s)
+	{
+		for (int i = 0; i < (int)(timeout_s / 0.01); i++)
+		{
+			if (m_pQueue->queued() == 0)
+				return true;
+			usleep(10000);
+		}
+		return false;
+	}
+
+	std::vector<std::string> played()
+	{
+		std::vector<std::string> files;
+		std::ifstream log(m_sPlayLog.c_str());
+		std::string line;
+		while (std::getline(log, line))
+			files.push_back(line);
+		return files;
+	}
+
+	/// The cached file of a text, counts as a cache hit.
+	std::string cachedFile(const std::string& text)
+	{
+		std::string file;
+		m_pCache->lookup(text, "", file);
+		return file;
+	}
+
+	/// Size of the stub's waveform for a text.
+	static unsigned long waveBytes(const std::string& text) { return 44 + 2 * 80 * text.size(); }
+
+	std::string m_sDir;
+	std::string m_sPlayLog;
+	SynthesisWorker* m_pWorker;
+	WaveCache* m_pCache;
+	SpeechQueue* m_pQueue;
+};
+
+//-----------------------------------------------
+TEST_F(SpeechQueueTest, PriorityOrder)
+{
+	startQueue(1000000, 0.2);
+
+	unsigned long iFirst = m_pQueue->push("first", "", 5);
+	ASSERT_TRUE(waitUntilTaken(1.0));
+
+	// below the priority of the current utterance: queued, no preemption
+	unsigned long iLow1 = m_pQueue->push("low one", "", 1);
+	unsigned long iLow2 = m_pQueue->push("low two", "", 1);
+	unsigned long iMid = m_pQueue->push("middle", "", 3);
+	EXPECT_EQ(3u, m_pQueue->queued());
+
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(iFirst, 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(iMid, 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(iLow1, 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(iLow2, 5.0));
+
+	// higher priority first, equal priority in push order
+	std::vector<std::string> files = played();
+	ASSERT_EQ(4u, files.size());
+	EXPECT_EQ(cachedFile("first"), files[0]);
+	EXPECT_EQ(cachedFile("middle"), files[1]);
+	EXPECT_EQ(cachedFile("low one"), files[2]);
+	EXPECT_EQ(cachedFile("low two"), files[3]);
+
+	// all synthesized by the same worker process
+	EXPECT_EQ(1u, m_pWorker->starts());
+}
+
+//-----------------------------------------------
+TEST_F(SpeechQueueTest, Preemption)
+{
+	startQueue(1000000, 2.0);
+
+	unsigned long iLong = m_pQueue->push("long announcement", "", 0);
+	ASSERT_TRUE(waitUntilTaken(1.0));
+	boost::system_time StartTime = boost::get_system_time();
+	unsigned long iUrgent = m_pQueue->push("urgent", "", 1);
+
+	// the player is killed, not played to its end
+	EXPECT_EQ(SpeechQueue::PREEMPTED, m_pQueue->wait(iLong, 5.0));
+	EXPECT_LT((boost::get_system_time() - StartTime).total_milliseconds(), 1000);
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(iUrgent, 5.0));
+}
+
+//-----------------------------------------------
+TEST_F(SpeechQueueTest, CacheHits)
+{
+	startQueue(1000000, 0.0);
+
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("hello", "", 0), 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("hello", "", 0), 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("world", "", 0), 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("hello", "", 0), 5.0));
+
+	EXPECT_EQ(2u, m_pCache->hits());
+	EXPECT_EQ(2u, m_pCache->misses());
+	EXPECT_EQ(2u, m_pCache->entries());
+	EXPECT_EQ(waveBytes("hello") + waveBytes("world"), m_pCache->size());
+
+	// the hits play the cached file
+	std::vector<std::string> files = played();
+	ASSERT_EQ(4u, files.size());
+	EXPECT_EQ(files[0], files[1]);
+	EXPECT_EQ(files[0], files[3]);
+	EXPECT_NE(files[0], files[2]);
+}
+
+//-----------------------------------------------
+TEST_F(SpeechQueueTest, Eviction)
+{
+	// room for two waveforms of ten characters
+	startQueue(2 * waveBytes("0123456789") + 100, 0.0);
+
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("utterance1", "", 0), 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("utterance2", "", 0), 5.0));
+	// makes utterance2 the least recently used
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("utterance1", "", 0), 5.0));
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("utterance3", "", 0), 5.0));
+
+	EXPECT_EQ(2u, m_pCache->entries());
+	EXPECT_EQ(2 * waveBytes("0123456789"), m_pCache->size());
+	EXPECT_EQ(1u, m_pCache->hits());
+	EXPECT_EQ(3u, m_pCache->misses());
+
+	// the evicted file is gone, the others are still cached
+	std::vector<std::string> files = played();
+	ASSERT_EQ(4u, files.size());
+	EXPECT_FALSE(fileExists(files[1]));
+	EXPECT_TRUE(fileExists(files[0]));
+	EXPECT_TRUE(fileExists(files[3]));
+
+	// a waveform larger than the cache is played, but not kept
+	std::string sLong(30, 'x');
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push(sLong, "", 0), 5.0));
+	EXPECT_EQ(2u, m_pCache->entries());
+	files = played();
+	ASSERT_EQ(5u, files.size());
+	EXPECT_FALSE(fileExists(files[4]));
+}
+
+//-----------------------------------------------
+TEST_F(SpeechQueueTest, FailedSynthesisIsNotCached)
+{
+	startQueue(1000000, 0.0);
+
+	EXPECT_EQ(SpeechQueue::FAILED, m_pQueue->wait(m_pQueue->push("<fail>", "", 0), 5.0));
+	EXPECT_FALSE(m_pQueue->getLastError().empty());
+	EXPECT_EQ(0u, m_pCache->entries());
+	EXPECT_TRUE(played().empty());
+
+	// the worker survives the error
+	EXPECT_EQ(SpeechQueue::SPOKEN, m_pQueue->wait(m_pQueue->push("recovered", "", 0), 5.0));
+	EXPECT_EQ(1u, m_pWorker->starts());
+}
+
+//-----------------------------------------------
+int main(int argc, char** argv)
+{
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
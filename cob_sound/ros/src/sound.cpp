@@ -5,6 +5,7 @@
 #include <cob_srvs/Trigger.h>
 #include <cob_sound/SayAction.h>
 #include <cob_sound/SayText.h>
+#include <cob_sound/SpeechQueue.h>
 
 class SayAction
 {
@@ -19,6 +20,15 @@ protected:
   std::string action_name_;
   bool mute_;
 
+  std::string mode_;
+  std::string voice_;
+  int priority_action_;
+  int priority_service_;
+  int priority_topic_;
+  boost::shared_ptr<Synthesizer> synthesizer_;
+  boost::shared_ptr<WaveCache> cache_;
+  boost::shared_ptr<SpeechQueue> queue_;
+
 public:
   diagnostic_msgs::DiagnosticArray diagnostics_;
   ros::Publisher topicPub_Diagnostic_;
@@ -27,6 +37,50 @@ public:
     as_(nh_, name, boost::bind(&SayAction::as_cb, this, _1), false),
     action_name_(name)
   {
+    // festival: one persistent "festival --pipe" process
+    // worker: persistent process speaking the line protocol of SynthesisWorker (e.g. stub_synthesizer)
+    // cepstral: one swift process per utterance
+    std::string synthesizer_command;
+    std::string cepstral_conf;
+    std::string player_command;
+    double synthesis_timeout;
+    int cache_size_mb;
+    nh_.param<std::string>("/sound_controller/mode",mode_,"festival");
+    nh_.param<std::string>("/sound_controller/cepstral_settings",cepstral_conf,"\"speech/rate=170\"");
+    nh_.param<std::string>("/sound_controller/voice",voice_,"");
+    nh_.param<std::string>("/sound_controller/player_command",player_command,"aplay -q");
+    nh_.param<double>("/sound_controller/synthesis_timeout",synthesis_timeout,30.0);
+    nh_.param<int>("/sound_controller/cache_size_mb",cache_size_mb,64);
+    nh_.param<int>("/sound_controller/priority_action",priority_action_,2);
+    nh_.param<int>("/sound_controller/priority_service",priority_service_,1);
+    nh_.param<int>("/sound_controller/priority_topic",priority_topic_,0);
+
+    if (mode_ == "cepstral")
+    {
+      nh_.param<std::string>("/sound_controller/synthesizer_command",synthesizer_command,"swift -p " + cepstral_conf + " -n %v -o %o %t");
+      synthesizer_.reset(new CommandSynthesizer(synthesizer_command));
+    }
+    else
+    {
+      SynthesisWorker::Dialect dialect = SynthesisWorker::DIALECT_FESTIVAL;
+      if (mode_ == "worker")
+      {
+        nh_.param<std::string>("/sound_controller/synthesizer_command",synthesizer_command,"stub_synthesizer");
+        dialect = SynthesisWorker::DIALECT_LINE;
+      }
+      else
+        nh_.param<std::string>("/sound_controller/synthesizer_command",synthesizer_command,"festival --pipe");
+      SynthesisWorker* worker = new SynthesisWorker(synthesizer_command, dialect, synthesis_timeout);
+      synthesizer_.reset(worker);
+      // pay the start-up time of the synthesizer now and not with the first utterance
+      if (!worker->start())
+        ROS_ERROR("%s", worker->getLastError().c_str());
+    }
+
+    cache_.reset(new WaveCache((unsigned long)cache_size_mb * 1024 * 1024));
+    queue_.reset(new SpeechQueue(synthesizer_.get(), cache_.get(), player_command));
+    queue_->start();
+
     as_.start();
     srvServer_ = nh_.advertiseService("/say", &SayAction::service_cb, this);
     srvServer_mute_ = nh_.advertiseService("mute", &SayAction::service_cb_mute, this);
@@ -38,17 +92,38 @@ public:
 
   ~SayAction(void)
   {
+    queue_->stop();
   }
 
   void as_cb(const cob_sound::SayGoalConstPtr &goal)
   {
-    bool ret = say(goal->text.data);
-    if (ret)
+    if (mute_)
+    {
+      ROS_WARN("Sound is set to mute. You will hear nothing.");
+      as_.setSucceeded();
+      return;
+    }
+
+    ROS_INFO("Saying: %s", goal->text.data.c_str());
+    unsigned long id = queue_->push(goal->text.data, voice_, priority_action_);
+    SpeechQueue::Result result;
+    while ((result = queue_->wait(id, 0.1)) == SpeechQueue::PENDING)
+    {
+      if (as_.isPreemptRequested() || !ros::ok())
+        queue_->cancel(id);
+    }
+
+    if (result == SpeechQueue::SPOKEN)
     {
         as_.setSucceeded();
     }
+    else if (result == SpeechQueue::PREEMPTED || result == SpeechQueue::CANCELLED)
+    {
+        as_.setPreempted();
+    }
     else
     {
+        publishError();
         as_.setAborted();
     }
   }
@@ -56,13 +131,14 @@ public:
   bool service_cb(cob_sound::SayText::Request &req,
                   cob_sound::SayText::Response &res )
   {
-    say(req.text);
+    say(req.text, priority_service_, true);
     return true;
   }
 
   void topic_cb(const std_msgs::String::ConstPtr& msg)
   {
-    say(msg->data.c_str());
+    // topic messages are fire and forget, do not block the callback queue
+    say(msg->data, priority_topic_, false);
   }
 
   bool service_cb_mute(cob_srvs::Trigger::Request &req,
@@ -81,7 +157,7 @@ public:
     return true;
   }
 
-  bool say(std::string text)
+  bool say(const std::string& text, int priority, bool wait)
   {
     if (mute_)
     {
@@ -90,31 +166,14 @@ public:
     }
 
     ROS_INFO("Saying: %s", text.c_str());
-    std::string mode;
-    std::string command;
-    std::string cepstral_conf;
-    nh_.param<std::string>("/sound_controller/mode",mode,"festival");
-    nh_.param<std::string>("/sound_controller/cepstral_settings",cepstral_conf,"\"speech/rate=170\"");
-    if (mode == "cepstral")
-    {
-      command = "swift -p " + cepstral_conf + " " + text;
-    }
-    else
-    {
-      command = "echo " + text + " | text2wave | aplay -q";
-    }
-    if (system(command.c_str()) != 0)
+    unsigned long id = queue_->push(text, voice_, priority, wait);
+    if (!wait)
+      return true;
+
+    SpeechQueue::Result result = queue_->wait(id);
+    if (result == SpeechQueue::FAILED)
     {
-      ROS_ERROR("Could not play sound");
-      // publishing diagnotic error if output fails
-      diagnostic_msgs::DiagnosticStatus status;
-      status.level = 2;
-      status.name = "sound";
-      status.message = "command say failed to play sound using mode " + mode;
-      diagnostics_.status.push_back(status);
-      diagnostics_.header.stamp = ros::Time::now();
-      topicPub_Diagnostic_.publish(diagnostics_);
-      diagnostics_.status.resize(0);
+      publishError();
       return false;
     }
 
@@ -122,6 +181,20 @@ public:
     return true;
   }
 
+  void publishError()
+  {
+    ROS_ERROR("Could not play sound: %s", queue_->getLastError().c_str());
+    // publishing diagnotic error if output fails
+    diagnostic_msgs::DiagnosticStatus status;
+    status.level = 2;
+    status.name = "sound";
+    status.message = "command say failed to play sound using mode " + mode_ + ": " + queue_->getLastError();
+    diagnostics_.status.push_back(status);
+    diagnostics_.header.stamp = ros::Time::now();
+    topicPub_Diagnostic_.publish(diagnostics_);
+    diagnostics_.status.resize(0);
+  }
+
 
 };
 
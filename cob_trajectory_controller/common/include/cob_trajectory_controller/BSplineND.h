@@ -23,15 +23,16 @@
 #include <cmath>
 #include <assert.h>
 
-#define BSPLINE_TINY 1e-20
-
 
 /**
  * Implements a BSpline curve as a template class.
  * a PointND type needs the following operators:
- * operator=, copy constructor, p1 += p2, p1 * scalar
- * there needs to be a function Distance(p1,p2)
- * there needs to be a member function p1.zero()
+ * operator=, copy constructor, size(), operator[]
+ *
+ * Evaluation uses a knot span lookup and the de Boor algorithm, so only the
+ * m_iGrad control points with non-zero basis functions are touched per point.
+ * Sorted parameter sequences (see evalBatch and the ipo functions) advance the
+ * knot span incrementally instead of searching it again for every sample.
  */
 template <class PointND>
 class BSplineND
@@ -50,12 +51,18 @@ public:
 	bool ipoWithNumSamples(int iNumPts, std::vector<PointND>& ipoVec);
 	
 	void eval(double dPos, PointND& point);
+
+	/**
+	 * Evaluates the spline at all parameters of dPosVec in one pass.
+	 * Ascending parameters reuse the knot span of the previous sample.
+	 */
+	void evalBatch(const std::vector<double>& dPosVec, std::vector<PointND>& pointVec);
 	
 	double getMaxdPos() const { return m_dLength; }
 
 private:
 	//----------------------- Parameters
-	double m_iGrad;
+	int m_iGrad;
 
 	//----------------------- Variables
 	std::vector<PointND> m_CtrlPointVec;
@@ -64,8 +71,14 @@ private:
 
 	double m_dLength;
 
+	// scratch buffer of the de Boor recursion, m_iGrad points of m_iDim values
+	std::vector<double> m_DeBoorBuf;
+	unsigned int m_iDim;
+
 	//----------------------- Member functions
-	double evalBasis(double t, unsigned int i, int n);
+	int findSpan(double dPos) const;
+	int advanceSpan(double dPos, int iSpan) const;
+	void evalSpan(double dPos, int iSpan, PointND& point);
 
 };
 
@@ -81,6 +94,7 @@ inline BSplineND<PointND>::BSplineND()
 {
 	m_iGrad = 3;
 	m_dLength = 0;
+	m_iDim = 0;
 }
 
 //-----------------------------------------------
@@ -102,9 +116,13 @@ void BSplineND<PointND>::setCtrlPoints(const std::vector<PointND>& ctrlPointVec
 
 	if (iNumCtrlPoint < m_iGrad)
     {
+		m_KnotVec.clear();
+		m_dLength = 0;
         return;
     }
 
+	m_iDim = m_CtrlPointVec[0].size();
+	m_DeBoorBuf.resize(m_iGrad * m_iDim);
 	m_KnotVec.resize( iNumCtrlPoint + m_iGrad );
 
 	// Calculate knots
@@ -149,15 +167,33 @@ void BSplineND<PointND>::setCtrlPoints(const std::vector<PointND>& ctrlPointVec
 template <class PointND>
 void BSplineND<PointND>::eval(double dPos, PointND& point)
 {
-	double dFak;
+	if (m_KnotVec.empty())
+	{
+		if (!m_CtrlPointVec.empty())
+			point = m_CtrlPointVec.front();
+		return;
+	}
+
+	evalSpan(dPos, findSpan(dPos), point);
+}
+
+//-----------------------------------------------
+template <class PointND>
+void BSplineND<PointND>::evalBatch(const std::vector<double>& dPosVec, std::vector<PointND>& pointVec)
+{
+	pointVec.resize(dPosVec.size());
+	if (m_KnotVec.empty())
+	{
+		for(unsigned int i = 0; i < dPosVec.size(); i++)
+			eval(dPosVec[i], pointVec[i]);
+		return;
+	}
 
-	for(unsigned int i = 0; i<point.size(); i++)
-		point.at(i) = 0.0;
-	for(unsigned int i = 0; i < m_CtrlPointVec.size(); i++)
+	int iSpan = m_iGrad - 1;
+	for(unsigned int i = 0; i < dPosVec.size(); i++)
 	{
-		dFak = evalBasis(dPos, i, m_iGrad);
-		for(unsigned int j = 0; j<point.size(); j++)
-			point.at(j) += m_CtrlPointVec[i][j] * dFak;  // !!!! TODO this might be wrong due to change from JointD to std::vector
+		iSpan = advanceSpan(dPosVec[i], iSpan);
+		evalSpan(dPosVec[i], iSpan, pointVec[i]);
 	}
 }
 
@@ -166,12 +202,12 @@ void BSplineND<PointND>::eval(double dPos, PointND& point)
 template <class PointND>
 bool BSplineND<PointND>::ipoWithConstSampleDist(double dIpoDist, std::vector<PointND >& ipoVec)
 {
-	PointND buf = m_CtrlPointVec.front();
 	int iNumOfPoints;
 	double dPos;
+	int iSpan;
 	//int iStart, iNextStart;
 
-	if (m_CtrlPointVec.size() < m_iGrad)
+	if (m_CtrlPointVec.size() < (unsigned int)m_iGrad)
 	{
 		ipoVec = m_CtrlPointVec;
 		return false;
@@ -185,10 +221,11 @@ bool BSplineND<PointND>::ipoWithConstSampleDist(double dIpoDist, std::vector<Poi
 
 	// Calculate x- and y-coordinates
 	dPos = 0;
+	iSpan = m_iGrad - 1;
 	for(int i=0; i < iNumOfPoints -1 ; i++)
 	{
-		eval(dPos, buf);
-		ipoVec[i] = buf;
+		iSpan = advanceSpan(dPos, iSpan);
+		evalSpan(dPos, iSpan, ipoVec[i]);
 		dPos += dIpoDist;
 	}
 
@@ -273,10 +310,10 @@ bool BSplineND<PointND>::ipoWithConstSampleDist(double dIpoDist, OmniPath& ipoVe
 template <class PointND>
 bool BSplineND<PointND>::ipoWithNumSamples(int iNumOfPoints, std::vector<PointND >& ipoVec)
 {
-	PointND buf;
 	double dPos, dInc;
+	int iSpan;
 
-	if (m_CtrlPointVec.size() < m_iGrad)
+	if (m_CtrlPointVec.size() < (unsigned int)m_iGrad)
 	{
 		ipoVec = m_CtrlPointVec;
 		return false;
@@ -287,11 +324,11 @@ bool BSplineND<PointND>::ipoWithNumSamples(int iNumOfPoints, std::vector<PointND
 
 	// Calculate x- and y-coordinates
 	dPos = 0;
+	iSpan = m_iGrad - 1;
 	for(int i=0; i < iNumOfPoints -1 ; i++)
 	{
-		eval(dPos, buf);
-
-		ipoVec[i] = buf;
+		iSpan = advanceSpan(dPos, iSpan);
+		evalSpan(dPos, iSpan, ipoVec[i]);
 		dPos += dInc;
 	}
 
@@ -300,55 +337,91 @@ bool BSplineND<PointND>::ipoWithNumSamples(int iNumOfPoints, std::vector<PointND
 }
 
 
+//-----------------------------------------------
+// Returns the index i of the non-empty knot span [m_KnotVec[i], m_KnotVec[i+1])
+// containing dPos. Parameters outside the spline are clamped to the first
+// resp. last non-empty span, so that the end parameter evaluates to the last point.
 template <class PointND>
-double BSplineND<PointND>::evalBasis(double u, unsigned int i, int n)
+int BSplineND<PointND>::findSpan(double dPos) const
 {
-	assert(i >= 0);
-	assert(i < m_KnotVec.size() - 1 );
+	int iLow = m_iGrad - 1;
+	int iHigh = m_CtrlPointVec.size() - 1;
 
-	if (n==1)
+	if (dPos >= m_dLength)
 	{
-		if ( (m_KnotVec[i]<=u) && ( u<m_KnotVec[i+1]) )
-		{
-			return 1.0;
-		}
+		while ( (iHigh > iLow) && (m_KnotVec[iHigh] >= m_dLength) )
+			iHigh--;
+		return iHigh;
+	}
+
+	// largest i with m_KnotVec[i] <= dPos, hence m_KnotVec[i+1] > dPos
+	while (iHigh > iLow)
+	{
+		int iMid = (iLow + iHigh + 1) / 2;
+		if (dPos < m_KnotVec[iMid])
+			iHigh = iMid - 1;
 		else
-		{
-			return 0.0;
-		}
+			iLow = iMid;
 	}
-	else
+	return iLow;
+}
+
+//-----------------------------------------------
+// Like findSpan(), but starts at the span of the previous sample. For ascending
+// parameters this is amortized O(1), otherwise it falls back to the search.
+template <class PointND>
+int BSplineND<PointND>::advanceSpan(double dPos, int iSpan) const
+{
+	if ( (dPos < m_KnotVec[iSpan]) || (dPos >= m_dLength) )
+		return findSpan(dPos);
+	while (dPos >= m_KnotVec[iSpan + 1])
+		iSpan++;
+	return iSpan;
+}
+
+//-----------------------------------------------
+// de Boor's algorithm on the m_iGrad control points influencing span iSpan
+template <class PointND>
+void BSplineND<PointND>::evalSpan(double dPos, int iSpan, PointND& point)
+{
+	const int iDeg = m_iGrad - 1;
+	const unsigned int iDim = m_iDim;
+	double* d = &m_DeBoorBuf[0];
+
+	if (m_dLength <= 0.0)
 	{
-		double N;
-		double dNum1, dNum2;
-		double dDen1, dDen2;
-		
-		dDen1 = u - m_KnotVec[i];
-		dNum1 = m_KnotVec[i+n-1] - m_KnotVec[i];
+		// all control points coincide
+		point = m_CtrlPointVec.front();
+		return;
+	}
 
-		dDen2 = m_KnotVec[i+n] - u;
-		dNum2 = m_KnotVec[i+n] - m_KnotVec[i+1];
+	if (dPos < m_KnotVec[iDeg])
+		dPos = m_KnotVec[iDeg];
+	else if (dPos > m_dLength)
+		dPos = m_dLength;
 
-		if ( (fabs(dNum1) > BSPLINE_TINY)&&(fabs(dNum2) > BSPLINE_TINY) )
-		{
-			N = dDen1 / dNum1 * evalBasis(u, i , n-1);
-			N += dDen2 / dNum2 * evalBasis(u, i+1 , n-1);
-		}
-		else if ( (fabs(dNum1) < BSPLINE_TINY)&&(fabs(dNum2) > BSPLINE_TINY) )
-		{
-			N = dDen2 / dNum2 * evalBasis(u, i+1 , n-1);
-		}
-		else if ((fabs(dNum1) > BSPLINE_TINY)&&(fabs(dNum2) < BSPLINE_TINY))
-		{
-			N = dDen1 / dNum1 * evalBasis(u, i , n-1);
-		}
-		else
+	for(int j = 0; j <= iDeg; j++)
+	{
+		const PointND& ctrl = m_CtrlPointVec[iSpan - iDeg + j];
+		for(unsigned int k = 0; k < iDim; k++)
+			d[j * iDim + k] = ctrl[k];
+	}
+
+	for(int r = 1; r <= iDeg; r++)
+	{
+		for(int j = iDeg; j >= r; j--)
 		{
-			N = 0;
+			int i = iSpan - iDeg + j;
+			double dAlpha = (dPos - m_KnotVec[i]) / (m_KnotVec[i + iDeg + 1 - r] - m_KnotVec[i]);
+			for(unsigned int k = 0; k < iDim; k++)
+				d[j * iDim + k] = (1.0 - dAlpha) * d[(j-1) * iDim + k] + dAlpha * d[j * iDim + k];
 		}
-
-		return N;
 	}
+
+	if (point.size() != iDim)
+		point = m_CtrlPointVec[iSpan];
+	for(unsigned int k = 0; k < iDim; k++)
+		point[k] = d[iDeg * iDim + k];
 }
 
 
@@ -0,0 +1,74 @@
+/********************************************************************
+ *                                                                  *
+ *                         RealtimeLoop                             *
+ *                                                                  *
+ *   fixed rate loop on absolute deadlines (CLOCK_MONOTONIC) with   *
+ *   wake-up latency and overrun statistics                         *
+ *                                                                  *
+ ********************************************************************/
+
+#ifndef _REALTIME_LOOP_H_
+#define _REALTIME_LOOP_H_
+
+#include <time.h>
+
+
+class RealtimeLoop
+{
+	public:
+		struct Statistics
+		{
+			unsigned long cycles;
+			unsigned long overruns;		// deadlines which had passed before the cycle was done
+			double latency_min;		// s, wake-up time after the scheduled deadline, including overruns
+			double latency_max;
+			double latency_mean;
+			double exec_max;		// s, from wake-up to the next waitForNextCycle()
+			double exec_mean;
+		};
+
+		RealtimeLoop(double frequency);
+
+		/*
+		 * Configures the calling thread: SCHED_FIFO with priority (1..99, 0 keeps the
+		 * scheduler), pinning to cpu (< 0 for no pinning) and locking of all memory pages.
+		 * Returns false if one of the settings could not be applied, e.g. for missing
+		 * privileges. The loop works anyway, just with less determinism.
+		 */
+		bool configureThread(int priority, int cpu, bool lock_memory);
+
+		// sets the first deadline one period from now
+		void start();
+
+		/*
+		 * Sleeps until the next deadline and returns it. If the deadline already passed,
+		 * it returns immediately and counts an overrun. Missed cycles are skipped,
+		 * the loop does not try to catch up.
+		 */
+		const timespec& waitForNextCycle();
+
+		double getPeriod() const { return m_period_ns * 1e-9; }
+
+		Statistics getStatistics() const;
+		void resetStatistics();
+
+	protected:
+		static void addNs(timespec& t, long ns);
+		static long diffNs(const timespec& a, const timespec& b);
+
+		long m_period_ns;
+		timespec m_deadline;
+		timespec m_wakeup;
+		bool m_running;
+
+		unsigned long m_cycles;
+		unsigned long m_overruns;
+		long m_latency_min_ns;
+		long m_latency_max_ns;
+		double m_latency_sum_ns;
+		long m_exec_max_ns;
+		double m_exec_sum_ns;
+		unsigned long m_exec_count;
+};
+
+#endif
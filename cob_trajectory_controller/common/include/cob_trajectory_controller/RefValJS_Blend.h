@@ -0,0 +1,69 @@
+/********************************************************************
+ *                                                                  *
+ *                        RefValJS_Blend                            *
+ *                                                                  *
+ *   cross-fades from a running reference into a new one with      *
+ *   continuous position and velocity                               *
+ *                                                                  *
+ ********************************************************************/
+
+#ifndef _REFVALJS_BLEND_H_
+#define _REFVALJS_BLEND_H_
+
+#include "RefVal_JS.h"
+#include <vector>
+
+
+class RefValJS_Blend : public RefVal_JS
+{
+	public:
+		/*
+		 * Follows from until blend_start, then fades into to within blend_duration.
+		 * Time t of the blend is t + from_offset for from and t - blend_start for to.
+		 * The blend takes ownership of both references.
+		 */
+		RefValJS_Blend(RefVal_JS* from, double from_offset, RefVal_JS* to, double blend_start, double blend_duration);
+		~RefValJS_Blend();
+
+		/*
+		 * The path parameter of the blend is the normalized time s = t / getTotalTime(),
+		 * the blended motion does not follow a single geometric path.
+		 */
+		std::vector<double> r(double s) const;
+		double s(double t) const;
+
+		std::vector<double> dr_ds(double s) const;
+		double ds_dt(double t) const;
+
+		double getTotalTime() const { return m_T; }
+
+		unsigned int getDOF() const { return m_DOF; }
+		void getR(double s, double* soll) const;
+		void getDr_ds(double s, double* result) const;
+
+		double getBlendEnd() const { return m_blend_start + m_blend_duration; }
+
+		/*
+		 * Hands over the target reference, e.g. to a following blend once this one is
+		 * finished. Its time is t + time_offset. The blend must not be used afterwards.
+		 */
+		RefVal_JS* releaseTarget(double& time_offset);
+
+	protected:
+		// fading weight of the target and its time derivative
+		void weight(double t, double& alpha, double& dalpha_dt) const;
+
+		RefVal_JS* m_from;
+		RefVal_JS* m_to;
+		double m_from_offset;
+		double m_blend_start;
+		double m_blend_duration;
+		double m_T;
+		unsigned int m_DOF;
+
+		// scratch buffers, so the evaluation does not allocate
+		mutable std::vector<double> m_buf_pos;
+		mutable std::vector<double> m_buf_vel;
+};
+
+#endif
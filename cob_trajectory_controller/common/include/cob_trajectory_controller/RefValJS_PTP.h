@@ -23,6 +23,10 @@ class RefValJS_PTP : public RefVal_JS
 		virtual double ds_dt(double t) const;
 		
 		double getTotalTime() const { return m_T1 + m_T2 + m_T3; }
+
+		unsigned int getDOF() const { return m_start.size(); }
+		void getR(double s, double* soll) const;
+		void getDr_ds(double s, double* result) const;
 		
 	protected:
 		double norm(const std::vector<double>& j);
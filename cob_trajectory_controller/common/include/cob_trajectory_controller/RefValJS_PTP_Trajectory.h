@@ -10,6 +10,7 @@
 #include <cob_trajectory_controller/RefVal_JS.h>
 #include <vector>
 #include <cob_trajectory_controller/BSplineND.h>
+#include <cob_trajectory_controller/TimeOptimalProfile.h>
 #include <trajectory_msgs/JointTrajectory.h>
 
 
@@ -25,6 +26,9 @@ class RefValJS_PTP_Trajectory : public RefVal_JS
 		   	a path planner!
 		*/
 		RefValJS_PTP_Trajectory(const trajectory_msgs::JointTrajectory& trajectory, double v_rad_s, double a_rad_s2, bool smooth=false);
+		/* Time optimal along the path, every joint j moves within v_rad_s[j] and a_rad_s2[j]
+		   instead of a single trapezoid for the path length. */
+		RefValJS_PTP_Trajectory(const trajectory_msgs::JointTrajectory& trajectory, const std::vector<double>& v_rad_s, const std::vector<double>& a_rad_s2, bool smooth=false);
 		//RefValJS_PTP_Trajectory(const std::vector<Jointd>& trajectory, Jointd start, Jointd startvel, double v_rad_s, double a_rad_s2, bool smooth=false);
 		
 		std::vector<double> r(double s) const;
@@ -33,11 +37,23 @@ class RefValJS_PTP_Trajectory : public RefVal_JS
 		std::vector<double> dr_ds(double s) const;
 		double ds_dt(double t) const;
 		
-		double getTotalTime() const { return m_T1 + m_T2 + m_T3; }
+		double getTotalTime() const { return m_TimeOptimal ? m_Profile.getTotalTime() : m_T1 + m_T2 + m_T3; }
 		
 		std::vector<double> getLengthParts() const { return m_length_parts; }
+
+		unsigned int getDOF() const { return m_DOF; }
+		void getR(double s, double* soll) const;
+		void getDr_ds(double s, double* result) const;
 		
 	protected:
+		void calculatePath(const trajectory_msgs::JointTrajectory& trajectory, bool smooth);
+		void calculateTrapezoid(double v_rad_s, double a_rad_s2);
+		void calculateTimeOptimal(const std::vector<double>& v_rad_s, const std::vector<double>& a_rad_s2);
+		// dr_ds at fraction frac of the segment between the path points i and i+1
+		void pathDerivative(int i, double frac, double* result) const;
+		void buildLookupTable();
+		unsigned int findSegment(double s) const;
+
 		double norm(const std::vector<double>& j);
 		double norm_max(const std::vector<double>& j);
 		double norm_sqr(const std::vector<double>& j);
@@ -51,7 +67,22 @@ class RefValJS_PTP_Trajectory : public RefVal_JS
 		vecd m_s_parts;
 		
 		BSplineND< std::vector<double> > m_TrajectorySpline;
-		std::vector< std::vector<double> > m_SplinePoints;
+
+		// path points, m_DOF consecutive values per point
+		unsigned int m_DOF;
+		unsigned int m_NumSplinePoints;
+		vecd m_SplinePoints;
+		const double* splinePoint(unsigned int i) const { return &m_SplinePoints[i * m_DOF]; }
+
+		// Per segment m_SegStride values: s at the start, 1 / s length of the segment and
+		// m_DOF values each of the start point, the difference to the end point, dr_ds at
+		// the start and the change of dr_ds along the segment.
+		unsigned int m_SegStride;
+		vecd m_Segments;
+		// segment at s = b / m_Buckets.size() for the uniform buckets b
+		std::vector<unsigned int> m_Buckets;
+		// segment of the last lookup, time and therefore s usually progress monotonically
+		mutable unsigned int m_Cursor;
 		
 
 		double m_stepSize;
@@ -68,6 +99,9 @@ class RefValJS_PTP_Trajectory : public RefVal_JS
 		double m_sa1;	// "Beschl." des Wegparameters s in Phase 1
 		double m_sv2;	// "Geschw." des Wegparameters s in Phase 2
 		double m_sa3;	// "Verzög." des Wegparameters s in Phase 3
+
+		bool m_TimeOptimal;	// s(t) from m_Profile instead of the trapezoid
+		TimeOptimalProfile m_Profile;
 		
 		static const double weigths[];
 		
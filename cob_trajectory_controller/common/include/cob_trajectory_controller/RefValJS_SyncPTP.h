@@ -0,0 +1,67 @@
+/********************************************************************
+ *                                                                  *
+ *                       RefValJS_SyncPTP                           *
+ *                                                                  *
+ *   point to point motion of all joints with individual velocity,  *
+ *   acceleration and (optional) jerk limits. All joints follow     *
+ *   the same normalized trapezoid or double S profile s(t), so     *
+ *   they start and arrive together on a straight line in joint     *
+ *   space. Supports evaluation of many time samples at once.       *
+ *                                                                  *
+ ********************************************************************/
+
+#ifndef _REFVALJS_SYNCPTP_H_
+#define _REFVALJS_SYNCPTP_H_
+
+#include "RefVal_JS.h"
+
+
+class RefValJS_SyncPTP : public RefVal_JS
+{
+	public:
+		/*
+		 * One limit per joint. Without jerk limits (empty j_max) the profile is a
+		 * trapezoid in velocity, otherwise a double S profile with limited jerk.
+		 * Throws std::runtime_error if the sizes do not match or a limit is not positive.
+		 */
+		RefValJS_SyncPTP(const std::vector<double>& start, const std::vector<double>& ziel,
+			const std::vector<double>& v_max, const std::vector<double>& a_max,
+			const std::vector<double>& j_max = std::vector<double>());
+
+		virtual std::vector<double> r(double s) const;
+		virtual double s(double t) const;
+
+		virtual std::vector<double> dr_ds(double s) const;
+		virtual double ds_dt(double t) const;
+		double d2s_dt2(double t) const;
+
+		double getTotalTime() const { return m_T; }
+
+		unsigned int getDOF() const { return m_start.size(); }
+		void getR(double s, double* soll) const;
+		void getDr_ds(double s, double* result) const;
+
+		/*
+		 * Positions, velocities and accelerations of all joints at the n times t.
+		 * The results are stored joint by joint: joint j at t[k] is element j*n+k.
+		 * velocities and accelerations may be NULL. Does not allocate.
+		 */
+		void evaluate(const double* t, unsigned int n, double* positions, double* velocities, double* accelerations) const;
+
+	protected:
+		// normalized profile s(t) with its first and second derivative
+		void profile(double t, double& s, double& v, double& a) const;
+
+		std::vector<double> m_start;
+		std::vector<double> m_direction;	// ziel - start
+
+		double m_T;		// Gesamtdauer
+		double m_Ta;	// Dauer der Beschleunigungsphase (= Verzögerungsphase)
+		double m_Tv;	// Dauer der Phase konst. Geschw.
+		double m_Tj;	// Dauer der Phasen konst. Ruck, 0 für Trapezprofil
+		double m_J;		// Ruck des Wegparameters s
+		double m_alim;	// max. Beschl. des Wegparameters s
+		double m_vlim;	// max. Geschw. des Wegparameters s
+};
+
+#endif
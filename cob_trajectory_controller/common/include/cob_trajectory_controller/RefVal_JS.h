@@ -12,6 +12,7 @@
 #define _REFVAL_JS_H_
 
 #include <vector>
+#include <algorithm>
 
  
 class RefVal_JS
@@ -35,6 +36,33 @@ class RefVal_JS
 		virtual std::vector<double> getLast() const { return r_t( getTotalTime() ); }
 		
 		virtual double getTotalTime() const=0;
+
+		/*
+		 * Allocation free variants for the control loop. The results are written to
+		 * caller provided arrays of getDOF() values. Implementations should override
+		 * getR() and getDr_ds(), the defaults go through the std::vector interface.
+		 */
+		virtual unsigned int getDOF() const=0;
+		virtual void getR(double s, double* soll) const
+		{
+			std::vector<double> v = r(s);
+			std::copy(v.begin(), v.end(), soll);
+		}
+		virtual void getDr_ds(double s, double* result) const
+		{
+			std::vector<double> v = dr_ds(s);
+			std::copy(v.begin(), v.end(), result);
+		}
+		void getR_t(double t, double* soll) const { getR( s(t), soll ); }
+		void getDr_dt(double t, double* result) const
+		{
+			getDr_ds( s(t), result );
+			double v = ds_dt(t);
+			for(unsigned int i = 0; i < getDOF(); i++)
+				result[i] *= v;
+		}
+
+		virtual ~RefVal_JS() {}
 };
 
 #endif
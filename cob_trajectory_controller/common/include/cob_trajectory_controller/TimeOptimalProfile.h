@@ -0,0 +1,60 @@
+/********************************************************************
+ *                                                                  *
+ *                      TimeOptimalProfile                          *
+ *                                                                  *
+ *   time optimal path parameterization s(t) along a given path     *
+ *   r(s), s in [0,1], respecting velocity and acceleration         *
+ *   limits of every joint                                          *
+ *                                                                  *
+ ********************************************************************/
+
+#ifndef _TIME_OPTIMAL_PROFILE_H_
+#define _TIME_OPTIMAL_PROFILE_H_
+
+#include <vector>
+
+
+class TimeOptimalProfile
+{
+	public:
+		TimeOptimalProfile();
+
+		/*
+		 * Computes the fastest profile on the grid s_grid (ascending, from 0 to 1)
+		 * which starts and ends at rest.
+		 * dr_ds and d2r_ds2 hold dof values per grid point, d2r_ds2 is taken
+		 * as constant on the interval [s_grid[k], s_grid[k+1]].
+		 * The path velocity is the largest one for which every joint j satisfies
+		 *   |dr_ds_j * ds_dt| <= v_max[j]
+		 *   |dr_ds_j * d2s_dt2 + d2r_ds2_j * ds_dt^2| <= a_max[j]
+		 * at all grid points. Returns false if the limits do not allow a motion.
+		 */
+		bool compute(const std::vector<double>& s_grid, const std::vector<double>& dr_ds, const std::vector<double>& d2r_ds2,
+			const std::vector<double>& v_max, const std::vector<double>& a_max);
+
+		double s(double t) const;
+		double ds_dt(double t) const;
+
+		double getTotalTime() const { return m_t.empty() ? 0.0 : m_t.back(); }
+
+	protected:
+		// bounds of d2s_dt2 at grid point k for the squared path velocity x = ds_dt^2
+		void accelerationBounds(unsigned int k, double x, double& u_min, double& u_max) const;
+		// upper bound of x at grid point k, after which the acceleration limits cannot be kept
+		double maxVelocitySqr(unsigned int k, double x_limit) const;
+
+		unsigned int findInterval(double t) const;
+
+		unsigned int m_dof;
+		const double* m_dr_ds;
+		const double* m_d2r_ds2;
+		const double* m_a_max;
+
+		std::vector<double> m_s;	// grid
+		std::vector<double> m_x;	// ds_dt^2 at the grid points
+		std::vector<double> m_u;	// d2s_dt2 on the intervals
+		std::vector<double> m_t;	// time at the grid points
+		mutable unsigned int m_cursor;	// interval of the last lookup
+};
+
+#endif
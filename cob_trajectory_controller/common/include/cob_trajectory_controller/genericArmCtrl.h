@@ -27,10 +27,44 @@ class genericArmCtrl
 	
 		// void stop(); --> TODO: better reset
 
-		bool step(std::vector<double> current_pos, std::vector<double> & desired_vel);
+		// does not allocate once desired_vel has m_DOF elements
+		bool step(const std::vector<double>& current_pos, std::vector<double> & desired_vel);
+		// evaluates the reference at timeNow_ instead of the current time, e.g. the deadline of a fixed rate loop
+		bool step(const std::vector<double>& current_pos, std::vector<double> & desired_vel, const TimeStamp& timeNow_);
 
 		bool moveThetas(std::vector<double> conf_goal, std::vector<double> conf_current);
 		bool moveTrajectory(trajectory_msgs::JointTrajectory pfad, std::vector<double> conf_current);
+		/*
+		 * Splices pfad into the running motion without stopping. The new path starts at
+		 * the reference position at the beginning of the blend, the reference velocity
+		 * stays continuous over m_BlendTime. append = false blends in immediately,
+		 * append = true at the end of the running motion, so that queued paths chain.
+		 * Returns false if no motion is running.
+		 */
+		bool blendTrajectory(trajectory_msgs::JointTrajectory pfad, bool append);
+
+		/*
+		 * blendTrajectory() in steps, for a controller which is shared with a control loop:
+		 * beginBlend() and commitBlend() access the running motion and need the lock of the loop,
+		 * buildBlend() creates the time-parameterized reference of the new path without it.
+		 * commitBlend() fails if the motion has ended or has been replaced in the meantime,
+		 * cancelBlend() frees the unused reference then. If building took longer than the
+		 * planned blend start, the blend starts at commitBlend().
+		 */
+		struct Blend
+		{
+			Blend() : refvals_count(0), elapsed(0.0), blend_start(0.0), blend_time(0.0), to(NULL) {}
+			unsigned int refvals_count;	// running motion the blend belongs to
+			double elapsed;				// time of the running motion at beginBlend()
+			double blend_start;
+			double blend_time;
+			RefVal_JS* to;
+		};
+		// inserts the start point of the blend into pfad
+		bool beginBlend(trajectory_msgs::JointTrajectory& pfad, bool append, Blend& blend);
+		bool buildBlend(const trajectory_msgs::JointTrajectory& pfad, Blend& blend);
+		bool commitBlend(Blend& blend);
+		void cancelBlend(Blend& blend);
 
 
 //		bool movePos(AbsPos position);
@@ -51,6 +85,18 @@ class genericArmCtrl
 		double m_CurrentError;
 		double m_TargetError;
 		double m_ExtraTime;	// Zusätzliche Zeit, um evtl. verbleibende Regelfehler auszuregeln
+		bool m_TimeOptimal;	// trajectories respect the limits of every joint instead of the slowest one
+		double m_BlendTime;	// s, Dauer der Überblendung in blendTrajectory()
+
+	private:
+		RefVal_JS* createTrajectoryRefVals(const trajectory_msgs::JointTrajectory& pfad) const;
+
+		// counts the references, so that a blend can tell whether the motion has been replaced
+		unsigned int m_RefValsCount;
+
+		// reference values of the current cycle, preallocated in the constructor
+		std::vector<double> m_qsoll;
+		std::vector<double> m_vsoll;
 };
 
 
@@ -0,0 +1,138 @@
+#include <cob_trajectory_controller/RealtimeLoop.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+static const long NSEC_PER_SEC = 1000000000L;
+
+
+RealtimeLoop::RealtimeLoop(double frequency)
+{
+	m_period_ns = (frequency > 0.0) ? (long)(1e9 / frequency) : NSEC_PER_SEC;
+	m_deadline.tv_sec = m_deadline.tv_nsec = 0;
+	m_wakeup = m_deadline;
+	m_running = false;
+	resetStatistics();
+}
+
+bool RealtimeLoop::configureThread(int priority, int cpu, bool lock_memory)
+{
+	bool ok = true;
+
+	if (lock_memory)
+	{
+		// no page faults in the loop
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+			ok = false;
+	}
+
+	if (cpu >= 0)
+	{
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(cpu, &cpus);
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+			ok = false;
+	}
+
+	if (priority > 0)
+	{
+		sched_param param;
+		param.sched_priority = priority;
+		if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+			ok = false;
+	}
+
+	return ok;
+}
+
+void RealtimeLoop::start()
+{
+	clock_gettime(CLOCK_MONOTONIC, &m_deadline);
+	addNs(m_deadline, m_period_ns);
+	m_running = false;
+}
+
+const timespec& RealtimeLoop::waitForNextCycle()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	if (m_running)
+	{
+		long exec = diffNs(now, m_wakeup);
+		m_exec_sum_ns += exec;
+		m_exec_count++;
+		if (exec > m_exec_max_ns)
+			m_exec_max_ns = exec;
+
+		addNs(m_deadline, m_period_ns);
+	}
+	m_running = true;
+
+	// the latency is measured against the scheduled deadline, also for late cycles
+	timespec scheduled = m_deadline;
+	if (diffNs(now, m_deadline) > 0)
+	{
+		// too late for this deadline, continue from now instead of catching up
+		m_overruns++;
+		m_deadline = now;
+	}
+	else
+	{
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &m_deadline, NULL) == EINTR)
+			;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &m_wakeup);
+	long latency = diffNs(m_wakeup, scheduled);
+	m_cycles++;
+	m_latency_sum_ns += latency;
+	if (latency < m_latency_min_ns)
+		m_latency_min_ns = latency;
+	if (latency > m_latency_max_ns)
+		m_latency_max_ns = latency;
+
+	return m_deadline;
+}
+
+RealtimeLoop::Statistics RealtimeLoop::getStatistics() const
+{
+	Statistics stats;
+	stats.cycles = m_cycles;
+	stats.overruns = m_overruns;
+	stats.latency_min = (m_cycles > 0) ? m_latency_min_ns * 1e-9 : 0.0;
+	stats.latency_max = m_latency_max_ns * 1e-9;
+	stats.latency_mean = (m_cycles > 0) ? m_latency_sum_ns / m_cycles * 1e-9 : 0.0;
+	stats.exec_max = m_exec_max_ns * 1e-9;
+	stats.exec_mean = (m_exec_count > 0) ? m_exec_sum_ns / m_exec_count * 1e-9 : 0.0;
+	return stats;
+}
+
+void RealtimeLoop::resetStatistics()
+{
+	m_cycles = 0;
+	m_overruns = 0;
+	m_latency_min_ns = NSEC_PER_SEC;
+	m_latency_max_ns = 0;
+	m_latency_sum_ns = 0.0;
+	m_exec_max_ns = 0;
+	m_exec_sum_ns = 0.0;
+	m_exec_count = 0;
+}
+
+void RealtimeLoop::addNs(timespec& t, long ns)
+{
+	t.tv_nsec += ns;
+	while (t.tv_nsec >= NSEC_PER_SEC)
+	{
+		t.tv_nsec -= NSEC_PER_SEC;
+		t.tv_sec++;
+	}
+}
+
+long RealtimeLoop::diffNs(const timespec& a, const timespec& b)
+{
+	return (a.tv_sec - b.tv_sec) * NSEC_PER_SEC + (a.tv_nsec - b.tv_nsec);
+}
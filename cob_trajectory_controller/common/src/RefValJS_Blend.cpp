@@ -0,0 +1,142 @@
+#include <cob_trajectory_controller/RefValJS_Blend.h>
+#include <algorithm>
+
+
+RefValJS_Blend::RefValJS_Blend(RefVal_JS* from, double from_offset, RefVal_JS* to, double blend_start, double blend_duration)
+{
+	m_from = from;
+	m_to = to;
+	m_from_offset = from_offset;
+	m_blend_start = (blend_start > 0.0) ? blend_start : 0.0;
+	m_blend_duration = (blend_duration > 0.0) ? blend_duration : 0.0;
+	m_T = m_blend_start + std::max(m_to->getTotalTime(), m_blend_duration);
+	m_DOF = m_to->getDOF();
+
+	m_buf_pos.resize(m_DOF);
+	m_buf_vel.resize(m_DOF);
+}
+
+RefValJS_Blend::~RefValJS_Blend()
+{
+	delete m_from;
+	delete m_to;
+}
+
+RefVal_JS* RefValJS_Blend::releaseTarget(double& time_offset)
+{
+	RefVal_JS* to = m_to;
+	m_to = NULL;
+	time_offset = -m_blend_start;
+	return to;
+}
+
+void RefValJS_Blend::weight(double t, double& alpha, double& dalpha_dt) const
+{
+	if (t <= m_blend_start)
+	{
+		alpha = 0.0;
+		dalpha_dt = 0.0;
+	}
+	else if (t >= m_blend_start + m_blend_duration)
+	{
+		alpha = 1.0;
+		dalpha_dt = 0.0;
+	}
+	else
+	{
+		// quintic, velocity and acceleration of the weight vanish at both ends
+		double tau = (t - m_blend_start) / m_blend_duration;
+		alpha = tau*tau*tau * (10.0 - 15.0*tau + 6.0*tau*tau);
+		dalpha_dt = 30.0 * tau*tau * (1.0-tau)*(1.0-tau) / m_blend_duration;
+	}
+}
+
+std::vector<double> RefValJS_Blend::r(double s) const
+{
+	std::vector<double> soll(m_DOF);
+	getR(s, &soll[0]);
+	return soll;
+}
+
+double RefValJS_Blend::s(double t) const
+{
+	if (t <= 0.0)
+		return 0.0;
+	if (t >= m_T)
+		return 1.0;
+	return t / m_T;
+}
+
+std::vector<double> RefValJS_Blend::dr_ds(double s) const
+{
+	std::vector<double> result(m_DOF);
+	getDr_ds(s, &result[0]);
+	return result;
+}
+
+double RefValJS_Blend::ds_dt(double t) const
+{
+	// the running motion may move at t = 0 already
+	if (t < 0.0 || t >= m_T)
+		return 0.0;
+	return 1.0 / m_T;
+}
+
+void RefValJS_Blend::getR(double s, double* soll) const
+{
+	double t = s * m_T;
+	double alpha, dalpha_dt;
+	weight(t, alpha, dalpha_dt);
+
+	if (alpha <= 0.0)
+	{
+		m_from->getR_t(t + m_from_offset, soll);
+		return;
+	}
+	if (alpha >= 1.0)
+	{
+		m_to->getR_t(t - m_blend_start, soll);
+		return;
+	}
+
+	m_from->getR_t(t + m_from_offset, soll);
+	m_to->getR_t(t - m_blend_start, &m_buf_pos[0]);
+	for(unsigned int i = 0; i < m_DOF; i++)
+		soll[i] += alpha * (m_buf_pos[i] - soll[i]);
+}
+
+void RefValJS_Blend::getDr_ds(double s, double* result) const
+{
+	// dr_ds = dr_dt / ds_dt = dr_dt * m_T
+	double t = s * m_T;
+	double alpha, dalpha_dt;
+	weight(t, alpha, dalpha_dt);
+
+	if (alpha <= 0.0)
+	{
+		m_from->getDr_dt(t + m_from_offset, result);
+	}
+	else if (alpha >= 1.0)
+	{
+		m_to->getDr_dt(t - m_blend_start, result);
+	}
+	else
+	{
+		double t_from = t + m_from_offset;
+		double t_to = t - m_blend_start;
+
+		// positions enter through the derivative of the weight
+		m_from->getDr_dt(t_from, result);
+		m_to->getDr_dt(t_to, &m_buf_vel[0]);
+		for(unsigned int i = 0; i < m_DOF; i++)
+			result[i] += alpha * (m_buf_vel[i] - result[i]);
+
+		m_to->getR_t(t_to, &m_buf_pos[0]);
+		m_from->getR_t(t_from, &m_buf_vel[0]);
+		for(unsigned int i = 0; i < m_DOF; i++)
+			result[i] += dalpha_dt * (m_buf_pos[i] - m_buf_vel[i]);
+	}
+
+	for(unsigned int i = 0; i < m_DOF; i++)
+		result[i] *= m_T;
+}
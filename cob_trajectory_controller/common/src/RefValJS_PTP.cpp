@@ -1,4 +1,5 @@
 #include <cob_trajectory_controller/RefValJS_PTP.h>
+#include <algorithm>
 
 inline double sqr(double x)
 {
@@ -66,22 +67,26 @@ RefValJS_PTP::RefValJS_PTP(const std::vector<double>& start, const std::vector<d
 	
 std::vector<double> RefValJS_PTP::r(double s) const
 {
-	std::vector<double> soll;
-	soll.resize(m_start.size());
+	std::vector<double> soll(m_start.size());
+	getR(s, &soll[0]);
+	return soll;
+}
+
+void RefValJS_PTP::getR(double s, double* soll) const
+{
 	if (s <= 0)
 	{
-		soll = m_start;
+		std::copy(m_start.begin(), m_start.end(), soll);
 	} else
 	if (s < 1)
 	{
 		for(unsigned int i = 0; i < m_start.size(); i++)
-			soll.at(i) = m_start.at(i) + m_direction.at(i) * s;
+			soll[i] = m_start[i] + m_direction[i] * s;
 	}
 	else
 	{
-		soll = m_ziel;
+		std::copy(m_ziel.begin(), m_ziel.end(), soll);
 	}
-	return soll;
 }
 
 double RefValJS_PTP::s(double t) const
@@ -124,18 +129,21 @@ double RefValJS_PTP::ds_dt(double t) const
 
 std::vector<double> RefValJS_PTP::dr_ds(double s) const
 {
-	std::vector<double> result = m_start;
+	std::vector<double> result(m_start.size());
+	getDr_ds(s, &result[0]);
+	return result;
+}
+
+void RefValJS_PTP::getDr_ds(double s, double* result) const
+{
 	if (s < 0.0 || s >= 1.0)
 	{
-		for(unsigned int i = 0; i<result.size(); i++)
-			result.at(i) = 0.0;
+		std::fill(result, result + m_direction.size(), 0.0);
 	}
 	else
 	{
-		result = m_direction;
+		std::copy(m_direction.begin(), m_direction.end(), result);
 	}
-
-	return result;
 }
 
 
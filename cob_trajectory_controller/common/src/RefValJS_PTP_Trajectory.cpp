@@ -14,6 +14,18 @@ inline double sqr(double x)
 }
 
 RefValJS_PTP_Trajectory::RefValJS_PTP_Trajectory(const trajectory_msgs::JointTrajectory& trajectory, double v_rad_s, double a_rad_s2, bool smooth)
+{
+	calculatePath(trajectory, smooth);
+	calculateTrapezoid(v_rad_s, a_rad_s2);
+}
+
+RefValJS_PTP_Trajectory::RefValJS_PTP_Trajectory(const trajectory_msgs::JointTrajectory& trajectory, const std::vector<double>& v_rad_s, const std::vector<double>& a_rad_s2, bool smooth)
+{
+	calculatePath(trajectory, smooth);
+	calculateTimeOptimal(v_rad_s, a_rad_s2);
+}
+
+void RefValJS_PTP_Trajectory::calculatePath(const trajectory_msgs::JointTrajectory& trajectory, bool smooth)
 {	
 	m_trajectory = trajectory;
 	m_length = 0;
@@ -74,30 +86,39 @@ RefValJS_PTP_Trajectory::RefValJS_PTP_Trajectory(const trajectory_msgs::JointTra
 	
 	// Note: unlike the name of the function suggests, the distance between any two neigbouring points
 	// is not always the same!
-	if ( m_TrajectorySpline.ipoWithConstSampleDist(m_stepSize, m_SplinePoints)==false )
+	std::vector<std::vector<double> > ipoPoints;
+	if ( m_TrajectorySpline.ipoWithConstSampleDist(m_stepSize, ipoPoints)==false )
 	{
 		//uhr-messmerf: diese exception wird geworfen, wenn nicht genügend Stützpunkte vorhanden sind (kleiner m_iGrad=3)
 		//uhr-messmerf: dies tritt auf, wenn die Punkte der Trajectory pfad zu nah beieinander liegen (dist < between_stepsize=2.5)
 		throw std::runtime_error("Error in BSplineND::ipoWithConstSampleDist!");
 	}
-	m_SplinePoints = zwischenPunkte;
-	ROS_INFO("Calculated %d splinepoints", m_SplinePoints.size());
+	m_DOF = zwischenPunkte.front().size();
+	m_NumSplinePoints = zwischenPunkte.size();
+	m_SplinePoints.resize(m_NumSplinePoints * m_DOF);
+	for (unsigned int i=0; i < m_NumSplinePoints; i++)
+	{
+		std::copy(zwischenPunkte[i].begin(), zwischenPunkte[i].end(), m_SplinePoints.begin() + i * m_DOF);
+	}
+	ROS_INFO("Calculated %d splinepoints", m_NumSplinePoints);
 	
 	m_length_cumulated.clear();
 	m_length_cumulated.push_back(0.0);
 	
-	for (unsigned int i=0; i < m_SplinePoints.size()-1; i++)
+	std::vector<double> dist;
+	dist.resize(m_DOF);
+	for (unsigned int i=0; i < m_NumSplinePoints-1; i++)
 	{
-		std::vector<double> dist;
-		dist.resize(m_SplinePoints[i].size());
-		for(unsigned int j=0; j < m_SplinePoints[i].size(); j++)
+		const double* p0 = splinePoint(i);
+		const double* p1 = splinePoint(i+1);
+		for(unsigned int j=0; j < m_DOF; j++)
 		{
-			dist.at(j) = m_SplinePoints[i+1].at(j) - m_SplinePoints[i].at(j);
+			dist.at(j) = p1[j] - p0[j];
 		}
 		//double max = fabs(direction.getMax());
 		//double min = fabs(direction.getMin());
 		m_length_parts.push_back( norm(dist) );
-		m_length += norm(dist);
+		m_length += m_length_parts.back();
 		m_length_cumulated.push_back(m_length);
 	}
 	
@@ -107,7 +128,84 @@ RefValJS_PTP_Trajectory::RefValJS_PTP_Trajectory(const trajectory_msgs::JointTra
 	{
 		m_s_parts.push_back( m_length_parts[i] / m_length );
 	}
-	
+
+	buildLookupTable();
+}
+
+void RefValJS_PTP_Trajectory::buildLookupTable()
+{
+	unsigned int num_segments = (m_NumSplinePoints > 1) ? m_NumSplinePoints - 1 : 0;
+
+	m_SegStride = 2 + 4 * m_DOF;
+	m_Segments.assign(num_segments * m_SegStride, 0.0);
+	m_Buckets.clear();
+	m_Cursor = 0;
+	if ( num_segments == 0 || m_length <= 0.0 )
+		return;
+
+	for (unsigned int i=0; i < num_segments; i++)
+	{
+		double* seg = &m_Segments[i * m_SegStride];
+		double* p0 = seg + 2;
+		double* dp = p0 + m_DOF;
+		double* v0 = dp + m_DOF;
+		double* dv = v0 + m_DOF;
+
+		seg[0] = m_length_cumulated[i] / m_length;
+		seg[1] = (m_length_parts[i] > 0.0) ? m_length / m_length_parts[i] : 0.0;
+		for (unsigned int j=0; j < m_DOF; j++)
+		{
+			p0[j] = splinePoint(i)[j];
+			dp[j] = splinePoint(i+1)[j] - p0[j];
+		}
+		if ( m_length_parts[i] > 0.0 )
+		{
+			// dr_ds is linear on the segment
+			pathDerivative(i, 0.0, v0);
+			pathDerivative(i, 1.0, dv);
+			for (unsigned int j=0; j < m_DOF; j++)
+				dv[j] -= v0[j];
+		}
+	}
+
+	// one bucket per segment on average, each knows the segment at its start
+	m_Buckets.resize(num_segments);
+	unsigned int i = 0;
+	for (unsigned int b=0; b < m_Buckets.size(); b++)
+	{
+		double s_bucket = (double)b / m_Buckets.size();
+		while ( i+1 < num_segments && s_bucket >= m_Segments[(i+1) * m_SegStride] )
+			i++;
+		m_Buckets[b] = i;
+	}
+}
+
+unsigned int RefValJS_PTP_Trajectory::findSegment(double s) const
+{
+	unsigned int num_segments = m_Buckets.size();
+	unsigned int i = m_Cursor;
+
+	// s usually stays in the segment of the last call or moves on to the next one
+	if ( s >= m_Segments[i * m_SegStride] )
+	{
+		if ( i+1 >= num_segments || s < m_Segments[(i+1) * m_SegStride] )
+			return i;
+		if ( i+2 >= num_segments || s < m_Segments[(i+2) * m_SegStride] )
+			return m_Cursor = i+1;
+	}
+
+	unsigned int b = (unsigned int)(s * num_segments);
+	if ( b >= num_segments )
+		b = num_segments - 1;
+	i = m_Buckets[b];
+	while ( i+1 < num_segments && s >= m_Segments[(i+1) * m_SegStride] )
+		i++;
+	return m_Cursor = i;
+}
+
+void RefValJS_PTP_Trajectory::calculateTrapezoid(double v_rad_s, double a_rad_s2)
+{
+	m_TimeOptimal = false;
 	m_v_rad_s = v_rad_s;
 	m_a_rad_s2 = a_rad_s2;
 	
@@ -140,52 +238,106 @@ RefValJS_PTP_Trajectory::RefValJS_PTP_Trajectory(const trajectory_msgs::JointTra
 		
 }
 
+void RefValJS_PTP_Trajectory::calculateTimeOptimal(const std::vector<double>& v_rad_s, const std::vector<double>& a_rad_s2)
+{
+	if ( m_NumSplinePoints < 2 || m_length <= 0.0 )
+	{
+		// nothing to move, the trapezoid handles this with zero duration
+		calculateTrapezoid(*std::min_element(v_rad_s.begin(), v_rad_s.end()), *std::min_element(a_rad_s2.begin(), a_rad_s2.end()));
+		return;
+	}
+
+	// Sample dr_ds at the segment boundaries and at least every TOPP_GRID_STEP in s.
+	// dr_ds is linear on each segment, so its derivative is constant there.
+	const double TOPP_GRID_STEP = 1e-3;
+	std::vector<double> s_grid, dr_ds, d2r_ds2;
+	std::vector<double> vi(m_DOF), vii(m_DOF);
+	s_grid.reserve(m_NumSplinePoints + (unsigned int)(1.0 / TOPP_GRID_STEP) + 1);
+	for (unsigned int i=0; i < m_NumSplinePoints-1; i++)
+	{
+		double s0 = m_length_cumulated[i] / m_length;
+		double s_part = m_length_parts[i] / m_length;
+		if ( s_part <= 0.0 )
+			continue;
+
+		pathDerivative(i, 0.0, &vi[0]);
+		pathDerivative(i, 1.0, &vii[0]);
+		int num_sub = (int)ceil(s_part / TOPP_GRID_STEP);
+		for (int k=0; k < num_sub; k++)
+		{
+			double frac = (double)k / num_sub;
+			s_grid.push_back(s0 + s_part * frac);
+			for(unsigned int j=0; j < m_DOF; j++)
+			{
+				dr_ds.push_back( vi[j] + (vii[j]-vi[j])*frac );
+				d2r_ds2.push_back( (vii[j]-vi[j]) / s_part );
+			}
+		}
+	}
+	s_grid.push_back(1.0);
+	for(unsigned int j=0; j < m_DOF; j++)
+	{
+		dr_ds.push_back( vii[j] );
+		d2r_ds2.push_back( 0.0 );
+	}
+
+	std::vector<double> v_max(m_DOF), a_max(m_DOF);
+	for(unsigned int j=0; j < m_DOF; j++)
+	{
+		v_max[j] = fabs(v_rad_s.at(j));
+		a_max[j] = fabs(a_rad_s2.at(j));
+	}
+
+	if ( m_Profile.compute(s_grid, dr_ds, d2r_ds2, v_max, a_max) == false )
+	{
+		throw std::runtime_error("Joint limits do not allow a motion along the trajectory!");
+	}
+	m_TimeOptimal = true;
+	ROS_INFO("Time optimal parameterization on %d samples: %f s", (int)s_grid.size(), m_Profile.getTotalTime());
+}
+
 std::vector<double> RefValJS_PTP_Trajectory::r(double s) const
+{
+	std::vector<double> soll(m_DOF);
+	getR(s, &soll[0]);
+	return soll;
+}
+
+void RefValJS_PTP_Trajectory::getR(double s, double* soll) const
 {
 	//printw("Line %d\ts: %f\n", __LINE__, s);
-	std::vector<double> soll;
-	if (s <= 0)
+	if (s <= 0 || m_Buckets.empty())
 	{
-		soll = m_trajectory.points.front().positions;
+		const std::vector<double>& front = m_trajectory.points.front().positions;
+		std::copy(front.begin(), front.end(), soll);
 	} else
 	if (s < 1)
 	{
 		// since the Distances between the points of m_SplinePoints are not equal,
-		// we first need to find the last i where m_length_cumulated[i] is smaller than s*m_length
-		
-		// return the first index i, where m_length_cumulated[i] is not smaller s * m_length
-		// more information under: http://www.cplusplus.com/reference/algorithm/lower_bound/
-		//typedef std::vector<double> dvec;
-		
-		
-		vecd_it start = m_length_cumulated.begin();
-		vecd_it end = m_length_cumulated.end();
-		vecd_it it = upper_bound(start, end, s * m_length);
-		
-		int i = int(it-start) - 1;
-		double frac = (s * m_length - m_length_cumulated[i]) / m_length_parts[i];
-		
+		// the segment is looked up in the table built by buildLookupTable()
+		const double* seg = &m_Segments[findSegment(s) * m_SegStride];
+		double frac = (s - seg[0]) * seg[1];
 
-		/*
-		int i = floor( s * m_param_length / m_stepSize);
-		double frac = s * m_param_length / m_stepSize - (double) i;
-		*/
 		// interpolate
-		soll.resize(m_SplinePoints[i].size());
-		for(unsigned int j = 0; j < m_SplinePoints[i].size(); j++)
+		const double* p0 = seg + 2;
+		const double* dp = p0 + m_DOF;
+		for(unsigned int j = 0; j < m_DOF; j++)
 		{
-			soll.at(j) = m_SplinePoints[i].at(j) + (m_SplinePoints[i+1].at(j)-m_SplinePoints[i].at(j))*frac;
+			soll[j] = p0[j] + dp[j]*frac;
 		}
 	}
 	else
 	{
-		soll = m_trajectory.points.back().positions;
+		const std::vector<double>& back = m_trajectory.points.back().positions;
+		std::copy(back.begin(), back.end(), soll);
 	}
-	return soll;
 }
 
 double RefValJS_PTP_Trajectory::s(double t) const
 {
+	if (m_TimeOptimal)
+		return m_Profile.s(t);
+
 	if (t >= m_T1 + m_T2 + m_T3)
 		return 1.0;
 	else if (t >= m_T1 + m_T2)
@@ -205,6 +357,9 @@ double RefValJS_PTP_Trajectory::s(double t) const
 
 double RefValJS_PTP_Trajectory::ds_dt(double t) const
 {
+	if (m_TimeOptimal)
+		return m_Profile.ds_dt(t);
+
 	if (t >= m_T1 + m_T2 + m_T3)
 		return 0.0;
 	else if (t >= m_T1 + m_T2)
@@ -224,80 +379,80 @@ double RefValJS_PTP_Trajectory::ds_dt(double t) const
 
 
 std::vector<double> RefValJS_PTP_Trajectory::dr_ds(double s) const
+{
+	std::vector<double> result(m_DOF);
+	getDr_ds(s, &result[0]);
+	return result;
+}
+
+void RefValJS_PTP_Trajectory::getDr_ds(double s, double* result) const
 {
 	//printw("Line %d\ts: %f\n", __LINE__, s);
-	std::vector<double> result = m_trajectory.points.front().positions;
-	if (s < 0.0 || s >= 1.0)
+	if (s < 0.0 || s >= 1.0 || m_Buckets.empty())
 	{
-		for(unsigned int j=0; j < result.size(); j++)
-			result.at(j) = 0.0;
+		std::fill(result, result + m_DOF, 0.0);
 	}
 	else
 	{
-		
-		vecd_it start = m_length_cumulated.begin();
-		vecd_it end = m_length_cumulated.end();
-		vecd_it it = upper_bound(start, end, s * m_length);
-		
-		int i = int(it-start) - 1;	
-		double frac = (s * m_length - m_length_cumulated[i]) / m_length_parts[i];
-		
-		
-		/*
-		int i = floor( s * m_param_length / m_stepSize);
-		double frac = s * m_param_length / m_stepSize - (double) i;
-		*/
-		
-		std::vector<double> vi;	// vi
-		std::vector<double> vii;// vi+1
-		
-		double step_s = m_stepSize / m_param_length;
+		const double* seg = &m_Segments[findSegment(s) * m_SegStride];
+		double frac = (s - seg[0]) * seg[1];
 
-		if ( i == 0 )
-		{
-			// vi rechtsseitig approximieren
-			step_s = m_length_parts[0] / m_length;
-			vi.resize(m_SplinePoints[i].size());
-			for(unsigned int k = 0; k < m_SplinePoints[i].size(); k++)
-			{
-				vi.at(k) = (m_SplinePoints[1].at(k) - m_SplinePoints[0].at(k)) / step_s;
-			}
-			vii = vi;
-			// vi+1 zentrisch approximieren
-			//step_s = (m_length_parts[i]+m_length_parts[i+1]) / m_length;
-			//vii = (m_SplinePoints[i+2] - m_SplinePoints[i]) / (2.0 * step_s);
-		} else
-		if ( i == (int) m_SplinePoints.size() - 2 )
+		// linear interpolation of the difference quotients, see pathDerivative()
+		const double* v0 = seg + 2 + 2 * m_DOF;
+		const double* dv = v0 + m_DOF;
+		for(unsigned int j = 0; j < m_DOF; j++)
 		{
-			// vi zentrisch:
-			//step_s = (m_length_parts[i]+m_length_parts[i-1]) / m_length;
-			//vi = (m_SplinePoints[i+1] - m_SplinePoints[i-1]) / (2.0 * step_s);
-			// vi+1 linksseitig:
-			step_s = (m_length_parts[i]) / m_length;
-			vii.resize(m_SplinePoints[i].size());
-			for(unsigned int k = 0; k < m_SplinePoints[i].size(); k++)
-				vii.at(k) = (m_SplinePoints[i+1].at(k) - m_SplinePoints[i].at(k)) / step_s;
-			vi = vii;
-		} else
-		{
-			// beide zentrisch:
-			step_s = (m_length_parts[i]+m_length_parts[i-1]) / m_length;
-			vi.resize(m_SplinePoints[i].size());
-			for(unsigned int k = 0; k < m_SplinePoints[i].size(); k++)
-				vi.at(k) = (m_SplinePoints[i+1].at(k) - m_SplinePoints[i-1].at(k)) / step_s;
-			step_s = (m_length_parts[i]+m_length_parts[i+1]) / m_length;
-			vii.resize(m_SplinePoints[i].size());
-			for(unsigned int k = 0; k < m_SplinePoints[i].size(); k++)
-				vii.at(k) = (m_SplinePoints[i+2].at(k) - m_SplinePoints[i].at(k)) / step_s;
+			result[j] = v0[j] + dv[j]*frac;
 		}
+	}
+}
+
+void RefValJS_PTP_Trajectory::pathDerivative(int i, double frac, double* result) const
+{
+	// vi and vi+1 are the difference quotients at the points i and i+1,
+	// dr_ds interpolates linearly between them
+	const double* vi_a;	// vi = (vi_b - vi_a) / vi_step
+	const double* vi_b;
+	const double* vii_a;	// vi+1 = (vii_b - vii_a) / vii_step
+	const double* vii_b;
+	double vi_step, vii_step;
+
+	// vi: rechtsseitig am Anfang, sonst zentrisch
+	if ( i == 0 )
+	{
+		vi_a = splinePoint(0);
+		vi_b = splinePoint(1);
+		vi_step = m_length_parts[0] / m_length;
+	}
+	else
+	{
+		vi_a = splinePoint(i-1);
+		vi_b = splinePoint(i+1);
+		vi_step = (m_length_parts[i]+m_length_parts[i-1]) / m_length;
+	}
 
-		// linear interpolieren:
-		result.resize(m_SplinePoints[i].size());
-		for(unsigned int k = 0; k < m_SplinePoints[i].size(); k++)
-			result.at(k) = vi.at(k) + (vii.at(k)-vi.at(k))*frac;
+	// vi+1: linksseitig am Ende, sonst zentrisch
+	// (so that dr_ds is continuous at the path points)
+	if ( i == (int) m_NumSplinePoints - 2 )
+	{
+		vii_a = splinePoint(i);
+		vii_b = splinePoint(i+1);
+		vii_step = (m_length_parts[i]) / m_length;
+	}
+	else
+	{
+		vii_a = splinePoint(i);
+		vii_b = splinePoint(i+2);
+		vii_step = (m_length_parts[i]+m_length_parts[i+1]) / m_length;
 	}
 
-	return result;
+	// linear interpolieren:
+	for(unsigned int k = 0; k < m_DOF; k++)
+	{
+		double vi = (vi_b[k] - vi_a[k]) / vi_step;
+		double vii = (vii_b[k] - vii_a[k]) / vii_step;
+		result[k] = vi + (vii-vi)*frac;
+	}
 }
 
 
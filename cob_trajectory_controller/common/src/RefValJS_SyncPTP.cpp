@@ -0,0 +1,232 @@
+#include <cob_trajectory_controller/RefValJS_SyncPTP.h>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// samples per block in evaluate(), the profile values of a block stay on the stack
+static const unsigned int EVAL_BLOCK = 64;
+
+
+RefValJS_SyncPTP::RefValJS_SyncPTP(const std::vector<double>& start, const std::vector<double>& ziel,
+	const std::vector<double>& v_max, const std::vector<double>& a_max, const std::vector<double>& j_max)
+{
+	unsigned int dof = start.size();
+	if (ziel.size() != dof || v_max.size() != dof || a_max.size() != dof || (!j_max.empty() && j_max.size() != dof))
+		throw std::runtime_error("RefValJS_SyncPTP: number of joints does not match");
+
+	m_start = start;
+	m_direction.resize(dof);
+
+	/* Grenzen des Wegparameters s: jedes Gelenk bewegt sich mit direction * s(t),
+	 * das langsamste Gelenk bestimmt das Profil. */
+	double V = std::numeric_limits<double>::infinity();
+	double A = std::numeric_limits<double>::infinity();
+	double J = std::numeric_limits<double>::infinity();
+	for(unsigned int i = 0; i < dof; i++)
+	{
+		if (v_max[i] <= 0.0 || a_max[i] <= 0.0 || (!j_max.empty() && j_max[i] <= 0.0))
+			throw std::runtime_error("RefValJS_SyncPTP: limits have to be positive");
+
+		m_direction[i] = ziel[i] - start[i];
+		double d = fabs(m_direction[i]);
+		if (d == 0.0)
+			continue;
+		V = std::min(V, v_max[i] / d);
+		A = std::min(A, a_max[i] / d);
+		if (!j_max.empty())
+			J = std::min(J, j_max[i] / d);
+	}
+
+	if (V == std::numeric_limits<double>::infinity())
+	{
+		// keine Bewegung
+		m_T = m_Ta = m_Tv = m_Tj = 0.0;
+		m_J = m_alim = m_vlim = 0.0;
+		return;
+	}
+
+	/* Profil für die Strecke 1 aus der Ruhe in die Ruhe */
+	if (J == std::numeric_limits<double>::infinity())
+	{
+		// Trapezprofil
+		m_J = 0.0;
+		m_Tj = 0.0;
+		m_Ta = V / A;
+		m_Tv = 1.0 / V - m_Ta;
+		if (m_Tv < 0.0)
+		{
+			// Phase konst. Geschw. wird nicht erreicht
+			m_Ta = sqrt(1.0 / A);
+			m_Tv = 0.0;
+		}
+	}
+	else
+	{
+		// Doppel-S-Profil
+		m_J = J;
+		if (V * J >= A * A)
+		{
+			m_Tj = A / J;
+			m_Ta = m_Tj + V / A;
+		}
+		else
+		{
+			// max. Beschl. wird nicht erreicht
+			m_Tj = sqrt(V / J);
+			m_Ta = 2.0 * m_Tj;
+		}
+		m_Tv = 1.0 / V - m_Ta;
+		if (m_Tv < 0.0)
+		{
+			// Phase konst. Geschw. wird nicht erreicht
+			m_Tv = 0.0;
+			m_Tj = A / J;
+			m_Ta = 0.5 * m_Tj + sqrt(0.25 * m_Tj * m_Tj + 1.0 / A);
+			if (m_Ta < 2.0 * m_Tj)
+			{
+				m_Tj = pow(0.5 / J, 1.0 / 3.0);
+				m_Ta = 2.0 * m_Tj;
+			}
+		}
+	}
+
+	m_alim = (m_Tj > 0.0) ? m_J * m_Tj : A;
+	m_vlim = (m_Ta - m_Tj) * m_alim;
+	m_T = 2.0 * m_Ta + m_Tv;
+}
+
+inline void RefValJS_SyncPTP::profile(double t, double& s, double& v, double& a) const
+{
+	if (t <= 0.0 || m_T <= 0.0)
+	{
+		s = (m_T <= 0.0) ? 1.0 : 0.0;
+		v = a = 0.0;
+		return;
+	}
+	if (t >= m_T)
+	{
+		s = 1.0;
+		v = a = 0.0;
+		return;
+	}
+	if (t >= m_Ta && t < m_Ta + m_Tv)
+	{
+		s = 0.5 * m_vlim * m_Ta + m_vlim * (t - m_Ta);
+		v = m_vlim;
+		a = 0.0;
+		return;
+	}
+
+	// Verzögerungsphase ist die gespiegelte Beschleunigungsphase
+	bool decel = (t >= m_Ta);
+	double tau = decel ? m_T - t : t;
+	if (tau < m_Tj)
+	{
+		s = m_J * tau * tau * tau / 6.0;
+		v = 0.5 * m_J * tau * tau;
+		a = m_J * tau;
+	}
+	else if (tau < m_Ta - m_Tj)
+	{
+		s = m_alim / 6.0 * (3.0 * tau * tau - 3.0 * m_Tj * tau + m_Tj * m_Tj);
+		v = m_alim * (tau - 0.5 * m_Tj);
+		a = m_alim;
+	}
+	else
+	{
+		double r = m_Ta - tau;
+		s = 0.5 * m_vlim * m_Ta - m_vlim * r + m_J * r * r * r / 6.0;
+		v = m_vlim - 0.5 * m_J * r * r;
+		a = m_J * r;
+	}
+	if (decel)
+	{
+		s = 1.0 - s;
+		a = -a;
+	}
+}
+
+double RefValJS_SyncPTP::s(double t) const
+{
+	double s, v, a;
+	profile(t, s, v, a);
+	return s;
+}
+
+double RefValJS_SyncPTP::ds_dt(double t) const
+{
+	double s, v, a;
+	profile(t, s, v, a);
+	return v;
+}
+
+double RefValJS_SyncPTP::d2s_dt2(double t) const
+{
+	double s, v, a;
+	profile(t, s, v, a);
+	return a;
+}
+
+std::vector<double> RefValJS_SyncPTP::r(double s) const
+{
+	std::vector<double> soll(m_start.size());
+	getR(s, &soll[0]);
+	return soll;
+}
+
+void RefValJS_SyncPTP::getR(double s, double* soll) const
+{
+	s = std::max(0.0, std::min(s, 1.0));
+	for(unsigned int i = 0; i < m_start.size(); i++)
+		soll[i] = m_start[i] + m_direction[i] * s;
+}
+
+std::vector<double> RefValJS_SyncPTP::dr_ds(double s) const
+{
+	std::vector<double> result(m_start.size());
+	getDr_ds(s, &result[0]);
+	return result;
+}
+
+void RefValJS_SyncPTP::getDr_ds(double s, double* result) const
+{
+	if (s < 0.0 || s >= 1.0)
+		std::fill(result, result + m_direction.size(), 0.0);
+	else
+		std::copy(m_direction.begin(), m_direction.end(), result);
+}
+
+void RefValJS_SyncPTP::evaluate(const double* t, unsigned int n, double* positions, double* velocities, double* accelerations) const
+{
+	double s[EVAL_BLOCK], v[EVAL_BLOCK], a[EVAL_BLOCK];
+	unsigned int dof = m_start.size();
+
+	for(unsigned int k0 = 0; k0 < n; k0 += EVAL_BLOCK)
+	{
+		unsigned int m = std::min(EVAL_BLOCK, n - k0);
+		for(unsigned int k = 0; k < m; k++)
+			profile(t[k0 + k], s[k], v[k], a[k]);
+
+		// contiguous per joint, the compiler vectorizes the inner loops
+		for(unsigned int j = 0; j < dof; j++)
+		{
+			double p0 = m_start[j];
+			double d = m_direction[j];
+			double* pos = positions + j * n + k0;
+			for(unsigned int k = 0; k < m; k++)
+				pos[k] = p0 + d * s[k];
+			if (velocities != NULL)
+			{
+				double* vel = velocities + j * n + k0;
+				for(unsigned int k = 0; k < m; k++)
+					vel[k] = d * v[k];
+			}
+			if (accelerations != NULL)
+			{
+				double* acc = accelerations + j * n + k0;
+				for(unsigned int k = 0; k < m; k++)
+					acc[k] = d * a[k];
+			}
+		}
+	}
+}
@@ -0,0 +1,221 @@
+#include <cob_trajectory_controller/TimeOptimalProfile.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// joints whose path derivative is below this are treated as not moving
+static const double DR_DS_EPS = 1e-12;
+// relative accuracy of the bisections on ds_dt^2
+static const double BISECTION_TOL = 1e-9;
+static const int BISECTION_MAX_ITER = 60;
+
+
+TimeOptimalProfile::TimeOptimalProfile()
+{
+	m_dof = 0;
+	m_dr_ds = NULL;
+	m_d2r_ds2 = NULL;
+	m_a_max = NULL;
+	m_cursor = 0;
+}
+
+void TimeOptimalProfile::accelerationBounds(unsigned int k, double x, double& u_min, double& u_max) const
+{
+	u_min = -std::numeric_limits<double>::infinity();
+	u_max = std::numeric_limits<double>::infinity();
+
+	const double* d = m_dr_ds + k * m_dof;
+	const double* dd = m_d2r_ds2 + k * m_dof;
+	for(unsigned int j = 0; j < m_dof; j++)
+	{
+		double a = m_a_max[j];
+		if (fabs(d[j]) < DR_DS_EPS)
+		{
+			// the joint only sees the centripetal part
+			if (fabs(dd[j] * x) > a)
+			{
+				u_min = std::numeric_limits<double>::infinity();
+				u_max = -std::numeric_limits<double>::infinity();
+				return;
+			}
+			continue;
+		}
+		double lo = (-a - dd[j] * x) / d[j];
+		double hi = (a - dd[j] * x) / d[j];
+		if (d[j] < 0)
+			std::swap(lo, hi);
+		u_min = std::max(u_min, lo);
+		u_max = std::min(u_max, hi);
+	}
+}
+
+double TimeOptimalProfile::maxVelocitySqr(unsigned int k, double x_limit) const
+{
+	double u_min, u_max;
+	accelerationBounds(k, x_limit, u_min, u_max);
+	if (u_min <= u_max)
+		return x_limit;
+
+	// the feasible set is an interval containing x = 0
+	double lo = 0.0;
+	double hi = x_limit;
+	for(int i = 0; i < BISECTION_MAX_ITER && hi - lo > BISECTION_TOL * hi; i++)
+	{
+		double mid = 0.5 * (lo + hi);
+		accelerationBounds(k, mid, u_min, u_max);
+		if (u_min <= u_max)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+bool TimeOptimalProfile::compute(const std::vector<double>& s_grid, const std::vector<double>& dr_ds, const std::vector<double>& d2r_ds2,
+	const std::vector<double>& v_max, const std::vector<double>& a_max)
+{
+	unsigned int n = s_grid.size();
+	m_dof = v_max.size();
+	m_s.clear();
+	m_x.clear();
+	m_u.clear();
+	m_t.clear();
+	m_cursor = 0;
+
+	if (n < 2 || m_dof == 0 || a_max.size() != m_dof || dr_ds.size() != n * m_dof || d2r_ds2.size() != n * m_dof)
+		return false;
+	for(unsigned int j = 0; j < m_dof; j++)
+	{
+		if (v_max[j] <= 0.0 || a_max[j] <= 0.0)
+			return false;
+	}
+
+	m_dr_ds = &dr_ds[0];
+	m_d2r_ds2 = &d2r_ds2[0];
+	m_a_max = &a_max[0];
+
+	// maximum velocity curve from the velocity and the acceleration limits
+	std::vector<double> x_max(n);
+	for(unsigned int k = 0; k < n; k++)
+	{
+		double x_limit = std::numeric_limits<double>::max();
+		const double* d = m_dr_ds + k * m_dof;
+		for(unsigned int j = 0; j < m_dof; j++)
+		{
+			if (fabs(d[j]) >= DR_DS_EPS)
+				x_limit = std::min(x_limit, (v_max[j] * v_max[j]) / (d[j] * d[j]));
+		}
+		x_max[k] = maxVelocitySqr(k, x_limit);
+	}
+
+	// backward pass: largest velocity at k from which the motion can still
+	// decelerate into the admissible velocity at k+1
+	x_max[n-1] = 0.0;
+	for(int k = n - 2; k >= 0; k--)
+	{
+		double ds = s_grid[k+1] - s_grid[k];
+		double u_min, u_max;
+
+		double lo = 0.0;
+		double hi = x_max[k];
+		accelerationBounds(k, hi, u_min, u_max);
+		if (hi + 2.0 * ds * u_min <= x_max[k+1] && hi + 2.0 * ds * u_max >= 0.0)
+			continue;
+
+		for(int i = 0; i < BISECTION_MAX_ITER && hi - lo > BISECTION_TOL * hi; i++)
+		{
+			double mid = 0.5 * (lo + hi);
+			accelerationBounds(k, mid, u_min, u_max);
+			if (u_min <= u_max && mid + 2.0 * ds * u_min <= x_max[k+1] && mid + 2.0 * ds * u_max >= 0.0)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		x_max[k] = lo;
+	}
+
+	// forward pass: accelerate as hard as the controllable velocities allow
+	m_s = s_grid;
+	m_x.resize(n);
+	m_u.resize(n - 1);
+	m_t.resize(n);
+	m_x[0] = 0.0;
+	m_t[0] = 0.0;
+	for(unsigned int k = 0; k < n - 1; k++)
+	{
+		double ds = s_grid[k+1] - s_grid[k];
+		double u_min, u_max;
+		accelerationBounds(k, m_x[k], u_min, u_max);
+
+		double x_next = std::min(m_x[k] + 2.0 * ds * u_max, x_max[k+1]);
+		if (x_next < 0.0)
+			x_next = 0.0;
+		m_x[k+1] = x_next;
+		m_u[k] = (ds > 0.0) ? (x_next - m_x[k]) / (2.0 * ds) : 0.0;
+
+		double v_sum = sqrt(m_x[k]) + sqrt(x_next);
+		if (v_sum <= 0.0)
+		{
+			if (ds > 0.0)
+			{
+				// path velocity stalls, the limits do not allow to move on
+				m_s.clear();
+				m_x.clear();
+				m_u.clear();
+				m_t.clear();
+				m_dr_ds = m_d2r_ds2 = m_a_max = NULL;
+				return false;
+			}
+			m_t[k+1] = m_t[k];
+		}
+		else
+			m_t[k+1] = m_t[k] + 2.0 * ds / v_sum;
+	}
+
+	m_dr_ds = m_d2r_ds2 = m_a_max = NULL;
+	return true;
+}
+
+unsigned int TimeOptimalProfile::findInterval(double t) const
+{
+	// t usually stays in the interval of the last call or moves on by a few
+	unsigned int last = m_u.size() - 1;
+	unsigned int k = m_cursor;
+	if (k <= last && t >= m_t[k])
+	{
+		for(int i = 0; i < 4 && k < last && t >= m_t[k+1]; i++)
+			k++;
+		if (k == last || t < m_t[k+1])
+			return m_cursor = k;
+	}
+
+	// last k with m_t[k] <= t
+	std::vector<double>::const_iterator it = std::upper_bound(m_t.begin(), m_t.end(), t);
+	k = (it - m_t.begin()) - 1;
+	return m_cursor = std::min(k, last);
+}
+
+double TimeOptimalProfile::s(double t) const
+{
+	if (m_t.empty())
+		return 0.0;
+	if (t <= 0.0)
+		return m_s.front();
+	if (t >= m_t.back())
+		return m_s.back();
+
+	unsigned int k = findInterval(t);
+	double tau = t - m_t[k];
+	double s = m_s[k] + sqrt(m_x[k]) * tau + 0.5 * m_u[k] * tau * tau;
+	return std::min(s, m_s[k+1]);
+}
+
+double TimeOptimalProfile::ds_dt(double t) const
+{
+	if (m_t.empty() || t <= 0.0 || t >= m_t.back())
+		return 0.0;
+
+	unsigned int k = findInterval(t);
+	double v = sqrt(m_x[k]) + m_u[k] * (t - m_t[k]);
+	return std::max(v, 0.0);
+}
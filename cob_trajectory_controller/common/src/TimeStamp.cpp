@@ -61,7 +61,7 @@ TimeStamp::TimeStamp()
 
 void TimeStamp::SetNow()
 {
-	::clock_gettime(CLOCK_REALTIME, &m_TimeStamp);
+	::clock_gettime(CLOCK_MONOTONIC, &m_TimeStamp);
 }
 
 double TimeStamp::TimespecToDouble(const ::timespec& LargeInt)
@@ -2,6 +2,8 @@
 #include <fstream>
 #include <cob_trajectory_controller/RefValJS_PTP_Trajectory.h>
 #include <cob_trajectory_controller/RefValJS_PTP.h>
+#include <cob_trajectory_controller/RefValJS_Blend.h>
+#include <stdexcept>
 
 
 /********************************************************************
@@ -44,6 +46,7 @@ genericArmCtrl::genericArmCtrl(int DOF, double PTPvel, double PTPacc, double max
 	m_DOF = DOF;
 	
 	m_pRefVals = NULL;
+	m_RefValsCount = 0;
 	
 	isMoving = false;
 
@@ -59,6 +62,11 @@ genericArmCtrl::genericArmCtrl(int DOF, double PTPvel, double PTPacc, double max
 	m_TargetError = 0.02; // rad;
 
 	m_ExtraTime = 3;	// s
+	m_TimeOptimal = true;
+	m_BlendTime = 0.5;	// s
+
+	m_qsoll.resize(m_DOF);
+	m_vsoll.resize(m_DOF);
 	
 }
 
@@ -126,6 +134,7 @@ bool genericArmCtrl::moveThetas(std::vector<double> conf_goal, std::vector<doubl
 
 					;
 	m_pRefVals = new RefValJS_PTP(conf_current, conf_goal, vel, acc);
+	m_RefValsCount++;
 	startTime_.SetNow();
 	isMoving = true;
 	TotalTime_ = m_pRefVals->getTotalTime();
@@ -154,6 +163,145 @@ bool genericArmCtrl::moveTrajectory(trajectory_msgs::JointTrajectory pfad, std::
 	STD_CHECK_PROCEDURE()
 	
 	/* Sollwerte generieren: */
+	m_pRefVals = createTrajectoryRefVals(pfad);
+	m_RefValsCount++;
+	
+	/* Regeljob starten: */
+	startTime_.SetNow();
+	isMoving = true;
+	TotalTime_ = m_pRefVals->getTotalTime();
+	ROS_INFO("Starting control of trajectory: %f s long", TotalTime_);
+
+	//START_CTRL_JOB(Trajectory)
+	return true;
+}
+
+bool genericArmCtrl::blendTrajectory(trajectory_msgs::JointTrajectory pfad, bool append)
+{
+	Blend blend;
+	if ( !beginBlend(pfad, append, blend) || !buildBlend(pfad, blend) )
+		return false;
+	if ( !commitBlend(blend) )
+	{
+		cancelBlend(blend);
+		return false;
+	}
+	return true;
+}
+
+bool genericArmCtrl::beginBlend(trajectory_msgs::JointTrajectory& pfad, bool append, Blend& blend)
+{
+	if ( !isMoving || m_pRefVals == NULL )
+	{
+		ROS_WARN("No motion to blend into, use moveTrajectory instead.");
+		return false;
+	}
+	if ( pfad.points.empty() )
+		return false;
+
+	TimeStamp now;
+	now.SetNow();
+	blend.refvals_count = m_RefValsCount;
+	blend.elapsed = now - startTime_;
+	blend.blend_time = m_BlendTime;
+	blend.blend_start = 0.0;
+	blend.to = NULL;
+	if (append)
+	{
+		/* Überblendung über die Bremsphase des laufenden Pfads, während der neue
+		   Pfad beschleunigt. So fällt die Geschwindigkeit zwischen beiden nicht auf null. */
+		for(int i = 0; i < m_DOF; i++)
+		{
+			if (m_acc_js.at(i) > 0.0 && m_vel_js.at(i) / m_acc_js.at(i) > blend.blend_time)
+				blend.blend_time = m_vel_js.at(i) / m_acc_js.at(i);
+		}
+		blend.blend_start = TotalTime_ - blend.elapsed - blend.blend_time;
+		if (blend.blend_start < 0.0)
+			blend.blend_start = 0.0;
+	}
+
+	/* Neuer Pfad beginnt an der Sollposition zu Beginn der Überblendung: */
+	trajectory_msgs::JointTrajectoryPoint p;
+	p.positions.resize(m_DOF);
+	p.velocities.assign(m_DOF, 0.0);
+	p.accelerations.assign(m_DOF, 0.0);
+	m_pRefVals->getR_t(blend.elapsed + blend.blend_start, &p.positions[0]);
+	pfad.points.insert(pfad.points.begin(), p);
+	return true;
+}
+
+bool genericArmCtrl::buildBlend(const trajectory_msgs::JointTrajectory& pfad, Blend& blend)
+{
+	try
+	{
+		blend.to = createTrajectoryRefVals(pfad);
+	}
+	catch (std::runtime_error& e)
+	{
+		ROS_ERROR("Cannot blend into trajectory: %s", e.what());
+		blend.to = NULL;
+		return false;
+	}
+	return true;
+}
+
+bool genericArmCtrl::commitBlend(Blend& blend)
+{
+	if ( !isMoving || m_pRefVals == NULL || blend.to == NULL || blend.refvals_count != m_RefValsCount )
+		return false;
+
+	/* Überblendung startet frühestens jetzt, falls das Erzeugen des Pfads länger gedauert hat: */
+	TimeStamp now;
+	now.SetNow();
+	double elapsed = now - startTime_;
+	double blend_start = blend.elapsed + blend.blend_start - elapsed;
+	if (blend_start < 0.0)
+		blend_start = 0.0;
+	double blend_time = blend.blend_time;
+
+	/* Abgeschlossene Überblendungen auflösen, damit Ketten nicht wachsen: */
+	RefVal_JS* from = m_pRefVals;
+	double from_offset = elapsed;
+	RefValJS_Blend* running = dynamic_cast<RefValJS_Blend*>(m_pRefVals);
+	if ( running != NULL && running->getBlendEnd() <= elapsed )
+	{
+		double offset;
+		from = running->releaseTarget(offset);
+		from_offset = elapsed + offset;
+		delete running;
+	}
+
+	/* Überblendung so lang, dass die Geschwindigkeit des laufenden Pfads in den
+	   Beschleunigungsgrenzen abgebaut werden kann (max. Steigung der Gewichtung: 15/8): */
+	std::vector<double> v_from(m_DOF);
+	from->getDr_dt(from_offset + blend_start, &v_from[0]);
+	for(int i = 0; i < m_DOF; i++)
+	{
+		if (m_acc_js.at(i) <= 0.0)
+			continue;
+		double t_min = 1.875 * fabs(v_from[i]) / m_acc_js.at(i);
+		if (t_min > blend_time)
+			blend_time = t_min;
+	}
+
+	m_pRefVals = new RefValJS_Blend(from, from_offset, blend.to, blend_start, blend_time);
+	m_RefValsCount++;
+	blend.to = NULL;
+	startTime_ = now;
+	TotalTime_ = m_pRefVals->getTotalTime();
+	ROS_INFO("Blending into trajectory in %f s: %f s long", blend_start, TotalTime_);
+
+	return true;
+}
+
+void genericArmCtrl::cancelBlend(Blend& blend)
+{
+	delete blend.to;
+	blend.to = NULL;
+}
+
+RefVal_JS* genericArmCtrl::createTrajectoryRefVals(const trajectory_msgs::JointTrajectory& pfad) const
+{
 	double vel = m_vel_js.at(0);
 	for	(unsigned int i = 0; i<m_vel_js.size(); i++)
 	{
@@ -166,16 +314,12 @@ bool genericArmCtrl::moveTrajectory(trajectory_msgs::JointTrajectory pfad, std::
 		if(m_acc_js.at(i) < acc)
 			acc = m_acc_js.at(i);
 	}
-	m_pRefVals = new RefValJS_PTP_Trajectory(pfad, vel, acc, true);
-	
-	/* Regeljob starten: */
-	startTime_.SetNow();
-	isMoving = true;
-	TotalTime_ = m_pRefVals->getTotalTime();
-	ROS_INFO("Starting control of trajectory: %f s long", TotalTime_);
 
-	//START_CTRL_JOB(Trajectory)
-	return true;
+	if (pfad.points.size() == 2)
+		return new RefValJS_PTP(pfad.points[0].positions, pfad.points[1].positions, vel, acc);
+	if (m_TimeOptimal)
+		return new RefValJS_PTP_Trajectory(pfad, m_vel_js, m_acc_js, true);
+	return new RefValJS_PTP_Trajectory(pfad, vel, acc, true);
 }
 
 //bool genericArmCtrl::movePos(AbsPos position)
@@ -201,18 +345,22 @@ bool genericArmCtrl::moveTrajectory(trajectory_msgs::JointTrajectory pfad, std::
 //	START_CTRL_JOB(Cartesian)
 //}
 
-bool genericArmCtrl::step(std::vector<double> current_pos, std::vector<double> & desired_vel)
+bool genericArmCtrl::step(const std::vector<double>& current_pos, std::vector<double> & desired_vel)
+{
+	TimeStamp timeNow_;
+	timeNow_.SetNow();
+	return step(current_pos, desired_vel, timeNow_);
+}
+
+bool genericArmCtrl::step(const std::vector<double>& current_pos, std::vector<double> & desired_vel, const TimeStamp& timeNow_)
 {
 	if(isMoving)
 	{
-		TimeStamp timeNow_;
-		timeNow_.SetNow();
-
 		if ( m_pRefVals == NULL )
 				return false;
 		double t = timeNow_ - startTime_;
-		std::vector<double> m_qsoll = m_pRefVals->r_t( t );
-		std::vector<double> m_vsoll = m_pRefVals->dr_dt(t);
+		m_pRefVals->getR_t( t, &m_qsoll[0] );
+		m_pRefVals->getDr_dt( t, &m_vsoll[0] );
 
 		double len = 0;
 		for(int i = 0; i < m_DOF; i++)
@@ -63,11 +63,15 @@
 #include <sensor_msgs/JointState.h>
 #include <pr2_controllers_msgs/JointTrajectoryControllerState.h>
 #include <actionlib/server/simple_action_server.h>
+#include <boost/thread/mutex.hpp>
+#include <diagnostic_msgs/DiagnosticArray.h>
+#include <sstream>
 //#include <pr2_controllers_msgs/JointTrajectoryAction.h>
 #include <control_msgs/FollowJointTrajectoryAction.h>
 
 #include <brics_actuator/JointVelocities.h>
 #include <cob_trajectory_controller/genericArmCtrl.h>
+#include <cob_trajectory_controller/RealtimeLoop.h>
 // ROS service includes
 #include <cob_srvs/Trigger.h>
 #include <cob_srvs/SetOperationMode.h>
@@ -82,6 +86,7 @@ private:
     ros::NodeHandle n_;
 
     ros::Publisher joint_vel_pub_;
+    ros::Publisher diagnostics_pub_;
     ros::Subscriber controller_state_;
  	ros::Subscriber operation_mode_;
  	ros::ServiceServer srvServer_Stop_;
@@ -98,9 +103,15 @@ private:
     std::string current_operation_mode_;
     XmlRpc::XmlRpcValue JointNames_param_;
     std::vector<std::string> JointNames_;
+    // written by the action thread and by run(), guarded by traj_mutex_
     bool executing_;
     bool failure_;
     bool rejected_;
+    bool preempted_;
+    bool blending_;	// goal preempted by a new one, motion continues until the new goal is spliced in
+    bool queue_goals_;	// parameter queue_goals: a preempting goal starts after the running motion instead of replacing it
+    boost::mutex traj_mutex_;
+    boost::mutex state_mutex_;	// q_current, written by the state callback
     int DOF;
     double velocity_timeout_;
 
@@ -108,6 +119,16 @@ private:
     genericArmCtrl* traj_generator_;
     trajectory_msgs::JointTrajectory traj_;
     std::vector<double> q_current, startposition_, joint_distance_;
+    std::vector<double> des_vel_;
+    std::vector<double> q_cycle_;	// copy of q_current for the running cycle
+    brics_actuator::JointVelocities target_joint_vel_;	// joint names and units filled once, only the values change per cycle
+    // statistics of the realtime loop, copied by the loop and published by the spinner thread
+    boost::mutex stats_mutex_;
+    RealtimeLoop::Statistics loop_stats_;
+    double loop_period_;
+    bool loop_stats_pending_;
+    unsigned long total_overruns_;
+    ros::Timer stats_timer_;
 
 public:
 
@@ -120,6 +141,7 @@ public:
  
     {
 		joint_vel_pub_ = n_.advertise<brics_actuator::JointVelocities>("command_vel", 1);
+		diagnostics_pub_ = n_.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
         controller_state_ = n_.subscribe("state", 1, &cob_trajectory_controller_node::state_callback, this);
 		operation_mode_ = n_.subscribe("current_operationmode", 1, &cob_trajectory_controller_node::operationmode_callback, this);
 		srvServer_Stop_ = n_.advertiseService("stop", &cob_trajectory_controller_node::srvCallback_Stop, this);
@@ -134,6 +156,8 @@ public:
         executing_ = false;
         failure_ = false;
         rejected_ = false;
+        preempted_ = false;
+        blending_ = false;
 		watchdog_counter = 0;
 		current_operation_mode_ = "undefined";
 		double PTPvel = 0.7;
@@ -169,9 +193,32 @@ public:
 		{
 			n_.getParam("max_error", maxError);
 		}
+		bool timeOptimal = true;
+		if (n_.hasParam("time_optimal"))
+		{
+			n_.getParam("time_optimal", timeOptimal);
+		}
+		queue_goals_ = false;
+		if (n_.hasParam("queue_goals"))
+		{
+			n_.getParam("queue_goals", queue_goals_);
+		}
 		q_current.resize(DOF);
+		q_cycle_.resize(DOF);
+		des_vel_.resize(DOF);
+		target_joint_vel_.velocities.resize(DOF);
+		for(int i = 0; i < DOF; i++)
+		{
+			target_joint_vel_.velocities[i].joint_uri = JointNames_[i];
+			target_joint_vel_.velocities[i].unit = "rad";
+			target_joint_vel_.velocities[i].value = 0.0;
+		}
+		loop_period_ = 0.0;
+		loop_stats_pending_ = false;
+		total_overruns_ = 0;
 		ROS_INFO("starting controller with DOF: %d PTPvel: %f PTPAcc: %f maxError %f", DOF, PTPvel, PTPacc, maxError);
 		traj_generator_ = new genericArmCtrl(DOF, PTPvel, PTPacc, maxError);
+		traj_generator_->m_TimeOptimal = timeOptimal;
 	}
 
   double getFrequency()
@@ -195,9 +242,13 @@ public:
 		ROS_INFO("Stopping trajectory controller.");
 
 		// stop trajectory controller
+		boost::mutex::scoped_lock lock(traj_mutex_);
+		// without a motion, a goal may be starting the generator outside of the lock
+		if(executing_ || blending_)
+			traj_generator_->isMoving = false;
 		executing_ = false;
+		blending_ = false;
 		res.success.data = true;
-		traj_generator_->isMoving = false;
 		//as_.setPreemted();
 		failure_ = true;
 		return true;
@@ -223,16 +274,71 @@ public:
   }
   void state_callback(const pr2_controllers_msgs::JointTrajectoryControllerStatePtr& message)
   {
-    std::vector<double> positions = message->actual.positions;
-    for(unsigned int i = 0; i < positions.size(); i++)
+    const std::vector<double>& positions = message->actual.positions;
+    boost::mutex::scoped_lock lock(state_mutex_);
+    for(unsigned int i = 0; i < positions.size() && i < q_current.size(); i++)
     {
       q_current[i] = positions[i];
     }
   }
 
+  // copy of q_current, which the state callback writes concurrently
+  std::vector<double> getCurrentPosition()
+  {
+    boost::mutex::scoped_lock lock(state_mutex_);
+    return q_current;
+  }
+
   void spawnTrajector(trajectory_msgs::JointTrajectory trajectory)
   {
-    if(!executing_)
+    bool executing;
+    bool blending;
+    {
+        boost::mutex::scoped_lock lock(traj_mutex_);
+        executing = executing_;
+        blending = blending_;
+    }
+    if(!executing && blending)
+    {
+        // splice into the running motion: the new goal replaces the motion right away,
+        // or with the parameter queue_goals starts after the running one.
+        // The reference of the new goal is built without the lock, run() keeps stepping meanwhile.
+        genericArmCtrl::Blend blend;
+        trajectory_msgs::JointTrajectory path = trajectory;
+        bool moving;
+        bool begun = false;
+        {
+            boost::mutex::scoped_lock lock(traj_mutex_);
+            moving = traj_generator_->isMoving;
+            if(moving)
+                begun = traj_generator_->beginBlend(path, queue_goals_, blend);
+        }
+        if(moving && (!begun || !traj_generator_->buildBlend(path, blend)))
+        {
+            // keep the running motion, it ends without a goal
+            boost::mutex::scoped_lock lock(traj_mutex_);
+            ROS_WARN("Cannot blend into new goal, rejecting it");
+            rejected_ = true;
+            return;
+        }
+        boost::mutex::scoped_lock lock(traj_mutex_);
+        if(moving && blending_ && traj_generator_->commitBlend(blend))
+        {
+            traj_ = trajectory;
+            blending_ = false;
+            executing_ = true;
+            startposition_ = getCurrentPosition();
+            executing = true;
+        }
+        else
+        {
+            // the running motion ended in the meantime, start the goal from standstill
+            traj_generator_->cancelBlend(blend);
+            blending_ = false;
+        }
+    }
+    // from standstill run() does not use the generator, it is started without the lock
+    if(!executing)
         {
            //set component to velocity mode
           cob_srvs::SetOperationMode opmode;
@@ -246,14 +352,16 @@ public:
              //add timeout and set action to rejected
              if((ros::Time::now() - begin).toSec() > velocity_timeout_)
 				{
+               boost::mutex::scoped_lock lock(traj_mutex_);
                rejected_ = true;
                return;
 				}  
             }
             traj_ = trajectory;
+            std::vector<double> q_start = getCurrentPosition();
             if(traj_.points.size() == 1)
             {
-                traj_generator_->moveThetas(traj_.points[0].positions, q_current);
+                traj_generator_->moveThetas(traj_.points[0].positions, q_start);
             }
             else
             {
@@ -264,26 +372,32 @@ public:
                 p.accelerations.resize(DOF);
                 for(int i = 0; i<DOF; i++)
                 {
-                    p.positions.at(i) = q_current.at(i);
+                    p.positions.at(i) = q_start.at(i);
                     p.velocities.at(i) = 0.0;
                     p.accelerations.at(i) = 0.0;
                 }
                 std::vector<trajectory_msgs::JointTrajectoryPoint>::iterator it;
                 it = traj_.points.begin();
                 traj_.points.insert(it,p);
-                traj_generator_->moveTrajectory(traj_, q_current);
+                traj_generator_->moveTrajectory(traj_, q_start);
             }
+            boost::mutex::scoped_lock lock(traj_mutex_);
             executing_ = true;
-            startposition_ = q_current;
+            startposition_ = q_start;
 
             }
         else //suspend current movement and start new one
         {
             
         }
-        while(executing_)
+        while(true)
         {
-            sleep(1);
+            {
+                boost::mutex::scoped_lock lock(traj_mutex_);
+                if(!executing_)
+                    break;
+            }
+            usleep(10000);
         }
         
   }
@@ -311,81 +425,187 @@ public:
   {
         ROS_INFO("Received new goal trajectory with %d points",goal->trajectory.points.size());
         spawnTrajector(goal->trajectory);
+        bool rejected, preempted, failure;
+        {
+            boost::mutex::scoped_lock lock(traj_mutex_);
+            rejected = rejected_;
+            preempted = preempted_;
+            failure = failure_;
+            rejected_ = false;
+            failure_ = false;
+            preempted_ = false;
+        }
         // only set to succeeded if component could reach position. this is currently not the care for e.g. by emergency stop, hardware error or exceeds limit.
-        if(rejected_)
+        if(rejected)
             as_follow_.setAborted(); //setRejected not implemented in simpleactionserver ?
+        else if(preempted)
+            as_follow_.setPreempted();
         else
         {
-            if(failure_)
+            if(failure)
                 as_follow_.setAborted();
             else
                 as_follow_.setSucceeded();
         }
-        rejected_ = false;
-        failure_ = false;     
     }
     
+    // called with traj_mutex_ held
+    void stopMotion()
+    {
+        // set the action state to preempted
+        executing_ = false;
+        blending_ = false;
+        traj_generator_->isMoving = false;
+        //as_.setPreempted();
+        failure_ = true;
+        ROS_INFO("Preempted trajectory action");
+    }
+
     void run()
     {
-        if(executing_)
+        TimeStamp now;
+        now.SetNow();
+        run(now);
+    }
+
+    // one control cycle, the reference is evaluated at now
+    void run(const TimeStamp& now)
+    {
+        boost::mutex::scoped_lock lock(traj_mutex_);
+        if(executing_ || blending_)
         {
             failure_ = false;
 	        watchdog_counter = 0;
-			if (as_follow_.isPreemptRequested() || !ros::ok() || current_operation_mode_ != "velocity")
+			if (!ros::ok() || current_operation_mode_ != "velocity")
 			{
-				
-				// set the action state to preempted
-				executing_ = false;
-				traj_generator_->isMoving = false;
-				//as_.setPreempted();
-                failure_ = true;
-				ROS_INFO("Preempted trajectory action");
+				stopMotion();
 				return;
 			}
-        	std::vector<double> des_vel;
-        	if(traj_generator_->step(q_current, des_vel))
+			if (executing_ && as_follow_.isPreemptRequested())
+			{
+				if (as_follow_.isNewGoalAvailable())
+				{
+					// keep moving, executeFollowTrajectory blends the new goal in
+					preempted_ = true;
+					blending_ = true;
+					executing_ = false;
+					ROS_INFO("Preempted trajectory action, blending into new goal");
+				}
+				else
+				{
+					stopMotion();
+					return;
+				}
+			}
+			{
+				boost::mutex::scoped_lock state_lock(state_mutex_);
+				q_cycle_ = q_current;
+			}
+        	if(traj_generator_->step(q_cycle_, des_vel_, now))
         	{
         		if(!traj_generator_->isMoving) //Finished trajectory
         		{
         			executing_ = false;
+        			blending_ = false;
         		}
-				brics_actuator::JointVelocities target_joint_vel;
-				target_joint_vel.velocities.resize(DOF);
 				for(int i=0; i<DOF; i++)
 				{
-					target_joint_vel.velocities[i].joint_uri = JointNames_[i].c_str();
-					target_joint_vel.velocities[i].unit = "rad";
-					target_joint_vel.velocities[i].value = des_vel.at(i);
-
+					target_joint_vel_.velocities[i].value = des_vel_.at(i);
 				}
 
 				//send everything
-				joint_vel_pub_.publish(target_joint_vel);
+				joint_vel_pub_.publish(target_joint_vel_);
         	}
         	else
         	{
         		ROS_INFO("An controller error occured!");
                 failure_ = true;
         		executing_ = false;
+        		blending_ = false;
         	}
         }
 		else
 		{	//WATCHDOG TODO: don't always send
 		  if(watchdog_counter < 10)
 		    {
-			brics_actuator::JointVelocities target_joint_vel;
-			target_joint_vel.velocities.resize(DOF);
 			for (int i = 0; i < DOF; i += 1)
 			{
-				target_joint_vel.velocities[i].joint_uri = JointNames_[i].c_str();
-				target_joint_vel.velocities[i].unit = "rad";
-				target_joint_vel.velocities[i].value = 0;
+				target_joint_vel_.velocities[i].value = 0;
 			}
-				joint_vel_pub_.publish(target_joint_vel);
+				joint_vel_pub_.publish(target_joint_vel_);
 			}
 		  watchdog_counter++;
 		}
     }
+
+    // publishes the statistics reported by the realtime loop from the spinner thread every period
+    void startLoopStatistics(double period)
+    {
+        stats_timer_ = n_.createTimer(ros::Duration(period), &cob_trajectory_controller_node::publishLoopStatistics, this);
+    }
+
+    // called by the realtime loop, only copies the statistics, so the loop does not allocate
+    void reportLoopStatistics(const RealtimeLoop& loop)
+    {
+        boost::mutex::scoped_lock lock(stats_mutex_);
+        loop_stats_ = loop.getStatistics();
+        loop_period_ = loop.getPeriod();
+        total_overruns_ += loop_stats_.overruns;
+        loop_stats_pending_ = true;
+    }
+
+    void publishLoopStatistics(const ros::TimerEvent&)
+    {
+        RealtimeLoop::Statistics stats;
+        double period;
+        unsigned long total_overruns;
+        {
+            boost::mutex::scoped_lock lock(stats_mutex_);
+            if(!loop_stats_pending_)
+                return;
+            stats = loop_stats_;
+            period = loop_period_;
+            total_overruns = total_overruns_;
+            loop_stats_pending_ = false;
+        }
+
+        diagnostic_msgs::DiagnosticArray diagnostics;
+        diagnostics.header.stamp = ros::Time::now();
+        diagnostics.status.resize(1);
+        diagnostic_msgs::DiagnosticStatus& status = diagnostics.status[0];
+        status.name = ros::this_node::getName() + ": control loop";
+        if(stats.overruns > 0)
+        {
+            status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+            status.message = "deadlines missed";
+        }
+        else
+        {
+            status.level = diagnostic_msgs::DiagnosticStatus::OK;
+            status.message = "running";
+        }
+        addValue(status, "frequency [Hz]", 1.0 / period);
+        addValue(status, "cycles", stats.cycles);
+        addValue(status, "overruns", stats.overruns);
+        addValue(status, "overruns total", total_overruns);
+        addValue(status, "latency min [us]", stats.latency_min * 1e6);
+        addValue(status, "latency mean [us]", stats.latency_mean * 1e6);
+        addValue(status, "latency max [us]", stats.latency_max * 1e6);
+        addValue(status, "execution mean [us]", stats.exec_mean * 1e6);
+        addValue(status, "execution max [us]", stats.exec_max * 1e6);
+        diagnostics_pub_.publish(diagnostics);
+    }
+
+private:
+    static void addValue(diagnostic_msgs::DiagnosticStatus& status, const std::string& key, double value)
+    {
+        diagnostic_msgs::KeyValue kv;
+        kv.key = key;
+        std::ostringstream ss;
+        ss << value;
+        kv.value = ss.str();
+        status.values.push_back(kv);
+    }
     
 };
 
@@ -400,13 +620,56 @@ int main(int argc, char ** argv)
     /// get main loop parameters
     double frequency = tm.getFrequency();
 
-    ros::Rate loop_rate(frequency);
+    bool realtime = false;
+    int priority = 0;
+    int cpu = -1;
+    ros::NodeHandle n;
+    n.param("realtime", realtime, false);
+    n.param("realtime_priority", priority, 0);
+    n.param("realtime_cpu", cpu, -1);
+
+    if (!realtime)
+    {
+        ros::Rate loop_rate(frequency);
+        while (ros::ok())
+        {
+            tm.run();
+            ros::spinOnce();
+            loop_rate.sleep();
+        }
+        return 0;
+    }
+
+    // callbacks run in the spinner thread, the control loop only waits for its
+    // deadlines. The spinner is started before the thread settings are applied,
+    // so it keeps the normal scheduler.
+    ros::AsyncSpinner spinner(1);
+    spinner.start();
+    tm.startLoopStatistics(1.0);
+
+    RealtimeLoop loop(frequency);
+    if (!loop.configureThread(priority, cpu, priority > 0))
+        ROS_WARN("Could not apply all realtime settings (priority %d, cpu %d), missing privileges?", priority, cpu);
+    ROS_INFO("Starting realtime control loop with %f Hz", frequency);
+
+    unsigned long cycles_per_report = (unsigned long)frequency;
+    loop.start();
     while (ros::ok())
     {
-        tm.run();
-        ros::spinOnce();
-        loop_rate.sleep();
-    }  
+        const timespec& deadline = loop.waitForNextCycle();
+        TimeStamp now;
+        now.setTimeStamp(deadline.tv_sec, deadline.tv_nsec);
+        tm.run(now);
+
+        // once per second, published by the spinner thread
+        if (loop.getStatistics().cycles >= cycles_per_report)
+        {
+            tm.reportLoopStatistics(loop);
+            loop.resetStatistics();
+        }
+    }
+    spinner.stop();
+    return 0;
 	
 }
 
@@ -0,0 +1,680 @@
+/****************************************************************
+ *
+ * Copyright (c) 2026
+ *
+ * Fraunhofer Institute for Manufacturing Engineering
+ * and Automation (IPA)
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Project name: care-o-bot
+ * ROS stack name: cob_driver
+ * ROS package name: cob_trajectory_controller
+ * Description: Benchmark for the construction of RefValJS_PTP_Trajectory
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Date of creation: October 2026
+ * ToDo:
+ *
+ * +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Fraunhofer Institute for Manufacturing
+ *       Engineering and Automation (IPA) nor the names of its
+ *       contributors may be used to endorse or promote products derived from
+ *       this software without specific prior written permission.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License LGPL as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License LGPL for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License LGPL along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ *
+ ****************************************************************/
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include <trajectory_msgs/JointTrajectory.h>
+#include <cob_trajectory_controller/RefValJS_PTP.h>
+#include <cob_trajectory_controller/RefValJS_PTP_Trajectory.h>
+#include <cob_trajectory_controller/RefValJS_SyncPTP.h>
+#include <cob_trajectory_controller/genericArmCtrl.h>
+#include <cob_trajectory_controller/RealtimeLoop.h>
+#include <cob_trajectory_controller/TimeStamp.h>
+
+// Counts heap allocations, so the benchmark can check that the control loop does not allocate
+static unsigned long g_num_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+	g_num_allocations++;
+	void* p = malloc(size ? size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) throw()
+{
+	free(p);
+}
+
+void operator delete(void* p, std::size_t) throw()
+{
+	free(p);
+}
+
+struct Options
+{
+	unsigned int dof;
+	std::vector<unsigned int> sizes;	// waypoints, empty for the defaults of each benchmark
+	double rate;
+	unsigned int cycles;
+	unsigned int seed;
+	std::string only;			// comma separated benchmark names, empty for all
+	std::string format;
+
+	Options() : dof(7), rate(1000.0), cycles(5000), seed(42), format("text") {}
+
+	bool selected(const char* name) const
+	{
+		if (only.empty())
+			return true;
+		std::string list = "," + only + ",";
+		return list.find("," + std::string(name) + ",") != std::string::npos;
+	}
+
+	std::vector<unsigned int> getSizes(const unsigned int* defaults, unsigned int num_defaults) const
+	{
+		if (!sizes.empty())
+			return sizes;
+		return std::vector<unsigned int>(defaults, defaults + num_defaults);
+	}
+};
+
+/*
+ * Prints the results of the benchmarks as table per benchmark (text), as csv
+ * with the benchmark name in the first column or as one json object per row.
+ * The machine readable formats keep the column names stable, so results of
+ * different versions can be compared.
+ */
+class Report
+{
+	public:
+		Report(const std::string& format) : m_format(format) {}
+
+		void begin(const char* name, const char* title, const char* columns)
+		{
+			m_name = name;
+			m_columns.clear();
+			std::string cols(columns);
+			size_t pos = 0;
+			while (pos <= cols.size())
+			{
+				size_t next = cols.find(',', pos);
+				if (next == std::string::npos)
+					next = cols.size();
+				m_columns.push_back(cols.substr(pos, next - pos));
+				pos = next + 1;
+			}
+
+			if (m_format == "text")
+			{
+				printf("# %s\n#", title);
+				for(unsigned int i = 0; i < m_columns.size(); i++)
+					printf(" %14s", m_columns[i].c_str());
+				printf("\n");
+			}
+			else if (m_format == "csv")
+			{
+				printf("benchmark");
+				for(unsigned int i = 0; i < m_columns.size(); i++)
+					printf(",%s", m_columns[i].c_str());
+				printf("\n");
+			}
+		}
+
+		void row(const double* values)
+		{
+			if (m_format == "text")
+			{
+				printf(" ");
+				for(unsigned int i = 0; i < m_columns.size(); i++)
+					printf(" %14.6g", values[i]);
+				printf("\n");
+			}
+			else if (m_format == "csv")
+			{
+				printf("%s", m_name.c_str());
+				for(unsigned int i = 0; i < m_columns.size(); i++)
+					printf(",%.9g", values[i]);
+				printf("\n");
+			}
+			else
+			{
+				printf("{\"benchmark\": \"%s\"", m_name.c_str());
+				for(unsigned int i = 0; i < m_columns.size(); i++)
+				{
+					// json has no nan or inf
+					if (values[i] == values[i] && fabs(values[i]) <= 1e308)
+						printf(", \"%s\": %.9g", m_columns[i].c_str(), values[i]);
+					else
+						printf(", \"%s\": null", m_columns[i].c_str());
+				}
+				printf("}\n");
+			}
+		}
+
+		void end()
+		{
+			if (m_format == "text")
+				printf("\n");
+		}
+
+	protected:
+		std::string m_format;
+		std::string m_name;
+		std::vector<std::string> m_columns;
+};
+
+// Random walk in joint space, deterministic for a given seed
+trajectory_msgs::JointTrajectory createTrajectory(unsigned int num_points, unsigned int dof, unsigned int seed)
+{
+	trajectory_msgs::JointTrajectory traj;
+	std::vector<double> q(dof, 0.0);
+
+	srand(seed);
+	traj.points.resize(num_points);
+	for(unsigned int i = 0; i < num_points; i++)
+	{
+		for(unsigned int j = 0; j < dof; j++)
+			q[j] += 0.05 * ((double)rand() / RAND_MAX - 0.3);
+		traj.points[i].positions = q;
+		traj.points[i].velocities.assign(dof, 0.0);
+		traj.points[i].accelerations.assign(dof, 0.0);
+	}
+	return traj;
+}
+
+// Smooth sweep of all joints, like the output of a motion planner
+trajectory_msgs::JointTrajectory createSmoothTrajectory(unsigned int num_points, unsigned int dof)
+{
+	trajectory_msgs::JointTrajectory traj;
+
+	traj.points.resize(num_points);
+	for(unsigned int i = 0; i < num_points; i++)
+	{
+		double f = (double)i / (num_points - 1);
+		traj.points[i].positions.resize(dof);
+		for(unsigned int j = 0; j < dof; j++)
+			traj.points[i].positions[j] = (1.0 + 0.2 * j) * sin(6.0 * f + j) + 0.3 * j * f;
+		traj.points[i].velocities.assign(dof, 0.0);
+		traj.points[i].accelerations.assign(dof, 0.0);
+	}
+	return traj;
+}
+
+/*
+ * Velocity controlled joint: the commanded velocity takes effect one cycle
+ * later and is followed with a first order lag, like the drives of the arm
+ * in velocity mode.
+ */
+class SimulatedJoints
+{
+	public:
+		SimulatedJoints(const std::vector<double>& q0, double dt, double time_constant) :
+			m_q(q0), m_v(q0.size(), 0.0), m_cmd(q0.size(), 0.0), m_dt(dt)
+		{
+			m_alpha = 1.0 - exp(-dt / time_constant);
+		}
+
+		void update(const std::vector<double>& cmd)
+		{
+			for(unsigned int j = 0; j < m_q.size(); j++)
+			{
+				m_v[j] += m_alpha * (m_cmd[j] - m_v[j]);
+				m_q[j] += m_v[j] * m_dt;
+				m_cmd[j] = cmd[j];
+			}
+		}
+
+		const std::vector<double>& position() const { return m_q; }
+
+	protected:
+		std::vector<double> m_q;
+		std::vector<double> m_v;
+		std::vector<double> m_cmd;	// command of the last cycle
+		double m_dt;
+		double m_alpha;
+};
+
+void benchmarkConstruction(const Options& opt, Report& report)
+{
+	const unsigned int defaults[] = { 100, 300, 1000, 3000, 10000 };
+	std::vector<unsigned int> sizes = opt.getSizes(defaults, sizeof(defaults) / sizeof(defaults[0]));
+
+	report.begin("construction", "RefValJS_PTP_Trajectory construction, smooth spline", "dof,waypoints,runs,mean_ms,min_ms,trajectory_s");
+	for(unsigned int n = 0; n < sizes.size(); n++)
+	{
+		trajectory_msgs::JointTrajectory traj = createTrajectory(sizes[n], opt.dof, opt.seed);
+
+		// enough runs for a stable mean on the short trajectories
+		int runs = 200000 / sizes[n];
+		if (runs < 5)
+			runs = 5;
+
+		double sum = 0.0;
+		double min = 1e9;
+		double total_time = 0.0;
+		for(int r = 0; r < runs; r++)
+		{
+			TimeStamp start, end;
+			start.SetNow();
+			RefValJS_PTP_Trajectory ref(traj, 0.7, 0.2, true);
+			end.SetNow();
+
+			double dt = end - start;
+			sum += dt;
+			if (dt < min)
+				min = dt;
+			total_time = ref.getTotalTime();
+		}
+		double row[] = { (double)opt.dof, (double)sizes[n], (double)runs, 1e3 * sum / runs, 1e3 * min, total_time };
+		report.row(row);
+	}
+	report.end();
+}
+
+// Cost of one reference evaluation (position and velocity) for progressing time
+void benchmarkEvaluation(const Options& opt, Report& report)
+{
+	const unsigned int defaults[] = { 100, 1000, 10000, 100000 };
+	std::vector<unsigned int> sizes = opt.getSizes(defaults, sizeof(defaults) / sizeof(defaults[0]));
+	const unsigned int samples = 200000;
+
+	std::vector<double> q(opt.dof), dq(opt.dof);
+
+	report.begin("evaluation", "reference evaluation getR_t() + getDr_dt()", "dof,waypoints,samples,mean_ns");
+	for(unsigned int n = 0; n < sizes.size(); n++)
+	{
+		trajectory_msgs::JointTrajectory traj = createTrajectory(sizes[n], opt.dof, opt.seed);
+		RefValJS_PTP_Trajectory ref(traj, 0.7, 0.2, true);
+		double T = ref.getTotalTime();
+
+		double check = 0.0;
+		TimeStamp start, end;
+		start.SetNow();
+		for(unsigned int i = 0; i < samples; i++)
+		{
+			double t = T * i / samples;
+			ref.getR_t(t, &q[0]);
+			ref.getDr_dt(t, &dq[0]);
+			check += q[0] + dq[0];
+		}
+		end.SetNow();
+
+		// check keeps the evaluation from being optimized away
+		double row[] = { (double)opt.dof, (double)sizes[n], (double)samples, 1e9 * (end - start) / samples + 0.0 * check };
+		report.row(row);
+	}
+	report.end();
+}
+
+// Execution time of the single trapezoid for the slowest joint against the
+// time optimal profile with individual joint limits
+void benchmarkTimeParameterization(const Options& opt, Report& report)
+{
+	const unsigned int defaults[] = { 100, 1000, 10000 };
+	std::vector<unsigned int> sizes = opt.getSizes(defaults, sizeof(defaults) / sizeof(defaults[0]));
+
+	std::vector<double> v_max(opt.dof, 0.7);
+	std::vector<double> a_max(opt.dof, 0.2);
+	// wrist joints are faster
+	for(unsigned int j = opt.dof / 2; j < opt.dof; j++)
+	{
+		v_max[j] = 1.0;
+		a_max[j] = 0.5;
+	}
+
+	report.begin("timing", "time parameterization, smooth path", "dof,waypoints,trapezoid_s,time_optimal_s,construction_ms");
+	for(unsigned int n = 0; n < sizes.size(); n++)
+	{
+		trajectory_msgs::JointTrajectory traj = createSmoothTrajectory(sizes[n], opt.dof);
+		RefValJS_PTP_Trajectory trapezoid(traj, 0.7, 0.2, true);
+
+		TimeStamp start, end;
+		start.SetNow();
+		RefValJS_PTP_Trajectory optimal(traj, v_max, a_max, true);
+		end.SetNow();
+
+		double row[] = { (double)opt.dof, (double)sizes[n], trapezoid.getTotalTime(), optimal.getTotalTime(), 1e3 * (end - start) };
+		report.row(row);
+	}
+	report.end();
+}
+
+// Runs genericArmCtrl::step() at the loop rate on absolute deadlines, the joints
+// integrate the commanded velocities perfectly.
+void benchmarkStep(const Options& opt, Report& report)
+{
+	const unsigned int defaults[] = { 1000 };
+	std::vector<unsigned int> sizes = opt.getSizes(defaults, sizeof(defaults) / sizeof(defaults[0]));
+	const double dt = 1.0 / opt.rate;
+
+	report.begin("step", "genericArmCtrl::step() in realtime", "dof,waypoints,rate_hz,cycles,mean_us,max_us,allocations_per_cycle,latency_mean_us,latency_max_us,overruns");
+	for(unsigned int n = 0; n < sizes.size(); n++)
+	{
+		trajectory_msgs::JointTrajectory traj = createTrajectory(sizes[n], opt.dof, opt.seed);
+		std::vector<double> q = traj.points.front().positions;
+		std::vector<double> vel(opt.dof, 0.0);
+
+		genericArmCtrl ctrl(opt.dof);
+		ctrl.moveTrajectory(traj, q);
+
+		RealtimeLoop loop(opt.rate);
+		loop.start();
+
+		double sum = 0.0;
+		double max = 0.0;
+		unsigned int steps = 0;
+		unsigned long allocations = g_num_allocations;
+		for(unsigned int c = 0; c < opt.cycles; c++)
+		{
+			const timespec& deadline = loop.waitForNextCycle();
+			TimeStamp now, start, end;
+			now.setTimeStamp(deadline.tv_sec, deadline.tv_nsec);
+			start.SetNow();
+			bool ok = ctrl.step(q, vel, now);
+			end.SetNow();
+			if (!ok || !ctrl.isMoving)
+				break;
+
+			double t = end - start;
+			sum += t;
+			if (t > max)
+				max = t;
+			steps++;
+
+			for(unsigned int j = 0; j < opt.dof; j++)
+				q[j] += vel[j] * dt;
+		}
+		allocations = g_num_allocations - allocations;
+
+		RealtimeLoop::Statistics stats = loop.getStatistics();
+		double row[] = { (double)opt.dof, (double)sizes[n], opt.rate, (double)steps, steps ? 1e6 * sum / steps : 0.0, 1e6 * max,
+			steps ? (double)allocations / steps : 0.0, 1e6 * stats.latency_mean, 1e6 * stats.latency_max, (double)stats.overruns };
+		report.row(row);
+	}
+	report.end();
+}
+
+/*
+ * Executes whole trajectories in simulated time, as fast as possible, against
+ * SimulatedJoints. Reports the compute time of the complete execution, the time
+ * the controller needed to finish and the largest tracking error on the way.
+ */
+void benchmarkSimulation(const Options& opt, Report& report)
+{
+	const unsigned int defaults[] = { 10, 100, 1000 };
+	std::vector<unsigned int> sizes = opt.getSizes(defaults, sizeof(defaults) / sizeof(defaults[0]));
+	const double dt = 1.0 / opt.rate;
+	const double time_constant = 0.02;
+
+	report.begin("simulation", "whole trajectory against simulated joints, smooth path",
+		"dof,waypoints,rate_hz,success,trajectory_s,executed_s,cycles,compute_ms,step_mean_us,max_error,final_error");
+	for(unsigned int n = 0; n < sizes.size(); n++)
+	{
+		trajectory_msgs::JointTrajectory traj = createSmoothTrajectory(sizes[n], opt.dof);
+		SimulatedJoints joints(traj.points.front().positions, dt, time_constant);
+		std::vector<double> vel(opt.dof, 0.0);
+
+		genericArmCtrl ctrl(opt.dof);
+		TimeStamp compute_start;
+		compute_start.SetNow();
+		ctrl.moveTrajectory(traj, joints.position());
+		TimeStamp now;
+		now.SetNow();
+		double trajectory_time = ctrl.TotalTime_;
+
+		// the controller stops by itself after its extra time, the limit only guards against a hang
+		unsigned int max_cycles = (unsigned int)((trajectory_time + 60.0) * opt.rate);
+		unsigned int cycles = 0;
+		bool ok = true;
+		double max_error = 0.0;
+		while (ctrl.isMoving && cycles < max_cycles)
+		{
+			now += dt;
+			ok = ctrl.step(joints.position(), vel, now);
+			if (!ok)
+				break;
+			if (ctrl.m_CurrentError > max_error)
+				max_error = ctrl.m_CurrentError;
+			joints.update(vel);
+			cycles++;
+		}
+		TimeStamp compute_end;
+		compute_end.SetNow();
+
+		double final_error = 0.0;
+		const std::vector<double>& goal = traj.points.back().positions;
+		for(unsigned int j = 0; j < opt.dof; j++)
+			final_error += (goal[j] - joints.position()[j]) * (goal[j] - joints.position()[j]);
+		final_error = sqrt(final_error);
+
+		double compute = compute_end - compute_start;
+		double row[] = { (double)opt.dof, (double)sizes[n], opt.rate, (ok && !ctrl.isMoving) ? 1.0 : 0.0, trajectory_time, cycles * dt, (double)cycles,
+			1e3 * compute, cycles ? 1e6 * compute / cycles : 0.0, max_error, final_error };
+		report.row(row);
+	}
+	report.end();
+}
+
+/*
+ * Point to point moves: RefValJS_PTP with one velocity and acceleration for the
+ * weighted norm against RefValJS_SyncPTP with the same limits for every joint,
+ * as trapezoid and as double S profile. Evaluation of the same number of time
+ * samples per move, sample by sample through the RefVal_JS interface and in one
+ * batch (positions and velocities).
+ */
+void benchmarkPTP(const Options& opt, Report& report)
+{
+	const unsigned int defaults[] = { 10, 100, 1000, 10000 };
+	std::vector<unsigned int> sizes = opt.getSizes(defaults, sizeof(defaults) / sizeof(defaults[0]));
+	const unsigned int moves = 100;
+	const unsigned int dof = opt.dof;
+
+	std::vector<double> v_max(dof, 0.7), a_max(dof, 0.2), j_max(dof, 1.0);
+	std::vector<double> q(dof), dq(dof);
+
+	// random start and goal configurations
+	std::vector<std::vector<double> > conf(moves + 1, std::vector<double>(dof));
+	srand(opt.seed);
+	for(unsigned int m = 0; m <= moves; m++)
+		for(unsigned int j = 0; j < dof; j++)
+			conf[m][j] = 2.0 * ((double)rand() / RAND_MAX - 0.5);
+
+	report.begin("ptp", "point to point moves, RefValJS_PTP against RefValJS_SyncPTP",
+		"dof,samples,ptp_s,sync_s,double_s_s,ptp_construct_ns,sync_construct_ns,ptp_scalar_ns,sync_scalar_ns,sync_batch_ns,double_s_batch_ns");
+	for(unsigned int n = 0; n < sizes.size(); n++)
+	{
+		unsigned int samples = sizes[n];
+		std::vector<double> t(samples), pos(samples * dof), vel(samples * dof);
+		double ptp_time = 0.0, sync_time = 0.0, double_s_time = 0.0;
+		double ptp_construct = 0.0, sync_construct = 0.0;
+		double ptp_scalar = 0.0, sync_scalar = 0.0, sync_batch = 0.0, double_s_batch = 0.0;
+		double check = 0.0;
+
+		for(unsigned int m = 0; m < moves; m++)
+		{
+			TimeStamp start, end;
+			start.SetNow();
+			RefValJS_PTP ptp(conf[m], conf[m+1], 0.7, 0.2);
+			end.SetNow();
+			ptp_construct += end - start;
+
+			start.SetNow();
+			RefValJS_SyncPTP sync(conf[m], conf[m+1], v_max, a_max);
+			end.SetNow();
+			sync_construct += end - start;
+
+			RefValJS_SyncPTP double_s(conf[m], conf[m+1], v_max, a_max, j_max);
+			ptp_time += ptp.getTotalTime();
+			sync_time += sync.getTotalTime();
+			double_s_time += double_s.getTotalTime();
+
+			double T = ptp.getTotalTime();
+			start.SetNow();
+			for(unsigned int k = 0; k < samples; k++)
+			{
+				ptp.getR_t(T * k / samples, &q[0]);
+				ptp.getDr_dt(T * k / samples, &dq[0]);
+				check += q[0] + dq[0];
+			}
+			end.SetNow();
+			ptp_scalar += end - start;
+
+			T = sync.getTotalTime();
+			start.SetNow();
+			for(unsigned int k = 0; k < samples; k++)
+			{
+				sync.getR_t(T * k / samples, &q[0]);
+				sync.getDr_dt(T * k / samples, &dq[0]);
+				check += q[0] + dq[0];
+			}
+			end.SetNow();
+			sync_scalar += end - start;
+
+			for(unsigned int k = 0; k < samples; k++)
+				t[k] = T * k / samples;
+			start.SetNow();
+			sync.evaluate(&t[0], samples, &pos[0], &vel[0], NULL);
+			end.SetNow();
+			sync_batch += end - start;
+			check += pos[samples / 2] + vel[samples / 2];
+
+			T = double_s.getTotalTime();
+			for(unsigned int k = 0; k < samples; k++)
+				t[k] = T * k / samples;
+			start.SetNow();
+			double_s.evaluate(&t[0], samples, &pos[0], &vel[0], NULL);
+			end.SetNow();
+			double_s_batch += end - start;
+			check += pos[samples / 2] + vel[samples / 2];
+		}
+
+		// check keeps the evaluation from being optimized away
+		double per_sample = 1e9 / ((double)moves * samples);
+		double row[] = { (double)dof, (double)samples, ptp_time / moves, sync_time / moves, double_s_time / moves,
+			1e9 * ptp_construct / moves, 1e9 * sync_construct / moves,
+			ptp_scalar * per_sample, sync_scalar * per_sample, sync_batch * per_sample + 0.0 * check, double_s_batch * per_sample };
+		report.row(row);
+	}
+	report.end();
+}
+
+void usage(const char* name)
+{
+	printf("usage: %s [options]\n"
+		"  --dof N             joints of the synthetic trajectories (7)\n"
+		"  --points N[,N...]   waypoints (time samples for ptp), replaces the default sizes of every benchmark\n"
+		"  --rate HZ           control rate of step and simulation (1000)\n"
+		"  --cycles N          cycles of the realtime step benchmark (5000)\n"
+		"  --seed N            seed of the random trajectories (42)\n"
+		"  --only NAME[,NAME]  construction, evaluation, timing, step, simulation, ptp\n"
+		"  --format FORMAT     text, csv or json (text)\n", name);
+}
+
+bool parseOptions(int argc, char** argv, Options& opt)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--help" || arg == "-h" || i + 1 >= argc)
+			return false;
+		const char* value = argv[++i];
+
+		if (arg == "--dof")
+			opt.dof = strtoul(value, NULL, 10);
+		else if (arg == "--points")
+		{
+			opt.sizes.clear();
+			char* end = (char*)value;
+			while (*end != '\0')
+			{
+				opt.sizes.push_back(strtoul(end, &end, 10));
+				if (*end == ',')
+					end++;
+				else if (*end != '\0')
+					return false;
+			}
+		}
+		else if (arg == "--rate")
+			opt.rate = strtod(value, NULL);
+		else if (arg == "--cycles")
+			opt.cycles = strtoul(value, NULL, 10);
+		else if (arg == "--seed")
+			opt.seed = strtoul(value, NULL, 10);
+		else if (arg == "--only")
+			opt.only = value;
+		else if (arg == "--format")
+			opt.format = value;
+		else
+			return false;
+	}
+
+	if (opt.dof == 0 || opt.rate <= 0.0 || (opt.format != "text" && opt.format != "csv" && opt.format != "json"))
+		return false;
+	for(unsigned int n = 0; n < opt.sizes.size(); n++)
+	{
+		if (opt.sizes[n] < 2)
+			return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	Options opt;
+	if (!parseOptions(argc, argv, opt))
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	Report report(opt.format);
+	if (opt.selected("construction"))
+		benchmarkConstruction(opt, report);
+	if (opt.selected("evaluation"))
+		benchmarkEvaluation(opt, report);
+	if (opt.selected("timing"))
+		benchmarkTimeParameterization(opt, report);
+	if (opt.selected("step"))
+		benchmarkStep(opt, report);
+	if (opt.selected("simulation"))
+		benchmarkSimulation(opt, report);
+	if (opt.selected("ptp"))
+		benchmarkPTP(opt, report);
+	return 0;
+}